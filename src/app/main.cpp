@@ -15,10 +15,12 @@
 #include "IApplicationSettings.hpp"
 #include "impls/Factory.hpp"
 #include "includes.h"
+#include "IndexQuery.h"
 #include "language_packages.h"
 #include "LanguagePackageManager.h"
 #include "logging.h"
 #include "productVersion.h"
+#include "Profiler.h"
 #include "QtApplication.h"
 #include "QtCoreApplication.h"
 #include "QtNetworkFactory.h"
@@ -89,12 +91,16 @@ int runConsole(int argc, char** argv, const Version& version, commandline::Comma
   commandLineParser.parse();
 
   if(commandLineParser.exitApplication()) {
-    return EXIT_SUCCESS;
+    return commandLineParser.commandFailed() ? EXIT_FAILURE : EXIT_SUCCESS;
   }
 
   if(commandLineParser.hasError()) {
     std::wcout << commandLineParser.getError() << L'\n';
   } else {
+    if(!commandLineParser.getProfileFilePath().empty()) {
+      Profiler::start(commandLineParser.getProfileFilePath().str());
+    }
+
     MessageLoadProject{commandLineParser.getProjectFilePath(),
                        false,
                        commandLineParser.getRefreshMode(),
@@ -102,7 +108,49 @@ int runConsole(int argc, char** argv, const Version& version, commandline::Comma
         .dispatch();
   }
 
-  return QCoreApplication::exec();
+  const int result = QCoreApplication::exec();
+
+  if(!Profiler::finish()) {
+    std::wcout << L"Failed to write the profile to " << commandLineParser.getProfileFilePath().wstr() << L'\n';
+  }
+
+  return result;
+}
+
+int runQueries(commandline::CommandLineParser& commandLineParser) {
+  commandLineParser.parse();
+
+  if(commandLineParser.exitApplication()) {
+    return commandLineParser.commandFailed() ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+
+  try {
+    const IndexQuery indexQuery(commandLineParser.getQueryDatabaseFilePath());
+    if(!indexQuery.isCompatible()) {
+      std::cerr << "ERROR: The database was created by another version of Sourcetrail, please reindex the project\n";
+      return EXIT_FAILURE;
+    }
+
+    if(!commandLineParser.getQueries().empty()) {
+      for(const std::string& query : commandLineParser.getQueries()) {
+        std::cout << indexQuery.run(query) << '\n';
+      }
+      return EXIT_SUCCESS;
+    }
+
+    // answer each line right away, so scripts can keep one process open and send further queries
+    std::string query;
+    while(std::getline(std::cin, query)) {
+      if(!utility::trim(query).empty()) {
+        std::cout << indexQuery.run(query) << std::endl;
+      }
+    }
+  } catch(const CppSQLite3Exception& exception) {
+    std::cerr << "ERROR: " << exception.errorMessage() << '\n';
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
 }
 
 int runGui(int argc, char** argv, const Version& version, commandline::CommandLineParser& commandLineParser) {
@@ -189,6 +237,9 @@ int main(int argc, char* argv[]) {
   setupPlatform(argc, argv);
 
   IApplicationSettings::setInstance(std::make_shared<ApplicationSettings>());
+  if(commandLineParser.runWithoutApplication()) {
+    return runQueries(commandLineParser);
+  }
   if(commandLineParser.runWithoutGUI()) {
     return runConsole(argc, argv, version, commandLineParser);
   }
@@ -66,7 +66,8 @@ TEST(CommandLineParserConfig, helpOption) {
   {
     constexpr std::string_view HelpString =
         "Usage:\n  Sourcetrail [command] [option...] [positional arguments]\n\nCommands:\n  config                 Change "
-        "preferences relevant to project indexing.*\n  index                  Index a certain project.*\n\n  * has its own "
+        "preferences relevant to project indexing.*\n  index                  Index a certain project.*\n  query                  "
+        "Answer queries on an indexed project as JSON lines.*\n\n  * has its own "
         "--help\n\nOptions:\n  -h [ --help ]          Print this help message\n  -v [ --version ]       Version of Sourcetrail\n "
         " --project-file arg     Open Sourcetrail with this project (.srctrlprj)\n\nPositional Arguments: \n  1: project-file\n";
     CollectOutStream collectCout(std::cout);
@@ -218,3 +219,30 @@ TEST(CommandLineParserConfig, initStateRegisitedCommands) {
   EXPECT_EQ(RefreshMode::UpdatedFiles, parser.getRefreshMode());
   EXPECT_FALSE(parser.getShallowIndexingRequested());
 }
+
+// NOLINTNEXTLINE
+TEST(CommandLineParserQuery, helpQuitsWithoutFailure) {
+  commandline::CommandLineParser parser({});
+  parser.preparse({"query", "--help"});
+  {
+    CollectOutStream collectCout(std::cout);
+    parser.parse();
+    collectCout.close();
+  }
+  EXPECT_TRUE(parser.runWithoutApplication());
+  EXPECT_TRUE(parser.exitApplication());
+  EXPECT_FALSE(parser.commandFailed());
+}
+
+// NOLINTNEXTLINE
+TEST(CommandLineParserQuery, missingDatabaseFails) {
+  commandline::CommandLineParser parser({});
+  parser.preparse({"query", "/tmp/missing.srctrldb"});
+  {
+    CollectOutStream collectCerr(std::cerr);
+    parser.parse();
+    collectCerr.close();
+  }
+  EXPECT_TRUE(parser.exitApplication());
+  EXPECT_TRUE(parser.commandFailed());
+}
@@ -31,7 +31,8 @@ TEST_F(CommandlineCommandIndexFix, emptyArgs) {
       "Usage:\n\n  Sourcetrail index [option...]\n\nIndex a certain project.\n\n\nConfig Options:\n  -h [ --help ]          "
       "Print this help message\n  -i [ --incomplete ]    Also reindex incomplete files (files with errors)\n  -f [ --full ]      "
       "    Index full project (omit to only index new/changed \n                         files)\n  -s [ --shallow ]       Build "
-      "a shallow index is supported by the project\n  --project-file arg     Project file to index (.srctrlprj)\n\nPositional "
+      "a shallow index is supported by the project\n  --profile arg          Write a Chrome trace of the indexing phases to "
+      "this \n                         file\n  --project-file arg     Project file to index (.srctrlprj)\n\nPositional "
       "Arguments: \n  1: project-file\n";
 
   CollectOutStream oStream(std::cout);
@@ -48,7 +49,8 @@ TEST_F(CommandlineCommandIndexFix, helpArgs) {
       "Usage:\n\n  Sourcetrail index [option...]\n\nIndex a certain project.\n\n\nConfig Options:\n  -h [ --help ]          "
       "Print this help message\n  -i [ --incomplete ]    Also reindex incomplete files (files with errors)\n  -f [ --full ]      "
       "    Index full project (omit to only index new/changed \n                         files)\n  -s [ --shallow ]       Build "
-      "a shallow index is supported by the project\n  --project-file arg     Project file to index (.srctrlprj)\n\nPositional "
+      "a shallow index is supported by the project\n  --profile arg          Write a Chrome trace of the indexing phases to "
+      "this \n                         file\n  --project-file arg     Project file to index (.srctrlprj)\n\nPositional "
       "Arguments: \n  1: project-file\n";
 
   CollectOutStream oStream(std::cout);
@@ -68,6 +70,24 @@ TEST_F(CommandlineCommandIndexFix, goodCaseArgs) {
   EXPECT_TRUE(mParser->getShallowIndexingRequested());
 }
 
+TEST_F(CommandlineCommandIndexFix, profileArgs) {
+  std::vector<std::string> args = {"-f", "--profile", "/tmp/trace.json"};
+
+  auto ret = mConfig->parse(args);
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_OK, ret);
+  EXPECT_EQ(L"/tmp/trace.json", mParser->getProfileFilePath().wstr());
+}
+
+TEST_F(CommandlineCommandIndexFix, noProfileArgs) {
+  std::vector<std::string> args = {"-f"};
+
+  auto ret = mConfig->parse(args);
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_OK, ret);
+  EXPECT_TRUE(mParser->getProfileFilePath().empty());
+}
+
 TEST_F(CommandlineCommandIndexFix, projectIsAbsent) {
   auto handler = FileHandler::createEmptyFile("/tmp/invalid");
   std::vector<std::string> args = {"/tmp/invalid"};
@@ -0,0 +1,82 @@
+#include <iostream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "CommandlineCommandQuery.h"
+#include "CommandLineParser.h"
+#include "utilities/CollectOutStream.hpp"
+#include "utilities/FileHandler.hpp"
+
+using namespace testing;
+using namespace commandline;
+
+struct CommandlineCommandQueryFix : public Test {
+  void SetUp() override {
+    mParser = std::make_unique<CommandLineParser>("2023.6.8");
+
+    mQuery = std::make_unique<CommandlineCommandQuery>(mParser.get());
+    mQuery->setup();
+  }
+
+  std::unique_ptr<CommandLineParser> mParser;
+  std::unique_ptr<CommandlineCommandQuery> mQuery;
+};
+
+TEST_F(CommandlineCommandQueryFix, emptyArgs) {
+  std::vector<std::string> args;
+
+  CollectOutStream oStream(std::cout);
+  auto ret = mQuery->parse(args);
+  oStream.close();
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_QUIT, ret);
+  EXPECT_THAT(oStream.str(), HasSubstr("Sourcetrail query [option...]"));
+}
+
+TEST_F(CommandlineCommandQueryFix, runsWithoutApplication) {
+  EXPECT_FALSE(mQuery->needsApplication());
+}
+
+TEST_F(CommandlineCommandQueryFix, databaseIsMissing) {
+  std::vector<std::string> args = {"--query", "callers main"};
+
+  CollectOutStream eStream(std::cerr);
+  auto ret = mQuery->parse(args);
+  eStream.close();
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_FAILURE, ret);
+  EXPECT_TRUE(mParser->getQueryDatabaseFilePath().empty());
+}
+
+TEST_F(CommandlineCommandQueryFix, databaseHasWrongFileEnding) {
+  auto handler = FileHandler::createEmptyFile("/tmp/invalid.srctrlprj");
+  std::vector<std::string> args = {"/tmp/invalid.srctrlprj"};
+
+  CollectOutStream eStream(std::cerr);
+  auto ret = mQuery->parse(args);
+  eStream.close();
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_FAILURE, ret);
+  EXPECT_TRUE(mParser->getQueryDatabaseFilePath().empty());
+}
+
+TEST_F(CommandlineCommandQueryFix, queryArgs) {
+  auto handler = FileHandler::createEmptyFile("/tmp/project.srctrldb");
+  std::vector<std::string> args = {"/tmp/project.srctrldb", "-q", "callers main", "--query", "includes main.cpp"};
+
+  auto ret = mQuery->parse(args);
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_OK, ret);
+  EXPECT_EQ(L"/tmp/project.srctrldb", mParser->getQueryDatabaseFilePath().wstr());
+  EXPECT_THAT(mParser->getQueries(), ElementsAre("callers main", "includes main.cpp"));
+}
+
+TEST_F(CommandlineCommandQueryFix, queriesFromStdin) {
+  auto handler = FileHandler::createEmptyFile("/tmp/project.srctrldb");
+  std::vector<std::string> args = {"/tmp/project.srctrldb"};
+
+  auto ret = mQuery->parse(args);
+
+  ASSERT_EQ(CommandlineCommand::ReturnStatus::CMD_OK, ret);
+  EXPECT_TRUE(mParser->getQueries().empty());
+}
@@ -0,0 +1,163 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "FileChangeJournal.h"
+
+namespace {
+namespace fs = std::filesystem;
+
+struct FileChangeJournalFix : testing::Test {
+  void SetUp() override {
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+    fs::create_directories(mRoot / "src", errorCode);
+    writeFile(mRoot / "src" / "main.cpp");
+    writeFile(mRoot / "src" / "util.h");
+  }
+
+  void TearDown() override {
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+  }
+
+  static void writeFile(const fs::path& filePath) {
+    std::ofstream file(filePath, std::ios::app);
+    file << "int i;\n";
+  }
+
+  static FilePath toFilePath(const fs::path& path) {
+    return FilePath(path.wstring());
+  }
+
+  // synchronizes the journal with the current files like a refresh after a full scan
+  static FileChangeJournal::Changes synchronize(FileChangeJournal& journal) {
+    const FileChangeJournal::Changes changes = journal.getChanges();
+    journal.markSynchronized(changes.checkpoint);
+    return journal.getChanges();
+  }
+
+  const fs::path mRoot = fs::temp_directory_path() / "FileChangeJournalTestSuite";
+};
+}    // namespace
+
+TEST_F(FileChangeJournalFix, journalIsIncompleteUntilSynchronized) {
+  FileChangeJournal journal({toFilePath(mRoot)});
+
+  EXPECT_FALSE(journal.getChanges().complete);
+  EXPECT_FALSE(journal.getChanges().isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+}
+
+#ifdef __linux__
+TEST_F(FileChangeJournalFix, synchronizedJournalVouchesForUnchangedFiles) {
+  FileChangeJournal journal({toFilePath(mRoot)});
+
+  const FileChangeJournal::Changes changes = synchronize(journal);
+
+  EXPECT_TRUE(changes.complete);
+  EXPECT_TRUE(changes.changedPaths.empty());
+  EXPECT_TRUE(changes.isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+}
+
+TEST_F(FileChangeJournalFix, recordsCreatedModifiedDeletedAndRenamedFiles) {
+  FileChangeJournal journal({toFilePath(mRoot)});
+  synchronize(journal);
+
+  writeFile(mRoot / "src" / "main.cpp");
+  writeFile(mRoot / "src" / "added.cpp");
+  fs::remove(mRoot / "src" / "util.h");
+  fs::rename(mRoot / "src" / "added.cpp", mRoot / "src" / "renamed.cpp");
+
+  const FileChangeJournal::Changes changes = journal.getChanges();
+
+  EXPECT_TRUE(changes.complete);
+  for(const char* name : {"main.cpp", "added.cpp", "util.h", "renamed.cpp"}) {
+    EXPECT_TRUE(changes.changedPaths.contains((mRoot / "src" / name).wstring())) << name;
+    EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "src" / name))) << name;
+  }
+}
+
+TEST_F(FileChangeJournalFix, filesBelowCreatedOrRenamedDirectoriesAreChanged) {
+  FileChangeJournal journal({toFilePath(mRoot)});
+  synchronize(journal);
+
+  fs::create_directories(mRoot / "lib" / "detail");
+  writeFile(mRoot / "lib" / "detail" / "impl.cpp");
+  fs::rename(mRoot / "src", mRoot / "source");
+
+  FileChangeJournal::Changes changes = journal.getChanges();
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "lib" / "detail" / "impl.cpp")));
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "source" / "main.cpp")));
+
+  // the new directory is watched as well
+  journal.markSynchronized(changes.checkpoint);
+  writeFile(mRoot / "lib" / "detail" / "impl.cpp");
+
+  changes = journal.getChanges();
+  EXPECT_TRUE(changes.complete);
+  EXPECT_EQ(1U, changes.changedPaths.size());
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "lib" / "detail" / "impl.cpp")));
+}
+
+TEST_F(FileChangeJournalFix, synchronizationKeepsChangesAfterCheckpoint) {
+  FileChangeJournal journal({toFilePath(mRoot)});
+  synchronize(journal);
+
+  writeFile(mRoot / "src" / "main.cpp");
+  const FileChangeJournal::Changes plannedChanges = journal.getChanges();
+  writeFile(mRoot / "src" / "util.h");
+  std::ignore = journal.getChanges();
+  journal.markSynchronized(plannedChanges.checkpoint);
+
+  const FileChangeJournal::Changes changes = journal.getChanges();
+
+  EXPECT_TRUE(changes.isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "src" / "util.h")));
+}
+
+TEST_F(FileChangeJournalFix, filesOutsideRootsAreNotVouchedFor) {
+  FileChangeJournal journal({toFilePath(mRoot / "src")});
+
+  const FileChangeJournal::Changes changes = synchronize(journal);
+
+  EXPECT_TRUE(changes.isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "main.cpp")));
+  EXPECT_FALSE(changes.isUnchanged(toFilePath(mRoot / "src2" / "main.cpp")));
+}
+
+TEST_F(FileChangeJournalFix, removedRootMakesJournalIncomplete) {
+  FileChangeJournal journal({toFilePath(mRoot / "src")});
+  synchronize(journal);
+
+  fs::remove_all(mRoot / "src");
+
+  EXPECT_FALSE(synchronize(journal).complete);
+  EXPECT_FALSE(journal.isWatching());
+}
+
+TEST_F(FileChangeJournalFix, replacedJournalWatchesRestoredRootAgain) {
+  auto journal = std::make_unique<FileChangeJournal>(std::vector<FilePath>{toFilePath(mRoot / "src")});
+  synchronize(*journal);
+  fs::remove_all(mRoot / "src");
+  ASSERT_FALSE(synchronize(*journal).complete);
+
+  fs::create_directories(mRoot / "src");
+  writeFile(mRoot / "src" / "main.cpp");
+  journal = std::make_unique<FileChangeJournal>(std::vector<FilePath>{toFilePath(mRoot / "src")});
+
+  EXPECT_TRUE(journal->isWatching());
+  EXPECT_TRUE(synchronize(*journal).complete);
+
+  writeFile(mRoot / "src" / "main.cpp");
+  EXPECT_FALSE(journal->getChanges().isUnchanged(toFilePath(mRoot / "src" / "main.cpp")));
+}
+
+TEST_F(FileChangeJournalFix, missingRootMakesJournalIncomplete) {
+  FileChangeJournal journal({toFilePath(mRoot / "missing")});
+
+  EXPECT_FALSE(synchronize(journal).complete);
+}
+#endif
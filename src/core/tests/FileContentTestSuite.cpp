@@ -0,0 +1,42 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "FileContent.h"
+
+TEST(FileContent, hashIsStable) {
+  EXPECT_EQ(utility::hashFileContent("int main() {}\n"), utility::hashFileContent(std::string("int main() {}\n")));
+}
+
+TEST(FileContent, hashDiffersForDifferentContent) {
+  EXPECT_NE(utility::hashFileContent("int main() {}\n"), utility::hashFileContent("int main() { }\n"));
+}
+
+TEST(FileContent, hashToStringHasFixedSize) {
+  EXPECT_EQ("0000000000000001", utility::fileContentHashToString(1));
+  EXPECT_EQ(16, utility::fileContentHashToString(utility::hashFileContent("")).size());
+}
+
+TEST(FileContent, compressRoundTrip) {
+  std::string content;
+  for(int i = 0; i < 1000; ++i) {
+    content += "void function" + std::to_string(i) + "();\n";
+  }
+
+  const std::string compressed = utility::compressFileContent(content);
+  EXPECT_LT(compressed.size(), content.size());
+
+  const auto result = utility::decompressFileContent(compressed);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(content, *result);
+}
+
+TEST(FileContent, compressEmptyContent) {
+  const auto result = utility::decompressFileContent(utility::compressFileContent(""));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(result->empty());
+}
+
+TEST(FileContent, decompressInvalidData) {
+  EXPECT_FALSE(utility::decompressFileContent("not compressed").has_value());
+}
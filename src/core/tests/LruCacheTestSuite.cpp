@@ -0,0 +1,81 @@
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "LruCache.h"
+
+using namespace ::testing;
+
+TEST(LruCache, missOnEmptyCache) {
+  LruCache<int, std::string> cache(100);
+
+  EXPECT_FALSE(cache.getValue(0).has_value());
+  EXPECT_EQ(0, cache.getHitCount());
+  EXPECT_EQ(1, cache.getMissCount());
+}
+
+TEST(LruCache, hitAfterSetValue) {
+  LruCache<int, std::string> cache(100);
+  cache.setValue(0, "zero", 4);
+
+  const auto result = cache.getValue(0);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ("zero", *result);
+  EXPECT_EQ(1, cache.getHitCount());
+  EXPECT_EQ(4, cache.getByteSize());
+}
+
+TEST(LruCache, evictsLeastRecentlyUsedEntry) {
+  LruCache<int, std::string> cache(10);
+  cache.setValue(0, "zero", 4);
+  cache.setValue(1, "one", 4);
+  std::ignore = cache.getValue(0);
+
+  cache.setValue(2, "two", 4);
+
+  EXPECT_TRUE(cache.contains(0));
+  EXPECT_FALSE(cache.contains(1));
+  EXPECT_TRUE(cache.contains(2));
+  EXPECT_EQ(8, cache.getByteSize());
+}
+
+TEST(LruCache, replacingEntryUpdatesByteSize) {
+  LruCache<int, std::string> cache(10);
+  cache.setValue(0, "zero", 4);
+  cache.setValue(0, "null", 6);
+
+  EXPECT_EQ("null", cache.getValue(0).value());
+  EXPECT_EQ(6, cache.getByteSize());
+}
+
+TEST(LruCache, entryLargerThanBudgetIsNotStored) {
+  LruCache<int, std::string> cache(10);
+  cache.setValue(0, "zero", 4);
+  cache.setValue(1, "huge", 11);
+
+  EXPECT_TRUE(cache.contains(0));
+  EXPECT_FALSE(cache.contains(1));
+}
+
+TEST(LruCache, clearRemovesAllEntries) {
+  LruCache<int, std::string> cache(10);
+  cache.setValue(0, "zero", 4);
+  cache.clear();
+
+  EXPECT_FALSE(cache.contains(0));
+  EXPECT_EQ(0, cache.getByteSize());
+}
+
+TEST(LruCache, takeValueRemovesEntry) {
+  LruCache<int, std::unique_ptr<std::string>> cache(10);
+  cache.setValue(0, std::make_unique<std::string>("zero"), 4);
+
+  auto result = cache.takeValue(0);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ("zero", **result);
+  EXPECT_FALSE(cache.contains(0));
+  EXPECT_EQ(0, cache.getByteSize());
+  EXPECT_FALSE(cache.takeValue(0).has_value());
+}
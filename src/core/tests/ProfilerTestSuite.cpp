@@ -0,0 +1,131 @@
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "Profiler.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+struct ProfilerFix : testing::Test {
+  void TearDown() override {
+    Profiler::finish();
+    fs::remove(mTracePath);
+  }
+
+  [[nodiscard]] std::string readTrace() const {
+    std::ifstream file(mTracePath);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+  }
+
+  fs::path mTracePath = fs::temp_directory_path() / "sourcetrail_profiler_test.json";
+};
+}    // namespace
+
+TEST_F(ProfilerFix, nothingIsRecordedWhenNotStarted) {
+  EXPECT_FALSE(Profiler::isEnabled());
+
+  {
+    Profiler::Span span("indexer", "index");
+    EXPECT_FALSE(span.isRecording());
+  }
+  Profiler::addCounter("queue", 1);
+
+  EXPECT_TRUE(Profiler::finish());
+  EXPECT_FALSE(fs::exists(mTracePath));
+}
+
+TEST_F(ProfilerFix, spansAndCountersAreWrittenAsTraceEvents) {
+  Profiler::start(mTracePath.string());
+  Profiler::setThreadName("main");
+  {
+    Profiler::Span span("storage", "inject");
+    span.setDetail("C:\\project\\main.cpp");
+    span.setArgument("symbols", 42);
+  }
+  Profiler::addCounter("queued storages", 3);
+
+  ASSERT_TRUE(Profiler::finish());
+  EXPECT_FALSE(Profiler::isEnabled());
+
+  const std::string trace = readTrace();
+  EXPECT_EQ(0, trace.find("{\"traceEvents\":["));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"inject\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, trace.find("\"cat\":\"storage\""));
+  EXPECT_NE(std::string::npos, trace.find("\"detail\":\"C:\\\\project\\\\main.cpp\",\"symbols\":42"));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"queued storages\",\"ph\":\"C\""));
+  EXPECT_NE(std::string::npos, trace.find("\"args\":{\"value\":3}"));
+  EXPECT_NE(std::string::npos, trace.find("\"args\":{\"name\":\"main\"}"));
+}
+
+TEST_F(ProfilerFix, eventsOfIndexerProcessesAreMerged) {
+  Profiler::start(mTracePath.string());
+  const std::string session = std::getenv(Profiler::SessionVariable);
+  { Profiler::Span span("storage", "merge"); }
+
+  // an indexer process of this session writes the fragment that belongs to its process id
+  std::ofstream(mTracePath.string() + "." + session + ".2.part")
+      << "{\"name\":\"index\",\"ph\":\"X\",\"ts\":1,\"pid\":2,\"tid\":1,\"dur\":1,\"cat\":\"indexer\"}\n";
+  ASSERT_TRUE(Profiler::finish());
+
+  const std::string trace = readTrace();
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"merge\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, trace.find("\"name\":\"index\",\"ph\":\"X\""));
+  EXPECT_FALSE(fs::exists(mTracePath.string() + "." + session + ".2.part"));
+  EXPECT_EQ(nullptr, std::getenv(Profiler::OutputPathVariable));
+  EXPECT_EQ(nullptr, std::getenv(Profiler::SessionVariable));
+}
+
+TEST_F(ProfilerFix, indexerProcessesWriteFragmentsOfTheirSession) {
+  // the indexer process records with the path and session the main process passed on through the environment
+#ifdef _WIN32
+  _putenv_s(Profiler::OutputPathVariable, mTracePath.string().c_str());
+  _putenv_s(Profiler::SessionVariable, "7");
+#else
+  setenv(Profiler::OutputPathVariable, mTracePath.string().c_str(), 1);
+  setenv(Profiler::SessionVariable, "7", 1);
+#endif
+  Profiler::startFromEnvironment(2);
+  { Profiler::Span span("indexer", "index"); }
+  ASSERT_TRUE(Profiler::finish());
+  EXPECT_FALSE(fs::exists(mTracePath));
+
+  std::ifstream fragment(mTracePath.string() + ".7.2.part");
+  std::stringstream content;
+  content << fragment.rdbuf();
+  EXPECT_NE(std::string::npos, content.str().find("\"name\":\"index\",\"ph\":\"X\""));
+  EXPECT_NE(std::string::npos, content.str().find("\"args\":{\"name\":\"indexer 2\"}"));
+  fragment.close();
+
+#ifdef _WIN32
+  _putenv_s(Profiler::OutputPathVariable, "");
+  _putenv_s(Profiler::SessionVariable, "");
+#else
+  unsetenv(Profiler::OutputPathVariable);
+  unsetenv(Profiler::SessionVariable);
+#endif
+  fs::remove(mTracePath.string() + ".7.2.part");
+}
+
+TEST_F(ProfilerFix, staleFragmentsAreNotMerged) {
+  // left behind by a crashed run
+  std::ofstream(mTracePath.string() + ".1.2.part") << "{\"name\":\"stale\",\"ph\":\"X\",\"ts\":1,\"pid\":2}\n";
+
+  Profiler::start(mTracePath.string());
+  EXPECT_FALSE(fs::exists(mTracePath.string() + ".1.2.part"));
+
+  // flushed late by an indexer process of an earlier session
+  std::ofstream(mTracePath.string() + ".2.2.part") << "{\"name\":\"late\",\"ph\":\"X\",\"ts\":1,\"pid\":2}\n";
+  ASSERT_TRUE(Profiler::finish());
+
+  const std::string trace = readTrace();
+  EXPECT_EQ(std::string::npos, trace.find("\"name\":\"stale\""));
+  EXPECT_EQ(std::string::npos, trace.find("\"name\":\"late\""));
+  EXPECT_FALSE(fs::exists(mTracePath.string() + ".2.2.part"));
+}
@@ -5,6 +5,7 @@
 
 #include "CommandlineCommandConfig.h"
 #include "CommandlineCommandIndex.h"
+#include "CommandlineCommandQuery.h"
 #include "ConfigManager.hpp"
 #include "TextAccess.h"
 
@@ -27,6 +28,7 @@ CommandLineParser::CommandLineParser(std::string version) : m_version(std::move(
   // NOTE: Should be moved
   m_commands.push_back(std::make_unique<commandline::CommandlineCommandConfig>(this));
   m_commands.push_back(std::make_unique<commandline::CommandlineCommandIndex>(this));
+  m_commands.push_back(std::make_unique<commandline::CommandlineCommandQuery>(this));
 
   for(auto& command : m_commands) {
     command->setup();
@@ -46,6 +48,7 @@ void CommandLineParser::preparse(std::vector<std::string> args) {
     for(const auto& command : m_commands) {
       if(m_args[0] == command->name()) {
         m_withoutGUI = true;
+        m_withoutApplication = !command->needsApplication();
         return;
       }
     }
@@ -97,6 +100,7 @@ void CommandLineParser::parse() {
 
         if(status != CommandlineCommand::ReturnStatus::CMD_OK) {
           m_quit = true;
+          m_commandFailed = (status == CommandlineCommand::ReturnStatus::CMD_FAILURE);
         }
       }
     }
@@ -138,10 +142,18 @@ bool CommandLineParser::runWithoutGUI() const {
   return m_withoutGUI;
 }
 
+bool CommandLineParser::runWithoutApplication() const {
+  return m_withoutApplication;
+}
+
 bool CommandLineParser::exitApplication() const {
   return m_quit;
 }
 
+bool CommandLineParser::commandFailed() const {
+  return m_commandFailed;
+}
+
 bool CommandLineParser::hasError() const {
   return !m_errorString.empty();
 }
@@ -187,6 +199,18 @@ void CommandLineParser::setShallowIndexingRequested(bool enabled) {
   m_shallowIndexingRequested = enabled;
 }
 
+void CommandLineParser::setProfileFilePath(const FilePath& filePath) {
+  m_profileFile = filePath;
+}
+
+void CommandLineParser::setQueryDatabaseFilePath(const FilePath& filePath) {
+  m_queryDatabaseFile = filePath;
+}
+
+void CommandLineParser::setQueries(std::vector<std::string> queries) {
+  m_queries = std::move(queries);
+}
+
 const FilePath& CommandLineParser::getProjectFilePath() const {
   return m_projectFile;
 }
@@ -199,4 +223,16 @@ bool CommandLineParser::getShallowIndexingRequested() const {
   return m_shallowIndexingRequested;
 }
 
+const FilePath& CommandLineParser::getProfileFilePath() const {
+  return m_profileFile;
+}
+
+const FilePath& CommandLineParser::getQueryDatabaseFilePath() const {
+  return m_queryDatabaseFile;
+}
+
+const std::vector<std::string>& CommandLineParser::getQueries() const {
+  return m_queries;
+}
+
 }    // namespace commandline
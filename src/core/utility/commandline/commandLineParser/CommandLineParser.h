@@ -29,8 +29,18 @@ public:
 
   [[nodiscard]] bool runWithoutGUI() const;
 
+  /**
+   * @brief True for commands that only read an existing index and don't need the Application.
+   */
+  [[nodiscard]] bool runWithoutApplication() const;
+
   [[nodiscard]] bool exitApplication() const;
 
+  /**
+   * @brief True if a command got invalid arguments, exitApplication() is true then as well.
+   */
+  [[nodiscard]] bool commandFailed() const;
+
   [[nodiscard]] bool hasError() const;
 
   std::wstring getError();
@@ -41,6 +51,12 @@ public:
 
   void setShallowIndexingRequested(bool enabled = true);
 
+  void setProfileFilePath(const FilePath& filePath);
+
+  void setQueryDatabaseFilePath(const FilePath& filePath);
+
+  void setQueries(std::vector<std::string> queries);
+
   [[nodiscard]] const FilePath& getProjectFilePath() const;
 
   void setProjectFile(const FilePath& filepath);
@@ -49,6 +65,18 @@ public:
 
   [[nodiscard]] bool getShallowIndexingRequested() const;
 
+  /**
+   * @brief File for the trace of the indexing phases, empty if indexing is not profiled.
+   */
+  [[nodiscard]] const FilePath& getProfileFilePath() const;
+
+  [[nodiscard]] const FilePath& getQueryDatabaseFilePath() const;
+
+  /**
+   * @brief Queries given on the command line, empty if they are read from stdin.
+   */
+  [[nodiscard]] const std::vector<std::string>& getQueries() const;
+
 private:
   void processProjectfile();
 
@@ -64,9 +92,14 @@ private:
   FilePath m_projectFile;
   RefreshMode m_refreshMode = RefreshMode::UpdatedFiles;
   bool m_shallowIndexingRequested = false;
+  FilePath m_profileFile;
+  FilePath m_queryDatabaseFile;
+  std::vector<std::string> m_queries;
 
   bool m_quit = false;
+  bool m_commandFailed = false;
   bool m_withoutGUI = false;
+  bool m_withoutApplication = false;
 
   std::wstring m_errorString;
 };
@@ -35,6 +35,13 @@ public:
 
   [[nodiscard]] virtual bool hasHelp() const = 0;
 
+  /**
+   * @brief False for commands that run without creating the Application, like the queries on an existing index.
+   */
+  [[nodiscard]] virtual bool needsApplication() const {
+    return true;
+  }
+
   virtual void printHelp();
 
 protected:
@@ -22,6 +22,7 @@ void CommandlineCommandIndex::setup() {
     ("incomplete,i", "Also reindex incomplete files (files with errors)")
     ("full,f", "Index full project (omit to only index new/changed files)")
     ("shallow,s", "Build a shallow index is supported by the project")
+    ("profile", po::value<std::string>(), "Write a Chrome trace of the indexing phases to this file")
     ("project-file", po::value<std::string>(), "Project file to index (.srctrlprj)");
   // clang-format on
   m_options.add(options);
@@ -56,6 +57,10 @@ CommandlineCommand::ReturnStatus CommandlineCommandIndex::parse(std::vector<std:
     m_parser->setShallowIndexingRequested();
   }
 
+  if(variablesMap.count("profile") != 0U) {
+    m_parser->setProfileFilePath(FilePath(variablesMap["profile"].as<std::string>()));
+  }
+
   if(variablesMap.count("project-file") != 0U) {
     m_parser->setProjectFile(FilePath(variablesMap["project-file"].as<std::string>()));
   }
@@ -0,0 +1,65 @@
+#include "CommandlineCommandQuery.h"
+
+#include <iostream>
+
+#include "CommandLineParser.h"
+
+namespace po = boost::program_options;
+
+namespace commandline {
+
+CommandlineCommandQuery::CommandlineCommandQuery(CommandLineParser* parser)
+    : CommandlineCommand("query", "Answer queries on an indexed project as JSON lines.", parser) {}
+
+CommandlineCommandQuery::~CommandlineCommandQuery() = default;
+
+void CommandlineCommandQuery::setup() {
+  po::options_description options("Query Options");
+  // clang-format off
+  options.add_options()
+    ("help,h", "Print this help message")
+    ("query,q", po::value<std::vector<std::string>>(),
+     "Query to answer: search, references, callers or callees followed by a symbol name, or includes followed by a file "
+     "path. Reads one query per line from stdin if omitted")
+    ("database-file", po::value<std::string>(), "Index database to query (.srctrldb)");
+  // clang-format on
+  m_options.add(options);
+  m_positional.add("database-file", 1);
+}
+
+CommandlineCommand::ReturnStatus CommandlineCommandQuery::parse(std::vector<std::string>& args) {
+  po::variables_map variablesMap;
+  try {
+    po::store(po::command_line_parser(args).options(m_options).positional(m_positional).run(), variablesMap);
+    po::notify(variablesMap);
+  } catch(po::error& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+    std::cerr << m_options << std::endl;
+    return ReturnStatus::CMD_FAILURE;
+  }
+
+  if((variablesMap.count("help") != 0U) || args.empty() || args[0] == "help") {
+    printHelp();
+    return ReturnStatus::CMD_QUIT;
+  }
+
+  if(variablesMap.count("database-file") == 0U) {
+    std::cerr << "ERROR: No database file (.srctrldb) given" << std::endl;
+    return ReturnStatus::CMD_FAILURE;
+  }
+
+  const FilePath databaseFile = FilePath(variablesMap["database-file"].as<std::string>()).makeAbsolute();
+  if(databaseFile.extension() != L".srctrldb" || !databaseFile.exists()) {
+    std::cerr << "ERROR: Database file " << databaseFile.str() << " does not exist or is no .srctrldb file" << std::endl;
+    return ReturnStatus::CMD_FAILURE;
+  }
+  m_parser->setQueryDatabaseFilePath(databaseFile);
+
+  if(variablesMap.count("query") != 0U) {
+    m_parser->setQueries(variablesMap["query"].as<std::vector<std::string>>());
+  }
+
+  return ReturnStatus::CMD_OK;
+}
+
+}    // namespace commandline
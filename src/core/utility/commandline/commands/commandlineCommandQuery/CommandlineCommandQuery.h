@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CommandlineCommand.h"
+
+namespace commandline {
+
+class CommandlineCommandQuery : public CommandlineCommand {
+public:
+  explicit CommandlineCommandQuery(CommandLineParser* parser);
+
+  CommandlineCommandQuery(const CommandlineCommandQuery&) = delete;
+  CommandlineCommandQuery& operator=(const CommandlineCommandQuery&) = delete;
+  CommandlineCommandQuery(CommandlineCommandQuery&&) = delete;
+  CommandlineCommandQuery& operator=(CommandlineCommandQuery&&) = delete;
+
+  ~CommandlineCommandQuery() override;
+
+  void setup() override;
+
+  ReturnStatus parse(std::vector<std::string>& args) override;
+
+  [[nodiscard]] bool hasHelp() const override {
+    return true;
+  }
+
+  [[nodiscard]] bool needsApplication() const override {
+    return false;
+  }
+};
+
+}    // namespace commandline
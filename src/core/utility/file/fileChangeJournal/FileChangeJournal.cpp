@@ -0,0 +1,227 @@
+#include "FileChangeJournal.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+
+#ifdef __linux__
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+#include "logging.h"
+#include "utilityString.h"
+
+namespace {
+#ifdef __linux__
+constexpr uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+// attribute changes of a directory do not change the files inside
+constexpr uint32_t DirectoryChangeMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+#endif
+}    // namespace
+
+bool FileChangeJournal::Changes::isUnchanged(const FilePath& filePath) const {
+  if(!complete) {
+    return false;
+  }
+
+  const std::wstring path = filePath.wstr();
+  for(const FilePath& rootDirectory : rootDirectories) {
+    const std::wstring root = rootDirectory.wstr();
+    if(path.size() <= root.size() || !path.starts_with(root) || path[root.size()] != L'/') {
+      continue;
+    }
+
+    // check the file itself and each of its directories below the root
+    for(size_t end = path.size(); end > root.size(); end = path.rfind(L'/', end - 1)) {
+      if(changedPaths.contains(std::wstring_view(path).substr(0, end))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+FileChangeJournal::FileChangeJournal(std::vector<FilePath> rootDirectories) {
+  for(const FilePath& rootDirectory : rootDirectories) {
+    std::wstring root = rootDirectory.wstr();
+    while(root.size() > 1 && root.back() == L'/') {
+      root.pop_back();
+    }
+    m_rootDirectories.emplace_back(root);
+  }
+
+#ifdef __linux__
+  m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if(m_inotifyFd < 0) {
+    LOG_WARNING(fmt::format("Cannot watch the project for file changes: {}", std::strerror(errno)));
+    loseEvents();
+    return;
+  }
+
+  m_watching = true;
+  for(const FilePath& rootDirectory : m_rootDirectories) {
+    watchDirectoryTree(rootDirectory.wstr());
+  }
+#else
+  loseEvents();
+#endif
+}
+
+FileChangeJournal::~FileChangeJournal() {
+#ifdef __linux__
+  if(m_inotifyFd >= 0) {
+    close(m_inotifyFd);
+  }
+#endif
+}
+
+const std::vector<FilePath>& FileChangeJournal::getRootDirectories() const {
+  return m_rootDirectories;
+}
+
+bool FileChangeJournal::isWatching() const {
+  return m_watching;
+}
+
+FileChangeJournal::Changes FileChangeJournal::getChanges() {
+  readEvents();
+
+  Changes changes;
+  changes.rootDirectories = m_rootDirectories;
+  for(const auto& [path, sequence] : m_changedPaths) {
+    changes.changedPaths.insert(changes.changedPaths.end(), path);
+  }
+  changes.checkpoint = m_sequence;
+  changes.complete = isComplete();
+  return changes;
+}
+
+void FileChangeJournal::markSynchronized(uint64_t checkpoint) {
+  std::erase_if(m_changedPaths, [checkpoint](const auto& entry) { return entry.second <= checkpoint; });
+  m_synchronizedCheckpoint = std::max(m_synchronizedCheckpoint.value_or(0), checkpoint);
+}
+
+void FileChangeJournal::readEvents() {
+#ifdef __linux__
+  if(m_inotifyFd < 0) {
+    return;
+  }
+
+  alignas(inotify_event) char buffer[64 * 1024];
+  while(true) {
+    const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+    if(length < 0 && errno == EINTR) {
+      continue;
+    }
+    if(length <= 0) {
+      return;
+    }
+
+    for(ssize_t offset = 0; offset < length;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+      if((event->mask & IN_Q_OVERFLOW) != 0) {
+        LOG_WARNING("File change events were lost, the next refresh scans all files.");
+        loseEvents();
+        continue;
+      }
+
+      const auto watchedDirectory = m_watchedDirectories.find(event->wd);
+      if(watchedDirectory == m_watchedDirectories.end()) {
+        continue;
+      }
+
+      if((event->mask & IN_IGNORED) != 0) {
+        m_watchedDirectories.erase(watchedDirectory);
+        continue;
+      }
+
+      if((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0) {
+        // removed subdirectories are recorded by the event of their parent
+        if(isRootDirectory(watchedDirectory->second)) {
+          LOG_WARNING(fmt::format(L"Stopped watching the removed directory \"{}\".", watchedDirectory->second));
+          m_watching = false;
+          loseEvents();
+        }
+        continue;
+      }
+
+      if(event->len == 0) {
+        continue;
+      }
+
+      const std::wstring path = watchedDirectory->second + L'/' + utility::decodeFromUtf8(event->name);
+      if((event->mask & IN_ISDIR) == 0) {
+        recordChange(path);
+      } else if((event->mask & DirectoryChangeMask) != 0) {
+        recordChange(path);
+        if((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0) {
+          watchDirectoryTree(path);
+        }
+      }
+    }
+  }
+#endif
+}
+
+void FileChangeJournal::watchDirectoryTree(const std::wstring& directory) {
+  watchDirectory(directory);
+
+  std::error_code errorCode;
+  auto iterator = std::filesystem::recursive_directory_iterator(
+      directory, std::filesystem::directory_options::skip_permission_denied, errorCode);
+  for(; m_watching && !errorCode && iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(errorCode)) {
+    // symlinked directories are not watched, paths through them are not below the roots after canonicalization
+    if(!iterator->is_symlink(errorCode) && iterator->is_directory(errorCode)) {
+      watchDirectory(iterator->path().wstring());
+    }
+  }
+}
+
+void FileChangeJournal::watchDirectory(const std::wstring& directory) {
+#ifdef __linux__
+  if(!m_watching) {
+    return;
+  }
+
+  const int watch = inotify_add_watch(m_inotifyFd, utility::encodeToUtf8(directory).c_str(), WatchMask);
+  if(watch >= 0) {
+    m_watchedDirectories[watch] = directory;
+    return;
+  }
+
+  // a subdirectory removed right after its creation was recorded as changed already
+  if((errno == ENOENT || errno == ENOTDIR) && !isRootDirectory(directory)) {
+    return;
+  }
+
+  LOG_WARNING(fmt::format(L"Cannot watch \"{}\" for file changes: {}",
+                          directory,
+                          utility::decodeFromUtf8(std::strerror(errno))));
+  m_watching = false;
+  loseEvents();
+#endif
+}
+
+void FileChangeJournal::recordChange(const std::wstring& path) {
+  m_changedPaths[path] = ++m_sequence;
+}
+
+void FileChangeJournal::loseEvents() {
+  m_lostSequence = ++m_sequence;
+}
+
+bool FileChangeJournal::isRootDirectory(const std::wstring& directory) const {
+  return std::ranges::any_of(m_rootDirectories, [&directory](const FilePath& root) { return root.wstr() == directory; });
+}
+
+bool FileChangeJournal::isComplete() const {
+  return m_watching && m_synchronizedCheckpoint && *m_synchronizedCheckpoint >= m_lostSequence;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "FilePath.h"
+
+/**
+ * @brief Records the files created, modified, deleted or renamed below a set of root directories.
+ *
+ * On Linux the journal is backed by inotify. Events wait in the kernel queue until the changes are requested, so no
+ * thread is needed. On other platforms the journal is never complete and callers keep scanning all files.
+ *
+ * The journal can only vouch for a file once the caller marked it synchronized with the state it derived from the
+ * files. It becomes incomplete again when events were lost: the kernel queue overflowed, a directory could not be
+ * watched or a root directory was removed. The next synchronization after a full scan makes it complete again, unless
+ * the journal stopped watching. Such a journal is replaced by a new one that watches the directories again.
+ */
+class FileChangeJournal final {
+public:
+  struct Changes final {
+    std::vector<FilePath> rootDirectories;
+    std::set<std::wstring, std::less<>> changedPaths;    ///< changed files and directories, see isUnchanged
+    uint64_t checkpoint = 0;                              ///< pass to markSynchronized once the changes are handled
+    bool complete = false;                                ///< false if a full scan is needed
+
+    /**
+     * @brief True if the journal vouches that the file did not change since the last synchronization.
+     *
+     * A file counts as changed if it or one of its directories below the root was changed, so a renamed or newly
+     * created directory covers all files inside.
+     */
+    [[nodiscard]] bool isUnchanged(const FilePath& filePath) const;
+  };
+
+  explicit FileChangeJournal(std::vector<FilePath> rootDirectories);
+  ~FileChangeJournal();
+
+  FileChangeJournal(const FileChangeJournal&) = delete;
+  FileChangeJournal(FileChangeJournal&&) = delete;
+  FileChangeJournal& operator=(const FileChangeJournal&) = delete;
+  FileChangeJournal& operator=(FileChangeJournal&&) = delete;
+
+  [[nodiscard]] const std::vector<FilePath>& getRootDirectories() const;
+
+  /**
+   * @brief False once the directories are no longer watched, the journal then never becomes complete again.
+   */
+  [[nodiscard]] bool isWatching() const;
+
+  /**
+   * @brief Reads the pending events and returns all changes since the last synchronization.
+   */
+  [[nodiscard]] Changes getChanges();
+
+  /**
+   * @brief Forgets the changes up to the checkpoint, the caller's state reflects the files as of that point.
+   */
+  void markSynchronized(uint64_t checkpoint);
+
+private:
+  void readEvents();
+  void watchDirectoryTree(const std::wstring& directory);
+  void watchDirectory(const std::wstring& directory);
+  void recordChange(const std::wstring& path);
+  void loseEvents();
+
+  [[nodiscard]] bool isRootDirectory(const std::wstring& directory) const;
+  [[nodiscard]] bool isComplete() const;
+
+  std::vector<FilePath> m_rootDirectories;
+  int m_inotifyFd = -1;
+  bool m_watching = false;
+  std::unordered_map<int, std::wstring> m_watchedDirectories;
+
+  std::map<std::wstring, uint64_t, std::less<>> m_changedPaths;    ///< path to sequence number of its last change
+  uint64_t m_sequence = 0;
+  uint64_t m_lostSequence = 0;
+  std::optional<uint64_t> m_synchronizedCheckpoint;
+};
@@ -0,0 +1,51 @@
+#include "FileContent.h"
+
+#include <fmt/format.h>
+#include <xxhash.h>
+#include <zstd.h>
+
+namespace {
+// favors speed, indexing stores the content of every indexed file
+constexpr int CompressionLevel = 3;
+}    // namespace
+
+namespace utility {
+
+uint64_t hashFileContent(std::string_view content) {
+  return XXH64(content.data(), content.size(), 0);
+}
+
+std::string fileContentHashToString(uint64_t hash) {
+  return fmt::format("{:016x}", hash);
+}
+
+std::string compressFileContent(std::string_view content) {
+  std::string compressed(ZSTD_compressBound(content.size()), '\0');
+
+  const size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(), content.data(), content.size(), CompressionLevel);
+  if(ZSTD_isError(compressedSize) != 0U) {
+    return {};
+  }
+
+  compressed.resize(compressedSize);
+  return compressed;
+}
+
+std::optional<std::string> decompressFileContent(std::string_view compressed) {
+  const unsigned long long contentSize = ZSTD_getFrameContentSize(compressed.data(), compressed.size());
+  if(contentSize == ZSTD_CONTENTSIZE_ERROR || contentSize == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return std::nullopt;
+  }
+
+  std::string content(static_cast<size_t>(contentSize), '\0');
+
+  const size_t decompressedSize = ZSTD_decompress(content.data(), content.size(), compressed.data(), compressed.size());
+  if(ZSTD_isError(decompressedSize) != 0U) {
+    return std::nullopt;
+  }
+
+  content.resize(decompressedSize);
+  return content;
+}
+
+}    // namespace utility
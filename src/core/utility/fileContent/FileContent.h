@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace utility {
+
+/**
+ * @brief Hash of a file content that is stable across platforms and runs, so it can be stored in the index.
+ */
+uint64_t hashFileContent(std::string_view content);
+
+/**
+ * @brief Formats the hash as fixed size hex string, the form used for storing it.
+ */
+std::string fileContentHashToString(uint64_t hash);
+
+std::string compressFileContent(std::string_view content);
+
+/**
+ * @return The original content or std::nullopt if the data is not a valid compressed file content.
+ */
+std::optional<std::string> decompressFileContent(std::string_view compressed);
+
+}    // namespace utility
@@ -0,0 +1,149 @@
+#pragma once
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @brief Thread-safe least recently used cache that evicts entries once their total size exceeds a byte budget.
+ *
+ * The size of an entry is given when inserting it. An entry that is larger than the whole budget is not stored.
+ */
+template <typename KeyType, typename ValType, typename Hasher = std::hash<KeyType>>
+class LruCache final {
+public:
+  explicit LruCache(size_t byteBudget);
+
+  std::optional<ValType> getValue(const KeyType& key);
+  void setValue(const KeyType& key, ValType value, size_t byteSize);
+  /**
+   * @brief Removes the entry and hands its value to the caller.
+   */
+  std::optional<ValType> takeValue(const KeyType& key);
+
+  bool contains(const KeyType& key) const;
+  void clear();
+
+  [[nodiscard]] size_t getByteSize() const;
+  [[nodiscard]] size_t getHitCount() const;
+  [[nodiscard]] size_t getMissCount() const;
+
+private:
+  struct Entry {
+    KeyType key;
+    ValType value;
+    size_t byteSize;
+  };
+
+  void evict();
+
+  const size_t m_byteBudget;
+  size_t m_byteSize = 0;
+
+  std::list<Entry> m_entries;    // most recently used entries are in front
+  std::unordered_map<KeyType, typename std::list<Entry>::iterator, Hasher> m_index;
+
+  size_t m_hitCount = 0;
+  size_t m_missCount = 0;
+
+  mutable std::mutex m_mutex;
+};
+
+template <typename KeyType, typename ValType, typename Hasher>
+LruCache<KeyType, ValType, Hasher>::LruCache(size_t byteBudget) : m_byteBudget(byteBudget) {}
+
+template <typename KeyType, typename ValType, typename Hasher>
+std::optional<ValType> LruCache<KeyType, ValType, Hasher>::getValue(const KeyType& key) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto iterator = m_index.find(key);
+  if(iterator == m_index.end()) {
+    ++m_missCount;
+    return std::nullopt;
+  }
+
+  ++m_hitCount;
+  m_entries.splice(m_entries.begin(), m_entries, iterator->second);
+  return iterator->second->value;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::setValue(const KeyType& key, ValType value, size_t byteSize) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+
+  if(auto iterator = m_index.find(key); iterator != m_index.end()) {
+    m_byteSize -= iterator->second->byteSize;
+    m_entries.erase(iterator->second);
+    m_index.erase(iterator);
+  }
+
+  if(byteSize > m_byteBudget) {
+    return;
+  }
+
+  m_entries.push_front(Entry{key, std::move(value), byteSize});
+  m_index.emplace(key, m_entries.begin());
+  m_byteSize += byteSize;
+
+  evict();
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+std::optional<ValType> LruCache<KeyType, ValType, Hasher>::takeValue(const KeyType& key) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+
+  auto iterator = m_index.find(key);
+  if(iterator == m_index.end()) {
+    ++m_missCount;
+    return std::nullopt;
+  }
+
+  ++m_hitCount;
+  std::optional<ValType> value = std::move(iterator->second->value);
+  m_byteSize -= iterator->second->byteSize;
+  m_entries.erase(iterator->second);
+  m_index.erase(iterator);
+  return value;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+bool LruCache<KeyType, ValType, Hasher>::contains(const KeyType& key) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_index.find(key) != m_index.end();
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::clear() {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_index.clear();
+  m_byteSize = 0;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t LruCache<KeyType, ValType, Hasher>::getByteSize() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_byteSize;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t LruCache<KeyType, ValType, Hasher>::getHitCount() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_hitCount;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t LruCache<KeyType, ValType, Hasher>::getMissCount() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_missCount;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+void LruCache<KeyType, ValType, Hasher>::evict() {
+  while(m_byteSize > m_byteBudget && !m_entries.empty()) {
+    const Entry& entry = m_entries.back();
+    m_byteSize -= entry.byteSize;
+    m_index.erase(entry.key);
+    m_entries.pop_back();
+  }
+}
@@ -0,0 +1,328 @@
+#include "Profiler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+namespace {
+constexpr std::string_view FragmentExtension = ".part";
+
+struct ProfilerState {
+  std::mutex mutex;
+  std::vector<std::string> events;
+  std::string outputPath;
+  std::string session;
+  uint64_t processId = 0;
+  bool isIndexerProcess = false;
+  std::atomic<uint32_t> nextThreadId = 1;
+};
+
+ProfilerState& state() {
+  static ProfilerState profilerState;
+  return profilerState;
+}
+
+uint32_t currentThreadId() {
+  thread_local const uint32_t threadId = state().nextThreadId++;
+  return threadId;
+}
+
+int64_t toMicroseconds(Profiler::Clock::time_point timePoint) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(timePoint.time_since_epoch()).count();
+}
+
+void appendEscaped(std::string& json, std::string_view text) {
+  json += '"';
+  for(const char c : text) {
+    switch(c) {
+    case '"':
+      json += "\\\"";
+      break;
+    case '\\':
+      json += "\\\\";
+      break;
+    case '\n':
+      json += "\\n";
+      break;
+    case '\t':
+      json += "\\t";
+      break;
+    default:
+      if(static_cast<unsigned char>(c) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(c));
+        json += escaped;
+      } else {
+        json += c;
+      }
+    }
+  }
+  json += '"';
+}
+
+std::string eventHeader(std::string_view name, std::string_view phase, int64_t timestamp, bool withThread) {
+  ProfilerState& profilerState = state();
+
+  std::string json = "{\"name\":";
+  appendEscaped(json, name);
+  json += ",\"ph\":\"";
+  json += phase;
+  json += "\",\"ts\":" + std::to_string(timestamp) + ",\"pid\":" + std::to_string(profilerState.processId);
+  if(withThread) {
+    json += ",\"tid\":" + std::to_string(currentThreadId());
+  }
+  return json;
+}
+
+void addEvent(std::string event) {
+  ProfilerState& profilerState = state();
+  const std::scoped_lock<std::mutex> lock(profilerState.mutex);
+  profilerState.events.push_back(std::move(event));
+}
+
+void addProcessName(std::string_view name) {
+  std::string json = eventHeader("process_name", "M", 0, false);
+  json += ",\"args\":{\"name\":";
+  appendEscaped(json, name);
+  json += "}}";
+  addEvent(std::move(json));
+}
+
+std::string fragmentPath(const std::string& outputPath, const std::string& session, uint64_t processId) {
+  return outputPath + "." + session + "." + std::to_string(processId) + std::string(FragmentExtension);
+}
+
+// all fragment files of the output path, of any session
+std::vector<std::filesystem::path> getFragmentPaths(const std::string& outputPath) {
+  const std::filesystem::path path(outputPath);
+  const std::string fragmentPrefix = path.filename().string() + ".";
+  const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : ".";
+
+  std::vector<std::filesystem::path> fragmentPaths;
+  std::error_code error;
+  for(const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+    const std::string fileName = entry.path().filename().string();
+    if(fileName.starts_with(fragmentPrefix) && fileName.ends_with(FragmentExtension)) {
+      fragmentPaths.push_back(entry.path());
+    }
+  }
+  return fragmentPaths;
+}
+
+void setVariable(const char* name, const std::string& value) {
+#ifdef _WIN32
+  _putenv_s(name, value.c_str());
+#else
+  setenv(name, value.c_str(), 1);
+#endif
+}
+
+void clearVariable(const char* name) {
+#ifdef _WIN32
+  _putenv_s(name, "");
+#else
+  unsetenv(name);
+#endif
+}
+}    // namespace
+
+std::atomic<bool> Profiler::sEnabled = false;
+
+Profiler::Span::Span(std::string_view category, std::string_view name)
+    : mRecording(isEnabled()), mCategory(category), mName(name) {
+  if(mRecording) {
+    mBegin = Clock::now();
+  }
+}
+
+Profiler::Span::~Span() {
+  if(mRecording) {
+    addSpan(mCategory, mName, mBegin, Clock::now(), mDetail, mArguments);
+  }
+}
+
+void Profiler::Span::setDetail(std::string detail) {
+  if(mRecording) {
+    mDetail = std::move(detail);
+  }
+}
+
+void Profiler::Span::setArgument(std::string_view name, int64_t value) {
+  if(mRecording) {
+    mArguments.emplace_back(name, value);
+  }
+}
+
+void Profiler::start(const std::string& outputPath) {
+  const std::string session = std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+
+  std::error_code error;
+  for(const std::filesystem::path& fragmentPath : getFragmentPaths(outputPath)) {
+    std::filesystem::remove(fragmentPath, error);
+  }
+
+  ProfilerState& profilerState = state();
+  {
+    const std::scoped_lock<std::mutex> lock(profilerState.mutex);
+    profilerState.events.clear();
+    profilerState.outputPath = outputPath;
+    profilerState.session = session;
+    profilerState.processId = 0;
+    profilerState.isIndexerProcess = false;
+  }
+
+  setVariable(OutputPathVariable, outputPath);
+  setVariable(SessionVariable, session);
+  addProcessName("Sourcetrail");
+  sEnabled = true;
+}
+
+void Profiler::startFromEnvironment(uint64_t processId) {
+  const char* outputPath = std::getenv(OutputPathVariable);
+  const char* session = std::getenv(SessionVariable);
+  if(outputPath == nullptr || *outputPath == '\0' || session == nullptr || *session == '\0') {
+    return;
+  }
+
+  ProfilerState& profilerState = state();
+  {
+    const std::scoped_lock<std::mutex> lock(profilerState.mutex);
+    profilerState.events.clear();
+    profilerState.outputPath = outputPath;
+    profilerState.session = session;
+    profilerState.processId = processId;
+    profilerState.isIndexerProcess = true;
+  }
+
+  addProcessName("indexer " + std::to_string(processId));
+  sEnabled = true;
+}
+
+void Profiler::setThreadName(std::string_view name) {
+  if(!isEnabled()) {
+    return;
+  }
+
+  std::string json = eventHeader("thread_name", "M", 0, true);
+  json += ",\"args\":{\"name\":";
+  appendEscaped(json, name);
+  json += "}}";
+  addEvent(std::move(json));
+}
+
+void Profiler::addSpan(std::string_view category,
+                       std::string_view name,
+                       Clock::time_point begin,
+                       Clock::time_point end,
+                       std::string_view detail,
+                       const Arguments& arguments) {
+  if(!isEnabled()) {
+    return;
+  }
+
+  std::string json = eventHeader(name, "X", toMicroseconds(begin), true);
+  json += ",\"dur\":" + std::to_string(toMicroseconds(end) - toMicroseconds(begin)) + ",\"cat\":";
+  appendEscaped(json, category);
+
+  if(!detail.empty() || !arguments.empty()) {
+    json += ",\"args\":{";
+    bool first = true;
+    if(!detail.empty()) {
+      json += "\"detail\":";
+      appendEscaped(json, detail);
+      first = false;
+    }
+    for(const auto& [argumentName, value] : arguments) {
+      if(!first) {
+        json += ',';
+      }
+      appendEscaped(json, argumentName);
+      json += ':' + std::to_string(value);
+      first = false;
+    }
+    json += '}';
+  }
+  json += '}';
+
+  addEvent(std::move(json));
+}
+
+void Profiler::addCounter(std::string_view name, int64_t value) {
+  if(!isEnabled()) {
+    return;
+  }
+
+  std::string json = eventHeader(name, "C", toMicroseconds(Clock::now()), false);
+  json += ",\"args\":{\"value\":" + std::to_string(value) + "}}";
+  addEvent(std::move(json));
+}
+
+void Profiler::flush() {
+  ProfilerState& profilerState = state();
+  const std::scoped_lock<std::mutex> lock(profilerState.mutex);
+  if(!profilerState.isIndexerProcess || profilerState.events.empty()) {
+    return;
+  }
+
+  // one event per line, the process may be restarted and append to the same fragment
+  std::ofstream fragment(fragmentPath(profilerState.outputPath, profilerState.session, profilerState.processId), std::ios::app);
+  for(const std::string& event : profilerState.events) {
+    fragment << event << '\n';
+  }
+  profilerState.events.clear();
+}
+
+bool Profiler::finish() {
+  if(!sEnabled.exchange(false)) {
+    return true;
+  }
+
+  ProfilerState& profilerState = state();
+  if(profilerState.isIndexerProcess) {
+    flush();
+    return true;
+  }
+
+  clearVariable(OutputPathVariable);
+  clearVariable(SessionVariable);
+
+  const std::scoped_lock<std::mutex> lock(profilerState.mutex);
+  std::ofstream trace(profilerState.outputPath, std::ios::trunc);
+  if(!trace) {
+    return false;
+  }
+
+  trace << "{\"traceEvents\":[\n";
+  bool first = true;
+  const auto writeEvent = [&trace, &first](const std::string& event) {
+    trace << (first ? "" : ",\n") << event;
+    first = false;
+  };
+
+  for(const std::string& event : profilerState.events) {
+    writeEvent(event);
+  }
+  profilerState.events.clear();
+
+  // fragments of other sessions are stale, they are removed without being merged
+  const std::string sessionPrefix =
+      std::filesystem::path(profilerState.outputPath).filename().string() + "." + profilerState.session + ".";
+  std::error_code error;
+  for(const std::filesystem::path& fragmentPath : getFragmentPaths(profilerState.outputPath)) {
+    if(fragmentPath.filename().string().starts_with(sessionPrefix)) {
+      std::ifstream fragment(fragmentPath);
+      std::string event;
+      while(std::getline(fragment, event)) {
+        if(!event.empty()) {
+          writeEvent(event);
+        }
+      }
+    }
+    std::filesystem::remove(fragmentPath, error);
+  }
+
+  trace << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return static_cast<bool>(trace);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Records spans and counters of the indexing phases and writes them in the Chrome trace event format.
+ *
+ * Nothing is recorded unless start() was called, so each record call costs a single atomic load when profiling is off.
+ * Indexer processes started while recording inherit the output path through the environment, they write their events
+ * into fragment files next to it which finish() merges into the trace. Fragments are stamped with the session of the
+ * main process, so fragments of crashed runs or late flushes of indexer processes never end up in another trace.
+ */
+class Profiler final {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Arguments = std::vector<std::pair<std::string_view, int64_t>>;
+
+  static constexpr const char* OutputPathVariable = "SOURCETRAIL_PROFILE_FILE";
+  static constexpr const char* SessionVariable = "SOURCETRAIL_PROFILE_SESSION";
+
+  /**
+   * @brief Scoped span, recorded when it goes out of scope.
+   */
+  class Span final {
+  public:
+    Span(std::string_view category, std::string_view name);
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+    Span(Span&&) = delete;
+    Span& operator=(Span&&) = delete;
+
+    ~Span();
+
+    /**
+     * @brief Callers check this before computing expensive details or arguments.
+     */
+    [[nodiscard]] bool isRecording() const {
+      return mRecording;
+    }
+
+    void setDetail(std::string detail);
+    void setArgument(std::string_view name, int64_t value);
+
+  private:
+    bool mRecording;
+    std::string_view mCategory;
+    std::string_view mName;
+    std::string mDetail;
+    Arguments mArguments;
+    Clock::time_point mBegin;
+  };
+
+  /**
+   * @brief Starts recording in the main process and makes indexer processes started from now on record as well.
+   *
+   * Removes the fragment files left next to the output path by earlier sessions.
+   */
+  static void start(const std::string& outputPath);
+
+  /**
+   * @brief Starts recording in an indexer process if the main process records.
+   */
+  static void startFromEnvironment(uint64_t processId);
+
+  [[nodiscard]] static bool isEnabled() noexcept {
+    return sEnabled.load(std::memory_order_relaxed);
+  }
+
+  static void setThreadName(std::string_view name);
+
+  static void addSpan(std::string_view category,
+                      std::string_view name,
+                      Clock::time_point begin,
+                      Clock::time_point end,
+                      std::string_view detail = {},
+                      const Arguments& arguments = {});
+
+  static void addCounter(std::string_view name, int64_t value);
+
+  /**
+   * @brief Appends the events recorded so far to the fragment file of an indexer process.
+   */
+  static void flush();
+
+  /**
+   * @brief Stops recording, the main process writes the trace including the fragments of this session.
+   * @return false if the trace could not be written.
+   */
+  static bool finish();
+
+private:
+  static std::atomic<bool> sEnabled;
+};
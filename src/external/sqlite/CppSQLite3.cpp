@@ -823,6 +823,16 @@ void CppSQLite3Statement::bind(int nParam, const int nValue) {
 }
 
 
+void CppSQLite3Statement::bind(int nParam, const sqlite_int64 nValue) {
+  checkVM();
+  int nRes = sqlite3_bind_int64(mpVM, nParam, nValue);
+
+  if(nRes != SQLITE_OK) {
+    throw CppSQLite3Exception(nRes, "Error binding int64 param", DONT_DELETE_MSG);
+  }
+}
+
+
 void CppSQLite3Statement::bind(int nParam, const double dValue) {
   checkVM();
   int nRes = sqlite3_bind_double(mpVM, nParam, dValue);
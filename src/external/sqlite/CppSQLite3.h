@@ -239,6 +239,7 @@ public:
 
   void bind(int nParam, const char* szValue);
   void bind(int nParam, const int nValue);
+  void bind(int nParam, const sqlite_int64 nValue);
   void bind(int nParam, const double dwValue);
   void bind(int nParam, const unsigned char* blobValue, int nLen);
   void bindNull(int nParam);
@@ -293,6 +294,10 @@ public:
     sqlite3_interrupt(mpDB);
   }
 
+  void setProgressHandler(int nOps, int (*xProgress)(void*), void* pArg) {
+    sqlite3_progress_handler(mpDB, nOps, xProgress, pArg);
+  }
+
   void setBusyTimeout(int nMillisecs);
 
   static const char* SQLiteVersion() {
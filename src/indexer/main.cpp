@@ -1,6 +1,8 @@
+#include <chrono>
 #include <cstdlib>
 #include <iterator>
 #include <stdexcept>
+#include <string_view>
 
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/spdlog.h>
@@ -9,9 +11,11 @@
 #include "AppPath.h"
 #include "IApplicationSettings.hpp"
 #include "InterprocessIndexer.h"
+#include "InterprocessIndexerDaemon.h"
 #include "language_packages.h"
 #include "LanguagePackageManager.h"
 #include "logging.h"
+#include "Profiler.h"
 #include "UserPaths.h"
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
@@ -40,6 +44,13 @@ void suppressCrashMessage() {
 }    // namespace
 
 int main(int argc, char* argv[]) {
+  // persistent processes keep running across indexing runs until the application shuts them down
+  constexpr auto PersistentIdleTimeout = std::chrono::minutes(10);
+  const bool persistent = argc >= 2 && std::string_view(argv[argc - 1]) == "--persistent";
+  if(persistent) {
+    --argc;
+  }
+
   int processId = -1;
   std::string instanceUuid;
   std::string appPath;
@@ -106,6 +117,9 @@ int main(int argc, char* argv[]) {
     }
   }
 
+  // records only if the application was started with a profile file
+  Profiler::startFromEnvironment(static_cast<uint64_t>(processId));
+
   LOG_INFO(L"sharedDataPath: " + AppPath::getSharedDataDirectoryPath().wstr());
   LOG_INFO(L"userDataPath: " + UserPaths::getUserDataDirectoryPath().wstr());
 
@@ -115,8 +129,13 @@ int main(int argc, char* argv[]) {
 #endif    // BUILD_CXX_LANGUAGE_PACKAGE
 
   try {
-    InterprocessIndexer indexer(instanceUuid, Id(processId));
-    indexer.work();
+    if(persistent) {
+      InterprocessIndexerDaemon daemon(instanceUuid, Id(processId), PersistentIdleTimeout);
+      daemon.run();
+    } else {
+      InterprocessIndexer indexer(instanceUuid, Id(processId), true);
+      indexer.work();
+    }
   } catch(std::runtime_error& error) {
     LOG_ERROR(error.what());
     return EXIT_FAILURE;
@@ -18,6 +18,7 @@
 #include "IApplicationSettings.hpp"
 #include "IDECommunicationController.h"
 #include "impls/Factory.hpp"
+#include "IndexerProcessPool.h"
 #include "ISharedMemoryGarbageCollector.hpp"
 #include "ITaskManager.hpp"
 #include "logging.h"
@@ -205,6 +206,8 @@ Application::~Application() {
     mMainView->saveLayout();
   }
 
+  IndexerProcessPool::destroyInstance();
+
   if(auto* collector = lib::ISharedMemoryGarbageCollector::getInstanceRaw(); collector) {
     collector->stop();
   }
@@ -3,16 +3,19 @@
 #include <fmt/format.h>
 
 #include "BookmarkButtonsView.h"
+#include "CodeController.h"
 #include "CodeView.h"
 #include "CompositeView.h"
 #include "Controller.h"
 #include "DialogView.h"
+#include "GraphController.h"
 #include "GraphView.h"
 #include "logging.h"
 #include "RefreshView.h"
 #include "ScreenSearchController.h"
 #include "SearchView.h"
 #include "TabbedView.h"
+#include "UndoRedoController.h"
 #include "UndoRedoView.h"
 #include "ViewFactory.h"
 
@@ -131,6 +134,11 @@ void ComponentManager::setupTab(ViewLayout* viewLayout, Id tabId, ScreenSearchSe
   codeComponent->setTabId(tabId);
   m_components.push_back(codeComponent);
 
+  if(auto* undoRedoController = undoRedoComponent->getController<UndoRedoController>(); undoRedoController != nullptr) {
+    undoRedoController->addSnapshotSource(graphComponent->getController<GraphController>());
+    undoRedoController->addSnapshotSource(codeComponent->getController<CodeController>());
+  }
+
   screenSearchSender->addResponder(graphComponent->getView<GraphView>());
   screenSearchSender->addResponder(codeComponent->getView<CodeView>());
 }
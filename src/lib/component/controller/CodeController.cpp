@@ -1,5 +1,6 @@
 #include "CodeController.h"
 
+#include <algorithm>
 #include <memory>
 
 #include "Application.h"
@@ -10,6 +11,7 @@
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
 #include "StorageAccess.h"
+#include "StorageQueryToken.h"
 #include "TextAccess.h"
 #include "type/error/MessageShowError.h"
 #include "type/focus/MessageFocusView.h"
@@ -18,12 +20,97 @@
 #include "utility.h"
 #include "utilityString.h"
 
+struct CodeController::Snapshot final : public HistorySnapshot {
+  size_t getByteSize() const override {
+    return byteSize;
+  }
+
+  std::shared_ptr<SourceLocationCollection> collection;
+  std::vector<CodeFileParams> files;
+  FilePath currentFilePath;
+  CodeView::CodeParams codeParams;
+
+  std::vector<Reference> references;
+  int referenceIndex = -1;
+  std::vector<Reference> localReferences;
+  int localReferenceIndex = -1;
+
+  bool isInListMode = true;
+
+  size_t byteSize = 0;
+};
+
 CodeController::CodeController(StorageAccess* storageAccess) : m_storageAccess(storageAccess) {}
 
 Id CodeController::getSchedulerId() const {
   return Controller::getTabId();
 }
 
+bool CodeController::skipsMessage(const MessageBase& message) const {
+  return isRestoredMessage(message);
+}
+
+bool CodeController::hasSnapshot() const {
+  return true;
+}
+
+std::shared_ptr<HistorySnapshot> CodeController::takeSnapshot() {
+  auto snapshot = std::make_shared<Snapshot>();
+
+  snapshot->byteSize = m_collection ? m_collection->getSourceLocationCount() * sizeof(SourceLocation) : 0;
+  for(const CodeFileParams& file : m_files) {
+    snapshot->byteSize += sizeof(CodeFileParams);
+    for(const CodeSnippetParams& snippet : file.snippetParams) {
+      snapshot->byteSize += sizeof(CodeSnippetParams) + snippet.code.size();
+    }
+    if(file.fileParams) {
+      snapshot->byteSize += sizeof(CodeSnippetParams) + file.fileParams->code.size();
+    }
+  }
+  snapshot->byteSize += (m_references.size() + m_localReferences.size()) * sizeof(Reference);
+
+  snapshot->collection = std::move(m_collection);
+  snapshot->files = std::move(m_files);
+  snapshot->currentFilePath = m_currentFilePath;
+  snapshot->codeParams = std::move(m_codeParams);
+  snapshot->references = std::move(m_references);
+  snapshot->referenceIndex = m_referenceIndex;
+  snapshot->localReferences = std::move(m_localReferences);
+  snapshot->localReferenceIndex = m_localReferenceIndex;
+  snapshot->isInListMode = getView()->isInListMode();
+
+  // the view keeps showing the old files until the history restores or rebuilds them
+  m_collection = std::make_shared<SourceLocationCollection>();
+  m_files.clear();
+  m_currentFilePath = FilePath();
+  m_codeParams = CodeView::CodeParams();
+  m_scrollParams = CodeScrollParams();
+  clearReferences();
+
+  return snapshot;
+}
+
+void CodeController::restoreSnapshot(std::shared_ptr<HistorySnapshot> snapshot) {
+  auto codeSnapshot = std::dynamic_pointer_cast<Snapshot>(snapshot);
+  if(!codeSnapshot) {
+    LOG_ERROR("Snapshot was not created by a CodeController");
+    return;
+  }
+
+  m_collection = std::move(codeSnapshot->collection);
+  m_files = std::move(codeSnapshot->files);
+  m_currentFilePath = codeSnapshot->currentFilePath;
+  m_codeParams = std::move(codeSnapshot->codeParams);
+  m_codeParams.clearSnippets = true;
+  m_scrollParams = CodeScrollParams();
+  m_references = std::move(codeSnapshot->references);
+  m_referenceIndex = codeSnapshot->referenceIndex;
+  m_localReferences = std::move(codeSnapshot->localReferences);
+  m_localReferenceIndex = codeSnapshot->localReferenceIndex;
+
+  getView()->setMode(codeSnapshot->isInListMode);
+}
+
 void CodeController::handleMessage(MessageActivateErrors* message) {
   saveOrRestoreViewMode(message);
 
@@ -168,13 +255,24 @@ void CodeController::handleMessage(MessageActivateTokens* message) {
   params.activeTokenIds = message->tokenIds;
   params.clearSnippets = true;
 
+  const StorageQueryToken token(message->getSchedulerId(), message->getId());
   Id declarationId = 0;    // 0 means that no token is found.
-  if(!message->isBundledEdges) {
-    std::vector<Id> activeTokenIds;
-    for(Id tokenId : params.activeTokenIds) {
-      utility::append(activeTokenIds, m_storageAccess->getActiveTokenIdsForId(tokenId, &declarationId));
-    }
-    params.activeTokenIds = activeTokenIds;
+  std::shared_ptr<SourceLocationCollection> collection;
+  if(!token.run([&]() {
+       if(!message->isBundledEdges) {
+         std::vector<Id> activeTokenIds;
+         for(Id tokenId : params.activeTokenIds) {
+           utility::append(activeTokenIds, m_storageAccess->getActiveTokenIdsForId(tokenId, &declarationId));
+         }
+         params.activeTokenIds = activeTokenIds;
+       }
+
+       if(!message->isEdge || params.activeTokenIds.size() != 1) {
+         collection = m_storageAccess->getSourceLocationsForTokenIds(params.activeTokenIds);
+       }
+     })) {
+    LOG_INFO("Dropped source locations of superseded activation");
+    return;
   }
 
   if(message->isEdge && params.activeTokenIds.size() == 1) {
@@ -182,12 +280,13 @@ void CodeController::handleMessage(MessageActivateTokens* message) {
     return;
   }
 
-  m_collection = m_storageAccess->getSourceLocationsForTokenIds(params.activeTokenIds);
+  m_collection = collection;
 
   m_files = getFilesForActiveSourceLocations(m_collection.get(), declarationId);
   createReferences();
   expandVisibleFiles(params.useSingleFileCache);
   showFiles(params, definitionReferenceScrollParams(params.activeTokenIds), !message->isReplayed());
+  m_storageAccess->prefetchFileContents(m_collection);
 
   // send status message
   {
@@ -234,6 +333,7 @@ void CodeController::handleMessage(MessageActivateTrailEdge* message) {
   createReferences();
   expandVisibleFiles(m_codeParams.useSingleFileCache);
   showFiles(m_codeParams, firstReferenceScrollParams(), !message->isReplayed());
+  m_storageAccess->prefetchFileContents(m_collection);
 }
 
 void CodeController::handleMessage(MessageChangeFileView* message) {
@@ -335,6 +435,28 @@ void CodeController::handleMessage(MessageCodeShowDefinition* message) {
   showFiles(m_codeParams, CodeScrollParams::toLine(filePath, lineNumber, CodeScrollParams::Target::TOP), !message->isReplayed());
 }
 
+void CodeController::handleMessage(MessageCodeVisibleLinesChanged* message) {
+  for(CodeFileParams& file : m_files) {
+    if(!file.fileParams || !file.fileParams->isVirtualized || file.locationFile->getFilePath() != message->filePath) {
+      continue;
+    }
+
+    std::shared_ptr<SourceLocationFile> locationFile = m_storageAccess->getSourceLocationsForLinesInFile(
+        message->filePath, message->startLineNumber, message->endLineNumber);
+    if(locationFile) {
+      // the view shows the merged locations as they are, so they keep the flags of the whole file
+      const std::shared_ptr<SourceLocationFile>& wholeFile = file.fileParams->locationFile;
+      locationFile->setIsWhole(wholeFile->isWhole());
+      locationFile->setIsComplete(wholeFile->isComplete());
+      locationFile->setIsIndexed(wholeFile->isIndexed());
+      locationFile->copySourceLocations(wholeFile);
+      file.fileParams->locationFile = locationFile;
+      getView()->updateSourceLocations(m_files);
+    }
+    return;
+  }
+}
+
 void CodeController::handleMessage(MessageDeactivateEdge* message) {
   CodeScrollParams scrollParams;
   m_codeParams.activeLocationIds.clear();
@@ -364,6 +486,8 @@ void CodeController::handleMessage(MessageFocusChanged* message) {
 
 void CodeController::handleMessage(MessageFlushUpdates* /*message*/) {
   showFiles(m_codeParams, m_scrollParams, true);
+
+  clearRestoredMessageIds();
 }
 
 void CodeController::handleMessage(MessageFocusIn* message) {
@@ -1096,6 +1220,16 @@ void CodeController::setFileState(CodeFileParams& file, MessageChangeFileView::F
   case MessageChangeFileView::FILE_MAXIMIZED:
     if(!file.fileParams) {
       file.fileParams = std::make_shared<CodeSnippetParams>(getSnippetParamsForWholeFile(file.locationFile, useSingleFileCache));
+
+      const std::string& code = file.fileParams->code;
+      if(!code.empty()) {
+        const auto lineCount = static_cast<size_t>(std::count(code.begin(), code.end(), '\n')) + (code.back() != '\n' ? 1 : 0);
+        file.fileParams->isVirtualized = lineCount > CodeSnippetParams::VirtualizedLineCount;
+      } else {
+        // the view has the file cached, so its content was not loaded
+        const auto textAccess = m_storageAccess->getFileContent(file.locationFile->getFilePath(), false);
+        file.fileParams->isVirtualized = textAccess && textAccess->getLineCount() > CodeSnippetParams::VirtualizedLineCount;
+      }
     }
 
     if(file.locationFile) {
@@ -1133,7 +1267,8 @@ bool CodeController::addAllSourceLocations() {
     }
 
     if(file.fileParams) {
-      if(file.fileParams->hasAllSourceLocations) {
+      // virtualized files receive the source locations of the visible lines on request of the view
+      if(file.fileParams->hasAllSourceLocations || file.fileParams->isVirtualized) {
         continue;
       }
 
@@ -1325,4 +1460,45 @@ void CodeController::showFiles(CodeView::CodeParams params, CodeScrollParams scr
   if(addAllSourceLocations() && updateView) {
     getView()->updateSourceLocations(m_files);
   }
+
+  if(updateView) {
+    prefetchTooltips();
+  }
+}
+
+void CodeController::prefetchTooltips() const {
+  std::vector<Id> tokenIds;
+  std::set<Id> addedTokenIds;
+
+  const auto addTokenIds = [&](const std::shared_ptr<SourceLocationFile>& locationFile) {
+    if(!locationFile) {
+      return;
+    }
+
+    locationFile->forEachStartSourceLocation([&](SourceLocation* location) {
+      if(location->getType() != LOCATION_TOKEN) {
+        return;
+      }
+
+      for(const Id tokenId : location->getTokenIds()) {
+        if(tokenIds.size() < TooltipPrefetchTokenCount && addedTokenIds.insert(tokenId).second) {
+          tokenIds.push_back(tokenId);
+        }
+      }
+    });
+  };
+
+  for(const CodeFileParams& file : m_files) {
+    if(getView()->isInListMode()) {
+      if(!file.isMinimized) {
+        for(const CodeSnippetParams& snippet : file.snippetParams) {
+          addTokenIds(snippet.locationFile);
+        }
+      }
+    } else if(file.fileParams && file.locationFile->getFilePath() == m_currentFilePath) {
+      addTokenIds(file.fileParams->locationFile);
+    }
+  }
+
+  m_storageAccess->prefetchTooltipInfos(tokenIds, TOOLTIP_ORIGIN_CODE);
 }
\ No newline at end of file
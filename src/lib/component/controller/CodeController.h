@@ -8,6 +8,7 @@
 #include "Controller.h"
 #include "FilePath.h"
 #include "GlobalId.hpp"
+#include "HistorySnapshotInterfaces.h"
 #include "LocationType.h"
 #include "MessageListener.h"
 #include "SnippetMerger.h"
@@ -21,6 +22,7 @@
 #include "type/code/MessageChangeFileView.h"
 #include "type/code/MessageCodeReference.h"
 #include "type/code/MessageCodeShowDefinition.h"
+#include "type/code/MessageCodeVisibleLinesChanged.h"
 #include "type/code/MessageScrollCode.h"
 #include "type/code/MessageScrollToLine.h"
 #include "type/code/MessageShowReference.h"
@@ -53,6 +55,7 @@ class CodeController
     , public MessageListener<MessageChangeFileView>
     , public MessageListener<MessageCodeReference>
     , public MessageListener<MessageCodeShowDefinition>
+    , public MessageListener<MessageCodeVisibleLinesChanged>
     , public MessageListener<MessageDeactivateEdge>
     , public MessageListener<MessageErrorCountClear>
     , public MessageListener<MessageFocusChanged>
@@ -64,14 +67,23 @@ class CodeController
     , public MessageListener<MessageShowError>
     , public MessageListener<MessageShowReference>
     , public MessageListener<MessageShowScope>
-    , public MessageListener<MessageToNextCodeReference> {
+    , public MessageListener<MessageToNextCodeReference>
+    , public HistorySnapshotSource {
 public:
   CodeController(StorageAccess* storageAccess);
   virtual ~CodeController() = default;
 
   Id getSchedulerId() const override;
+  bool skipsMessage(const MessageBase& message) const override;
+
+  bool hasSnapshot() const override;
+  std::shared_ptr<HistorySnapshot> takeSnapshot() override;
+  void restoreSnapshot(std::shared_ptr<HistorySnapshot> snapshot) override;
 
 private:
+  // tooltips of at most that many tokens of the shown snippets are created ahead of hovering them
+  static constexpr size_t TooltipPrefetchTokenCount = 200;
+
   struct Reference {
     FilePath filePath;
     Id tokenId = 0;
@@ -82,6 +94,8 @@ private:
     size_t columnNumber = 0;
   };
 
+  struct Snapshot;
+
   void handleMessage(MessageActivateErrors* message) override;
   void handleMessage(MessageActivateFullTextSearch* message) override;
   void handleMessage(MessageActivateLegend* message) override;
@@ -93,6 +107,7 @@ private:
   void handleMessage(MessageChangeFileView* message) override;
   void handleMessage(MessageCodeReference* message) override;
   void handleMessage(MessageCodeShowDefinition* message) override;
+  void handleMessage(MessageCodeVisibleLinesChanged* message) override;
   void handleMessage(MessageDeactivateEdge* message) override;
   void handleMessage(MessageErrorCountClear* message) override;
   void handleMessage(MessageFocusChanged* message) override;
@@ -156,6 +171,7 @@ private:
 
   void showFirstActiveReference(Id tokenId, bool updateView);
   void showFiles(CodeView::CodeParams params, CodeScrollParams scrollParams, bool updateView);
+  void prefetchTooltips() const;
 
   StorageAccess* m_storageAccess;
 
@@ -154,19 +154,18 @@ void ErrorController::clear() {
 bool ErrorController::showErrors(const ErrorFilter& filter, bool scrollTo) {
   auto* pView = getView();
 
-  ErrorFilter filterUnlimited = filter;
-  filterUnlimited.limit = 0;
-
   std::vector<ErrorInfo> errors;
+  ErrorCountInfo errorCount;
   if(m_tabActiveFilePath[TabId::currentTab()].empty()) {
-    errors = m_storageAccess->getErrorsLimited(filterUnlimited);
+    // the storage only loads the shown page of errors and counts the rest
+    errors = m_storageAccess->getErrorsLimited(filter);
+    errorCount = m_storageAccess->getFilteredErrorCount(filter);
   } else {
     errors = m_storageAccess->getErrorsForFileLimited(filter, m_tabActiveFilePath[TabId::currentTab()]);
-  }
-
-  ErrorCountInfo errorCount(errors);
-  if(filter.limit > 0 && errors.size() > filter.limit) {
-    errors.resize(filter.limit);
+    errorCount = ErrorCountInfo(errors);
+    if(filter.limit > 0 && errors.size() > filter.limit) {
+      errors.resize(filter.limit);
+    }
   }
 
   pView->addErrors(errors, errorCount, scrollTo);
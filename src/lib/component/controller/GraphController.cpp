@@ -13,7 +13,10 @@
 #include "IApplicationSettings.hpp"
 #include "ListLayouter.h"
 #include "logging.h"
+#include "Profiler.h"
 #include "StorageAccess.h"
+#include "StorageQueryToken.h"
+#include "TimeStamp.h"
 #include "TokenComponentAccess.h"
 #include "TokenComponentFilePath.h"
 #include "TokenComponentInheritanceChain.h"
@@ -21,8 +24,74 @@
 #include "type/graph/MessageActivateNodes.h"
 #include "type/MessageStatus.h"
 #include "utility.h"
+#include "utilityApp.h"
 #include "utilityString.h"
 
+namespace {
+// Overview bundles are filled from storage when they get split. Their ids set the first three bits, which keeps them apart
+// from the ids of other bundles and groups, and hold the bundle kind and the page, 0 standing for the whole bundle.
+constexpr Id OverviewBundleIdFlags = ~(~Id(0) >> 3);
+constexpr size_t OverviewBundlePageSize = StorageAccess::OverviewBundlePageSize;
+
+Id getOverviewBundleId(NodeKind kind, size_t page) {
+  return OverviewBundleIdFlags | (static_cast<Id>(nodeKindToInt(kind)) << 32) | page;
+}
+
+bool isOverviewBundleId(Id bundleId) {
+  return (bundleId & OverviewBundleIdFlags) == OverviewBundleIdFlags;
+}
+
+NodeKind getOverviewBundleKind(Id bundleId) {
+  return intToNodeKind(static_cast<int>((bundleId & ~OverviewBundleIdFlags) >> 32));
+}
+
+size_t getOverviewBundlePage(Id bundleId) {
+  return bundleId & 0xFFFFFFFF;
+}
+
+// Records a phase of turning the storage graph into a laid out dummy graph as profiler span and logs how long it took.
+class PhaseTimer final {
+public:
+  explicit PhaseTimer(const char* phase) : m_phase(phase), m_span("graph", phase), m_start(TimeStamp::now()) {}
+
+  ~PhaseTimer() {
+    LOG_INFO("Graph {} took {} ms", m_phase, TimeStamp::now().deltaMS(m_start));
+  }
+
+  PhaseTimer(const PhaseTimer&) = delete;
+  PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+  const char* m_phase;
+  const Profiler::Span m_span;
+  TimeStamp m_start;
+};
+
+// nested groups of a worker are laid out on that worker, see utility::forEachIndexParallel
+constexpr size_t MinLayoutNodesPerThread = 32;
+}    // namespace
+
+struct GraphController::Snapshot final : public HistorySnapshot {
+  size_t getByteSize() const override {
+    return byteSize;
+  }
+
+  std::vector<std::shared_ptr<DummyNode>> dummyNodes;
+  std::vector<std::shared_ptr<DummyEdge>> dummyEdges;
+  std::map<Id, std::shared_ptr<DummyNode>> dummyGraphNodes;
+
+  std::vector<Id> activeNodeIds;
+  std::vector<Id> activeEdgeIds;
+
+  std::shared_ptr<Graph> graph;
+  std::map<Id, Id> topLevelAncestorIds;
+
+  bool useBezierEdges = false;
+  bool showsLegend = false;
+
+  size_t byteSize = 0;
+};
+
 GraphController::GraphController(StorageAccess* storageAccess) : m_storageAccess(storageAccess), m_useBezierEdges(false) {}
 
 GraphController::~GraphController() = default;
@@ -31,6 +100,65 @@ Id GraphController::getSchedulerId() const {
   return Controller::getTabId();
 }
 
+bool GraphController::skipsMessage(const MessageBase& message) const {
+  return isRestoredMessage(message);
+}
+
+bool GraphController::hasSnapshot() const {
+  return m_graph != nullptr;
+}
+
+std::shared_ptr<HistorySnapshot> GraphController::takeSnapshot() {
+  auto snapshot = std::make_shared<Snapshot>();
+
+  size_t dummyNodeCount = 0;
+  forEachDummyNodeRecursive([&dummyNodeCount](DummyNode* /*node*/) { dummyNodeCount++; });
+  snapshot->byteSize = dummyNodeCount * sizeof(DummyNode) + m_dummyEdges.size() * sizeof(DummyEdge) +
+      m_graph->getNodeCount() * sizeof(Node) + m_graph->getEdgeCount() * sizeof(Edge);
+
+  snapshot->dummyNodes = std::move(m_dummyNodes);
+  snapshot->dummyEdges = std::move(m_dummyEdges);
+  snapshot->dummyGraphNodes = std::move(m_dummyGraphNodes);
+  snapshot->activeNodeIds = std::move(m_activeNodeIds);
+  snapshot->activeEdgeIds = std::move(m_activeEdgeIds);
+  snapshot->graph = std::move(m_graph);
+  snapshot->topLevelAncestorIds = std::move(m_topLevelAncestorIds);
+  snapshot->useBezierEdges = m_useBezierEdges;
+  snapshot->showsLegend = m_showsLegend;
+
+  // the view keeps showing the old graph until the history restores or rebuilds one
+  m_dummyNodes.clear();
+  m_dummyEdges.clear();
+  m_dummyGraphNodes.clear();
+  m_activeNodeIds.clear();
+  m_activeEdgeIds.clear();
+  m_topLevelAncestorIds.clear();
+  m_useBezierEdges = false;
+  m_showsLegend = false;
+  m_tokenIdToFocus = 0;
+
+  return snapshot;
+}
+
+void GraphController::restoreSnapshot(std::shared_ptr<HistorySnapshot> snapshot) {
+  auto graphSnapshot = std::dynamic_pointer_cast<Snapshot>(snapshot);
+  if(!graphSnapshot) {
+    LOG_ERROR("Snapshot was not created by a GraphController");
+    return;
+  }
+
+  m_dummyNodes = std::move(graphSnapshot->dummyNodes);
+  m_dummyEdges = std::move(graphSnapshot->dummyEdges);
+  m_dummyGraphNodes = std::move(graphSnapshot->dummyGraphNodes);
+  m_activeNodeIds = std::move(graphSnapshot->activeNodeIds);
+  m_activeEdgeIds = std::move(graphSnapshot->activeEdgeIds);
+  m_graph = std::move(graphSnapshot->graph);
+  m_topLevelAncestorIds = std::move(graphSnapshot->topLevelAncestorIds);
+  m_useBezierEdges = graphSnapshot->useBezierEdges;
+  m_showsLegend = graphSnapshot->showsLegend;
+  m_tokenIdToFocus = 0;
+}
+
 void GraphController::handleMessage(MessageActivateErrors* /*message*/) {
   clear();
 }
@@ -56,17 +184,28 @@ void GraphController::handleMessage(MessageActivateLegend* message) {
 void GraphController::handleMessage(MessageActivateOverview* message) {
   clear();
 
+  const StorageQueryToken token(message->getSchedulerId(), message->getId());
+  std::shared_ptr<Graph> graph;
+  std::map<NodeKind, size_t> bundleCounts;
+  if(!token.run([&]() {
+       if(message->acceptedNodeTypes != NodeTypeSet::all()) {
+         graph = m_storageAccess->getGraphForNodeTypes(message->acceptedNodeTypes);
+       } else {
+         bundleCounts = m_storageAccess->getOverviewBundleCounts();
+       }
+     })) {
+    LOG_INFO("Dropped overview graph of superseded activation");
+    return;
+  }
+
   if(message->acceptedNodeTypes != NodeTypeSet::all()) {
-    createDummyGraphAndSetActiveAndVisibility(
-        std::vector<Id>(), m_storageAccess->getGraphForNodeTypes(message->acceptedNodeTypes), false);
+    createDummyGraphAndSetActiveAndVisibility(std::vector<Id>(), graph, false);
 
     addCharacterIndex();
     layoutNesting();
     layoutList();
   } else {
-    createDummyGraphAndSetActiveAndVisibility(std::vector<Id>(), m_storageAccess->getGraphForAll(), false);
-
-    bundleNodesByType();
+    createOverviewBundles(bundleCounts);
 
     layoutNesting();
     assignBundleIds();
@@ -114,8 +253,13 @@ void GraphController::handleMessage(MessageActivateTokens* message) {
 
   std::vector<Id> tokenIds = utility::concat(m_activeNodeIds, m_activeEdgeIds);
 
+  const StorageQueryToken token(message->getSchedulerId(), message->getId());
   bool isNamespace = false;
-  std::shared_ptr<Graph> graph = m_storageAccess->getGraphForActiveTokenIds(tokenIds, getExpandedNodeIds(), &isNamespace);
+  std::shared_ptr<Graph> graph;
+  if(!token.run([&]() { graph = m_storageAccess->getGraphForActiveTokenIds(tokenIds, getExpandedNodeIds(), &isNamespace); })) {
+    LOG_INFO("Dropped graph of superseded activation");
+    return;
+  }
 
   createDummyGraphAndSetActiveAndVisibility(tokenIds, graph, !message->isFromSearch);
 
@@ -175,14 +319,20 @@ void GraphController::handleMessage(MessageActivateTrail* message) {
 
   m_activeEdgeIds.clear();
 
-  std::shared_ptr<Graph> graph = m_storageAccess->getGraphForTrail(
-      message->originId,
-      message->targetId,
-      message->nodeTypes,
-      message->edgeTypes,
-      message->nodeNonIndexed,
-      message->depth,
-      true /* !message->custom || (message->originId && message->targetId) */);
+  const StorageQueryToken token(message->getSchedulerId(), message->getId());
+  std::shared_ptr<Graph> graph;
+  if(!token.run([&]() {
+       graph = m_storageAccess->getGraphForTrail(message->originId,
+                                                 message->targetId,
+                                                 message->nodeTypes,
+                                                 message->edgeTypes,
+                                                 message->nodeNonIndexed,
+                                                 message->depth,
+                                                 true /* !message->custom || (message->originId && message->targetId) */);
+     })) {
+    LOG_INFO("Dropped trail graph of superseded activation");
+    return;
+  }
 
   // remove non-indexed files from include graph if indexed file is origin
   if(!message->custom && message->edgeTypes & Edge::EDGE_INCLUDE) {
@@ -280,6 +430,8 @@ void GraphController::handleMessage(MessageFlushUpdates* message) {
   params.centerActiveNode = true;
   params.animatedTransition = !message->keepContent();
   buildGraph(message, params);
+
+  clearRestoredMessageIds();
 }
 
 void GraphController::handleMessage(MessageScrollGraph* message) {
@@ -297,6 +449,11 @@ void GraphController::handleMessage(MessageFocusOut* message) {
 }
 
 void GraphController::handleMessage(MessageGraphNodeBundleSplit* message) {
+  if(isOverviewBundleId(message->bundleId)) {
+    splitOverviewBundle(message);
+    return;
+  }
+
   std::wstring name;
   if(m_dummyNodes.size() == 1 && m_dummyNodes[0]->isGroupNode()) {
     name = m_dummyNodes[0]->name;
@@ -528,6 +685,8 @@ void GraphController::clear() {
 }
 
 void GraphController::createDummyGraph(const std::shared_ptr<Graph> graph) {
+  const PhaseTimer timer("dummy graph creation");
+
   GraphView* view = getView();
   if(!view) {
     LOG_ERROR("GraphController has no associated GraphView");
@@ -839,6 +998,8 @@ void GraphController::hideBuiltinTypes() {
 }
 
 void GraphController::bundleNodes() {
+  const PhaseTimer timer("bundling");
+
   // evaluate top level nodes
   for(const std::shared_ptr<DummyNode>& node : m_dummyNodes) {
     if(!node->isGraphNode() || !node->visible) {
@@ -1148,38 +1309,103 @@ std::shared_ptr<DummyNode> GraphController::bundleByType(std::list<std::shared_p
   return bundleNode;
 }
 
-void GraphController::bundleNodesByType() {
-  std::list<std::shared_ptr<DummyNode>> nodes(m_dummyNodes.begin(), m_dummyNodes.end());
-  std::vector<std::shared_ptr<DummyNode>> oldNodes = std::move(m_dummyNodes);
-  m_dummyNodes.clear();
+void GraphController::createOverviewBundles(const std::map<NodeKind, size_t>& bundleCounts) {
+  m_graph = std::make_shared<Graph>();
 
   bool hasNonFileBundle = false;
+  const auto addBundle = [&](const NodeType& nodeType) {
+    auto it = bundleCounts.find(nodeType.getKind());
+    if(it == bundleCounts.end() || !it->second) {
+      return;
+    }
+
+    const Tree<NodeType::BundleInfo> bundleInfoTree = nodeType.getOverviewBundleTree();
+
+    auto bundleNode = std::make_shared<DummyNode>(DummyNode::DUMMY_BUNDLE);
+    bundleNode->name = bundleInfoTree.data.isValid() ? bundleInfoTree.data.bundleName : L"Symbols";
+    bundleNode->visible = true;
+    bundleNode->tokenId = getOverviewBundleId(nodeType.getKind(), 0);
+    bundleNode->bundledNodeType = nodeType;
+    bundleNode->bundledNodeCount = it->second;
+    m_dummyNodes.push_back(bundleNode);
+
+    if(nodeType.getKind() != NODE_FILE) {
+      hasNonFileBundle = true;
+    }
+  };
 
   for(const NodeType& nodeType : NodeType::overviewBundleNodeTypesOrdered) {
-    Tree<NodeType::BundleInfo> bundleInfoTree = nodeType.getOverviewBundleTree();
-    if(bundleInfoTree.data.isValid()) {
-      std::shared_ptr<DummyNode> bundleNode = bundleByType(nodes, nodeType, bundleInfoTree, false);
-      if(bundleNode) {
-        m_dummyNodes.push_back(bundleNode);
-
-        if(bundleNode->bundledNodeType.getKind() != NODE_FILE) {
-          hasNonFileBundle = true;
-        }
-      }
+    addBundle(nodeType);
+  }
+
+  // symbols without a bundle of their own are only shown when there is no other symbol bundle
+  if(!hasNonFileBundle) {
+    addBundle(NodeType(NODE_SYMBOL));
+  }
+}
+
+void GraphController::splitOverviewBundle(MessageGraphNodeBundleSplit* message) {
+  std::shared_ptr<DummyNode> bundleNode;
+  for(const std::shared_ptr<DummyNode>& node : m_dummyNodes) {
+    if(node->isBundleNode() && node->tokenId == message->bundleId) {
+      bundleNode = node;
+      break;
     }
   }
 
-  if(nodes.size() && !hasNonFileBundle) {
-    Tree<NodeType::BundleInfo> bundleInfoTree(NodeType::BundleInfo(L"Symbols"));
-    std::shared_ptr<DummyNode> bundleNode = bundleByType(nodes, NodeType(NODE_SYMBOL), bundleInfoTree, false);
-    if(bundleNode) {
-      m_dummyNodes.push_back(bundleNode);
+  if(!bundleNode) {
+    return;
+  }
+
+  const NodeKind kind = getOverviewBundleKind(message->bundleId);
+  const size_t page = getOverviewBundlePage(message->bundleId);
+  const size_t count = bundleNode->bundledNodeCount;
+
+  // split big bundles into pages first, so members are only loaded for one page at a time
+  if(!page && count > OverviewBundlePageSize) {
+    m_dummyNodes.clear();
+
+    for(size_t offset = 0; offset < count; offset += OverviewBundlePageSize) {
+      const size_t pageCount = std::min(OverviewBundlePageSize, count - offset);
+
+      auto pageNode = std::make_shared<DummyNode>(DummyNode::DUMMY_BUNDLE);
+      pageNode->name = bundleNode->name + L" " + std::to_wstring(offset + 1) + L" - " + std::to_wstring(offset + pageCount);
+      pageNode->visible = true;
+      pageNode->tokenId = getOverviewBundleId(kind, offset / OverviewBundlePageSize + 1);
+      pageNode->bundledNodeType = bundleNode->bundledNodeType;
+      pageNode->bundledNodeCount = pageCount;
+      m_dummyNodes.push_back(pageNode);
     }
+
+    layoutNesting();
+    assignBundleIds();
+    layoutGraph();
+
+    GraphView::GraphParams params;
+    params.scrollToTop = true;
+    buildGraph(message, params);
+    return;
   }
 
-  if(nodes.size()) {
-    LOG_ERROR("Nodes left after bundling for overview");
+  const size_t offset = page ? (page - 1) * OverviewBundlePageSize : 0;
+  std::shared_ptr<Graph> graph = m_storageAccess->getGraphForOverviewBundle(kind, offset, OverviewBundlePageSize);
+
+  createDummyGraphAndSetActiveAndVisibility({}, graph, false);
+
+  // keep the sub-bundles of the kind, e.g. anonymous namespaces
+  std::list<std::shared_ptr<DummyNode>> nodes(m_dummyNodes.begin(), m_dummyNodes.end());
+  m_dummyNodes.clear();
+  for(const Tree<NodeType::BundleInfo>& childBundleInfoTree : NodeType(kind).getOverviewBundleTree().children) {
+    if(std::shared_ptr<DummyNode> childBundle = bundleByType(nodes, NodeType(kind), childBundleInfoTree, true)) {
+      childBundle->bundledNodeType = NodeType(kind);
+      m_dummyNodes.push_back(childBundle);
+    }
   }
+  m_dummyNodes.insert(m_dummyNodes.end(), nodes.begin(), nodes.end());
+
+  GraphView::GraphParams params;
+  params.scrollToTop = true;
+  relayoutGraph(message, params, true, bundleNode->name);
 }
 
 void GraphController::addCharacterIndex() {
@@ -1222,6 +1448,8 @@ bool GraphController::hasCharacterIndex() const {
 }
 
 void GraphController::groupNodesByParents(GroupType groupType) {
+  const PhaseTimer timer("grouping");
+
   if(groupType != GroupType::FILE_TYPE && groupType != GroupType::NAMESPACE) {
     return;
   }
@@ -1347,6 +1575,8 @@ DummyNode* GraphController::groupAllNodes(GroupType groupType, Id groupNodeId) {
 }
 
 void GraphController::groupTrailNodes(GroupType groupType) {
+  const PhaseTimer timer("trail grouping");
+
   struct TrailNode {
     Id nodeId;
     std::set<Id> targetNodeIds;
@@ -1483,11 +1713,12 @@ void GraphController::groupTrailNodes(GroupType groupType) {
 }
 
 void GraphController::layoutNesting() {
+  const PhaseTimer timer("nesting layout");
+
   extendEqualFunctionNames(m_dummyNodes);
 
-  for(const std::shared_ptr<DummyNode>& node : m_dummyNodes) {
-    layoutNestingRecursive(node.get());
-  }
+  utility::forEachIndexParallel(
+      m_dummyNodes.size(), MinLayoutNodesPerThread, [this](size_t index) { layoutNestingRecursive(m_dummyNodes[index].get()); });
 
   for(const std::shared_ptr<DummyNode>& node : m_dummyNodes) {
     layoutToGrid(node.get());
@@ -1567,7 +1798,12 @@ QVector4D GraphController::layoutNestingRecursive(DummyNode* node, int relayoutA
   width += margins.iconWidth;
   width = std::max(width, margins.minWidth);
 
-  if(relayoutAccessMaxWidth == -1) {
+  if(relayoutAccessMaxWidth == -1 && node->isGroupNode()) {
+    // members of a group don't depend on each other's size
+    utility::forEachIndexParallel(node->subNodes.size(), MinLayoutNodesPerThread, [this, node](size_t index) {
+      layoutNestingRecursive(node->subNodes[index].get());
+    });
+  } else if(relayoutAccessMaxWidth == -1) {
     int maxAccessWidth = 0;
     std::shared_ptr<const DummyNode> maxWidthAccessNode;
 
@@ -1738,6 +1974,8 @@ void GraphController::layoutToGrid(DummyNode* node) const {
 }
 
 void GraphController::layoutGraph(bool getSortedNodes) {
+  const PhaseTimer timer("bucket layout");
+
   std::vector<std::shared_ptr<DummyNode>> visibleNodes;
   for(auto node : m_dummyNodes) {
     if(node->visible) {
@@ -1755,10 +1993,14 @@ void GraphController::layoutGraph(bool getSortedNodes) {
 }
 
 void GraphController::layoutList() {
+  const PhaseTimer timer("list layout");
+
   ListLayouter::layoutMultiColumn(getView()->getViewSize(), &m_dummyNodes);
 }
 
 void GraphController::layoutTrail(bool horizontal, bool hasOrigin) {
+  const PhaseTimer timer("trail layout");
+
   TrailLayouter::LayoutDirection direction;
   if(horizontal) {
     if(hasOrigin) {
@@ -1786,6 +2028,8 @@ void GraphController::layoutTrail(bool horizontal, bool hasOrigin) {
 }
 
 void GraphController::assignBundleIds() {
+  const PhaseTimer timer("bundle id assignment");
+
   Id bundleId = 0;
   for(size_t i = m_dummyNodes.size(); i > 0; i--) {
     bundleId = m_dummyNodes[i - 1]->setBundleIdRecursive(bundleId);
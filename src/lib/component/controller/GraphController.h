@@ -27,6 +27,7 @@
 #include "DummyEdge.h"
 #include "DummyNode.h"
 #include "GraphView.h"
+#include "HistorySnapshotInterfaces.h"
 #include "Node.h"
 
 class Graph;
@@ -51,14 +52,22 @@ class GraphController
     , public MessageListener<MessageGraphNodeHide>
     , public MessageListener<MessageGraphNodeMove>
     , public MessageListener<MessageScrollGraph>
-    , public MessageListener<MessageShowReference> {
+    , public MessageListener<MessageShowReference>
+    , public HistorySnapshotSource {
 public:
   GraphController(StorageAccess* storageAccess);
   ~GraphController() override;
 
   Id getSchedulerId() const override;
+  bool skipsMessage(const MessageBase& message) const override;
+
+  bool hasSnapshot() const override;
+  std::shared_ptr<HistorySnapshot> takeSnapshot() override;
+  void restoreSnapshot(std::shared_ptr<HistorySnapshot> snapshot) override;
 
 private:
+  struct Snapshot;
+
   void handleMessage(MessageActivateErrors* message) override;
   void handleMessage(MessageActivateFullTextSearch* message) override;
   void handleMessage(MessageActivateLegend* message) override;
@@ -115,7 +124,8 @@ private:
                                           const NodeType& type,
                                           const Tree<NodeType::BundleInfo>& bundleInfoTree,
                                           const bool considerInvisibleNodes);
-  void bundleNodesByType();
+  void createOverviewBundles(const std::map<NodeKind, size_t>& bundleCounts);
+  void splitOverviewBundle(MessageGraphNodeBundleSplit* message);
 
   void addCharacterIndex();
   bool hasCharacterIndex() const;
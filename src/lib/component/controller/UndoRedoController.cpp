@@ -1,5 +1,7 @@
 #include "UndoRedoController.h"
 
+#include <algorithm>
+
 #include "Application.h"
 #include "Project.h"
 #include "StorageAccess.h"
@@ -8,7 +10,8 @@
 #include "UndoRedoView.h"
 #include "utility.h"
 
-UndoRedoController::UndoRedoController(StorageAccess* storageAccess) : m_storageAccess(storageAccess) {
+UndoRedoController::UndoRedoController(StorageAccess* storageAccess)
+    : m_storageAccess(storageAccess), m_snapshots(SnapshotByteBudget) {
   m_iterator = m_list.end();
 }
 
@@ -23,6 +26,7 @@ UndoRedoView* UndoRedoController::getView() {
 void UndoRedoController::clear() {
   m_list.clear();
   m_iterator = m_list.begin();
+  m_snapshots.clear();
 
   m_historyOffset = 0;
   m_history.clear();
@@ -34,6 +38,12 @@ void UndoRedoController::clear() {
   getView()->setRedoButtonEnabled(false);
 }
 
+void UndoRedoController::addSnapshotSource(HistorySnapshotSource* source) {
+  if(source != nullptr) {
+    m_snapshotSources.push_back(source);
+  }
+}
+
 UndoRedoController::Command::Command(std::shared_ptr<MessageBase> message_, Order order_, bool replayLastOnly_)
     : message(message_), order(order_), replayLastOnly(replayLastOnly_) {}
 
@@ -178,18 +188,29 @@ void UndoRedoController::handleMessage(MessageHistoryRedo* /*message*/) {
   }
 
   std::list<Command>::iterator oldIterator = m_iterator;
+  std::list<Command>::iterator newIterator = std::next(m_iterator);
+  while(newIterator != m_list.end() && newIterator->order == Command::ORDER_VIEW) {
+    std::advance(newIterator, 1);
+  }
 
-  std::advance(m_iterator, 1);
-  while(m_iterator != m_list.end() && m_iterator->order == Command::ORDER_VIEW) {
-    std::advance(m_iterator, 1);
+  // replaying only the new commands builds on the current state, so it can only be stored if it is not needed
+  const bool restoresSnapshots = hasSnapshots(newIterator);
+  if(restoresSnapshots) {
+    storeSnapshots();
   }
 
+  m_iterator = newIterator;
+
   getView()->setUndoButtonEnabled(true);
   if(m_iterator == m_list.end()) {
     getView()->setRedoButtonEnabled(false);
   }
 
-  replayCommands(oldIterator);
+  if(restoresSnapshots) {
+    replayCommands();
+  } else {
+    replayCommands(oldIterator);
+  }
 
   updateHistory();
 }
@@ -208,6 +229,7 @@ void UndoRedoController::handleMessage(MessageHistoryToPosition* message) {
           std::advance(it, 1);
         } while(it != m_list.end() && it->order != Command::ORDER_ACTIVATE);
 
+        storeSnapshots();
         m_iterator = it;
 
         if(start != m_iterator) {
@@ -263,6 +285,7 @@ void UndoRedoController::handleMessage(MessageHistoryUndo* /*message*/) {
 
   getView()->setRedoButtonEnabled(true);
 
+  storeSnapshots();
   m_iterator = it;
 
   replayCommands();
@@ -289,9 +312,14 @@ void UndoRedoController::handleMessage(MessageIndexingFinished* /*message*/) {
 
   m_list = newList;
   m_iterator = m_list.end();
+
+  // snapshots reference data of the old index
+  m_snapshots.clear();
 }
 
 void UndoRedoController::handleMessage(MessageRefreshUIState* message) {
+  m_snapshots.clear();
+
   std::list<Command>::iterator startIterator = m_iterator;
   do {
     std::advance(startIterator, -1);
@@ -363,6 +391,8 @@ void UndoRedoController::replayCommands() {
 }
 
 void UndoRedoController::replayCommands(std::list<Command>::iterator it) {
+  restoreSnapshots(it);
+
   std::map<std::string, std::list<Command>::iterator> lastOfType;
   std::list<Command>::iterator at = it;
   while(at != m_iterator) {
@@ -458,6 +488,7 @@ void UndoRedoController::processCommand(Command command) {
     }
 
     if(command.order == Command::ORDER_ACTIVATE) {
+      dropSnapshots(m_iterator, m_list.end());
       m_iterator = m_list.erase(m_iterator, m_list.end());
     } else if(command.order == Command::ORDER_ADAPT) {
       std::list<Command>::iterator end = m_iterator;
@@ -468,6 +499,7 @@ void UndoRedoController::processCommand(Command command) {
         std::advance(end, 1);
       }
 
+      dropSnapshots(m_iterator, end);
       m_iterator = m_list.erase(m_iterator, end);
     }
 
@@ -490,6 +522,63 @@ void UndoRedoController::processCommand(Command command) {
   }
 }
 
+void UndoRedoController::storeSnapshots() {
+  if(m_snapshotSources.empty() || m_iterator == m_list.begin()) {
+    return;
+  }
+
+  // a position is only restored with the state of all sources, so none gives up its state unless all can
+  if(!std::ranges::all_of(m_snapshotSources, [](const HistorySnapshotSource* source) { return source->hasSnapshot(); })) {
+    return;
+  }
+
+  Snapshots snapshots;
+  size_t byteSize = 0;
+  for(HistorySnapshotSource* source : m_snapshotSources) {
+    std::shared_ptr<HistorySnapshot> snapshot = source->takeSnapshot();
+    byteSize += snapshot->getByteSize();
+    snapshots.push_back(std::move(snapshot));
+  }
+
+  m_snapshots.setValue(std::prev(m_iterator)->message->getId(), std::move(snapshots), byteSize);
+}
+
+bool UndoRedoController::restoreSnapshots(std::list<Command>::iterator it) {
+  if(m_snapshotSources.empty() || m_iterator == m_list.begin()) {
+    return false;
+  }
+
+  std::optional<Snapshots> snapshots = m_snapshots.takeValue(std::prev(m_iterator)->message->getId());
+  if(!snapshots) {
+    return false;
+  }
+
+  // the replayed commands still reach the other listeners, only view commands that apply last values are redone
+  std::set<Id> restoredMessageIds;
+  for(; it != m_iterator; std::advance(it, 1)) {
+    if(it->order != Command::ORDER_VIEW || !it->replayLastOnly) {
+      restoredMessageIds.insert(it->message->getId());
+    }
+  }
+
+  for(size_t i = 0; i < m_snapshotSources.size(); i++) {
+    m_snapshotSources[i]->restoreSnapshot((*snapshots)[i]);
+    m_snapshotSources[i]->setRestoredMessageIds(restoredMessageIds);
+  }
+
+  return true;
+}
+
+bool UndoRedoController::hasSnapshots(std::list<Command>::iterator position) const {
+  return position != m_list.begin() && m_snapshots.contains(std::prev(position)->message->getId());
+}
+
+void UndoRedoController::dropSnapshots(std::list<Command>::iterator first, std::list<Command>::iterator last) {
+  for(; first != last; std::advance(first, 1)) {
+    m_snapshots.takeValue(first->message->getId());
+  }
+}
+
 bool UndoRedoController::sameMessageTypeAsLast(MessageBase* message) const {
   if(message->isReplayed()) {
     return false;
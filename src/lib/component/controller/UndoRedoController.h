@@ -4,6 +4,8 @@
 #include <list>
 
 #include "Controller.h"
+#include "HistorySnapshotInterfaces.h"
+#include "LruCache.h"
 #include "MessageBase.h"
 #include "MessageListener.h"
 #include "type/activation/MessageActivateErrors.h"
@@ -74,7 +76,16 @@ public:
 
   void clear() override;
 
+  /**
+   * @brief Registers a controller of the same tab whose state is stored with the history positions.
+   */
+  void addSnapshotSource(HistorySnapshotSource* source);
+
 private:
+  using Snapshots = std::vector<std::shared_ptr<HistorySnapshot>>;
+
+  static constexpr size_t SnapshotByteBudget = 128 * 1024 * 1024;
+
   struct Command {
     enum Order { ORDER_ACTIVATE, ORDER_ADAPT, ORDER_VIEW };
 
@@ -118,6 +129,11 @@ private:
 
   void processCommand(Command command);
 
+  void storeSnapshots();
+  bool restoreSnapshots(std::list<Command>::iterator it);
+  bool hasSnapshots(std::list<Command>::iterator position) const;
+  void dropSnapshots(std::list<Command>::iterator first, std::list<Command>::iterator last);
+
   bool sameMessageTypeAsLast(MessageBase* message) const;
   MessageBase* lastMessage() const;
 
@@ -133,6 +149,9 @@ private:
 
   std::vector<std::shared_ptr<MessageBase>> m_history;
   size_t m_historyOffset;
+
+  std::vector<HistorySnapshotSource*> m_snapshotSources;
+  LruCache<Id, Snapshots> m_snapshots;    // keyed by the id of the last command before the position
 };
 
 #endif    // UNDO_REDO_CONTROLLER_H
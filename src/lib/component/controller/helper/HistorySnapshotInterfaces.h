@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <set>
+
+#include "GlobalId.hpp"
+#include "MessageBase.h"
+
+/**
+ * @brief Finished state of a controller at one position of the undo redo history.
+ */
+class HistorySnapshot {
+public:
+  virtual ~HistorySnapshot() = default;
+
+  /**
+   * @brief Approximate memory footprint, charged against the snapshot budget of the history.
+   */
+  [[nodiscard]] virtual size_t getByteSize() const = 0;
+};
+
+/**
+ * @brief Controller whose state can be stored with a history position and restored instead of replaying the messages.
+ *
+ * Snapshots change owner: the source gives up its state in takeSnapshot() and the history hands it back with
+ * restoreSnapshot(), so later in place modifications never reach a stored snapshot.
+ */
+class HistorySnapshotSource {
+public:
+  virtual ~HistorySnapshotSource() = default;
+
+  /**
+   * @brief Whether there is a finished state to store, checked for all sources before any of them gives up its state.
+   */
+  [[nodiscard]] virtual bool hasSnapshot() const = 0;
+
+  /**
+   * @brief Hands over the current state and leaves the source empty. Only called if hasSnapshot() is true.
+   */
+  [[nodiscard]] virtual std::shared_ptr<HistorySnapshot> takeSnapshot() = 0;
+
+  /**
+   * @brief Takes back a snapshot created by takeSnapshot() of the same source.
+   */
+  virtual void restoreSnapshot(std::shared_ptr<HistorySnapshot> snapshot) = 0;
+
+  /**
+   * @brief Marks replayed messages whose effect is already part of the restored snapshot.
+   */
+  void setRestoredMessageIds(std::set<Id> messageIds) {
+    m_restoredMessageIds = std::move(messageIds);
+  }
+
+protected:
+  [[nodiscard]] bool isRestoredMessage(const MessageBase& message) const {
+    return message.isReplayed() && m_restoredMessageIds.contains(message.getId());
+  }
+
+  void clearRestoredMessageIds() {
+    m_restoredMessageIds.clear();
+  }
+
+private:
+  std::set<Id> m_restoredMessageIds;
+};
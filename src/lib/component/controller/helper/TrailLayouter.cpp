@@ -1,9 +1,14 @@
 #include "TrailLayouter.h"
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
+#include <set>
 
 #include <QVector4D>
 
+#include "TimeStamp.h"
+
 TrailLayouter::TrailLayouter(LayoutDirection dir) : m_direction(dir), m_rootNode(nullptr) {}
 
 void TrailLayouter::layoutGraph(std::vector<std::shared_ptr<DummyNode>>& dummyNodes,
@@ -16,7 +21,7 @@ void TrailLayouter::layoutGraph(std::vector<std::shared_ptr<DummyNode>>& dummyNo
   }
 
   removeDeadEnds();
-  makeAcyclicRecursive(m_rootNode, std::set<TrailNode*>());
+  makeAcyclic();
 
   assignLongestPathLevels();
   assignRemainingLevels();
@@ -113,62 +118,91 @@ void TrailLayouter::removeDeadEnds() {
   }
 }
 
-void TrailLayouter::makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors) {
-  predecessors.insert(node);
+void TrailLayouter::makeAcyclic() {
+  // iterative depth first search, every edge back to a node on the current path closes a cycle and gets switched
+  std::set<TrailNode*> visited;
+  std::set<TrailNode*> onPath;
+  std::vector<std::pair<TrailNode*, size_t>> path;
 
-  std::set<TrailEdge*> edgesToSwitch;
-  for(TrailEdge* edge : node->outgoingEdges) {
-    if(predecessors.find(edge->target) != predecessors.end()) {
-      edgesToSwitch.insert(edge);
-    } else {
-      makeAcyclicRecursive(edge->target, predecessors);
+  visited.insert(m_rootNode);
+  onPath.insert(m_rootNode);
+  path.emplace_back(m_rootNode, 0);
+
+  while(path.size()) {
+    TrailNode* node = path.back().first;
+    size_t& edgeIndex = path.back().second;
+
+    if(edgeIndex >= node->outgoingEdges.size()) {
+      onPath.erase(node);
+      path.pop_back();
+      continue;
+    }
+
+    TrailEdge* edge = node->outgoingEdges[edgeIndex];
+    if(onPath.find(edge->target) != onPath.end()) {
+      // removes the edge from the outgoing edges, so the index already points to the next one
+      switchEdge(edge);
+      continue;
     }
-  }
 
-  for(TrailEdge* edge : edgesToSwitch) {
-    switchEdge(edge);
+    edgeIndex++;
+
+    if(visited.insert(edge->target).second) {
+      onPath.insert(edge->target);
+      path.emplace_back(edge->target, 0);
+    }
   }
 }
 
 void TrailLayouter::assignLongestPathLevels() {
-  std::set<TrailNode*> nodes;
-  nodes.insert(m_rootNode);
+  // the graph is acyclic now, so the longest paths from the root are found in a single pass in topological order
+  std::map<TrailNode*, size_t> incomingEdgeCounts;
+  std::vector<TrailNode*> nodes;
+  nodes.push_back(m_rootNode);
+  incomingEdgeCounts.emplace(m_rootNode, 0);
 
+  for(size_t i = 0; i < nodes.size(); i++) {
+    for(TrailEdge* edge : nodes[i]->outgoingEdges) {
+      if(incomingEdgeCounts[edge->target]++ == 0) {
+        nodes.push_back(edge->target);
+      }
+    }
+  }
+
+  std::map<TrailNode*, int> pathLengths;
   std::map<TrailNode*, TrailNode*> predecessorNodes;
 
-  int level = 0;
+  std::vector<TrailNode*> sortedNodes;
+  sortedNodes.push_back(m_rootNode);
+  pathLengths.emplace(m_rootNode, 0);
 
-  while(nodes.size()) {
-    std::set<TrailNode*> newNodes;
+  int maxPathLength = 0;
 
-    for(TrailNode* node : nodes) {
-      for(TrailEdge* edge : node->outgoingEdges) {
-        newNodes.insert(edge->target);
+  for(size_t i = 0; i < sortedNodes.size(); i++) {
+    TrailNode* node = sortedNodes[i];
+    const int pathLength = pathLengths[node];
+
+    for(TrailEdge* edge : node->outgoingEdges) {
+      int& targetPathLength = pathLengths[edge->target];
+      if(pathLength + 1 > targetPathLength) {
+        targetPathLength = pathLength + 1;
         predecessorNodes[edge->target] = node;
+        maxPathLength = std::max(maxPathLength, targetPathLength);
       }
-    }
 
-    if(!newNodes.size()) {
-      break;
+      if(--incomingEdgeCounts[edge->target] == 0) {
+        sortedNodes.push_back(edge->target);
+      }
     }
-
-    nodes = newNodes;
-    level++;
   }
 
-  while(nodes.size()) {
-    std::set<TrailNode*> newNodes;
-
-    for(TrailNode* node : nodes) {
-      node->level = level;
-
-      if(level > 0) {
-        newNodes.insert(predecessorNodes[node]);
+  // only the nodes on the longest paths get their level here
+  for(const auto& [node, pathLength] : pathLengths) {
+    if(pathLength == maxPathLength) {
+      for(TrailNode* pathNode = node; pathNode && pathNode->level < 0; pathNode = predecessorNodes[pathNode]) {
+        pathNode->level = pathLengths[pathNode];
       }
     }
-
-    nodes = newNodes;
-    level--;
   }
 }
 
@@ -237,12 +271,12 @@ void TrailLayouter::addVirtualNodes() {
       virtualEdge->id = 0;
 
       virtualEdge->origin = edge->origin;
-      virtualEdge->origin->outgoingEdges.erase(edge.get());
-      virtualEdge->origin->outgoingEdges.insert(virtualEdge.get());
+      std::vector<TrailEdge*>& originEdges = virtualEdge->origin->outgoingEdges;
+      std::replace(originEdges.begin(), originEdges.end(), edge.get(), virtualEdge.get());
 
       virtualEdge->target = virtualNode.get();
-      virtualEdge->target->incomingEdges.insert(virtualEdge.get());
-      virtualEdge->target->outgoingEdges.insert(edge.get());
+      virtualEdge->target->incomingEdges.push_back(virtualEdge.get());
+      virtualEdge->target->outgoingEdges.push_back(edge.get());
 
       edge->origin = virtualNode.get();
       newEdges.push_back(virtualEdge);
@@ -259,59 +293,129 @@ void TrailLayouter::buildColumns() {
       m_nodesPerCol.push_back(std::vector<TrailNode*>());
     }
 
-    m_nodesPerCol[static_cast<size_t>(level)].push_back(node.get());
+    std::vector<TrailNode*>& nodes = m_nodesPerCol[static_cast<size_t>(level)];
+    node->index = nodes.size();
+    nodes.push_back(node.get());
   }
 }
 
 void TrailLayouter::reduceEdgeCrossings() {
+  // initial sweep along the columns, a column with a single node is no good reference, so its successors are used instead
   for(size_t i = 1; i < m_nodesPerCol.size(); i++) {
-    std::vector<TrailNode*> nodes = m_nodesPerCol[i];
+    const bool usePredecessors = !(m_nodesPerCol[i - 1].size() == 1 && i + 1 < m_nodesPerCol.size() &&
+                                   m_nodesPerCol[i + 1].size() > 0);
+    orderColumnByBarycenters(i, usePredecessors);
+  }
+
+  size_t minCrossings = countEdgeCrossings();
+  std::vector<std::vector<TrailNode*>> bestNodesPerCol = m_nodesPerCol;
+
+  // further sweeps alternate between both directions, bounded in count and time for large trails
+  const TimeStamp start = TimeStamp::now();
+  size_t sweepsWithoutImprovement = 0;
+  for(size_t sweep = 0; sweep < MaxCrossingReductionSweeps && minCrossings > 0 && sweepsWithoutImprovement < 2; sweep++) {
+    if(TimeStamp::now().deltaMS(start) > CrossingReductionBudgetMS) {
+      break;
+    }
 
-    bool usePredecessors = true;
-    std::vector<TrailNode*> neighbors = m_nodesPerCol[i - 1];
-    if(neighbors.size() == 1 && i + 1 < m_nodesPerCol.size() && m_nodesPerCol[i + 1].size() > 0) {
-      neighbors = m_nodesPerCol[i + 1];
-      usePredecessors = false;
+    if(sweep % 2 == 0) {
+      for(size_t i = m_nodesPerCol.size() - 1; i > 1; i--) {
+        orderColumnByBarycenters(i - 1, false);
+      }
+    } else {
+      for(size_t i = 1; i < m_nodesPerCol.size(); i++) {
+        orderColumnByBarycenters(i, true);
+      }
     }
 
-    std::map<TrailNode*, size_t> neighborIndices;
-    for(size_t j = 0; j < neighbors.size(); j++) {
-      neighborIndices.emplace(neighbors[j], j);
+    const size_t crossings = countEdgeCrossings();
+    if(crossings < minCrossings) {
+      minCrossings = crossings;
+      bestNodesPerCol = m_nodesPerCol;
+      sweepsWithoutImprovement = 0;
+    } else {
+      sweepsWithoutImprovement++;
     }
+  }
 
-    std::multimap<float, TrailNode*> newOrder;
+  m_nodesPerCol = bestNodesPerCol;
+}
 
-    for(size_t j = 0; j < nodes.size(); j++) {
-      TrailNode* node = nodes[j];
+void TrailLayouter::orderColumnByBarycenters(size_t col, bool usePredecessors) {
+  std::vector<TrailNode*>& nodes = m_nodesPerCol[col];
 
-      size_t sum = 0;
-      size_t count = 0;
+  std::vector<std::pair<float, TrailNode*>> newOrder;
+  newOrder.reserve(nodes.size());
 
-      if(usePredecessors) {
-        for(TrailEdge* edge : node->incomingEdges) {
-          sum += neighborIndices[edge->origin];
-          count++;
-        }
-      } else {
-        for(TrailEdge* edge : node->outgoingEdges) {
-          sum += neighborIndices[edge->target];
-          count++;
-        }
-      }
+  for(TrailNode* node : nodes) {
+    size_t sum = 0;
+    size_t count = 0;
+
+    for(TrailEdge* edge : usePredecessors ? node->incomingEdges : node->outgoingEdges) {
+      sum += usePredecessors ? edge->origin->index : edge->target->index;
+      count++;
+    }
+
+    float value = static_cast<float>(node->index);
+    if(count) {
+      value = static_cast<float>(sum) / static_cast<float>(count);
+    }
+    newOrder.emplace_back(value, node);
+  }
 
-      float value = float(j);
-      if(count) {
-        value = float(sum) / static_cast<float>(count);
+  std::stable_sort(newOrder.begin(), newOrder.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  for(size_t i = 0; i < newOrder.size(); i++) {
+    nodes[i] = newOrder[i].second;
+    nodes[i]->index = i;
+  }
+}
+
+size_t TrailLayouter::countEdgeCrossings() const {
+  size_t crossings = 0;
+  for(size_t i = 0; i + 1 < m_nodesPerCol.size(); i++) {
+    crossings += countEdgeCrossings(i);
+  }
+  return crossings;
+}
+
+size_t TrailLayouter::countEdgeCrossings(size_t col) const {
+  const int level = static_cast<int>(col) - 1;
+
+  std::vector<std::pair<size_t, size_t>> edgeIndices;
+  for(TrailNode* node : m_nodesPerCol[col]) {
+    for(TrailEdge* edge : node->outgoingEdges) {
+      if(edge->target->level == level + 1) {
+        edgeIndices.emplace_back(node->index, edge->target->index);
+      }
+    }
+    for(TrailEdge* edge : node->incomingEdges) {
+      if(edge->origin->level == level + 1) {
+        edgeIndices.emplace_back(node->index, edge->origin->index);
       }
-      newOrder.emplace(value, node);
     }
+  }
+
+  // two edges cross if their order differs between both columns, counted as inversions with a binary indexed tree
+  std::sort(edgeIndices.begin(), edgeIndices.end());
 
-    nodes.clear();
-    for(std::pair<float, TrailNode*> p : newOrder) {
-      nodes.push_back(p.second);
+  const size_t targetCount = m_nodesPerCol[col + 1].size();
+  std::vector<size_t> tree(targetCount + 1, 0);
+
+  size_t crossings = 0;
+  for(size_t i = 0; i < edgeIndices.size(); i++) {
+    size_t notGreaterCount = 0;
+    for(size_t j = edgeIndices[i].second + 1; j > 0; j -= j & (~j + 1)) {
+      notGreaterCount += tree[j];
+    }
+    crossings += i - notGreaterCount;
+
+    for(size_t j = edgeIndices[i].second + 1; j <= targetCount; j += j & (~j + 1)) {
+      tree[j]++;
     }
-    m_nodesPerCol[i] = nodes;
   }
+
+  return crossings;
 }
 
 void TrailLayouter::layout() {
@@ -385,7 +489,7 @@ void TrailLayouter::layout() {
   // put into grid
 }
 
-void TrailLayouter::moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bool forward) {
+void TrailLayouter::moveNodesToAveragePosition(const std::vector<TrailNode*>& nodes, bool forward) {
   unsigned int yIdx = horizontalLayout() ? 1 : 0;
 
   std::map<int, std::vector<TrailNode*>> averagePositions;
@@ -524,6 +628,7 @@ void TrailLayouter::addNode(const std::shared_ptr<DummyNode>& dummyNode) {
   node->name = dummyNode->name;
   node->dummyNode = dummyNode.get();
   node->level = -1;
+  node->index = 0;
 
   node->size = dummyNode->size;
 
@@ -563,27 +668,29 @@ void TrailLayouter::addEdge(const std::shared_ptr<DummyEdge> dummyEdge, const st
   edge->origin = origin->second;
   edge->target = target->second;
 
-  for(std::shared_ptr<TrailEdge>& e : m_allEdges) {
-    if((e->origin == edge->origin && e->target == edge->target) || (e->origin == edge->target && e->target == edge->origin)) {
-      e->dummyEdges.push_back(dummyEdge.get());
-      return;
-    }
+  // edges in both directions between the same nodes share one trail edge
+  const std::pair<TrailNode*, TrailNode*> nodes = std::minmax(edge->origin, edge->target);
+  auto it = m_edgesByNodes.find(nodes);
+  if(it != m_edgesByNodes.end()) {
+    it->second->dummyEdges.push_back(dummyEdge.get());
+    return;
   }
+  m_edgesByNodes.emplace(nodes, edge.get());
 
   edge->dummyEdges.push_back(dummyEdge.get());
 
-  edge->origin->outgoingEdges.insert(edge.get());
-  edge->target->incomingEdges.insert(edge.get());
+  edge->origin->outgoingEdges.push_back(edge.get());
+  edge->target->incomingEdges.push_back(edge.get());
 
   m_allEdges.push_back(edge);
 }
 
 void TrailLayouter::switchEdge(TrailEdge* edge) {
-  edge->origin->outgoingEdges.erase(edge);
-  edge->origin->incomingEdges.insert(edge);
+  std::erase(edge->origin->outgoingEdges, edge);
+  edge->origin->incomingEdges.push_back(edge);
 
-  edge->target->incomingEdges.erase(edge);
-  edge->target->outgoingEdges.insert(edge);
+  std::erase(edge->target->incomingEdges, edge);
+  edge->target->outgoingEdges.push_back(edge);
 
   std::swap(edge->origin, edge->target);
 }
@@ -2,7 +2,6 @@
 #define GRAPH_LAYOUTER_H
 
 #include <map>
-#include <set>
 #include <vector>
 
 #include <QVector2D>
@@ -33,8 +32,11 @@ private:
     QVector2D pos;
     QVector2D size;
 
-    std::set<TrailEdge*> incomingEdges;
-    std::set<TrailEdge*> outgoingEdges;
+    std::vector<TrailEdge*> incomingEdges;
+    std::vector<TrailEdge*> outgoingEdges;
+
+    // position within its column, kept up to date while reducing edge crossings
+    size_t index;
 
     DummyNode* dummyNode;
   };
@@ -54,7 +56,7 @@ private:
                   const std::map<Id, Id>& topLevelAncestorIds);
 
   void removeDeadEnds();
-  void makeAcyclicRecursive(TrailNode* node, std::set<TrailNode*> predecessors);
+  void makeAcyclic();
 
   void assignLongestPathLevels();
   void assignRemainingLevels();
@@ -62,9 +64,12 @@ private:
   void addVirtualNodes();
   void buildColumns();
   void reduceEdgeCrossings();
+  void orderColumnByBarycenters(size_t col, bool usePredecessors);
+  size_t countEdgeCrossings() const;
+  size_t countEdgeCrossings(size_t col) const;
 
   void layout();
-  void moveNodesToAveragePosition(std::vector<TrailNode*> nodes, bool forward);
+  void moveNodesToAveragePosition(const std::vector<TrailNode*>& nodes, bool forward);
   void retrievePositions(const std::map<Id, Id>& topLevelAncestorIds);
 
   void print();
@@ -76,12 +81,17 @@ private:
   bool horizontalLayout() const;
   bool invertedLayout() const;
 
+  // barycenter sweeps stop early once they no longer reduce the crossings
+  static constexpr size_t MaxCrossingReductionSweeps = 24;
+  static constexpr size_t CrossingReductionBudgetMS = 100;
+
   LayoutDirection m_direction;
 
   std::vector<std::shared_ptr<TrailNode>> m_allNodes;
   std::vector<std::shared_ptr<TrailEdge>> m_allEdges;
 
   std::map<Id, TrailNode*> m_nodesById;
+  std::map<std::pair<TrailNode*, TrailNode*>, TrailEdge*> m_edgesByNodes;
   TrailNode* m_rootNode;
 
   std::vector<std::vector<TrailNode*>> m_nodesPerCol;
@@ -39,6 +39,8 @@ void DialogView::updateIndexingDialog(size_t /*startedFileCount*/,
                                       size_t /*totalFileCount*/,
                                       const std::vector<FilePath>& /*sourcePaths*/) {}
 
+void DialogView::updateIndexingMemoryUsage(size_t /*usedMemory*/, size_t /*memoryBudget*/) {}
+
 void DialogView::updateCustomIndexingDialog(size_t /*startedFileCount*/,
                                             size_t /*finishedFileCount*/,
                                             size_t /*totalFileCount*/,
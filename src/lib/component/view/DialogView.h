@@ -43,6 +43,7 @@ public:
                                     size_t finishedFileCount,
                                     size_t totalFileCount,
                                     const std::vector<FilePath>& sourcePaths);
+  virtual void updateIndexingMemoryUsage(size_t usedMemory, size_t memoryBudget);
   virtual void updateCustomIndexingDialog(size_t startedFileCount,
                                           size_t finishedFileCount,
                                           size_t totalFileCount,
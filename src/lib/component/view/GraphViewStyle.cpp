@@ -12,6 +12,7 @@ int GraphViewStyle::s_gridCellPadding = 10;
 
 std::map<NodeType::StyleType, float> GraphViewStyle::s_charWidths;
 std::map<NodeType::StyleType, float> GraphViewStyle::s_charHeights;
+std::mutex GraphViewStyle::s_charSizeMutex;
 
 std::shared_ptr<GraphViewStyleImpl> GraphViewStyle::s_impl;
 
@@ -104,8 +105,11 @@ void GraphViewStyle::loadStyleSettings() {
   const float zoomDifference = getImpl()->getGraphViewZoomDifferenceForPlatform();
   s_zoomFactor = float(IApplicationSettings::getInstanceRaw()->getFontSize()) / float(s_fontSize) * zoomDifference;
 
-  s_charWidths.clear();
-  s_charHeights.clear();
+  {
+    const std::lock_guard<std::mutex> lock(s_charSizeMutex);
+    s_charWidths.clear();
+    s_charHeights.clear();
+  }
 
   s_focusColor.clear();
   s_nodeColors.clear();
@@ -709,31 +713,37 @@ const GraphViewStyle::NodeColor& GraphViewStyle::getScreenMatchColor(bool focus)
 }
 
 float GraphViewStyle::getCharWidth(NodeType::StyleType type) {
+  const std::lock_guard<std::mutex> lock(s_charSizeMutex);
+
   auto iterator = s_charWidths.find(type);
   if(iterator != s_charWidths.end()) {
     return iterator->second;
   }
 
-  float charWidth = getCharWidth(getFontNameForDataNode(), getFontSizeForStyleType(type));
+  float charWidth = getImpl()->getCharWidth(getFontNameForDataNode(), getFontSizeForStyleType(type));
   s_charWidths.emplace(type, charWidth);
   return charWidth;
 }
 
 float GraphViewStyle::getCharHeight(NodeType::StyleType type) {
+  const std::lock_guard<std::mutex> lock(s_charSizeMutex);
+
   auto iterator = s_charHeights.find(type);
   if(iterator != s_charHeights.end()) {
     return iterator->second;
   }
 
-  float charHeight = getCharHeight(getFontNameForDataNode(), getFontSizeForStyleType(type));
+  float charHeight = getImpl()->getCharHeight(getFontNameForDataNode(), getFontSizeForStyleType(type));
   s_charHeights.emplace(type, charHeight);
   return charHeight;
 }
 
 float GraphViewStyle::getCharWidth(const std::string& fontName, size_t fontSize) {
+  const std::lock_guard<std::mutex> lock(s_charSizeMutex);
   return getImpl()->getCharWidth(fontName, fontSize);
 }
 
 float GraphViewStyle::getCharHeight(const std::string& fontName, size_t fontSize) {
+  const std::lock_guard<std::mutex> lock(s_charSizeMutex);
   return getImpl()->getCharHeight(fontName, fontSize);
 }
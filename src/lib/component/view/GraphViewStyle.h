@@ -2,6 +2,7 @@
 // STL
 #include <map>
 #include <memory>
+#include <mutex>
 
 #include <QVector2D>
 
@@ -165,6 +166,7 @@ private:
 
   static std::map<NodeType::StyleType, float> s_charWidths;
   static std::map<NodeType::StyleType, float> s_charHeights;
+  static std::mutex s_charSizeMutex;    // the graph controller measures nodes on several threads
 
   static std::shared_ptr<GraphViewStyleImpl> s_impl;
 
@@ -9,6 +9,9 @@
 class SourceLocationFile;
 
 struct CodeSnippetParams {
+  // Whole files with more lines are virtualized: the view only receives source locations for the lines on screen.
+  static constexpr size_t VirtualizedLineCount = 5000;
+
   static CodeSnippetParams merge(const CodeSnippetParams& a, const CodeSnippetParams& b);
 
   size_t startLineNumber = 0;
@@ -23,6 +26,7 @@ struct CodeSnippetParams {
 
   std::shared_ptr<SourceLocationFile> locationFile;
   bool hasAllSourceLocations = false;
+  bool isVirtualized = false;
   bool isOverview = false;
 };
 
@@ -2,6 +2,7 @@
 
 #include <utility>
 
+#include "Profiler.h"
 #include "Storage.h"
 #include "StorageProvider.h"
 
@@ -16,6 +17,8 @@ Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> /*blackb
       const auto source = std::move(result.value());
       // TODO(Hussein): What happen if lock failed but provider is consumed?!
       if(const auto target = m_target.lock()) {
+        Profiler::Span span("storage", "inject storage");
+        span.setArgument("source locations", static_cast<int64_t>(source->getSourceLocationCount()));
         target->inject(source.get());
         return STATE_SUCCESS;
       }
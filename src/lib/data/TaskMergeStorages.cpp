@@ -1,36 +1,30 @@
 #include "TaskMergeStorages.h"
 
+#include <algorithm>
 #include <utility>
 
+#include "Profiler.h"
 #include "StorageProvider.h"
 
-TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider)
-    : m_storageProvider(std::move(storageProvider)) {}
+TaskMergeStorages::TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t maxMergeCount)
+    : m_storageProvider(std::move(storageProvider)), m_maxMergeCount(std::max<size_t>(2, maxMergeCount)) {}
 
 void TaskMergeStorages::doEnter(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
 Task::TaskState TaskMergeStorages::doUpdate(std::shared_ptr<Blackboard> /*blackboard*/) {
   if(m_storageProvider->getStorageCount() > 2)    // largest storage won't be touched here
   {
-    std::shared_ptr<IntermediateStorage> target;
-    if(auto result = m_storageProvider->consumeSecondLargestStorage()) {
-      target = result.value();
-    }
-    std::shared_ptr<IntermediateStorage> source;
-    if(auto result = m_storageProvider->consumeSecondLargestStorage()) {
-      source = result.value();
-    }
-    if(target && source) {
-      target->inject(source.get());
-      m_storageProvider->insert(target);
+    std::vector<std::shared_ptr<IntermediateStorage>> storages = m_storageProvider->consumeStoragesToMerge(m_maxMergeCount);
+    if(storages.size() > 1) {
+      Profiler::Span span("storage", "merge storages");
+      span.setArgument("storages", static_cast<int64_t>(storages.size()));
+      m_storageProvider->insert(StorageProvider::merge(std::move(storages)));
       return STATE_SUCCESS;
-    } else {
-      if(target) {
-        m_storageProvider->insert(target);
-      }
-      if(source) {
-        m_storageProvider->insert(source);
-      }
+    }
+
+    // another merge thread was faster
+    for(auto& storage : storages) {
+      m_storageProvider->insert(std::move(storage));
     }
   }
 
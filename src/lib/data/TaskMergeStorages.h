@@ -1,6 +1,7 @@
 #ifndef TASK_MERGE_STORAGES_H
 #define TASK_MERGE_STORAGES_H
 
+#include <memory>
 #include <vector>
 
 #include "../../scheduling/Task.h"
@@ -9,7 +10,11 @@ class StorageProvider;
 
 class TaskMergeStorages : public Task {
 public:
-  TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider);
+  /**
+   * @param maxMergeCount Maximum number of storages that are merged in one pass, see
+   * IApplicationSettings::getStorageMergeCount.
+   */
+  TaskMergeStorages(std::shared_ptr<StorageProvider> storageProvider, size_t maxMergeCount);
 
 private:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -18,6 +23,7 @@ private:
   void doReset(std::shared_ptr<Blackboard> blackboard) override;
 
   std::shared_ptr<StorageProvider> m_storageProvider;
+  const size_t m_maxMergeCount;
 };
 
 #endif    // TASK_MERGE_STORAGES_H
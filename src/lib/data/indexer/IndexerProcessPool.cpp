@@ -0,0 +1,250 @@
+#include "IndexerProcessPool.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <fmt/format.h>
+
+#include "AppPath.h"
+#include "logging.h"
+#include "UserPaths.h"
+#include "utilityApp.h"
+#include "utilityString.h"
+
+namespace {
+constexpr auto ShutdownTimeout = std::chrono::seconds(3);
+constexpr auto ShutdownPollInterval = std::chrono::milliseconds(50);
+constexpr auto QuickFailureDuration = std::chrono::seconds(1);
+constexpr int MaxQuickFailureCount = 3;
+}    // namespace
+
+std::shared_ptr<IndexerProcessPool> IndexerProcessPool::sInstance;
+std::mutex IndexerProcessPool::sInstanceMutex;
+
+std::shared_ptr<IndexerProcessPool> IndexerProcessPool::getInstance(const std::string& appUUID) {
+  std::shared_ptr<IndexerProcessPool> instance;
+  std::shared_ptr<IndexerProcessPool> previousInstance;
+  {
+    const std::lock_guard<std::mutex> lock(sInstanceMutex);
+    // the processes of a pool share memory named after its appUUID, so they cannot join batches of another one
+    if(sInstance && sInstance->mAppUUID != appUUID) {
+      std::swap(previousInstance, sInstance);
+    }
+    if(!sInstance) {
+      sInstance = std::make_shared<IndexerProcessPool>(appUUID);
+    }
+    instance = sInstance;
+  }
+
+  if(previousInstance) {
+    previousInstance->shutdown();
+  }
+  return instance;
+}
+
+void IndexerProcessPool::destroyInstance() {
+  std::shared_ptr<IndexerProcessPool> instance;
+  {
+    const std::lock_guard<std::mutex> lock(sInstanceMutex);
+    std::swap(instance, sInstance);
+  }
+
+  if(instance) {
+    instance->shutdown();
+  }
+}
+
+IndexerProcessPool::IndexerProcessPool(std::string appUUID)
+    : mAppUUID(std::move(appUUID)), mInterprocessIndexerControlManager(mAppUUID, 0, true) {}
+
+IndexerProcessPool::~IndexerProcessPool() {
+  shutdown();
+}
+
+Id IndexerProcessPool::openBatch(size_t workerCount) {
+  if(!AppPath::getCxxIndexerFilePath().exists()) {
+    LOG_ERROR(fmt::format(L"Cannot start indexer process because executable is missing at \"{}\"",
+                          AppPath::getCxxIndexerFilePath().wstr()));
+    return 0;
+  }
+
+  const std::lock_guard<std::mutex> lock(mWorkersMutex);
+  if(mShutdown) {
+    return 0;
+  }
+
+  const Id batchId = mInterprocessIndexerControlManager.openBatch(workerCount);
+  mBatchWorkerCount = workerCount;
+
+  if(mWorkers.size() < workerCount) {
+    mWorkers.resize(workerCount);
+  }
+
+  for(size_t index = 0; index < workerCount; ++index) {
+    Worker& worker = mWorkers[index];
+    if(!worker.running) {
+      worker.running = true;
+      worker.startRequested = true;
+    }
+
+    if(!worker.thread) {
+      worker.thread = std::make_unique<std::thread>(&IndexerProcessPool::superviseWorker, this, static_cast<Id>(index + 1));
+    }
+  }
+
+  mWorkersCondition.notify_all();
+
+  LOG_INFO(fmt::format("opened indexing batch {} for {} persistent indexer processes", batchId, workerCount));
+  return batchId;
+}
+
+void IndexerProcessPool::closeBatch() {
+  mInterprocessIndexerControlManager.closeBatch();
+}
+
+bool IndexerProcessPool::isBatchFinished(Id batchId) {
+  const std::lock_guard<std::mutex> lock(mWorkersMutex);
+
+  for(size_t index = 0; index < mBatchWorkerCount && index < mWorkers.size(); ++index) {
+    if(mWorkers[index].running && mInterprocessIndexerControlManager.getFinishedBatchId(static_cast<Id>(index + 1)) < batchId) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool IndexerProcessPool::hasRunningWorkers() {
+  const std::lock_guard<std::mutex> lock(mWorkersMutex);
+
+  for(size_t index = 0; index < mBatchWorkerCount && index < mWorkers.size(); ++index) {
+    if(mWorkers[index].running) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void IndexerProcessPool::abortBatch() {
+  LOG_WARNING("aborting the indexing batch, killing persistent indexer processes");
+
+  {
+    // the supervising threads do not restart the killed processes of an aborted batch
+    const std::lock_guard<std::mutex> lock(mWorkersMutex);
+    mAbortedBatchId = mInterprocessIndexerControlManager.getBatchId();
+  }
+  mInterprocessIndexerControlManager.closeBatch();
+  killWorkers();
+}
+
+void IndexerProcessPool::shutdown() {
+  {
+    const std::lock_guard<std::mutex> lock(mWorkersMutex);
+    if(mShutdown) {
+      return;
+    }
+    mShutdown = true;
+  }
+
+  LOG_INFO("shutting down persistent indexer processes");
+
+  mInterprocessIndexerControlManager.requestShutdown();
+  mWorkersCondition.notify_all();
+
+  const auto start = std::chrono::steady_clock::now();
+  while(std::chrono::steady_clock::now() - start < ShutdownTimeout) {
+    {
+      const std::lock_guard<std::mutex> lock(mWorkersMutex);
+      if(std::ranges::none_of(mWorkers, [](const Worker& worker) { return worker.running; })) {
+        break;
+      }
+    }
+    std::this_thread::sleep_for(ShutdownPollInterval);
+  }
+
+  bool workersRunning = false;
+  {
+    const std::lock_guard<std::mutex> lock(mWorkersMutex);
+    workersRunning = std::ranges::any_of(mWorkers, [](const Worker& worker) { return worker.running; });
+  }
+  if(workersRunning) {
+    LOG_WARNING("persistent indexer processes did not shut down in time, killing them");
+    killWorkers();
+  }
+
+  for(Worker& worker : mWorkers) {
+    if(worker.thread) {
+      worker.thread->join();
+      worker.thread.reset();
+    }
+  }
+}
+
+void IndexerProcessPool::superviseWorker(Id processId) {
+  const std::vector<std::wstring> commandArguments = getCommandArguments(processId);
+
+  int quickFailureCount = 0;
+
+  std::unique_lock<std::mutex> lock(mWorkersMutex);
+  while(true) {
+    mWorkersCondition.wait(lock, [&]() { return mShutdown || mWorkers[processId - 1].startRequested; });
+    if(mShutdown) {
+      break;
+    }
+    mWorkers[processId - 1].startRequested = false;
+
+    lock.unlock();
+    const auto start = std::chrono::steady_clock::now();
+    const int result =
+        utility::executeProcess(AppPath::getCxxIndexerFilePath().wstr(), commandArguments, FilePath(), false, -1).exitCode;
+    const bool quickFailure = result != 0 && std::chrono::steady_clock::now() - start < QuickFailureDuration;
+    lock.lock();
+
+    LOG_INFO(fmt::format("Persistent indexer process {} returned with {}", processId, result));
+
+    quickFailureCount = quickFailure ? quickFailureCount + 1 : 0;
+    if(mShutdown) {
+      break;
+    }
+
+    if(quickFailureCount < MaxQuickFailureCount && needsRestart(processId)) {
+      // a crashed process leaves its translation unit in the status memory, the restarted process continues with the batch
+      LOG_WARNING(fmt::format("Restarting persistent indexer process {}", processId));
+      mWorkers[processId - 1].startRequested = true;
+      continue;
+    }
+
+    mWorkers[processId - 1].running = false;
+  }
+
+  mWorkers[processId - 1].running = false;
+}
+
+bool IndexerProcessPool::needsRestart(Id processId) {
+  // a closed batch may still have queued commands, only an aborted one is given up
+  const Id batchId = mInterprocessIndexerControlManager.getBatchId();
+  return processId <= mBatchWorkerCount && batchId != mAbortedBatchId &&
+      mInterprocessIndexerControlManager.getFinishedBatchId(processId) < batchId;
+}
+
+std::vector<std::wstring> IndexerProcessPool::getCommandArguments(Id processId) const {
+  return {std::to_wstring(processId),
+          utility::decodeFromUtf8(mAppUUID),
+          AppPath::getSharedDataDirectoryPath().getAbsolute().wstr(),
+          UserPaths::getUserDataDirectoryPath().getAbsolute().wstr(),
+          L"--persistent"};
+}
+
+void IndexerProcessPool::killWorkers() {
+  size_t workerCount = 0;
+  {
+    const std::lock_guard<std::mutex> lock(mWorkersMutex);
+    workerCount = mWorkers.size();
+  }
+
+  // other processes of the application, e.g. those of a custom command, keep running
+  for(size_t index = 0; index < workerCount; ++index) {
+    utility::killRunningProcesses(getCommandArguments(static_cast<Id>(index + 1)));
+  }
+}
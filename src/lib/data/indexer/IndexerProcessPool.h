@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InterprocessIndexerControlManager.h"
+
+/**
+ * @brief Keeps persistent indexer processes alive between indexing runs of the application.
+ *
+ * Every worker is supervised by a thread that (re)starts the indexer process in persistent mode whenever a batch needs it. An
+ * indexing run opens a batch, closes it once all commands are queued and waits until every worker is done with it.
+ */
+class IndexerProcessPool final {
+public:
+  // replaces a pool that was created for another appUUID
+  static std::shared_ptr<IndexerProcessPool> getInstance(const std::string& appUUID);
+  static void destroyInstance();
+
+  explicit IndexerProcessPool(std::string appUUID);
+  ~IndexerProcessPool();
+
+  IndexerProcessPool(const IndexerProcessPool&) = delete;
+  IndexerProcessPool(IndexerProcessPool&&) = delete;
+  IndexerProcessPool& operator=(const IndexerProcessPool&) = delete;
+  IndexerProcessPool& operator=(IndexerProcessPool&&) = delete;
+
+  // returns 0 if the indexer processes cannot be started
+  Id openBatch(size_t workerCount);
+  void closeBatch();
+  bool isBatchFinished(Id batchId);
+  // false once no process of the batch is alive or about to be restarted
+  bool hasRunningWorkers();
+  // closes the batch and kills the processes of this pool, e.g. if they do not finish in time
+  void abortBatch();
+
+  void shutdown();
+
+private:
+  struct Worker {
+    std::unique_ptr<std::thread> thread;
+    bool running = false;
+    bool startRequested = false;
+  };
+
+  void superviseWorker(Id processId);
+  bool needsRestart(Id processId);
+  std::vector<std::wstring> getCommandArguments(Id processId) const;
+  void killWorkers();
+
+  static std::shared_ptr<IndexerProcessPool> sInstance;
+  static std::mutex sInstanceMutex;
+
+  const std::string mAppUUID;
+  InterprocessIndexerControlManager mInterprocessIndexerControlManager;
+
+  std::mutex mWorkersMutex;
+  std::condition_variable mWorkersCondition;
+  std::vector<Worker> mWorkers;
+  size_t mBatchWorkerCount = 0;
+  Id mAbortedBatchId = 0;
+  bool mShutdown = false;
+};
@@ -5,8 +5,10 @@
 #include "AppPath.h"
 #include "Blackboard.h"
 #include "DialogView.h"
+#include "IndexerProcessPool.h"
 #include "InterprocessIndexer.h"
 #include "ParserClientImpl.h"
+#include "Profiler.h"
 #include "StorageProvider.h"
 #include "TimeStamp.h"
 #include "type/indexing/MessageIndexingStatus.h"
@@ -17,24 +19,34 @@ namespace {
 constexpr auto DelayTimeBeforeFinishUpdateInMs = 50;
 constexpr auto DelayTimeBeforeStatrWorkInMs = 200;
 constexpr auto DelayTimeInMs = 100;
+// persistent indexer processes that have not finished the batch by then are considered hung
+constexpr auto BatchFinishTimeout = std::chrono::seconds(30);
 constexpr auto MaxProcessTimeInMs = 500;
 constexpr int MaxStorageCount = 10;
+constexpr size_t OneMb = 1048576;
 }    // namespace
 
 TaskBuildIndex::TaskBuildIndex(size_t processCount,
                                std::shared_ptr<StorageProvider> storageProvider,
                                std::shared_ptr<DialogView> dialogView,
                                std::string appUUID,
-                               bool multiProcessIndexing)
+                               bool multiProcessIndexing,
+                               size_t memoryBudget,
+                               std::shared_ptr<IndexerProcessPool> processPool)
     : mStorageProvider(std::move(storageProvider))
     , mDialogView(std::move(dialogView))
     , mAppUUID(std::move(appUUID))
     , mMultiProcessIndexing(multiProcessIndexing)
+    , mMemoryBudget(memoryBudget)
+    , mProcessPool(std::move(processPool))
     , mInterprocessIndexingStatusManager(mAppUUID, 0, true)
     , mProcessCount(processCount) {}
 
 void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard) {
   mInterprocessIndexingStatusManager.setIndexingInterrupted(false);
+  mInterprocessIndexingStatusManager.setMemoryBudget(mMemoryBudget);
+  mReportedMemoryUsageMb = 0;
+  updateMemoryUsage();
 
   mIndexingFileCount = 0;
   updateIndexingDialog(blackboard, std::vector<FilePath>());
@@ -48,16 +60,20 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard) {
 
   // start indexer processes
   for(size_t index = 0; index < mProcessCount; ++index) {
-    {
-      const std::lock_guard<std::mutex> lock(mRunningThreadCountMutex);
-      ++mRunningThreadCount;
-    }
-
     const size_t processId = index + 1;    // 0 remains reserved for the main process
 
     mInterprocessIntermediateStorageManagers.push_back(
         std::make_shared<InterprocessIntermediateStorageManager>(mAppUUID, processId, true));
 
+    if(mProcessPool) {
+      continue;    // persistent processes join the batch opened below
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(mRunningThreadCountMutex);
+      ++mRunningThreadCount;
+    }
+
     if(mMultiProcessIndexing) {
       mProcessThreads.push_back(
           std::make_unique<std::thread>(&TaskBuildIndex::runIndexerProcess, this, processId, std::wstring{} /*logFilePath*/));
@@ -66,24 +82,31 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard) {
     }
   }
 
+  if(mProcessPool) {
+    mBatchId = mProcessPool->openBatch(mProcessCount);
+    if(mBatchId == 0) {
+      mInterrupted = true;
+    }
+  }
+
   blackboard->set<bool>("indexer_threads_started", true);
 }
 
 Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard) {
-  size_t runningThreadCount = 0;
-  {
-    const std::lock_guard<std::mutex> lock(mRunningThreadCountMutex);
-    runningThreadCount = mRunningThreadCount;
+  blackboard->get<bool>("indexer_command_queue_stopped", mIndexerCommandQueueStopped);
+
+  if(mProcessPool && mIndexerCommandQueueStopped) {
+    mProcessPool->closeBatch();
   }
 
-  blackboard->get<bool>("indexer_command_queue_stopped", mIndexerCommandQueueStopped);
+  const bool indexersRunning = hasRunningIndexers();
 
   const std::vector<FilePath> indexingFiles = mInterprocessIndexingStatusManager.getCurrentlyIndexedSourceFilePaths();
   if(!indexingFiles.empty()) {
     updateIndexingDialog(blackboard, indexingFiles);
   }
 
-  if(mIndexerCommandQueueStopped && runningThreadCount == 0) {
+  if(mIndexerCommandQueueStopped && !indexersRunning) {
     LOG_INFO("command queue stopped and no running threads. done.");
     return STATE_SUCCESS;
   } else if(mInterrupted) {
@@ -96,6 +119,8 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
     updateIndexingDialog(blackboard, std::vector<FilePath>());
   }
 
+  updateMemoryUsage();
+
   std::this_thread::sleep_for(std::chrono::milliseconds(DelayTimeBeforeFinishUpdateInMs));
 
   return STATE_RUNNING;
@@ -108,6 +133,21 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard) {
   }
   mProcessThreads.clear();
 
+  if(mProcessPool && mBatchId != 0) {
+    mProcessPool->closeBatch();
+
+    const auto deadline = std::chrono::steady_clock::now() + BatchFinishTimeout;
+    while(!mProcessPool->isBatchFinished(mBatchId)) {
+      if(!mProcessPool->hasRunningWorkers() || std::chrono::steady_clock::now() > deadline) {
+        // the files the processes are still working on remain in the status memory and are reported as crashed below
+        LOG_WARNING(fmt::format("persistent indexer processes did not finish batch {} in time", mBatchId));
+        mProcessPool->abortBatch();
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(DelayTimeBeforeFinishUpdateInMs));
+    }
+  }
+
   if(!mInterrupted) {
     while(fetchIntermediateStorages(blackboard)) {}
   }
@@ -134,6 +174,8 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard) {
     mStorageProvider->insert(storage);
   }
 
+  mInterprocessIndexingStatusManager.clearProcessMemoryUsage();
+
   blackboard->set<bool>("indexer_threads_stopped", true);
 }
 
@@ -141,6 +183,9 @@ void TaskBuildIndex::doReset(std::shared_ptr<Blackboard> /*blackboard*/) {}
 
 void TaskBuildIndex::terminate() {
   mInterrupted = true;
+  if(mProcessPool) {
+    mProcessPool->abortBatch();
+  }
   utility::killRunningProcesses();
 }
 
@@ -186,7 +231,7 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
 
 void TaskBuildIndex::runIndexerThread(int processId) {
   do {    // NOLINT(cppcoreguidelines-avoid-do-while)
-    InterprocessIndexer indexer(mAppUUID, static_cast<Id>(processId));
+    InterprocessIndexer indexer(mAppUUID, static_cast<Id>(processId), false);
     indexer.work();    // this will only return if there are no indexer commands left in the queue
     if(!mInterrupted) {
       // sleeping if interrupted may result in a crash due to objects that are already
@@ -201,8 +246,18 @@ void TaskBuildIndex::runIndexerThread(int processId) {
   }
 }
 
+bool TaskBuildIndex::hasRunningIndexers() {
+  if(mProcessPool) {
+    return mBatchId != 0 && !mProcessPool->isBatchFinished(mBatchId);
+  }
+
+  const std::lock_guard<std::mutex> lock(mRunningThreadCountMutex);
+  return mRunningThreadCount != 0;
+}
+
 bool TaskBuildIndex::fetchIntermediateStorages(const std::shared_ptr<Blackboard>& blackboard) {
   int poppedStorageCount = 0;
+  int poppedSourceFileCount = 0;
 
   if(const int providerStorageCount = mStorageProvider->getStorageCount(); providerStorageCount > MaxStorageCount) {
     LOG_INFO("waiting, too many storages queued: {}", providerStorageCount);
@@ -228,13 +283,16 @@ bool TaskBuildIndex::fetchIntermediateStorages(const std::shared_ptr<Blackboard>
     }
 
     LOG_INFO("{} - storage count: {}", storageManager->getProcessId(), storageCount);
-    mStorageProvider->insert(storageManager->popIntermediateStorage());
+    auto [storage, sourceFileCount] = storageManager->popIntermediateStorage();
+    mStorageProvider->insert(std::move(storage));
     poppedStorageCount++;
+    poppedSourceFileCount += static_cast<int>(sourceFileCount);
   } while(TimeStamp::now().deltaMS(currentTime) <
           MaxProcessTimeInMs);    // don't process all storages at once to allow for status updates in-between
 
   if(poppedStorageCount > 0) {
-    blackboard->update<int>("indexed_source_file_count", [=](int count) { return count + poppedStorageCount; });
+    blackboard->update<int>("indexed_source_file_count", [=](int count) { return count + poppedSourceFileCount; });
+    Profiler::addCounter("queued storages", static_cast<int64_t>(mStorageProvider->getStorageCount()));
     return true;
   }
 
@@ -256,3 +314,14 @@ void TaskBuildIndex::updateIndexingDialog(const std::shared_ptr<Blackboard>& bla
   const size_t progress = (sourceFileCount > 0) ? 0 : static_cast<size_t>(indexedSourceFileCount * 100 / sourceFileCount);
   MessageIndexingStatus{true, progress}.dispatch();
 }
+
+void TaskBuildIndex::updateMemoryUsage() {
+  // the main process holds the queued storages and, without multi process indexing, the indexer threads as well
+  mInterprocessIndexingStatusManager.setProcessMemoryUsage(utility::getResidentMemorySize());
+
+  const size_t memoryUsage = mInterprocessIndexingStatusManager.getTotalMemoryUsage();
+  if(memoryUsage / OneMb != mReportedMemoryUsageMb) {
+    mReportedMemoryUsageMb = memoryUsage / OneMb;
+    mDialogView->updateIndexingMemoryUsage(memoryUsage, mMemoryBudget);
+  }
+}
@@ -9,6 +9,7 @@
 #include "type/indexing/MessageIndexingInterrupted.h"
 
 class DialogView;
+class IndexerProcessPool;
 class StorageProvider;
 class IndexerCommandList;
 
@@ -20,7 +21,9 @@ public:
                  std::shared_ptr<StorageProvider> storageProvider,
                  std::shared_ptr<DialogView> dialogView,
                  std::string appUUID,
-                 bool multiProcessIndexing);
+                 bool multiProcessIndexing,
+                 size_t memoryBudget = 0,
+                 std::shared_ptr<IndexerProcessPool> processPool = nullptr);
 
 protected:
   void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -34,7 +37,9 @@ protected:
   void runIndexerProcess(int processId, const std::wstring& logFilePath);
   void runIndexerThread(int processId);
   bool fetchIntermediateStorages(const std::shared_ptr<Blackboard>& blackboard);
+  bool hasRunningIndexers();
   void updateIndexingDialog(const std::shared_ptr<Blackboard>& blackboard, const std::vector<FilePath>& sourcePaths);
+  void updateMemoryUsage();
 
   static const std::wstring sProcessName;
 
@@ -43,6 +48,10 @@ protected:
   std::shared_ptr<DialogView> mDialogView;
   const std::string mAppUUID;
   bool mMultiProcessIndexing;
+  const size_t mMemoryBudget;
+  std::shared_ptr<IndexerProcessPool> mProcessPool;
+  Id mBatchId = 0;
+  size_t mReportedMemoryUsageMb = 0;
 
   InterprocessIndexingStatusManager mInterprocessIndexingStatusManager;
   bool mIndexerCommandQueueStopped = false;
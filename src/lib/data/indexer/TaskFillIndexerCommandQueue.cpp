@@ -4,6 +4,7 @@
 #include "FileSystem.h"
 #include "IndexerCommandProvider.h"
 #include "logging.h"
+#include "Profiler.h"
 #include "utilityFile.h"
 
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(const std::string& appUUID,
@@ -92,6 +93,7 @@ bool TaskFillIndexerCommandsQueue::fillCommandQueue() {
 
   if(commands.size()) {
     m_indexerCommandManager.pushIndexerCommands(commands);
+    Profiler::addCounter("indexer command queue", static_cast<int64_t>(m_indexerCommandManager.indexerCommandCount()));
     return true;
   }
 
@@ -1,19 +1,33 @@
 #include "InterprocessIndexer.h"
 
+#include <optional>
+
 #include <fmt/format.h>
 
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
+#include "IntermediateStorage.h"
 #include "LanguagePackageManager.h"
 #include "logging.h"
+#include "Profiler.h"
 #include "ScopedFunctor.h"
+#include "utilityApp.h"
+
+namespace {
+// results of small translation units are merged in the indexer process and published together, which saves the
+// application one shared memory round trip and one storage merge per translation unit
+constexpr size_t MaxPendingSourceLocationCount = 100000;
+constexpr size_t MaxPendingTimeInMs = 1000;
+constexpr size_t OneMb = 1048576;
+}    // namespace
 
-InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
+InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId, bool reportMemoryUsage)
     : mInterprocessIndexerCommandManager(uuid, processId, false)
     , mInterprocessIndexingStatusManager(uuid, processId, false)
     , mInterprocessIntermediateStorageManager(uuid, processId, false)
     , mUuid(uuid)
-    , mProcessId(processId) {}
+    , mProcessId(processId)
+    , mReportMemoryUsage(reportMemoryUsage) {}
 
 void InterprocessIndexer::work() {
   bool updaterThreadRunning = true;
@@ -22,6 +36,7 @@ void InterprocessIndexer::work() {
 
   try {
     LOG_INFO(fmt::format("{} starting up indexer", mProcessId));
+    Profiler::setThreadName(fmt::format("indexer {}", mProcessId));
     pIndexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
 
     pUpdaterThread = std::make_shared<std::thread>([&]() {
@@ -29,6 +44,10 @@ void InterprocessIndexer::work() {
         using namespace std::chrono_literals;
         std::this_thread::sleep_for(1000ms);
 
+        if(mReportMemoryUsage) {
+          mInterprocessIndexingStatusManager.setProcessMemoryUsage(utility::getResidentMemorySize());
+        }
+
         if(mInterprocessIndexingStatusManager.getIndexingInterrupted()) {
           // NOLINTNEXTLINE(bugprone-lambda-function-name)
           LOG_INFO(fmt::format("{} received indexer interrupt command.", mProcessId));
@@ -46,24 +65,58 @@ void InterprocessIndexer::work() {
         pUpdaterThread->join();
         pUpdaterThread.reset();
       }
+      if(mReportMemoryUsage) {
+        mInterprocessIndexingStatusManager.clearProcessMemoryUsage();
+      }
     });
 
     while(auto pIndexerCommand = mInterprocessIndexerCommandManager.popIndexerCommand()) {
       LOG_INFO(fmt::format("{} fetched indexer command for \"{}\"", mProcessId, pIndexerCommand->getSourceFilePath().str()));
       LOG_INFO(fmt::format("{} indexer commands left: {}", mProcessId, mInterprocessIndexerCommandManager.indexerCommandCount()));
 
+      std::optional<Profiler::Span> waitSpan;
       while(updaterThreadRunning) {
         const size_t storageCount = mInterprocessIntermediateStorageManager.getIntermediateStorageCount();
         if(storageCount < 2) {
           break;
         }
 
+        if(!waitSpan) {
+          waitSpan.emplace("indexer", "wait for storage queue");
+        }
+
         LOG_INFO(fmt::format("{} waits, too many intermediate storages: {}", mProcessId, storageCount));
 
         using namespace std::chrono_literals;
         std::this_thread::sleep_for(200ms);
       }
 
+      while(updaterThreadRunning) {
+        if(mReportMemoryUsage) {
+          mInterprocessIndexingStatusManager.setProcessMemoryUsage(utility::getResidentMemorySize());
+        }
+
+        if(mInterprocessIndexingStatusManager.canStartIndexingSourceFile()) {
+          break;
+        }
+
+        if(!waitSpan) {
+          waitSpan.emplace("indexer", "wait for memory budget");
+        }
+
+        // hand over what is already indexed instead of holding its memory while waiting
+        publishPendingIntermediateStorage();
+
+        LOG_INFO(fmt::format("{} waits, memory budget exhausted: {} MB in use",
+                             mProcessId,
+                             mInterprocessIndexingStatusManager.getTotalMemoryUsage() / OneMb));
+
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(200ms);
+      }
+
+      waitSpan.reset();
+
       if(!updaterThreadRunning) {
         break;
       }
@@ -72,18 +125,42 @@ void InterprocessIndexer::work() {
       mInterprocessIndexingStatusManager.startIndexingSourceFile(pIndexerCommand->getSourceFilePath());
 
       LOG_INFO(fmt::format("{} starting to index current file", mProcessId));
-      auto pResult = pIndexer->index(pIndexerCommand);
+      std::shared_ptr<IntermediateStorage> pResult;
+      {
+        Profiler::Span indexSpan("indexer", "index translation unit");
+        if(indexSpan.isRecording()) {
+          indexSpan.setDetail(pIndexerCommand->getSourceFilePath().str());
+        }
 
-      if(pResult) {
-        LOG_INFO(fmt::format("{} spushing index to shared memory", mProcessId));
-        mInterprocessIntermediateStorageManager.pushIntermediateStorage(pResult);
+        pResult = pIndexer->index(pIndexerCommand);
+
+        if(pResult && indexSpan.isRecording()) {
+          indexSpan.setArgument("nodes", static_cast<int64_t>(pResult->getStorageNodes().size()));
+          indexSpan.setArgument("source locations", static_cast<int64_t>(pResult->getSourceLocationCount()));
+        }
+      }
+
+      const bool resultPending = pResult != nullptr;
+      if(resultPending) {
+        addPendingIntermediateStorage(std::move(pResult), pIndexerCommand->getSourceFilePath());
       }
 
       LOG_INFO(fmt::format("{} sfinalizing indexer status for current file", mProcessId));
-      mInterprocessIndexingStatusManager.finishIndexingSourceFile();
+      mInterprocessIndexingStatusManager.finishIndexingSourceFile(resultPending);
+
+      if(shouldPublishPendingIntermediateStorage()) {
+        publishPendingIntermediateStorage();
+      }
 
       LOG_INFO(fmt::format("{} sall done", mProcessId));
     }
+
+    if(updaterThreadRunning) {
+      publishPendingIntermediateStorage();
+    } else {
+      dropPendingIntermediateStorage();
+    }
+    Profiler::flush();
   } catch(boost::interprocess::interprocess_exception& exception) {
     LOG_INFO(fmt::format("{} error: {}", mProcessId, exception.what()));
     throw exception;    // NOLINT(cert-err60-cpp)
@@ -96,3 +173,65 @@ void InterprocessIndexer::work() {
 
   LOG_INFO(fmt::format("{} shutting down indexer", mProcessId));
 }
+
+bool InterprocessIndexer::hasIndexerCommands() {
+  return mInterprocessIndexerCommandManager.indexerCommandCount() > 0;
+}
+
+bool InterprocessIndexer::isInterrupted() {
+  return mInterprocessIndexingStatusManager.getIndexingInterrupted();
+}
+
+void InterprocessIndexer::addPendingIntermediateStorage(std::shared_ptr<IntermediateStorage> intermediateStorage,
+                                                        const FilePath& sourceFilePath) {
+  mPendingSourceFilePaths.push_back(sourceFilePath);
+
+  if(!mPendingIntermediateStorage) {
+    mPendingIntermediateStorage = std::move(intermediateStorage);
+    mPendingSince = TimeStamp::now();
+    return;
+  }
+
+  // inject the smaller storage into the larger one, the cost of a merge depends on the injected size
+  if(intermediateStorage->getSourceLocationCount() > mPendingIntermediateStorage->getSourceLocationCount()) {
+    std::swap(intermediateStorage, mPendingIntermediateStorage);
+  }
+
+  LOG_INFO(fmt::format("{} merging index into {} pending", mProcessId, mPendingSourceFilePaths.size() - 1));
+  const Profiler::Span span("indexer", "merge pending storage");
+  mPendingIntermediateStorage->inject(intermediateStorage.get());
+}
+
+bool InterprocessIndexer::shouldPublishPendingIntermediateStorage() const {
+  if(!mPendingIntermediateStorage) {
+    return false;
+  }
+
+  return mPendingIntermediateStorage->getSourceLocationCount() >= MaxPendingSourceLocationCount ||
+      TimeStamp::now().deltaMS(mPendingSince) >= MaxPendingTimeInMs;
+}
+
+void InterprocessIndexer::publishPendingIntermediateStorage() {
+  if(!mPendingIntermediateStorage) {
+    return;
+  }
+
+  LOG_INFO(fmt::format("{} spushing index of {} files to shared memory", mProcessId, mPendingSourceFilePaths.size()));
+  mInterprocessIntermediateStorageManager.pushIntermediateStorage(mPendingIntermediateStorage, mPendingSourceFilePaths.size());
+  mInterprocessIndexingStatusManager.pushFinishedProcessId();
+  mInterprocessIndexingStatusManager.clearPendingSourceFiles(mPendingSourceFilePaths);
+
+  mPendingIntermediateStorage.reset();
+  mPendingSourceFilePaths.clear();
+
+  // the events of a process killed later on are not lost
+  Profiler::flush();
+}
+
+void InterprocessIndexer::dropPendingIntermediateStorage() {
+  // interrupted indexing discards its results, so the files are not reported as crashed either
+  mInterprocessIndexingStatusManager.clearPendingSourceFiles(mPendingSourceFilePaths);
+
+  mPendingIntermediateStorage.reset();
+  mPendingSourceFilePaths.clear();
+}
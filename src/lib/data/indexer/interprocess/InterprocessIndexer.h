@@ -2,18 +2,39 @@
 #include "InterprocessIndexerCommandManager.h"
 #include "InterprocessIndexingStatusManager.h"
 #include "InterprocessIntermediateStorageManager.h"
+#include "TimeStamp.h"
+
+class IntermediateStorage;
 
 class InterprocessIndexer final {
 public:
-  InterprocessIndexer(const std::string& uuid, Id processId);
+  /**
+   * @param reportMemoryUsage Publish the resident memory of this process for the memory budget. Disable when running as thread
+   * inside the application, which accounts for its own memory.
+   */
+  InterprocessIndexer(const std::string& uuid, Id processId, bool reportMemoryUsage);
 
   void work();
 
+  [[nodiscard]] bool hasIndexerCommands();
+  [[nodiscard]] bool isInterrupted();
+
 private:
+  // merges the result of a translation unit into the storage that waits for publishing
+  void addPendingIntermediateStorage(std::shared_ptr<IntermediateStorage> intermediateStorage, const FilePath& sourceFilePath);
+  [[nodiscard]] bool shouldPublishPendingIntermediateStorage() const;
+  void publishPendingIntermediateStorage();
+  void dropPendingIntermediateStorage();
+
   InterprocessIndexerCommandManager mInterprocessIndexerCommandManager;
   InterprocessIndexingStatusManager mInterprocessIndexingStatusManager;
   InterprocessIntermediateStorageManager mInterprocessIntermediateStorageManager;
 
   const std::string mUuid;
   const Id mProcessId;
+  const bool mReportMemoryUsage;
+
+  std::shared_ptr<IntermediateStorage> mPendingIntermediateStorage;
+  std::vector<FilePath> mPendingSourceFilePaths;
+  TimeStamp mPendingSince;
 };
\ No newline at end of file
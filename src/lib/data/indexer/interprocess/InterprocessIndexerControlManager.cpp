@@ -0,0 +1,103 @@
+#include "InterprocessIndexerControlManager.h"
+
+const char* InterprocessIndexerControlManager::sSharedMemoryNamePrefix = "ictl_";
+
+const char* InterprocessIndexerControlManager::sBatchIdKeyName = "batch_id";
+const char* InterprocessIndexerControlManager::sClosedBatchIdKeyName = "closed_batch_id";
+const char* InterprocessIndexerControlManager::sBatchWorkerCountKeyName = "batch_worker_count";
+const char* InterprocessIndexerControlManager::sFinishedBatchIdsKeyName = "finished_batch_ids";
+const char* InterprocessIndexerControlManager::sShutdownKeyName = "shutdown_flag";
+
+constexpr auto SharedMemorySize = 65536;
+
+InterprocessIndexerControlManager::InterprocessIndexerControlManager(const std::string& instanceUuid, Id processId, bool isOwner)
+    : BaseInterprocessDataManager(sSharedMemoryNamePrefix + instanceUuid, SharedMemorySize, instanceUuid, processId, isOwner) {}
+
+InterprocessIndexerControlManager::~InterprocessIndexerControlManager() = default;
+
+Id InterprocessIndexerControlManager::openBatch(size_t workerCount) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* batchIdPtr = access.accessValue<Id>(sBatchIdKeyName);
+  auto* workerCountPtr = access.accessValue<size_t>(sBatchWorkerCountKeyName);
+  if(batchIdPtr == nullptr || workerCountPtr == nullptr) {
+    return 0;
+  }
+
+  *workerCountPtr = workerCount;
+  return ++(*batchIdPtr);
+}
+
+void InterprocessIndexerControlManager::closeBatch() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* batchIdPtr = access.accessValue<Id>(sBatchIdKeyName);
+  auto* closedBatchIdPtr = access.accessValue<Id>(sClosedBatchIdKeyName);
+  if(batchIdPtr != nullptr && closedBatchIdPtr != nullptr) {
+    *closedBatchIdPtr = *batchIdPtr;
+  }
+}
+
+void InterprocessIndexerControlManager::requestShutdown() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  bool* shutdownPtr = access.accessValue<bool>(sShutdownKeyName);
+  if(shutdownPtr != nullptr) {
+    *shutdownPtr = true;
+  }
+}
+
+Id InterprocessIndexerControlManager::getBatchId() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* batchIdPtr = access.accessValue<Id>(sBatchIdKeyName);
+  return batchIdPtr != nullptr ? *batchIdPtr : 0;
+}
+
+size_t InterprocessIndexerControlManager::getBatchWorkerCount() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* workerCountPtr = access.accessValue<size_t>(sBatchWorkerCountKeyName);
+  return workerCountPtr != nullptr ? *workerCountPtr : 0;
+}
+
+bool InterprocessIndexerControlManager::isBatchOpen(Id batchId) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* batchIdPtr = access.accessValue<Id>(sBatchIdKeyName);
+  auto* closedBatchIdPtr = access.accessValue<Id>(sClosedBatchIdKeyName);
+  if(batchIdPtr == nullptr || closedBatchIdPtr == nullptr) {
+    return false;
+  }
+
+  return batchId != 0 && batchId == *batchIdPtr && batchId > *closedBatchIdPtr;
+}
+
+bool InterprocessIndexerControlManager::isShutdownRequested() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  bool* shutdownPtr = access.accessValue<bool>(sShutdownKeyName);
+  return shutdownPtr != nullptr && *shutdownPtr;
+}
+
+void InterprocessIndexerControlManager::setFinishedBatchId(Id batchId) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* finishedBatchIdsPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, Id>>(sFinishedBatchIdsKeyName);
+  if(finishedBatchIdsPtr != nullptr) {
+    (*finishedBatchIdsPtr)[getProcessId()] = batchId;
+  }
+}
+
+Id InterprocessIndexerControlManager::getFinishedBatchId(Id processId) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* finishedBatchIdsPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, Id>>(sFinishedBatchIdsKeyName);
+  if(finishedBatchIdsPtr != nullptr) {
+    if(auto iterator = finishedBatchIdsPtr->find(processId); iterator != finishedBatchIdsPtr->end()) {
+      return iterator->second;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "BaseInterprocessDataManager.h"
+
+/**
+ * @brief Coordinates persistent indexer processes that outlive a single indexing run.
+ *
+ * The owner opens a batch for every indexing run. Workers join open batches, report when they are done with them and
+ * terminate once a shutdown is requested.
+ */
+class InterprocessIndexerControlManager : public BaseInterprocessDataManager {
+public:
+  InterprocessIndexerControlManager(const std::string& instanceUuid, Id processId, bool isOwner);
+  ~InterprocessIndexerControlManager() override;
+
+  // owner side
+  Id openBatch(size_t workerCount);
+  void closeBatch();
+  void requestShutdown();
+
+  // worker side
+  Id getBatchId();
+  size_t getBatchWorkerCount();
+  bool isBatchOpen(Id batchId);
+  bool isShutdownRequested();
+
+  void setFinishedBatchId(Id batchId);
+  Id getFinishedBatchId(Id processId);
+
+private:
+  static const char* sSharedMemoryNamePrefix;
+
+  static const char* sBatchIdKeyName;
+  static const char* sClosedBatchIdKeyName;
+  static const char* sBatchWorkerCountKeyName;
+  static const char* sFinishedBatchIdsKeyName;
+  static const char* sShutdownKeyName;
+};
@@ -0,0 +1,70 @@
+#include "InterprocessIndexerDaemon.h"
+
+#include <thread>
+
+#include <fmt/format.h>
+
+#include "InterprocessIndexer.h"
+#include "logging.h"
+
+namespace {
+constexpr auto PollInterval = std::chrono::milliseconds(100);
+}    // namespace
+
+InterprocessIndexerDaemon::InterprocessIndexerDaemon(std::string uuid, Id processId, std::chrono::seconds idleTimeout)
+    : mInterprocessIndexerControlManager(uuid, processId, false)
+    , mUuid(std::move(uuid))
+    , mProcessId(processId)
+    , mIdleTimeout(idleTimeout) {}
+
+void InterprocessIndexerDaemon::run() {
+  LOG_INFO(fmt::format("{} persistent indexer waiting for work", mProcessId));
+
+  // a restarted process resumes the batch its crashed predecessor left unfinished
+  Id lastBatchId = mInterprocessIndexerControlManager.getFinishedBatchId(mProcessId);
+  auto idleSince = std::chrono::steady_clock::now();
+
+  while(!mInterprocessIndexerControlManager.isShutdownRequested()) {
+    const Id batchId = mInterprocessIndexerControlManager.getBatchId();
+    if(batchId > lastBatchId) {
+      // a small batch can be closed before this process polls for it, its queued commands still need to be indexed
+      if(mProcessId <= mInterprocessIndexerControlManager.getBatchWorkerCount()) {
+        workOnBatch(batchId);
+      }
+
+      mInterprocessIndexerControlManager.setFinishedBatchId(batchId);
+      lastBatchId = batchId;
+      idleSince = std::chrono::steady_clock::now();
+    } else if(std::chrono::steady_clock::now() - idleSince > mIdleTimeout) {
+      LOG_INFO(fmt::format("{} persistent indexer idle timeout reached", mProcessId));
+      break;
+    }
+
+    std::this_thread::sleep_for(PollInterval);
+  }
+
+  LOG_INFO(fmt::format("{} persistent indexer shutting down", mProcessId));
+}
+
+void InterprocessIndexerDaemon::workOnBatch(Id batchId) {
+  LOG_INFO(fmt::format("{} joining indexing batch {}", mProcessId, batchId));
+
+  InterprocessIndexer indexer(mUuid, mProcessId, true);
+  while(true) {
+    // commands may still be queued when the batch gets closed, so drain the queue once more after that
+    const bool batchOpen = mInterprocessIndexerControlManager.isBatchOpen(batchId);
+
+    // skip the indexer setup while the queue is waiting for a refill
+    if(indexer.hasIndexerCommands()) {
+      indexer.work();
+    }
+
+    if(!batchOpen || indexer.isInterrupted() || mInterprocessIndexerControlManager.isShutdownRequested()) {
+      break;
+    }
+
+    std::this_thread::sleep_for(PollInterval);
+  }
+
+  LOG_INFO(fmt::format("{} finished indexing batch {}", mProcessId, batchId));
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+
+#include "InterprocessIndexerControlManager.h"
+
+/**
+ * @brief Keeps an indexer process alive across indexing runs.
+ *
+ * Joins every batch opened through the InterprocessIndexerControlManager, even if it was closed already, and works on it with
+ * an InterprocessIndexer until the batch is closed and its queue is drained. Returns when a shutdown is requested or no batch
+ * was opened for the idle timeout.
+ */
+class InterprocessIndexerDaemon final {
+public:
+  InterprocessIndexerDaemon(std::string uuid, Id processId, std::chrono::seconds idleTimeout);
+
+  void run();
+
+private:
+  void workOnBatch(Id batchId);
+
+  InterprocessIndexerControlManager mInterprocessIndexerControlManager;
+
+  const std::string mUuid;
+  const Id mProcessId;
+  const std::chrono::seconds mIdleTimeout;
+};
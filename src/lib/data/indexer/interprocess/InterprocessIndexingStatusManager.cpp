@@ -1,5 +1,7 @@
 #include "InterprocessIndexingStatusManager.h"
 
+#include <algorithm>
+
 #include "logging.h"
 #include "utilityString.h"
 
@@ -8,11 +10,16 @@ const char* InterprocessIndexingStatusManager::sSharedMemoryNamePrefix = "ists_"
 const char* InterprocessIndexingStatusManager::sIndexingFilesKeyName = "indexing_files";
 const char* InterprocessIndexingStatusManager::sCurrentFilesKeyName = "current_files";
 const char* InterprocessIndexingStatusManager::sCrashedFilesKeyName = "crashed_files";
+const char* InterprocessIndexingStatusManager::sPendingFilesKeyName = "pending_files";
 const char* InterprocessIndexingStatusManager::sFinishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::sIndexingInterruptedKeyName = "indexing_interrupted_flag";
+const char* InterprocessIndexingStatusManager::sMemoryBudgetKeyName = "memory_budget";
+const char* InterprocessIndexingStatusManager::sMemoryUsageKeyName = "memory_usage";
 
 constexpr auto OneMb = 1048576;
 constexpr auto EstimatedPrefix = 262144;
+// new source files are held back once this share of the memory budget is in use
+constexpr auto MemoryBudgetAdmissionRatio = 0.9;
 
 InterprocessIndexingStatusManager::InterprocessIndexingStatusManager(const std::string& instanceUuid, Id processId, bool isOwner)
     : BaseInterprocessDataManager(sSharedMemoryNamePrefix + instanceUuid, OneMb, instanceUuid, processId, isOwner) {}
@@ -70,14 +77,64 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
   }
 }
 
-void InterprocessIndexingStatusManager::finishIndexingSourceFile() {
+void InterprocessIndexingStatusManager::finishIndexingSourceFile(bool resultPending) {
   SharedMemory::ScopedAccess access(&mSharedMemory);
 
   auto* currentFilesPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(sCurrentFilesKeyName);
-  if(currentFilesPtr != nullptr) {
-    currentFilesPtr->erase(currentFilesPtr->find(getProcessId()), currentFilesPtr->end());
+  if(currentFilesPtr == nullptr) {
+    return;
+  }
+
+  auto iterator = currentFilesPtr->find(getProcessId());
+  if(iterator == currentFilesPtr->end()) {
+    return;
   }
 
+  if(resultPending) {
+    const size_t overestimationMultiplier = 3;
+    const std::string pendingFilePath = iterator->second.c_str();
+
+    const size_t estimatedSize = (EstimatedPrefix + sizeof(SharedMemory::String) + pendingFilePath.size()) *
+        overestimationMultiplier;
+    while(access.getFreeMemorySize() < estimatedSize) {
+      access.growMemory(access.getMemorySize());
+    }
+
+    auto* pendingFilesPtr = access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(sPendingFilesKeyName);
+    currentFilesPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(sCurrentFilesKeyName);
+    if(pendingFilesPtr == nullptr || currentFilesPtr == nullptr) {
+      return;
+    }
+
+    SharedMemory::String str(access.getAllocator());
+    str = pendingFilePath.c_str();
+    pendingFilesPtr->push_back(str);
+  }
+
+  currentFilesPtr->erase(getProcessId());
+}
+
+void InterprocessIndexingStatusManager::clearPendingSourceFiles(const std::vector<FilePath>& filePaths) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* pendingFilesPtr = access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(sPendingFilesKeyName);
+  if(pendingFilesPtr == nullptr) {
+    return;
+  }
+
+  for(const FilePath& filePath : filePaths) {
+    const std::string path = utility::encodeToUtf8(filePath.wstr());
+    const auto iterator = std::ranges::find_if(
+        *pendingFilesPtr, [&](const SharedMemory::String& pendingPath) { return path == pendingPath.c_str(); });
+    if(iterator != pendingFilesPtr->end()) {
+      pendingFilesPtr->erase(iterator);
+    }
+  }
+}
+
+void InterprocessIndexingStatusManager::pushFinishedProcessId() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
   auto* finishedProcessIdsPtr = access.accessValueWithAllocator<SharedMemory::Queue<Id>>(sFinishedProcessIdsKeyName);
   if(finishedProcessIdsPtr != nullptr) {
     finishedProcessIdsPtr->push_back(mProcessId);
@@ -146,6 +203,14 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
     }
   }
 
+  // results that were still held back in an indexer process are lost as well
+  auto* pendingFilesPtr = access.accessValueWithAllocator<SharedMemory::Vector<SharedMemory::String>>(sPendingFilesKeyName);
+  if(pendingFilesPtr != nullptr) {
+    for(const auto& pendingFile : *pendingFilesPtr) {
+      crashedFiles.emplace_back(utility::decodeFromUtf8(pendingFile.c_str()));
+    }
+  }
+
   auto* currentFilesPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(sCurrentFilesKeyName);
   if(currentFilesPtr != nullptr) {
     for(SharedMemory::Map<Id, SharedMemory::String>::iterator it = currentFilesPtr->begin(); it != currentFilesPtr->end(); it++) {
@@ -155,3 +220,96 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 
   return crashedFiles;
 }
+
+std::vector<FilePath> InterprocessIndexingStatusManager::getIndexingSourceFilePaths() {
+  std::vector<FilePath> indexingFiles;
+
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* currentFilesPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(sCurrentFilesKeyName);
+  if(currentFilesPtr != nullptr) {
+    for(const auto& [processId, filePath] : *currentFilesPtr) {
+      indexingFiles.emplace_back(utility::decodeFromUtf8(filePath.c_str()));
+    }
+  }
+
+  return indexingFiles;
+}
+
+void InterprocessIndexingStatusManager::setMemoryBudget(size_t budget) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* memoryBudgetPtr = access.accessValue<size_t>(sMemoryBudgetKeyName);
+  if(memoryBudgetPtr != nullptr) {
+    *memoryBudgetPtr = budget;
+  }
+}
+
+size_t InterprocessIndexingStatusManager::getMemoryBudget() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* memoryBudgetPtr = access.accessValue<size_t>(sMemoryBudgetKeyName);
+  if(memoryBudgetPtr != nullptr) {
+    return *memoryBudgetPtr;
+  }
+
+  return 0;
+}
+
+void InterprocessIndexingStatusManager::setProcessMemoryUsage(size_t usage) {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* memoryUsagePtr = access.accessValueWithAllocator<SharedMemory::Map<Id, size_t>>(sMemoryUsageKeyName);
+  if(memoryUsagePtr != nullptr) {
+    (*memoryUsagePtr)[getProcessId()] = usage;
+  }
+}
+
+void InterprocessIndexingStatusManager::clearProcessMemoryUsage() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* memoryUsagePtr = access.accessValueWithAllocator<SharedMemory::Map<Id, size_t>>(sMemoryUsageKeyName);
+  if(memoryUsagePtr != nullptr) {
+    memoryUsagePtr->erase(getProcessId());
+  }
+}
+
+size_t InterprocessIndexingStatusManager::getTotalMemoryUsage() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  size_t totalUsage = 0;
+
+  auto* memoryUsagePtr = access.accessValueWithAllocator<SharedMemory::Map<Id, size_t>>(sMemoryUsageKeyName);
+  if(memoryUsagePtr != nullptr) {
+    for(const auto& [processId, usage] : *memoryUsagePtr) {
+      totalUsage += usage;
+    }
+  }
+
+  return totalUsage;
+}
+
+bool InterprocessIndexingStatusManager::canStartIndexingSourceFile() {
+  SharedMemory::ScopedAccess access(&mSharedMemory);
+
+  auto* memoryBudgetPtr = access.accessValue<size_t>(sMemoryBudgetKeyName);
+  if(memoryBudgetPtr == nullptr || *memoryBudgetPtr == 0) {
+    return true;
+  }
+
+  // always let one process continue, otherwise memory held by idle processes could block indexing forever
+  auto* currentFilesPtr = access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(sCurrentFilesKeyName);
+  if(currentFilesPtr == nullptr || currentFilesPtr->empty()) {
+    return true;
+  }
+
+  size_t totalUsage = 0;
+  auto* memoryUsagePtr = access.accessValueWithAllocator<SharedMemory::Map<Id, size_t>>(sMemoryUsageKeyName);
+  if(memoryUsagePtr != nullptr) {
+    for(const auto& [processId, usage] : *memoryUsagePtr) {
+      totalUsage += usage;
+    }
+  }
+
+  return static_cast<double>(totalUsage) < static_cast<double>(*memoryBudgetPtr) * MemoryBudgetAdmissionRatio;
+}
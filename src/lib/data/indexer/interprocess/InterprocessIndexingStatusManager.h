@@ -11,7 +11,12 @@ public:
   ~InterprocessIndexingStatusManager() override;
 
   void startIndexingSourceFile(const FilePath& filePath);
-  void finishIndexingSourceFile();
+  // a file whose result is held back for publishing stays reported as crashed until clearPendingSourceFiles is called
+  void finishIndexingSourceFile(bool resultPending = false);
+  // called once the held back results of the files are published or dropped
+  void clearPendingSourceFiles(const std::vector<FilePath>& filePaths);
+  // announces that this process published an intermediate storage
+  void pushFinishedProcessId();
 
   void setIndexingInterrupted(bool interrupted);
   bool getIndexingInterrupted();
@@ -20,6 +25,19 @@ public:
 
   std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
   std::vector<FilePath> getCrashedSourceFilePaths();
+  // the files processes are working on right now, unlike getCurrentlyIndexedSourceFilePaths nothing is consumed
+  std::vector<FilePath> getIndexingSourceFilePaths();
+
+  // memory admission control, all sizes in bytes, a budget of 0 disables the limit
+  void setMemoryBudget(size_t budget);
+  size_t getMemoryBudget();
+
+  void setProcessMemoryUsage(size_t usage);
+  void clearProcessMemoryUsage();
+  size_t getTotalMemoryUsage();
+
+  // returns false while the summed usage is close to the budget and other processes are still indexing
+  bool canStartIndexingSourceFile();
 
 private:
   static const char* sSharedMemoryNamePrefix;
@@ -27,6 +45,9 @@ private:
   static const char* sIndexingFilesKeyName;
   static const char* sCurrentFilesKeyName;
   static const char* sCrashedFilesKeyName;
+  static const char* sPendingFilesKeyName;
   static const char* sFinishedProcessIdsKeyName;
   static const char* sIndexingInterruptedKeyName;
+  static const char* sMemoryBudgetKeyName;
+  static const char* sMemoryUsageKeyName;
 };
\ No newline at end of file
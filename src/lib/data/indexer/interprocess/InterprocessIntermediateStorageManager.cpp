@@ -2,6 +2,7 @@
 
 #include "IntermediateStorage.h"
 #include "logging.h"
+#include "Profiler.h"
 #include "SharedIntermediateStorage.h"
 
 const char* InterprocessIntermediateStorageManager::sSharedMemoryNamePrefix = "iist_";
@@ -19,7 +20,8 @@ InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(c
 
 InterprocessIntermediateStorageManager::~InterprocessIntermediateStorageManager() = default;
 
-void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage) {
+void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage,
+                                                                     size_t sourceFileCount) {
   const size_t requiredInsertsToShrink = 10;
 
   const size_t overestimationMultiplier = 2;
@@ -27,6 +29,7 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
           overestimationMultiplier +
       1048576 /* 1 MB */;
 
+  Profiler::Span span("shared memory", "push intermediate storage");
   SharedMemory::ScopedAccess access(&mSharedMemory);
 
   const size_t freeMemory = access.getFreeMemorySize();
@@ -53,6 +56,7 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
     return;
   }
 
+  const size_t freeMemoryBeforeCopy = span.isRecording() ? access.getFreeMemorySize() : 0;
   queue->push_back(SharedIntermediateStorage(access.getAllocator()));
   SharedIntermediateStorage& storage = queue->back();
 
@@ -67,6 +71,11 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
   storage.setStorageErrors(intermediateStorage->getErrors());
 
   storage.setNextId(intermediateStorage->getNextId());
+  storage.setSourceFileCount(sourceFileCount);
+
+  if(span.isRecording()) {
+    span.setArgument("bytes", static_cast<int64_t>(freeMemoryBeforeCopy - access.getFreeMemorySize()));
+  }
 
   if(mInsertsWithoutGrowth >= requiredInsertsToShrink) {
     mInsertsWithoutGrowth = 0;
@@ -79,14 +88,17 @@ void InterprocessIntermediateStorageManager::pushIntermediateStorage(const std::
   LOG_INFO(access.logString());
 }
 
-std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::popIntermediateStorage() {
+std::pair<std::shared_ptr<IntermediateStorage>, size_t> InterprocessIntermediateStorageManager::popIntermediateStorage() {
   SharedMemory::ScopedAccess access(&mSharedMemory);
 
   auto* queue = access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(sIntermediateStoragesKeyName);
   if(!queue || queue->empty()) {
-    return nullptr;
+    return {nullptr, 0};
   }
 
+  Profiler::Span span("shared memory", "pop intermediate storage");
+  const size_t freeMemory = span.isRecording() ? access.getFreeMemorySize() : 0;
+
   SharedIntermediateStorage& sharedIntermediateStorage = queue->front();
 
   std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
@@ -102,11 +114,16 @@ std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::pop
   storage->setErrors(sharedIntermediateStorage.getStorageErrors());
 
   storage->setNextId(sharedIntermediateStorage.getNextId());
+  const size_t sourceFileCount = sharedIntermediateStorage.getSourceFileCount();
 
   queue->pop_front();
   LOG_INFO(access.logString());
 
-  return storage;
+  if(span.isRecording()) {
+    span.setArgument("bytes", static_cast<int64_t>(access.getFreeMemorySize() - freeMemory));
+  }
+
+  return {storage, sourceFileCount};
 }
 
 size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount() {
@@ -9,8 +9,14 @@ public:
   InterprocessIntermediateStorageManager(const std::string& instanceUuid, Id processId, bool isOwner);
   ~InterprocessIntermediateStorageManager() override;
 
-  void pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage);
-  std::shared_ptr<IntermediateStorage> popIntermediateStorage();
+  /**
+   * @param sourceFileCount Number of translation units the worker merged into the storage before publishing it.
+   */
+  void pushIntermediateStorage(const std::shared_ptr<IntermediateStorage>& intermediateStorage, size_t sourceFileCount = 1);
+  /**
+   * @return The storage and the number of translation units it contains, or nullptr if the queue is empty.
+   */
+  std::pair<std::shared_ptr<IntermediateStorage>, size_t> popIntermediateStorage();
 
   size_t getIntermediateStorageCount();
 
@@ -11,7 +11,8 @@ SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* al
     , mStorageSourceLocations(allocator)
     , mStorageErrors(allocator)
     , mAllocator(allocator)
-    , mNextId(1) {}
+    , mNextId(1)
+    , mSourceFileCount(1) {}
 
 SharedIntermediateStorage::~SharedIntermediateStorage() = default;
 
@@ -189,3 +190,11 @@ Id SharedIntermediateStorage::getNextId() const {
 void SharedIntermediateStorage::setNextId(const Id nextId) {
   mNextId = static_cast<int>(nextId);
 }
+
+size_t SharedIntermediateStorage::getSourceFileCount() const {
+  return mSourceFileCount;
+}
+
+void SharedIntermediateStorage::setSourceFileCount(size_t sourceFileCount) {
+  mSourceFileCount = sourceFileCount;
+}
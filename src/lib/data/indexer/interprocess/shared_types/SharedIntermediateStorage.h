@@ -41,6 +41,10 @@ public:
   Id getNextId() const;
   void setNextId(const Id nextId);
 
+  // number of translation units that were merged into this storage
+  size_t getSourceFileCount() const;
+  void setSourceFileCount(size_t sourceFileCount);
+
 private:
   SharedMemory::Vector<SharedStorageFile> mStorageFiles;
   SharedMemory::Vector<SharedStorageSymbol> mStorageSymbols;
@@ -55,4 +59,5 @@ private:
   SharedMemory::Allocator* mAllocator;
 
   int mNextId;
+  size_t mSourceFileCount;
 };
\ No newline at end of file
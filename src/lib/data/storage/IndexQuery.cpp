@@ -0,0 +1,220 @@
+#include "IndexQuery.h"
+
+#include <set>
+
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "DefinitionKind.h"
+#include "Edge.h"
+#include "FilePath.h"
+#include "NameHierarchy.h"
+#include "NodeType.h"
+#include "SearchIndex.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "utilityString.h"
+
+namespace {
+QString toQString(const std::wstring& text) {
+  return QString::fromStdWString(text);
+}
+
+QJsonObject toJson(const StorageNode& node) {
+  QJsonObject symbol;
+  symbol[QStringLiteral("id")] = static_cast<qint64>(node.id);
+  symbol[QStringLiteral("name")] = toQString(NameHierarchy::deserialize(node.serializedName).getQualifiedName());
+  symbol[QStringLiteral("type")] = QString::fromStdString(NodeType(intToNodeKind(node.type)).getReadableTypeString());
+  return symbol;
+}
+
+std::vector<Id> getIds(const std::vector<StorageNode>& nodes) {
+  std::vector<Id> ids;
+  ids.reserve(nodes.size());
+  for(const StorageNode& node : nodes) {
+    ids.push_back(node.id);
+  }
+  return ids;
+}
+
+void appendEscapedPattern(std::wstring& pattern, const std::wstring& text) {
+  for(const wchar_t c : text) {
+    if(c == L'%' || c == L'_' || c == L'\\') {
+      pattern += L'\\';
+    }
+    pattern += c;
+  }
+}
+}    // namespace
+
+IndexQuery::IndexQuery(const FilePath& dbFilePath) : m_storage(dbFilePath, SqliteStorage::OpenMode::ReadOnly) {}
+
+bool IndexQuery::isCompatible() const {
+  return !m_storage.isIncompatible();
+}
+
+std::string IndexQuery::run(const std::string& query) const {
+  const std::string trimmedQuery = utility::trim(query);
+  const size_t separator = trimmedQuery.find(' ');
+  const std::string kind = trimmedQuery.substr(0, separator);
+  const std::wstring argument = separator == std::string::npos ?
+      std::wstring() :
+      utility::decodeFromUtf8(utility::trim(trimmedQuery.substr(separator + 1)));
+
+  QJsonObject answer;
+  answer[QStringLiteral("query")] = QString::fromStdString(kind);
+  answer[QStringLiteral("argument")] = toQString(argument);
+
+  if(argument.empty()) {
+    answer[QStringLiteral("error")] = QStringLiteral("missing argument");
+  } else if(kind == "search") {
+    answer[QStringLiteral("results")] = search(argument);
+  } else if(kind == "includes") {
+    answer[QStringLiteral("results")] = includes(argument);
+  } else if(kind == "references" || kind == "callers" || kind == "callees") {
+    const std::vector<StorageNode> symbols = findSymbols(argument);
+    if(symbols.empty()) {
+      answer[QStringLiteral("error")] = QStringLiteral("unknown symbol");
+    } else if(kind == "references") {
+      answer[QStringLiteral("results")] = references(symbols);
+    } else {
+      answer[QStringLiteral("results")] = calls(symbols, kind == "callers");
+    }
+  } else {
+    answer[QStringLiteral("error")] = QStringLiteral("unknown query, use search, references, callers, callees or includes");
+  }
+
+  return QJsonDocument(answer).toJson(QJsonDocument::Compact).toStdString();
+}
+
+QJsonArray IndexQuery::search(const std::wstring& text) const {
+  // every symbol the fuzzy search can match contains the letters and digits of the query in this order, so the
+  // search index only needs to hold the nodes matching that pattern
+  std::wstring pattern = L"%";
+  for(const wchar_t c : text) {
+    if((c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') || (c >= L'0' && c <= L'9')) {
+      pattern += c;
+      pattern += L'%';
+    }
+  }
+
+  const std::vector<StorageNode> candidates = m_storage.getNodesBySerializedNamePattern(pattern);
+
+  std::set<Id> implicitSymbolIds;
+  for(const StorageSymbol& symbol : m_storage.getAllByIds<StorageSymbol>(getIds(candidates))) {
+    if(intToDefinitionKind(symbol.definitionKind) == DEFINITION_IMPLICIT) {
+      implicitSymbolIds.insert(symbol.id);
+    }
+  }
+
+  SearchIndex searchIndex;
+  for(const StorageNode& node : candidates) {
+    const NodeType type(intToNodeKind(node.type));
+    if(type.isFile() || implicitSymbolIds.contains(node.id)) {
+      continue;
+    }
+
+    const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+    searchIndex.addNode(node.id, nameHierarchy.getQualifiedName(), type);
+  }
+  searchIndex.finishSetup();
+
+  QJsonArray results;
+  for(const SearchResult& result : searchIndex.search(text, NodeTypeSet::all(), MaxSearchResultCount)) {
+    QJsonArray ids;
+    for(const Id elementId : result.elementIds) {
+      ids.append(static_cast<qint64>(elementId));
+    }
+
+    QJsonObject match;
+    match[QStringLiteral("name")] = toQString(result.text);
+    match[QStringLiteral("ids")] = ids;
+    match[QStringLiteral("score")] = result.score;
+    results.append(match);
+  }
+  return results;
+}
+
+QJsonArray IndexQuery::references(const std::vector<StorageNode>& symbols) const {
+  QJsonArray results;
+  m_storage.getSourceLocationsForElementIds(getIds(symbols))->forEachSourceLocation([&results](SourceLocation* location) {
+    if(location->getType() != LOCATION_TOKEN || !location->isStartLocation()) {
+      return;
+    }
+
+    QJsonObject reference;
+    reference[QStringLiteral("file")] = toQString(location->getFilePath().wstr());
+    reference[QStringLiteral("line")] = static_cast<qint64>(location->getLineNumber());
+    reference[QStringLiteral("column")] = static_cast<qint64>(location->getColumnNumber());
+    results.append(reference);
+  });
+  return results;
+}
+
+QJsonArray IndexQuery::calls(const std::vector<StorageNode>& symbols, bool callers) const {
+  const int callType = Edge::typeToInt(Edge::EDGE_CALL);
+  const std::vector<StorageEdge> edges = callers ? m_storage.getEdgesByTargetsType(getIds(symbols), callType) :
+                                                   m_storage.getEdgesBySourcesType(getIds(symbols), callType);
+
+  std::set<Id> nodeIds;
+  for(const StorageEdge& edge : edges) {
+    nodeIds.insert(callers ? edge.sourceNodeId : edge.targetNodeId);
+  }
+
+  QJsonArray results;
+  for(const StorageNode& node : m_storage.getAllByIds<StorageNode>({nodeIds.begin(), nodeIds.end()})) {
+    results.append(toJson(node));
+  }
+  return results;
+}
+
+QJsonArray IndexQuery::includes(const std::wstring& filePath) const {
+  StorageFile file = m_storage.getFileByPath(filePath);
+  if(file.id == 0) {
+    file = m_storage.getFileByPath(FilePath(filePath).makeAbsolute().makeCanonical().wstr());
+  }
+
+  std::vector<Id> includedFileIds;
+  if(file.id != 0) {
+    for(const StorageEdge& edge : m_storage.getEdgesBySourceType(file.id, Edge::typeToInt(Edge::EDGE_INCLUDE))) {
+      includedFileIds.push_back(edge.targetNodeId);
+    }
+  }
+
+  QJsonArray results;
+  for(const StorageFile& includedFile : m_storage.getAllByIds<StorageFile>(includedFileIds)) {
+    QJsonObject include;
+    include[QStringLiteral("id")] = static_cast<qint64>(includedFile.id);
+    include[QStringLiteral("file")] = toQString(includedFile.filePath);
+    results.append(include);
+  }
+  return results;
+}
+
+std::vector<StorageNode> IndexQuery::findSymbols(const std::wstring& name) const {
+  std::wstring lastElementName = name;
+  for(const std::wstring delimiter : {L"::", L"."}) {
+    if(const size_t pos = lastElementName.rfind(delimiter); pos != std::wstring::npos) {
+      lastElementName = lastElementName.substr(pos + delimiter.size());
+    }
+  }
+
+  // NameHierarchy::serialize writes each element name between "\tm" or "\tn" and "\ts"
+  std::wstring pattern = L"%\t_";
+  appendEscapedPattern(pattern, lastElementName);
+  pattern += L"\ts%";
+
+  std::vector<StorageNode> symbols;
+  for(StorageNode& node : m_storage.getNodesBySerializedNamePattern(pattern)) {
+    if(NodeType(intToNodeKind(node.type)).isFile()) {
+      continue;
+    }
+
+    const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+    const std::wstring qualifiedName = nameHierarchy.getQualifiedName();
+    if(qualifiedName == name || qualifiedName.ends_with(nameHierarchy.getDelimiter() + name)) {
+      symbols.push_back(std::move(node));
+    }
+  }
+  return symbols;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <QJsonArray>
+
+#include "SqliteIndexStorage.h"
+
+class FilePath;
+
+/**
+ * @brief Answers the queries of the headless "query" command directly from an index database.
+ *
+ * Unlike PersistentStorage nothing is cached up front: symbol names are looked up with a pattern in the database and a
+ * search only builds a search index over the nodes that can match it, so a single query starts in milliseconds.
+ */
+class IndexQuery final {
+public:
+  /**
+   * @brief Opens the database read-only.
+   * @throw CppSQLite3Exception if the database can not be opened
+   */
+  explicit IndexQuery(const FilePath& dbFilePath);
+
+  /**
+   * @brief False if the database is empty or was written by another storage version.
+   */
+  [[nodiscard]] bool isCompatible() const;
+
+  /**
+   * @brief Answers one query "<kind> <argument>" with a single line of JSON.
+   *
+   * Kinds are "search" (fuzzy symbol search), "references", "callers" and "callees" of a qualified symbol name and
+   * "includes" of a file path.
+   */
+  [[nodiscard]] std::string run(const std::string& query) const;
+
+  static constexpr size_t MaxSearchResultCount = 50;
+
+private:
+  [[nodiscard]] QJsonArray search(const std::wstring& text) const;
+  [[nodiscard]] QJsonArray references(const std::vector<StorageNode>& symbols) const;
+  [[nodiscard]] QJsonArray calls(const std::vector<StorageNode>& symbols, bool callers) const;
+  [[nodiscard]] QJsonArray includes(const std::wstring& filePath) const;
+
+  /**
+   * @brief Symbols whose qualified name is the given name or ends with it after a delimiter.
+   */
+  [[nodiscard]] std::vector<StorageNode> findSymbols(const std::wstring& name) const;
+
+  SqliteIndexStorage m_storage;
+};
@@ -13,6 +13,7 @@
 #include "logging.h"
 #include "NodeTypeSet.h"
 #include "ParseLocation.h"
+#include "Profiler.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
 #include "TextAccess.h"
@@ -270,6 +271,10 @@ void PersistentStorage::setup() {
   m_sqliteBookmarkStorage.migrateIfNecessary();
 }
 
+void PersistentStorage::enableQueryCancellation() {
+  m_sqliteIndexStorage.enableQueryCancellation();
+}
+
 void PersistentStorage::updateVersion() {
   m_sqliteIndexStorage.setVersion(m_sqliteIndexStorage.getStaticVersion());
   if(m_sqliteBookmarkStorage.isEmpty()) {
@@ -294,6 +299,7 @@ void PersistentStorage::clearCaches() {
   m_fileNodeIndexed.clear();
   m_fileNodeLanguage.clear();
   m_symbolDefinitionKinds.clear();
+  m_overviewNodeIds.clear();
 
   m_hierarchyCache.clear();
   m_fullTextSearchIndex.clear();
@@ -363,6 +369,17 @@ std::set<FilePath> PersistentStorage::getIncompleteFiles() const {
   return incompleteFiles;
 }
 
+std::set<FilePath> PersistentStorage::getIndexedFiles() const {
+  std::set<FilePath> indexedFiles;
+  for(const auto& [id, indexed] : m_fileNodeIndexed) {
+    if(indexed) {
+      indexedFiles.insert(getFileNodePath(id));
+    }
+  }
+
+  return indexedFiles;
+}
+
 bool PersistentStorage::getFilePathIndexed(const FilePath& path) const {
   Id fileId = getFileNodeId(path);
   if(fileId) {
@@ -373,12 +390,22 @@ bool PersistentStorage::getFilePathIndexed(const FilePath& path) const {
 }
 
 void PersistentStorage::buildCaches() {
+  Profiler::Span span("storage", "build caches");
   clearCaches();
 
-  buildFilePathMaps();
-  buildSearchIndex();
+  {
+    Profiler::Span filePathSpan("storage", "build file path maps");
+    buildFilePathMaps();
+  }
+  {
+    Profiler::Span hierarchySpan("storage", "build hierarchy cache");
+    buildHierarchyCache();    // needed by buildSearchIndex to collect the overview nodes
+  }
+  {
+    Profiler::Span searchIndexSpan("storage", "build search index");
+    buildSearchIndex();
+  }
   buildMemberEdgeIdOrderMap();
-  buildHierarchyCache();
 }
 
 void PersistentStorage::optimizeMemory() {
@@ -825,23 +852,45 @@ std::vector<SearchMatch> PersistentStorage::getSearchMatchesForTokenIds(const st
 
 std::shared_ptr<Graph> PersistentStorage::getGraphForAll() const {
   std::shared_ptr<Graph> graph = std::make_shared<Graph>();
-  const size_t sdk_size = m_symbolDefinitionKinds.size();
-  m_sqliteIndexStorage.forEach<StorageNode>([&, sdk_size](StorageNode&& storageNode) {
+  m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& storageNode) {
     const NodeType type(intToNodeKind(storageNode.type));
     if(type.isFile()) {
       auto fn_it = m_fileNodeIndexed.find(storageNode.id);
       if(fn_it != m_fileNodeIndexed.end() && fn_it->second) {
         addFileNodeToGraph(storageNode, graph.get());
       }
+    } else if(isOverviewSymbolNode(storageNode.id, type)) {
+      addNodeToGraph(storageNode, type, graph.get(), false);
+    }
+  });
+  return graph;
+}
+
+std::map<NodeKind, size_t> PersistentStorage::getOverviewBundleCounts() const {
+  std::map<NodeKind, size_t> counts;
+  for(const auto& [kind, nodeIds] : m_overviewNodeIds) {
+    counts.emplace(kind, nodeIds.size());
+  }
+  return counts;
+}
+
+std::shared_ptr<Graph> PersistentStorage::getGraphForOverviewBundle(NodeKind kind, size_t offset, size_t count) const {
+  auto graph = std::make_shared<Graph>();
+
+  auto it = m_overviewNodeIds.find(kind);
+  if(it == m_overviewNodeIds.end() || offset >= it->second.size()) {
+    return graph;
+  }
+
+  const auto first = it->second.begin() + static_cast<long>(offset);
+  const std::vector<Id> nodeIds(first, first + static_cast<long>(std::min(count, it->second.size() - offset)));
+
+  m_sqliteIndexStorage.forEachByIds<StorageNode>(nodeIds, [&](StorageNode&& storageNode) {
+    const NodeType type(intToNodeKind(storageNode.type));
+    if(type.isFile()) {
+      addFileNodeToGraph(storageNode, graph.get());
     } else {
-      bool showNode = true;
-      if(sdk_size) {
-        auto it = m_symbolDefinitionKinds.find(storageNode.id);
-        showNode = (it != m_symbolDefinitionKinds.end() && it->second == DEFINITION_EXPLICIT);
-      }
-      if(showNode && (type.isPackage() || !m_hierarchyCache.isChildOfVisibleNodeOrInvisible(storageNode.id))) {
-        addNodeToGraph(storageNode, type, graph.get(), false);
-      }
+      addNodeToGraph(storageNode, type, graph.get(), false);
     }
   });
   return graph;
@@ -1392,11 +1441,20 @@ std::shared_ptr<TextAccess> PersistentStorage::getFileContent(const FilePath& fi
 }
 
 bool PersistentStorage::hasContentForFile(const FilePath& filePath) const {
-  std::shared_ptr<TextAccess> fileContent = m_sqliteIndexStorage.getFileContentByPath(filePath.wstr());
-  if(fileContent->getLineCount() > 0) {
-    return true;
+  return m_sqliteIndexStorage.getFileContentFingerprint(filePath.wstr()).has_value();
+}
+
+std::optional<SqliteIndexStorage::FileContentFingerprint> PersistentStorage::getFileContentFingerprint(const FilePath& filePath) const {
+  return m_sqliteIndexStorage.getFileContentFingerprint(filePath.wstr());
+}
+
+std::map<FilePath, SqliteIndexStorage::FileContentFingerprint> PersistentStorage::getFileContentFingerprints(
+    const std::vector<FilePath>& filePaths) const {
+  std::map<FilePath, SqliteIndexStorage::FileContentFingerprint> fingerprints;
+  for(auto& [filePath, fingerprint] : m_sqliteIndexStorage.getFileContentFingerprints(utility::toWStrings(filePaths))) {
+    fingerprints.emplace(FilePath(filePath), std::move(fingerprint));
   }
-  return false;
+  return fingerprints;
 }
 
 FileInfo PersistentStorage::getFileInfoForFileId(Id id) const {
@@ -1434,11 +1492,15 @@ StorageStats PersistentStorage::getStorageStats() const {
 }
 
 ErrorCountInfo PersistentStorage::getErrorCount() const {
-  return ErrorCountInfo(m_sqliteIndexStorage.getAllErrorInfos());
+  return m_sqliteIndexStorage.getErrorCountInfo(ErrorFilter());
+}
+
+ErrorCountInfo PersistentStorage::getFilteredErrorCount(const ErrorFilter& filter) const {
+  return m_sqliteIndexStorage.getErrorCountInfo(filter);
 }
 
 std::vector<ErrorInfo> PersistentStorage::getErrorsLimited(const ErrorFilter& filter) const {
-  return filter.filterErrors(m_sqliteIndexStorage.getAllErrorInfos());
+  return m_sqliteIndexStorage.getErrorInfos(filter);
 }
 
 std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(const ErrorFilter& filter, const FilePath& filePath) const {
@@ -1459,14 +1521,7 @@ std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(const ErrorFil
     fileIdsToProcess = nextFileIdsToProcess;
   }
 
-  std::vector<ErrorInfo> res;
-
-  std::vector<ErrorInfo> errors = m_sqliteIndexStorage.getAllErrorInfos();
-  for(const ErrorInfo& error : errors) {
-    if(filter.filter(error) && fileIds.find(getFileNodeId(FilePath(error.filePath))) != fileIds.end()) {
-      res.push_back(error);
-    }
-  }
+  std::vector<ErrorInfo> res = m_sqliteIndexStorage.getErrorInfosInFiles(filter, fileIds);
 
   if(res.empty()) {
     std::unordered_map<Id, std::set<Id>> includingMap = getFileIdToIncludingFileIdMap();
@@ -1483,11 +1538,11 @@ std::vector<ErrorInfo> PersistentStorage::getErrorsForFileLimited(const ErrorFil
       fileIdsToProcess = nextFileIdsToProcess;
     }
 
-    for(const ErrorInfo& error : errors) {
-      if(error.fatal && filter.filter(error) && fileIds.find(getFileNodeId(FilePath(error.filePath))) != fileIds.end()) {
-        res.push_back(error);
-      }
-    }
+    // only fatal errors of including files are shown
+    ErrorFilter fatalFilter = filter;
+    fatalFilter.error = false;
+    fatalFilter.unindexedError = false;
+    res = m_sqliteIndexStorage.getErrorInfosInFiles(fatalFilter, fileIds);
   }
 
   return res;
@@ -2513,6 +2568,16 @@ void PersistentStorage::addInheritanceChainsToGraph(const std::vector<Id>& activ
   }
 }
 
+bool PersistentStorage::isOverviewSymbolNode(Id nodeId, const NodeType& type) const {
+  if(!m_symbolDefinitionKinds.empty()) {
+    auto it = m_symbolDefinitionKinds.find(nodeId);
+    if(it == m_symbolDefinitionKinds.end() || it->second != DEFINITION_EXPLICIT) {
+      return false;
+    }
+  }
+  return type.isPackage() || !m_hierarchyCache.isChildOfVisibleNodeOrInvisible(nodeId);
+}
+
 void PersistentStorage::buildFilePathMaps() {
   m_sqliteIndexStorage.forEach<StorageFile>([&](StorageFile&& file) {
     const FilePath path(file.filePath);
@@ -2540,6 +2605,8 @@ void PersistentStorage::buildSearchIndex() {
         return;
       }
 
+      m_overviewNodeIds[NODE_FILE].push_back(node.id);
+
       auto it = m_fileNodePaths.find(node.id);
       if(it != m_fileNodePaths.end()) {
         FilePath filePath(it->second);
@@ -2551,6 +2618,10 @@ void PersistentStorage::buildSearchIndex() {
         m_fileIndex.addNode(node.id, filePath.wstr(), type);
       }
     } else {
+      if(isOverviewSymbolNode(node.id, type)) {
+        m_overviewNodeIds[type.getOverviewBundleTree().data.isValid() ? type.getKind() : NODE_SYMBOL].push_back(node.id);
+      }
+
       auto it = m_symbolDefinitionKinds.find(node.id);
       const DefinitionKind defKind = (it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
       if(defKind != DEFINITION_IMPLICIT) {
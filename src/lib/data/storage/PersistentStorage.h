@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 #include "FullTextSearchIndex.h"
@@ -82,6 +83,11 @@ public:
   void setProjectSettingsText(std::string text);
 
   void setup();
+
+  /**
+   * @brief Interrupt index queries of superseded tab activations, see SqliteStorage::enableQueryCancellation.
+   */
+  void enableQueryCancellation();
   void updateVersion();
   void clear();
   void clearCaches();
@@ -94,6 +100,7 @@ public:
 
   std::vector<FileInfo> getFileInfoForAllFiles() const;
   std::set<FilePath> getIncompleteFiles() const;
+  std::set<FilePath> getIndexedFiles() const;
   bool getFilePathIndexed(const FilePath& path) const;
 
   void buildCaches();
@@ -146,6 +153,9 @@ public:
    */
   std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const override;
 
+  std::map<NodeKind, size_t> getOverviewBundleCounts() const override;
+  std::shared_ptr<Graph> getGraphForOverviewBundle(NodeKind kind, size_t offset, size_t count) const override;
+
   /**
    * @brief
    *
@@ -206,6 +216,9 @@ public:
 
   std::shared_ptr<TextAccess> getFileContent(const FilePath& filePath, bool showsErrors) const override;
   bool hasContentForFile(const FilePath& filePath) const;
+  std::optional<SqliteIndexStorage::FileContentFingerprint> getFileContentFingerprint(const FilePath& filePath) const;
+  std::map<FilePath, SqliteIndexStorage::FileContentFingerprint> getFileContentFingerprints(
+      const std::vector<FilePath>& filePaths) const;
 
   FileInfo getFileInfoForFileId(Id id) const override;
 
@@ -215,6 +228,7 @@ public:
   StorageStats getStorageStats() const override;
 
   ErrorCountInfo getErrorCount() const override;
+  ErrorCountInfo getFilteredErrorCount(const ErrorFilter& filter) const override;
   std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const override;
   std::vector<ErrorInfo> getErrorsForFileLimited(const ErrorFilter& filter, const FilePath& filePath) const override;
   std::shared_ptr<SourceLocationCollection> getErrorSourceLocations(const std::vector<ErrorInfo>& errors) const override;
@@ -289,6 +303,8 @@ private:
   void addCompleteFlagsToSourceLocationCollection(SourceLocationCollection* collection) const;
   void addInheritanceChainsToGraph(const std::vector<Id>& nodeIds, Graph* graph) const;
 
+  bool isOverviewSymbolNode(Id nodeId, const NodeType& type) const;
+
   void buildFilePathMaps();
   void buildSearchIndex();
   void buildFullTextSearchIndex() const;
@@ -319,6 +335,7 @@ private:
 
   std::unordered_map<Id, DefinitionKind> m_symbolDefinitionKinds;
   std::map<Id, Id> m_memberEdgeIdOrderMap;
+  std::map<NodeKind, std::vector<Id>> m_overviewNodeIds;    // top level nodes of the overview by bundle kind
 
   HierarchyCache m_hierarchyCache;
 };
@@ -1,9 +1,10 @@
 #include "Storage.h"
 
 #include <cstddef>
-#include <map>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "logging.h"
@@ -12,52 +13,97 @@ Storage::Storage() = default;
 
 Storage::~Storage() = default;
 
-// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+namespace {
+// Id of an element in one of the injected storages, the ids of different storages overlap.
+using InjectedId = std::pair<size_t, Id>;
+
+struct InjectedIdHash {
+  size_t operator()(const InjectedId& injectedId) const noexcept {
+    return std::hash<Id>{}(injectedId.second) ^ (std::hash<size_t>{}(injectedId.first) << 1U);
+  }
+};
+
+using InjectedIdMap = std::unordered_map<InjectedId, Id, InjectedIdHash>;
+
+Id findOwnId(const InjectedIdMap& injectedIdToOwnId, size_t storageIndex, Id injectedId) {
+  auto iterator = injectedIdToOwnId.find({storageIndex, injectedId});
+  return iterator != injectedIdToOwnId.end() ? iterator->second : 0;
+}
+}    // namespace
+
 void Storage::inject(Storage* injected) {
+  inject(std::vector<Storage*>{injected});
+}
+
+// NOLINTNEXTLINE(readability-function-cognitive-complexity)
+void Storage::inject(const std::vector<Storage*>& injected) {
   const std::lock_guard<std::mutex> lock(mDataMutex);
 
-  std::map<Id, Id> injectedIdToOwnElementId;
-  std::map<Id, Id> injectedIdToOwnSourceLocationId;
+  // one mapping for all injected storages, so each category is added to this storage in a single batch
+  InjectedIdMap injectedIdToOwnElementId;
+  InjectedIdMap injectedIdToOwnSourceLocationId;
+  {
+    size_t elementCount = 0;
+    size_t sourceLocationCount = 0;
+    for(const Storage* storage : injected) {
+      elementCount += storage->getErrors().size() + storage->getStorageNodes().size() + storage->getStorageEdges().size() +
+          storage->getStorageLocalSymbols().size();
+      sourceLocationCount += storage->getStorageSourceLocations().size();
+    }
+    injectedIdToOwnElementId.reserve(elementCount);
+    injectedIdToOwnSourceLocationId.reserve(sourceLocationCount);
+  }
 
   startInjection();
 
   {
-    for(const StorageError& error : injected->getErrors()) {
-      Id errorId = addError(error);
-      injectedIdToOwnElementId.emplace(error.id, errorId);
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageError& error : injected[storageIndex]->getErrors()) {
+        Id errorId = addError(error);
+        injectedIdToOwnElementId.emplace(InjectedId(storageIndex, error.id), errorId);
+      }
     }
   }
 
   {
-    const std::vector<StorageNode>& nodes = injected->getStorageNodes();
+    std::vector<StorageNode> nodes;
+    std::vector<InjectedId> nodeInjectedIds;
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageNode& node : injected[storageIndex]->getStorageNodes()) {
+        nodes.push_back(node);
+        nodeInjectedIds.emplace_back(storageIndex, node.id);
+      }
+    }
 
     std::vector<Id> nodeIds = addNodes(nodes);
 
     for(size_t i = 0; i < nodes.size(); i++) {
       if(nodeIds[i] != 0U) {
-        injectedIdToOwnElementId.emplace(nodes[i].id, nodeIds[i]);
+        injectedIdToOwnElementId.emplace(nodeInjectedIds[i], nodeIds[i]);
       }
     }
   }
 
   {
-    for(const StorageFile& file : injected->getStorageFiles()) {
-      if(auto iterator = injectedIdToOwnElementId.find(file.id); iterator != injectedIdToOwnElementId.end()) {
-        addFile(StorageFile(
-            iterator->second, file.filePath, file.languageIdentifier, file.modificationTime, file.indexed, file.complete));
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageFile& file : injected[storageIndex]->getStorageFiles()) {
+        if(const Id fileId = findOwnId(injectedIdToOwnElementId, storageIndex, file.id); fileId != 0U) {
+          addFile(StorageFile(
+              fileId, file.filePath, file.languageIdentifier, file.modificationTime, file.indexed, file.complete));
+        }
       }
     }
   }
 
   {
-    std::vector<StorageSymbol> symbols = injected->getStorageSymbols();
-    for(size_t i = 0; i < symbols.size(); i++) {
-      if(auto iterator = injectedIdToOwnElementId.find(symbols[i].id); iterator != injectedIdToOwnElementId.end()) {
-        symbols[i].id = iterator->second;
-      } else {
-        LOG_WARNING("New symbol id could not be found.");
-        symbols.erase(symbols.begin() + static_cast<long>(i));
-        i--;
+    std::vector<StorageSymbol> symbols;
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageSymbol& symbol : injected[storageIndex]->getStorageSymbols()) {
+        if(const Id symbolId = findOwnId(injectedIdToOwnElementId, storageIndex, symbol.id); symbolId != 0U) {
+          symbols.emplace_back(symbolId, symbol.definitionKind);
+        } else {
+          LOG_WARNING("New symbol id could not be found.");
+        }
       }
     }
 
@@ -65,27 +111,20 @@ void Storage::inject(Storage* injected) {
   }
 
   {
-    std::vector<StorageEdge> edges = injected->getStorageEdges();
-    for(size_t i = 0; i < edges.size(); i++) {
-      StorageEdge& edge = edges[i];
-      size_t updateCount = 0;
-
-      auto iterator = injectedIdToOwnElementId.find(edge.sourceNodeId);
-      if(iterator != injectedIdToOwnElementId.end()) {
-        edge.sourceNodeId = iterator->second;
-        updateCount++;
-      }
-
-      iterator = injectedIdToOwnElementId.find(edge.targetNodeId);
-      if(iterator != injectedIdToOwnElementId.end()) {
-        edge.targetNodeId = iterator->second;
-        updateCount++;
-      }
+    std::vector<StorageEdge> edges;
+    std::vector<InjectedId> edgeInjectedIds;
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageEdge& edge : injected[storageIndex]->getStorageEdges()) {
+        const Id sourceNodeId = findOwnId(injectedIdToOwnElementId, storageIndex, edge.sourceNodeId);
+        const Id targetNodeId = findOwnId(injectedIdToOwnElementId, storageIndex, edge.targetNodeId);
+
+        if(sourceNodeId == 0U || targetNodeId == 0U) {
+          LOG_WARNING("New edge source or target id could not be found.");
+          continue;
+        }
 
-      if(updateCount != 2) {
-        LOG_WARNING("New edge source or target id could not be found.");
-        edges.erase(edges.begin() + static_cast<long>(i));
-        i--;
+        edges.emplace_back(edge.id, edge.type, sourceNodeId, targetNodeId);
+        edgeInjectedIds.emplace_back(storageIndex, edge.id);
       }
     }
 
@@ -94,7 +133,7 @@ void Storage::inject(Storage* injected) {
     if(edges.size() == edgeIds.size()) {
       for(size_t i = 0; i < edgeIds.size(); i++) {
         if(edgeIds[i] != 0U) {
-          injectedIdToOwnElementId.emplace(edges[i].id, edgeIds[i]);
+          injectedIdToOwnElementId.emplace(edgeInjectedIds[i], edgeIds[i]);
         }
       }
     } else {
@@ -103,28 +142,37 @@ void Storage::inject(Storage* injected) {
   }
 
   {
-    const std::set<StorageLocalSymbol>& symbols = injected->getStorageLocalSymbols();
-    std::vector<Id> symbolIds = addLocalSymbols(symbols);
-
-    auto iterator = symbols.begin();
-    for(size_t i = 0; i < symbols.size(); i++) {
-      if(symbolIds[i] != 0U) {
-        injectedIdToOwnElementId.emplace(iterator->id, symbolIds[i]);
+    // local symbols are passed as a set, which would fold equal symbols of different storages, so they are added per storage
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      const std::set<StorageLocalSymbol>& symbols = injected[storageIndex]->getStorageLocalSymbols();
+      std::vector<Id> symbolIds = addLocalSymbols(symbols);
+
+      auto iterator = symbols.begin();
+      for(size_t i = 0; i < symbols.size(); i++) {
+        if(symbolIds[i] != 0U) {
+          injectedIdToOwnElementId.emplace(InjectedId(storageIndex, iterator->id), symbolIds[i]);
+        }
+        iterator++;
       }
-      iterator++;
     }
   }
 
   {
-    const std::set<StorageSourceLocation>& oldLocations = injected->getStorageSourceLocations();
     std::vector<StorageSourceLocation> locations;
-    locations.reserve(oldLocations.size());
-
-    for(const StorageSourceLocation& location : oldLocations) {
-      if(auto iterator = injectedIdToOwnElementId.find(location.fileNodeId); iterator != injectedIdToOwnElementId.end()) {
-        const Id ownFileNodeId = iterator->second;
-        locations.emplace_back(
-            location.id, ownFileNodeId, location.startLine, location.startCol, location.endLine, location.endCol, location.type);
+    std::vector<InjectedId> locationInjectedIds;
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageSourceLocation& location : injected[storageIndex]->getStorageSourceLocations()) {
+        const Id ownFileNodeId = findOwnId(injectedIdToOwnElementId, storageIndex, location.fileNodeId);
+        if(ownFileNodeId != 0U) {
+          locations.emplace_back(location.id,
+                                 ownFileNodeId,
+                                 location.startLine,
+                                 location.startCol,
+                                 location.endLine,
+                                 location.endCol,
+                                 location.type);
+          locationInjectedIds.emplace_back(storageIndex, location.id);
+        }
       }
     }
 
@@ -133,7 +181,7 @@ void Storage::inject(Storage* injected) {
     if(locations.size() == locationIds.size()) {
       for(size_t i = 0; i < locationIds.size(); i++) {
         if(locationIds[i] != 0U) {
-          injectedIdToOwnSourceLocationId.emplace(locations[i].id, locationIds[i]);
+          injectedIdToOwnSourceLocationId.emplace(locationInjectedIds[i], locationIds[i]);
         }
       }
     } else {
@@ -142,31 +190,19 @@ void Storage::inject(Storage* injected) {
   }
 
   {
-    const std::set<StorageOccurrence>& oldOccurrences = injected->getStorageOccurrences();
-
     std::vector<StorageOccurrence> occurrences;
-    occurrences.reserve(oldOccurrences.size());
-
-    for(const StorageOccurrence& occurrence : oldOccurrences) {
-      Id elementId = 0;
-      Id sourceLocationId = 0;
-
-      auto iterator = injectedIdToOwnElementId.find(occurrence.elementId);
-      if(iterator != injectedIdToOwnElementId.end()) {
-        elementId = iterator->second;
-      }
-
-      iterator = injectedIdToOwnSourceLocationId.find(occurrence.sourceLocationId);
-      if(iterator != injectedIdToOwnSourceLocationId.end()) {
-        sourceLocationId = iterator->second;
-      }
-
-      if(elementId == 0U) {
-        LOG_WARNING("New occurrence element id could not be found.");
-      } else if(sourceLocationId == 0U) {
-        LOG_WARNING("New occurrence location id could not be found.");
-      } else {
-        occurrences.emplace_back(elementId, sourceLocationId);
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageOccurrence& occurrence : injected[storageIndex]->getStorageOccurrences()) {
+        const Id elementId = findOwnId(injectedIdToOwnElementId, storageIndex, occurrence.elementId);
+        const Id sourceLocationId = findOwnId(injectedIdToOwnSourceLocationId, storageIndex, occurrence.sourceLocationId);
+
+        if(elementId == 0U) {
+          LOG_WARNING("New occurrence element id could not be found.");
+        } else if(sourceLocationId == 0U) {
+          LOG_WARNING("New occurrence location id could not be found.");
+        } else {
+          occurrences.emplace_back(elementId, sourceLocationId);
+        }
       }
     }
 
@@ -174,13 +210,12 @@ void Storage::inject(Storage* injected) {
   }
 
   {
-    const std::set<StorageElementComponent>& oldComponents = injected->getElementComponents();
     std::vector<StorageElementComponent> components;
-    components.reserve(oldComponents.size());
-
-    for(const StorageElementComponent& component : oldComponents) {
-      if(auto iterator = injectedIdToOwnElementId.find(component.elementId); iterator != injectedIdToOwnElementId.end()) {
-        components.emplace_back(iterator->second, component.type, component.data);
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageElementComponent& component : injected[storageIndex]->getElementComponents()) {
+        if(const Id elementId = findOwnId(injectedIdToOwnElementId, storageIndex, component.elementId); elementId != 0U) {
+          components.emplace_back(elementId, component.type, component.data);
+        }
       }
     }
 
@@ -188,13 +223,12 @@ void Storage::inject(Storage* injected) {
   }
 
   {
-    const std::set<StorageComponentAccess>& oldAccesses = injected->getComponentAccesses();
     std::vector<StorageComponentAccess> accesses;
-    accesses.reserve(oldAccesses.size());
-
-    for(const StorageComponentAccess& access : oldAccesses) {
-      if(auto iterator = injectedIdToOwnElementId.find(access.nodeId); iterator != injectedIdToOwnElementId.end()) {
-        accesses.emplace_back(iterator->second, access.type);
+    for(size_t storageIndex = 0; storageIndex < injected.size(); storageIndex++) {
+      for(const StorageComponentAccess& access : injected[storageIndex]->getComponentAccesses()) {
+        if(const Id nodeId = findOwnId(injectedIdToOwnElementId, storageIndex, access.nodeId); nodeId != 0U) {
+          accesses.emplace_back(nodeId, access.type);
+        }
       }
     }
 
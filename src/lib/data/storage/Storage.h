@@ -7,6 +7,7 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "GlobalId.hpp"
 #include "StorageComponentAccess.h"
@@ -223,6 +224,15 @@ public:
    */
   void inject(Storage* injected);
 
+  /**
+   * @brief Injects several Storage objects into this one in a single pass.
+   *
+   * Each category is added in one batch for all injected storages, the ids are remapped with one mapping keyed by
+   * storage and id.
+   * @param injected Pointers to the Storage objects to be injected.
+   */
+  void inject(const std::vector<Storage*>& injected);
+
 private:
   /**
    * @brief Starts the injection process.
@@ -3,6 +3,7 @@
  * @file StorageAccess.h
  * @brief Defines the StorageAccess interface for accessing and manipulating stored data.
  */
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "GlobalId.hpp"
 #include "LocationType.h"
 #include "NodeBookmark.h"
+#include "NodeKind.h"
 #include "SearchMatch.h"
 #include "StorageEdge.h"
 #include "StorageStats.h"
@@ -136,6 +138,26 @@ public:
    */
   [[nodiscard]] virtual std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const = 0;
 
+  /**
+   * @brief Number of top level nodes the overview graph loads at once when a bundle gets split.
+   */
+  static constexpr size_t OverviewBundlePageSize = 1000;
+
+  /**
+   * @brief Get the number of top level nodes in each bundle of the overview graph.
+   * @return Node counts by bundle kind, symbols without a bundle of their own are counted for NODE_SYMBOL.
+   */
+  [[nodiscard]] virtual std::map<NodeKind, size_t> getOverviewBundleCounts() const = 0;
+
+  /**
+   * @brief Get a graph containing one page of the top level nodes in an overview bundle.
+   * @param kind The bundle kind, as returned by getOverviewBundleCounts().
+   * @param offset Index of the first node of the page.
+   * @param count Maximum number of nodes of the page.
+   * @return A shared pointer to a Graph object without edges.
+   */
+  [[nodiscard]] virtual std::shared_ptr<Graph> getGraphForOverviewBundle(NodeKind kind, size_t offset, size_t count) const = 0;
+
   /**
    * @brief Get a graph for active token IDs and expanded node IDs.
    * @param tokenIds Vector of active token IDs.
@@ -284,6 +306,13 @@ public:
    */
   [[nodiscard]] virtual ErrorCountInfo getErrorCount() const = 0;
 
+  /**
+   * @brief Get the error count information of the errors passing a filter, the limit of the filter is ignored.
+   * @param filter An ErrorFilter object specifying the filter criteria.
+   * @return An ErrorCountInfo object containing the count of the filtered errors.
+   */
+  [[nodiscard]] virtual ErrorCountInfo getFilteredErrorCount(const ErrorFilter& filter) const = 0;
+
   /**
    * @brief Get a limited number of errors based on a filter.
    * @param filter An ErrorFilter object specifying the filter criteria.
@@ -401,4 +430,18 @@ public:
    */
   virtual void addErrorsToCache([[maybe_unused]] const std::vector<ErrorInfo>& newErrors,
                                 [[maybe_unused]] const ErrorCountInfo& errorCount) {}
+
+  /**
+   * @brief Hint that the contents of the files in the collection will be requested soon.
+   * @param collection The source location collection whose files may be loaded ahead of time.
+   */
+  virtual void prefetchFileContents([[maybe_unused]] std::shared_ptr<SourceLocationCollection> collection) const {}
+
+  /**
+   * @brief Hint that the tooltips of the tokens will be requested soon.
+   * @param tokenIds The tokens whose tooltips may be created ahead of time, each one on its own.
+   * @param origin The origin of the expected tooltip requests.
+   */
+  virtual void prefetchTooltipInfos([[maybe_unused]] const std::vector<Id>& tokenIds,
+                                    [[maybe_unused]] TooltipOrigin origin) const {}
 };
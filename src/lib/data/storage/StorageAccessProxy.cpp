@@ -130,6 +130,9 @@ DEF_GETTER_3(getAutocompletionMatches, const std::wstring&, NodeTypeSet, bool, s
 DEF_GETTER_1(getSearchMatchesForTokenIds, const std::vector<Id>&, std::vector<SearchMatch>, std::vector<SearchMatch>())
 DEF_GETTER_0(getGraphForAll, std::shared_ptr<Graph>, std::make_shared<Graph>())
 DEF_GETTER_1(getGraphForNodeTypes, NodeTypeSet, std::shared_ptr<Graph>, std::make_shared<Graph>())
+typedef std::map<NodeKind, size_t> OverviewBundleCounts;
+DEF_GETTER_0(getOverviewBundleCounts, OverviewBundleCounts, {})
+DEF_GETTER_3(getGraphForOverviewBundle, NodeKind, size_t, size_t, std::shared_ptr<Graph>, std::make_shared<Graph>())
 DEF_GETTER_3(getGraphForActiveTokenIds,
              const std::vector<Id>&,
              const std::vector<Id>&,
@@ -172,6 +175,7 @@ DEF_GETTER_1(getFileInfoForFilePath, const FilePath&, FileInfo, FileInfo())
 DEF_GETTER_1(getFileInfosForFilePaths, const std::vector<FilePath>&, std::vector<FileInfo>, {})
 DEF_GETTER_0(getStorageStats, StorageStats, StorageStats())
 DEF_GETTER_0(getErrorCount, ErrorCountInfo, ErrorCountInfo())
+DEF_GETTER_1(getFilteredErrorCount, const ErrorFilter&, ErrorCountInfo, ErrorCountInfo())
 DEF_GETTER_1(getErrorsLimited, const ErrorFilter&, std::vector<ErrorInfo>, {})
 DEF_GETTER_2(getErrorsForFileLimited, const ErrorFilter&, const FilePath&, std::vector<ErrorInfo>, {})
 DEF_GETTER_1(getErrorSourceLocations,
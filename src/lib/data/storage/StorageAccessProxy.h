@@ -32,6 +32,8 @@ public:
 
   std::shared_ptr<Graph> getGraphForAll() const override;
   std::shared_ptr<Graph> getGraphForNodeTypes(NodeTypeSet nodeTypes) const override;
+  std::map<NodeKind, size_t> getOverviewBundleCounts() const override;
+  std::shared_ptr<Graph> getGraphForOverviewBundle(NodeKind kind, size_t offset, size_t count) const override;
   std::shared_ptr<Graph> getGraphForActiveTokenIds(const std::vector<Id>& tokenIds,
                                                    const std::vector<Id>& expandedNodeIds,
                                                    bool* isActiveNamespace = nullptr) const override;
@@ -69,6 +71,7 @@ public:
   StorageStats getStorageStats() const override;
 
   ErrorCountInfo getErrorCount() const override;
+  ErrorCountInfo getFilteredErrorCount(const ErrorFilter& filter) const override;
   std::vector<ErrorInfo> getErrorsLimited(const ErrorFilter& filter) const override;
   std::vector<ErrorInfo> getErrorsForFileLimited(const ErrorFilter& filter, const FilePath& filePath) const override;
   std::shared_ptr<SourceLocationCollection> getErrorSourceLocations(const std::vector<ErrorInfo>& errors) const override;
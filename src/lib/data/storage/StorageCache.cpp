@@ -1,16 +1,35 @@
 #include "StorageCache.h"
 
+#include <numeric>
+
+#include "FileInfo.h"
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
+#include "TabId.h"
+#include "TaskLambda.h"
 #include "TextAccess.h"
 #include "utility.h"
+#include "utilityString.h"
+
+StorageCache::StorageCache() : mFileContents(FileContentCacheByteBudget), mTooltipInfos(TooltipCacheByteBudget) {}
 
 void StorageCache::clear() {
   mGraphForAll.reset();
   mStorageStats = {};
+  clearFileContents();
+  mTooltipGeneration++;
+  mTooltipInfos.clear();
   setUseErrorCache(false);
 }
 
+void StorageCache::clearFileContents() {
+  {
+    const std::lock_guard<std::mutex> lock(mFileContentKeysMutex);
+    mFileContentKeys.clear();
+  }
+  mFileContents.clear();
+}
+
 std::shared_ptr<Graph> StorageCache::getGraphForAll() const {
   if(!mGraphForAll) {
     mGraphForAll = StorageAccessProxy::getGraphForAll();
@@ -32,7 +51,19 @@ std::shared_ptr<TextAccess> StorageCache::getFileContent(const FilePath& filePat
     return TextAccess::createFromFile(filePath);
   }
 
-  return StorageAccessProxy::getFileContent(filePath, showsErrors);
+  const std::wstring key = getFileContentCacheKey(filePath);
+  if(auto cached = mFileContents.getValue(key)) {
+    return *cached;
+  }
+
+  std::shared_ptr<TextAccess> fileContent = StorageAccessProxy::getFileContent(filePath, showsErrors);
+  if(fileContent) {
+    const std::vector<std::string>& lines = fileContent->getAllLines();
+    const size_t byteSize = std::accumulate(
+        lines.begin(), lines.end(), size_t{0}, [](size_t sum, const std::string& line) { return sum + line.size(); });
+    mFileContents.setValue(key, fileContent, byteSize);
+  }
+  return fileContent;
 }
 
 ErrorCountInfo StorageCache::getErrorCount() const {
@@ -43,6 +74,16 @@ ErrorCountInfo StorageCache::getErrorCount() const {
   return mErrorCount;
 }
 
+ErrorCountInfo StorageCache::getFilteredErrorCount(const ErrorFilter& filter) const {
+  if(!mUseErrorCache) {
+    return StorageAccessProxy::getFilteredErrorCount(filter);
+  }
+
+  ErrorFilter filterUnlimited = filter;
+  filterUnlimited.limit = 0;
+  return ErrorCountInfo(filterUnlimited.filterErrors(mCachedErrors));
+}
+
 std::vector<ErrorInfo> StorageCache::getErrorsLimited(const ErrorFilter& filter) const {
   if(!mUseErrorCache) {
     return StorageAccessProxy::getErrorsLimited(filter);
@@ -93,3 +134,111 @@ void StorageCache::addErrorsToCache(const std::vector<ErrorInfo>& newErrors, con
   utility::append(mCachedErrors, newErrors);
   mErrorCount = errorCount;
 }
+
+void StorageCache::prefetchFileContents(std::shared_ptr<SourceLocationCollection> collection) const {
+  if(!collection || collection->getSourceLocationFileCount() == 0) {
+    return;
+  }
+
+  Task::dispatch(TabId::background(), std::make_shared<TaskLambda>([this, collection = std::move(collection)]() {
+                   collection->forEachSourceLocationFile([this](const std::shared_ptr<SourceLocationFile>& file) {
+                     if(!mFileContents.contains(getFileContentCacheKey(file->getFilePath()))) {
+                       std::ignore = getFileContent(file->getFilePath(), false);
+                     }
+                   });
+                 }));
+}
+
+TooltipInfo StorageCache::getTooltipInfoForTokenIds(const std::vector<Id>& tokenIds, TooltipOrigin origin) const {
+  const std::string key = getTooltipCacheKey(tokenIds, origin);
+  if(auto cached = mTooltipInfos.getValue(key)) {
+    return *cached;
+  }
+
+  const size_t generation = mTooltipGeneration;
+  TooltipInfo info = StorageAccessProxy::getTooltipInfoForTokenIds(tokenIds, origin);
+  cacheTooltipInfo(key, info, generation);
+  return info;
+}
+
+void StorageCache::prefetchTooltipInfos(const std::vector<Id>& tokenIds, TooltipOrigin origin) const {
+  std::vector<Id> missingTokenIds;
+  for(const Id tokenId : tokenIds) {
+    if(!mTooltipInfos.contains(getTooltipCacheKey({tokenId}, origin))) {
+      missingTokenIds.push_back(tokenId);
+    }
+  }
+
+  if(missingTokenIds.empty()) {
+    return;
+  }
+
+  const size_t generation = mTooltipGeneration;
+  auto task = std::make_shared<TaskLambda>([this, tokenIds = std::move(missingTokenIds), origin, generation]() {
+    for(const Id tokenId : tokenIds) {
+      // the storage changed, so the remaining tooltips would be outdated
+      if(generation != mTooltipGeneration) {
+        return;
+      }
+
+      const std::string key = getTooltipCacheKey({tokenId}, origin);
+      if(!mTooltipInfos.contains(key)) {
+        cacheTooltipInfo(key, StorageAccessProxy::getTooltipInfoForTokenIds({tokenId}, origin), generation);
+      }
+    }
+  });
+  Task::dispatch(TabId::background(), task);
+}
+
+size_t StorageCache::getFileContentCacheHitCount() const {
+  return mFileContents.getHitCount();
+}
+
+size_t StorageCache::getFileContentCacheMissCount() const {
+  return mFileContents.getMissCount();
+}
+
+size_t StorageCache::getTooltipCacheHitCount() const {
+  return mTooltipInfos.getHitCount();
+}
+
+std::wstring StorageCache::getFileContentCacheKey(const FilePath& filePath) const {
+  {
+    const std::lock_guard<std::mutex> lock(mFileContentKeysMutex);
+    if(auto iterator = mFileContentKeys.find(filePath.wstr()); iterator != mFileContentKeys.end()) {
+      return iterator->second;
+    }
+  }
+
+  std::wstring key;
+  if(const Id fileId = StorageAccessProxy::getNodeIdForFileNode(filePath); fileId != 0) {
+    const FileInfo fileInfo = StorageAccessProxy::getFileInfoForFileId(fileId);
+    key = std::to_wstring(fileId) + L'|' + utility::decodeFromUtf8(fileInfo.lastWriteTime.toString());
+  } else {
+    key = L'|' + filePath.wstr();
+  }
+
+  const std::lock_guard<std::mutex> lock(mFileContentKeysMutex);
+  mFileContentKeys.emplace(filePath.wstr(), key);
+  return key;
+}
+
+std::string StorageCache::getTooltipCacheKey(const std::vector<Id>& tokenIds, TooltipOrigin origin) {
+  std::string key = std::to_string(origin);
+  for(const Id tokenId : tokenIds) {
+    key += ',' + std::to_string(tokenId);
+  }
+  return key;
+}
+
+void StorageCache::cacheTooltipInfo(const std::string& key, const TooltipInfo& info, size_t generation) const {
+  if(!info.isValid() || generation != mTooltipGeneration) {
+    return;
+  }
+
+  size_t byteSize = sizeof(TooltipInfo) + info.title.size() * sizeof(wchar_t) + info.countText.size();
+  for(const TooltipSnippet& snippet : info.snippets) {
+    byteSize += sizeof(TooltipSnippet) + snippet.code.size() * sizeof(wchar_t);
+  }
+  mTooltipInfos.setValue(key, info, byteSize);
+}
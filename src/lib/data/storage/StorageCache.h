@@ -8,7 +8,12 @@
  * @copyright Copyright (c) 2025
  */
 #pragma once
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
 
+#include "LruCache.h"
 #include "StorageAccessProxy.h"
 
 /**
@@ -16,11 +21,28 @@
  */
 class StorageCache : public StorageAccessProxy {
 public:
+  /**
+   * @brief Upper bound for the decoded file contents kept in memory.
+   */
+  static constexpr size_t FileContentCacheByteBudget = 64 * 1024 * 1024;
+
+  /**
+   * @brief Upper bound for the tooltips kept in memory.
+   */
+  static constexpr size_t TooltipCacheByteBudget = 8 * 1024 * 1024;
+
+  StorageCache();
+
   /**
    * @brief Clear stored data.
    */
   void clear();
 
+  /**
+   * @brief Drop the cached file contents, called when a refresh replaced the indexed files.
+   */
+  void clearFileContents();
+
   /**
    * @brief Get the Graph For All object
    *
@@ -51,6 +73,14 @@ public:
    */
   [[nodiscard]] ErrorCountInfo getErrorCount() const override;
 
+  /**
+   * @brief Get the Filtered Error Count object
+   *
+   * @param filter The error filter, its limit is ignored.
+   * @return ErrorCountInfo The count of the filtered errors.
+   */
+  [[nodiscard]] ErrorCountInfo getFilteredErrorCount(const ErrorFilter& filter) const override;
+
   /**
    * @brief Get the Errors Limited object
    *
@@ -91,7 +121,65 @@ public:
    */
   void addErrorsToCache(const std::vector<ErrorInfo>& newErrors, const ErrorCountInfo& errorCount) override;
 
+  /**
+   * @brief Load the contents of all files in the collection into the file content cache on a background thread.
+   *
+   * @param collection The source location collection.
+   */
+  void prefetchFileContents(std::shared_ptr<SourceLocationCollection> collection) const override;
+
+  /**
+   * @brief Get the Tooltip Info object, cached until the next clear.
+   *
+   * @param tokenIds The token ids.
+   * @param origin The origin of the tooltip request.
+   * @return TooltipInfo The tooltip info.
+   */
+  [[nodiscard]] TooltipInfo getTooltipInfoForTokenIds(const std::vector<Id>& tokenIds, TooltipOrigin origin) const override;
+
+  /**
+   * @brief Create the tooltips of the tokens that are not cached yet on a background thread.
+   *
+   * @param tokenIds The token ids.
+   * @param origin The origin of the expected tooltip requests.
+   */
+  void prefetchTooltipInfos(const std::vector<Id>& tokenIds, TooltipOrigin origin) const override;
+
+  /**
+   * @brief Get the number of file content requests answered from the cache.
+   */
+  [[nodiscard]] size_t getFileContentCacheHitCount() const;
+
+  /**
+   * @brief Get the number of file content requests that had to be loaded from the storage.
+   */
+  [[nodiscard]] size_t getFileContentCacheMissCount() const;
+
+  /**
+   * @brief Get the number of tooltip requests answered from the cache.
+   */
+  [[nodiscard]] size_t getTooltipCacheHitCount() const;
+
 private:
+  /**
+   * @brief Files are keyed by their storage file id and indexed modification time, the key of a path is looked up once
+   * until the file contents are cleared. Files that are not in the storage are keyed by path.
+   */
+  std::wstring getFileContentCacheKey(const FilePath& filePath) const;
+
+  static std::string getTooltipCacheKey(const std::vector<Id>& tokenIds, TooltipOrigin origin);
+
+  /**
+   * @brief Stores the tooltip unless the cache was cleared since the given generation.
+   */
+  void cacheTooltipInfo(const std::string& key, const TooltipInfo& info, size_t generation) const;
+
+  mutable LruCache<std::wstring, std::shared_ptr<TextAccess>> mFileContents;
+  mutable std::mutex mFileContentKeysMutex;
+  mutable std::map<std::wstring, std::wstring> mFileContentKeys;
+  mutable LruCache<std::string, TooltipInfo> mTooltipInfos;
+  std::atomic<size_t> mTooltipGeneration = 0;
+
   mutable std::shared_ptr<Graph> mGraphForAll;
   mutable StorageStats mStorageStats;
 
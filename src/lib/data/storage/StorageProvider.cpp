@@ -1,6 +1,8 @@
 #include "StorageProvider.h"
 
-#include <range/v3/algorithm/find_if.hpp>
+#include <range/v3/algorithm/max_element.hpp>
+
+#include "logging.h"
 
 int StorageProvider::getStorageCount() const noexcept {
   const std::lock_guard lock(mStoragesMutex);
@@ -19,9 +21,7 @@ nonstd::expected<void, std::string> StorageProvider::insert(std::shared_ptr<Inte
   const std::size_t storageSize = storage->getSourceLocationCount();
 
   const std::lock_guard lock(mStoragesMutex);
-  const auto iterator = ranges::find_if(
-      mStorages, [storageSize](const auto& currentStorage) { return currentStorage->getSourceLocationCount() < storageSize; });
-  std::ignore = mStorages.insert(iterator, std::move(storage));
+  std::ignore = mStorages.emplace(storageSize, std::move(storage));
   return {};
 }
 
@@ -29,9 +29,8 @@ nonstd::expected<std::shared_ptr<IntermediateStorage>, std::string> StorageProvi
   {
     const std::lock_guard lock(mStoragesMutex);
     if(mStorages.size() > 1) {
-      auto iterator = mStorages.begin();
-      ++iterator;
-      auto storage = *iterator;
+      auto iterator = std::next(mStorages.begin());
+      auto storage = std::move(iterator->second);
       mStorages.erase(iterator);
       return storage;
     }
@@ -43,10 +42,48 @@ nonstd::expected<std::shared_ptr<IntermediateStorage>, std::string> StorageProvi
   {
     const std::lock_guard lock(mStoragesMutex);
     if(!mStorages.empty()) {
-      auto ret = mStorages.front();
-      mStorages.pop_front();
+      auto ret = std::move(mStorages.begin()->second);
+      mStorages.erase(mStorages.begin());
       return ret;
     }
   }
   return nonstd::make_unexpected("No Storage found");
 }
+
+std::vector<std::shared_ptr<IntermediateStorage>> StorageProvider::consumeStoragesToMerge(size_t maxCount) noexcept {
+  std::vector<std::shared_ptr<IntermediateStorage>> storages;
+
+  const std::lock_guard lock(mStoragesMutex);
+  if(mStorages.size() < 2) {
+    return storages;
+  }
+
+  auto iterator = std::next(mStorages.begin());
+  while(iterator != mStorages.end() && storages.size() < maxCount) {
+    storages.push_back(std::move(iterator->second));
+    iterator = mStorages.erase(iterator);
+  }
+  return storages;
+}
+
+std::shared_ptr<IntermediateStorage> StorageProvider::merge(std::vector<std::shared_ptr<IntermediateStorage>> storages) {
+  std::erase(storages, nullptr);
+  if(storages.empty()) {
+    return nullptr;
+  }
+
+  // the cost of an injection depends on the injected size only, so the largest storage is the target
+  auto target = ranges::max_element(storages, std::less<>{}, [](const auto& storage) { return storage->getSourceLocationCount(); });
+  std::iter_swap(storages.begin(), target);
+
+  const std::shared_ptr<IntermediateStorage>& result = storages.front();
+  std::vector<Storage*> injected;
+  injected.reserve(storages.size() - 1);
+  for(auto iterator = std::next(storages.begin()); iterator != storages.end(); ++iterator) {
+    injected.push_back(iterator->get());
+  }
+  result->inject(injected);
+
+  LOG_INFO("merged {} storages, {} source locations", storages.size(), result->getSourceLocationCount());
+  return result;
+}
@@ -8,9 +8,11 @@
  * @copyright Copyright (c) 2025
  */
 #pragma once
-#include <list>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <nonstd/expected.hpp>
 
@@ -65,7 +67,31 @@ public:
    */
   nonstd::expected<std::shared_ptr<IntermediateStorage>, std::string> consumeLargestStorage() noexcept;
 
+  /**
+   * @brief Consume storages for a merge, starting with the second-largest
+   *
+   * The largest storage is left for injection.
+   *
+   * @note This function is thread-safe
+   *
+   * @param maxCount The maximum number of storages to consume
+   * @return std::vector<std::shared_ptr<IntermediateStorage>> The consumed storages, larger storages first
+   */
+  std::vector<std::shared_ptr<IntermediateStorage>> consumeStoragesToMerge(size_t maxCount) noexcept;
+
+  /**
+   * @brief Merge storages in one pass
+   *
+   * All other storages are injected into the largest one in a single injection, so each element is copied a single time
+   * and the largest storage is only locked and updated once.
+   *
+   * @param storages The storages to merge, larger storages first
+   * @return std::shared_ptr<IntermediateStorage> The merged storage or nullptr if there is nothing to merge
+   */
+  static std::shared_ptr<IntermediateStorage> merge(std::vector<std::shared_ptr<IntermediateStorage>> storages);
+
 private:
-  std::list<std::shared_ptr<IntermediateStorage>> mStorages;    // larger storages are in front
+  // keyed by source location count, larger storages are in front
+  std::multimap<std::size_t, std::shared_ptr<IntermediateStorage>, std::greater<>> mStorages;
   mutable std::mutex mStoragesMutex;
 };
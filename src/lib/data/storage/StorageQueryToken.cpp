@@ -0,0 +1,43 @@
+#include "StorageQueryToken.h"
+
+#include <map>
+#include <mutex>
+
+namespace {
+std::mutex s_latestActivationIdsMutex;
+std::map<Id, Id> s_latestActivationIds;
+
+thread_local const StorageQueryToken* s_currentThreadToken = nullptr;
+}    // namespace
+
+StorageQueryToken::Scope::Scope(const StorageQueryToken& token) : m_previous(s_currentThreadToken) {
+  s_currentThreadToken = &token;
+}
+
+StorageQueryToken::Scope::~Scope() {
+  s_currentThreadToken = m_previous;
+}
+
+void StorageQueryToken::supersede(Id tabId, Id activationId) {
+  const std::scoped_lock<std::mutex> lock(s_latestActivationIdsMutex);
+  s_latestActivationIds[tabId] = activationId;
+}
+
+void StorageQueryToken::clear() {
+  const std::scoped_lock<std::mutex> lock(s_latestActivationIdsMutex);
+  s_latestActivationIds.clear();
+}
+
+bool StorageQueryToken::isCurrentThreadCancelled() {
+  return s_currentThreadToken != nullptr && s_currentThreadToken->isCancelled();
+}
+
+bool StorageQueryToken::isCancelled() const {
+  if(m_tabId == 0) {
+    return false;
+  }
+
+  const std::scoped_lock<std::mutex> lock(s_latestActivationIdsMutex);
+  const auto it = s_latestActivationIds.find(m_tabId);
+  return it != s_latestActivationIds.end() && it->second != m_activationId;
+}
@@ -0,0 +1,76 @@
+#pragma once
+/**
+ * @file StorageQueryToken.h
+ * @brief Generation tokens that let a newer activation of a tab cancel the storage queries of an older one.
+ */
+#include "GlobalId.hpp"
+
+/**
+ * @brief Identifies the activation a storage query is issued for.
+ *
+ * Every activation message dispatched to a tab supersedes the previous one of that tab. Storage queries run inside a
+ * Scope of a superseded token get interrupted by the sqlite progress handler, so the controller can drop their results.
+ */
+class StorageQueryToken final {
+public:
+  /**
+   * @brief Binds a token to the calling thread for the lifetime of the scope.
+   */
+  class Scope final {
+  public:
+    explicit Scope(const StorageQueryToken& token);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    const StorageQueryToken* m_previous;
+  };
+
+  /**
+   * @brief Marks the activation as the latest one of the tab.
+   */
+  static void supersede(Id tabId, Id activationId);
+
+  /**
+   * @brief Forgets all tabs, e.g. when a project gets unloaded.
+   */
+  static void clear();
+
+  /**
+   * @brief Whether the token bound to the calling thread got superseded. Used inside sqlite loops.
+   */
+  static bool isCurrentThreadCancelled();
+
+  StorageQueryToken() = default;
+  StorageQueryToken(Id tabId, Id activationId) : m_tabId(tabId), m_activationId(activationId) {}
+
+  [[nodiscard]] bool isCancelled() const;
+
+  /**
+   * @brief Runs the function with the token bound to the calling thread.
+   *
+   * Errors raised by queries interrupted because of the cancellation are dropped.
+   * @return false if the token got superseded, so the results of the function are stale.
+   */
+  template <typename Function>
+  bool run(Function&& function) const;
+
+private:
+  Id m_tabId = 0;
+  Id m_activationId = 0;
+};
+
+template <typename Function>
+bool StorageQueryToken::run(Function&& function) const {
+  const Scope scope(*this);
+  try {
+    function();
+  } catch(...) {
+    if(!isCancelled()) {
+      throw;
+    }
+  }
+  return !isCancelled();
+}
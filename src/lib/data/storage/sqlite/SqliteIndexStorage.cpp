@@ -1,5 +1,8 @@
 #include "SqliteIndexStorage.h"
 
+#include <filesystem>
+
+#include "FileContent.h"
 #include "FileSystem.h"
 #include "GlobalId.hpp"
 #include "LocationType.h"
@@ -9,7 +12,7 @@
 #include "TextAccess.h"
 #include "utilityString.h"
 
-const size_t SqliteIndexStorage::sStorageVersion = 25;
+const size_t SqliteIndexStorage::sStorageVersion = 26;
 
 namespace {
 std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& name) {
@@ -20,6 +23,62 @@ std::pair<std::wstring, std::wstring> splitLocalSymbolName(const std::wstring& n
 
   return std::make_pair(name.substr(0, pos), name.substr(pos + 1, name.size() - pos - 2));
 }
+
+std::string decompressFileContentField(CppSQLite3Query& query) {
+  int length = 0;
+  const unsigned char* data = query.getBlobField(0, length);
+  if(data == nullptr || length <= 0) {
+    return {};
+  }
+
+  const auto content =
+      utility::decompressFileContent(std::string_view(reinterpret_cast<const char*>(data), static_cast<size_t>(length)));
+  if(!content) {
+    LOG_WARNING("Stored file content could not be decompressed.");
+    return {};
+  }
+  return *content;
+}
+
+// Every occurrence of an error is one error info. Its position among the occurrences of the error is counted by index,
+// so the error info ids do not depend on which other rows a query returns.
+constexpr std::string_view ErrorInfoQuery =
+    "SELECT error.id, error.message, error.fatal, error.indexed, error.translation_unit, "
+    "file.path, source_location.start_line, source_location.start_column, "
+    "(SELECT COUNT(*) FROM occurrence AS previous WHERE previous.element_id = error.id AND "
+    "previous.source_location_id < occurrence.source_location_id), "
+    "occurrence.source_location_id "
+    "FROM error "
+    "CROSS JOIN occurrence ON (occurrence.element_id = error.id) "
+    "INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
+    "INNER JOIN file ON (file.id = source_location.file_node_id)";
+
+constexpr std::string_view ErrorInfoOrder = " ORDER BY error.id, occurrence.source_location_id";
+
+// One ordered query per error type that passes the filter. Each of them reads the error index in id order and stops at
+// the limit, so the first page of errors does not depend on the total error count.
+std::string getFilteredErrorInfoQuery(const ErrorFilter& filter, const std::string& condition, size_t limit) {
+  const std::string limitClause = limit > 0 ? " LIMIT " + std::to_string(limit) : "";
+
+  std::vector<std::string> queries;
+  for(const bool fatal : {false, true}) {
+    for(const bool indexed : {true, false}) {
+      ErrorInfo info;
+      info.fatal = fatal;
+      info.indexed = indexed;
+      if(filter.filter(info)) {
+        queries.push_back("SELECT * FROM (" + std::string(ErrorInfoQuery) + " WHERE error.fatal = " + std::to_string(int(fatal)) +
+                          " AND error.indexed = " + std::to_string(int(indexed)) + condition + std::string(ErrorInfoOrder) +
+                          limitClause + ")");
+      }
+    }
+  }
+
+  if(queries.empty()) {
+    return {};
+  }
+  return utility::join(queries, std::string(" UNION ALL ")) + " ORDER BY 1, 10" + limitClause + ";";
+}
 }    // namespace
 
 size_t SqliteIndexStorage::getStorageVersion() {
@@ -28,7 +87,8 @@ size_t SqliteIndexStorage::getStorageVersion() {
 
 SqliteIndexStorage::SqliteIndexStorage() = default;
 
-SqliteIndexStorage::SqliteIndexStorage(const FilePath& dbFilePath) : SqliteStorage(dbFilePath.getCanonical()) {}
+SqliteIndexStorage::SqliteIndexStorage(const FilePath& dbFilePath, OpenMode openMode)
+    : SqliteStorage(dbFilePath.getCanonical(), openMode) {}
 
 size_t SqliteIndexStorage::getStaticVersion() const {
   return sStorageVersion;
@@ -144,11 +204,22 @@ bool SqliteIndexStorage::addFile(const StorageFile& data) {
     modificationTime = FileSystem::getFileInfoForPath(filePath).lastWriteTime.toString();
   }
 
-  std::shared_ptr<TextAccess> content;
+  std::string compressedContent;
+  std::string contentHash;
   int lineCount = 0;
+  sqlite_int64 fileSize = 0;
   if(data.indexed) {
-    content = TextAccess::createFromFile(filePath);
+    const std::shared_ptr<TextAccess> content = TextAccess::createFromFile(filePath);
+    const std::string text = content->getText();
     lineCount = static_cast<int>(content->getLineCount());
+    contentHash = utility::fileContentHashToString(utility::hashFileContent(text));
+    compressedContent = utility::compressFileContent(text);
+
+    std::error_code errorCode;
+    fileSize = static_cast<sqlite_int64>(std::filesystem::file_size(filePath.str(), errorCode));
+    if(errorCode) {
+      fileSize = 0;
+    }
   }
 
   bool success = false;
@@ -160,12 +231,15 @@ bool SqliteIndexStorage::addFile(const StorageFile& data) {
     m_insertFileStmt.bind(5, data.indexed ? 1 : 0);
     m_insertFileStmt.bind(6, data.complete ? 1 : 0);
     m_insertFileStmt.bind(7, lineCount);
+    m_insertFileStmt.bind(8, fileSize);
+    m_insertFileStmt.bind(9, contentHash.c_str());
     success = executeStatement(m_insertFileStmt);
   }
 
-  if(success && content) {
+  if(success && data.indexed) {
     m_insertFileContentStmt.bind(1, int(data.id));
-    m_insertFileContentStmt.bind(2, content->getText().c_str());
+    m_insertFileContentStmt.bind(
+        2, reinterpret_cast<const unsigned char*>(compressedContent.data()), static_cast<int>(compressedContent.size()));
     success = executeStatement(m_insertFileContentStmt);
   }
 
@@ -407,15 +481,17 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
     updateStatusCallback(1);
   }
 
-  // preparing
+  // preparing, the ids to clear are kept in a temporary table and all following statements start from these ids, so
+  // they only look up rows by primary key or by the indices of the clear mode instead of scanning whole tables
   executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
+  executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 
   if(updateStatusCallback != nullptr) {
     updateStatusCallback(2);
   }
 
   executeStatement(
-      "CREATE TABLE IF NOT EXISTS element_id_to_clear("
+      "CREATE TEMP TABLE element_id_to_clear("
       "id INTEGER NOT NULL, "
       "PRIMARY KEY(id));");
 
@@ -427,8 +503,8 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
   executeStatement(
       "INSERT INTO element_id_to_clear "
       "	SELECT occurrence.element_id "
-      "	FROM occurrence "
-      "	INNER JOIN source_location ON ("
+      "	FROM source_location "
+      "	CROSS JOIN occurrence ON ("
       "		occurrence.source_location_id = source_location.id"
       "	) "
       "	WHERE source_location.file_node_id IN (" +
@@ -442,9 +518,11 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
 
   // delete all edges in element_id_to_clear
   executeStatement(
-      "DELETE FROM element WHERE element.id IN "
-      "	(SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN edge ON "
-      "(element_id_to_clear.id = edge.id))");
+      "DELETE FROM element WHERE id IN ("
+      "	SELECT id FROM element_id_to_clear WHERE EXISTS ("
+      "		SELECT 1 FROM edge WHERE edge.id = element_id_to_clear.id"
+      "	)"
+      ")");
 
   if(updateStatusCallback != nullptr) {
     updateStatusCallback(30);
@@ -452,8 +530,9 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
 
   // delete all edges originating from element_id_to_clear
   executeStatement(
-      "DELETE FROM element WHERE element.id IN (SELECT id FROM edge WHERE source_node_id IN "
-      "(SELECT id FROM element_id_to_clear))");
+      "DELETE FROM element WHERE id IN ("
+      "	SELECT edge.id FROM element_id_to_clear CROSS JOIN edge ON edge.source_node_id = element_id_to_clear.id"
+      ")");
 
   if(updateStatusCallback != nullptr) {
     updateStatusCallback(31);
@@ -462,8 +541,8 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
   // remove all non existing ids from element_id_to_clear (they have been cleared by now and we
   // can disregard them)
   executeStatement(
-      "DELETE FROM element_id_to_clear WHERE id NOT IN ("
-      "	SELECT id FROM element"
+      "DELETE FROM element_id_to_clear WHERE NOT EXISTS ("
+      "	SELECT 1 FROM element WHERE element.id = element_id_to_clear.id"
       ")");
 
   if(updateStatusCallback != nullptr) {
@@ -472,8 +551,8 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
 
   // remove all files from element_id_to_clear (they will be cleared later)
   executeStatement(
-      "DELETE FROM element_id_to_clear WHERE id IN ("
-      "	SELECT id FROM file"
+      "DELETE FROM element_id_to_clear WHERE EXISTS ("
+      "	SELECT 1 FROM file WHERE file.id = element_id_to_clear.id"
       ")");
 
   if(updateStatusCallback != nullptr) {
@@ -489,9 +568,8 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
 
   // remove all ids from element_id_to_clear that still have occurrences
   executeStatement(
-      "DELETE FROM element_id_to_clear WHERE id IN ("
-      "	SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN occurrence ON "
-      "		element_id_to_clear.id = occurrence.element_id"
+      "DELETE FROM element_id_to_clear WHERE EXISTS ("
+      "	SELECT 1 FROM occurrence WHERE occurrence.element_id = element_id_to_clear.id"
       ")");
 
   if(updateStatusCallback != nullptr) {
@@ -500,8 +578,8 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
 
   // remove all ids from element_id_to_clear that still have an edge pointing to them
   executeStatement(
-      "DELETE FROM element_id_to_clear WHERE id IN ("
-      "	SELECT target_node_id FROM edge"
+      "DELETE FROM element_id_to_clear WHERE EXISTS ("
+      "	SELECT 1 FROM edge WHERE edge.target_node_id = element_id_to_clear.id"
       ")");
 
   if(updateStatusCallback != nullptr) {
@@ -509,17 +587,14 @@ void SqliteIndexStorage::removeElementsWithLocationInFiles(const std::vector<Id>
   }
 
   // delete all elements that are still listed in element_id_to_clear
-  executeStatement(
-      "DELETE FROM element WHERE EXISTS ("
-      "	SELECT * FROM element_id_to_clear WHERE element.id = element_id_to_clear.id"
-      ")");
+  executeStatement("DELETE FROM element WHERE id IN (SELECT id FROM element_id_to_clear)");
 
   if(updateStatusCallback != nullptr) {
     updateStatusCallback(87);
   }
 
   // cleaning up
-  executeStatement("DROP TABLE IF EXISTS main.element_id_to_clear;");
+  executeStatement("DROP TABLE IF EXISTS temp.element_id_to_clear;");
 
   if(updateStatusCallback != nullptr) {
     updateStatusCallback(89);
@@ -636,6 +711,31 @@ StorageNode SqliteIndexStorage::getNodeBySerializedName(const std::wstring& seri
   return {};
 }
 
+std::vector<StorageNode> SqliteIndexStorage::getNodesBySerializedNamePattern(const std::wstring& pattern) const {
+  CppSQLite3Statement stmt = m_database.compileStatement(
+      "SELECT id, type, serialized_name FROM node WHERE serialized_name LIKE ? ESCAPE '\\';");
+
+  stmt.bind(1, utility::encodeToUtf8(pattern).c_str());
+  CppSQLite3Query query = executeQuery(stmt);
+
+  std::vector<StorageNode> nodes;
+  while(!query.eof()) {
+    const Id elementId = static_cast<Id>(query.getIntField(0, 0));
+    const int type = query.getIntField(1, -1);
+    const std::string name = query.getStringField(2, "");
+
+    if(elementId != 0 && type != -1) {
+      nodes.emplace_back(elementId, type, utility::decodeFromUtf8(name));
+    }
+
+    query.nextRow();
+  }
+
+  stmt.reset();
+
+  return nodes;
+}
+
 std::vector<int> SqliteIndexStorage::getAvailableNodeTypes() const {
   CppSQLite3Query query = executeQuery("SELECT DISTINCT type FROM node;");
 
@@ -681,7 +781,7 @@ std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<F
 std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentById(Id fileId) const {
   CppSQLite3Query query = executeQuery("SELECT content FROM filecontent WHERE id = '" + std::to_string(fileId) + "';");
   if(!query.eof()) {
-    return TextAccess::createFromString(query.getStringField(0, ""));
+    return TextAccess::createFromString(decompressFileContentField(query));
   }
 
   return TextAccess::createFromString("");
@@ -697,7 +797,7 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
         utility::encodeToUtf8(filePath) + "';");
 
     if(!query.eof()) {
-      return TextAccess::createFromString(query.getStringField(0, ""));
+      return TextAccess::createFromString(decompressFileContentField(query));
     }
   } catch(CppSQLite3Exception& e) {
     LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
@@ -706,6 +806,58 @@ std::shared_ptr<TextAccess> SqliteIndexStorage::getFileContentByPath(const std::
   return TextAccess::createFromString("");
 }
 
+std::optional<SqliteIndexStorage::FileContentFingerprint> SqliteIndexStorage::getFileContentFingerprint(
+    const std::wstring& filePath) const {
+  try {
+    CppSQLite3Query query = executeQuery(
+        "SELECT file.size, file.content_hash "
+        "FROM file "
+        "INNER JOIN filecontent ON filecontent.id = file.id "
+        "WHERE file.path = '" +
+        utility::encodeToUtf8(filePath) + "';");
+
+    if(!query.eof()) {
+      return FileContentFingerprint{static_cast<size_t>(query.getInt64Field(0, 0)), query.getStringField(1, "")};
+    }
+  } catch(CppSQLite3Exception& e) {
+    LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+  }
+
+  return std::nullopt;
+}
+
+std::map<std::wstring, SqliteIndexStorage::FileContentFingerprint> SqliteIndexStorage::getFileContentFingerprints(
+    const std::vector<std::wstring>& filePaths) const {
+  constexpr size_t MaxPathsPerQuery = 500;
+
+  std::map<std::wstring, FileContentFingerprint> fingerprints;
+  try {
+    for(size_t first = 0; first < filePaths.size(); first += MaxPathsPerQuery) {
+      std::string paths;
+      for(size_t i = first; i < std::min(first + MaxPathsPerQuery, filePaths.size()); i++) {
+        paths += (i == first ? "'" : ", '") + utility::replace(utility::encodeToUtf8(filePaths[i]), "'", "''") + "'";
+      }
+
+      CppSQLite3Query query = executeQuery(
+          "SELECT file.path, file.size, file.content_hash "
+          "FROM file "
+          "INNER JOIN filecontent ON filecontent.id = file.id "
+          "WHERE file.path IN (" +
+          paths + ");");
+
+      while(!query.eof()) {
+        fingerprints.emplace(utility::decodeFromUtf8(query.getStringField(0, "")),
+                             FileContentFingerprint{static_cast<size_t>(query.getInt64Field(1, 0)), query.getStringField(2, "")});
+        query.nextRow();
+      }
+    }
+  } catch(CppSQLite3Exception& e) {
+    LOG_ERROR(std::to_string(e.errorCode()) + ": " + e.errorMessage());
+  }
+
+  return fingerprints;
+}
+
 void SqliteIndexStorage::setFileIndexed(Id fileId, bool indexed) {
   executeStatement("UPDATE file SET indexed = " + std::to_string(indexed) + " WHERE id == " + std::to_string(fileId) + ";");
 }
@@ -848,52 +1000,50 @@ std::vector<StorageElementComponent> SqliteIndexStorage::getElementComponentsByE
 }
 
 std::vector<ErrorInfo> SqliteIndexStorage::getAllErrorInfos() const {
-  std::vector<ErrorInfo> errorInfos;
+  return doGetErrorInfos(std::string(ErrorInfoQuery) + std::string(ErrorInfoOrder) + ";");
+}
 
+std::vector<ErrorInfo> SqliteIndexStorage::getErrorInfos(const ErrorFilter& filter) const {
+  return doGetErrorInfos(getFilteredErrorInfoQuery(filter, "", filter.limit));
+}
+
+std::vector<ErrorInfo> SqliteIndexStorage::getErrorInfosInFiles(const ErrorFilter& filter, const std::set<Id>& fileIds) const {
+  if(fileIds.empty()) {
+    return {};
+  }
+
+  const std::string condition = " AND source_location.file_node_id IN (" +
+      utility::join(utility::toStrings(std::vector<Id>(fileIds.begin(), fileIds.end())), ',') + ")";
+  return doGetErrorInfos(getFilteredErrorInfoQuery(filter, condition, 0));
+}
+
+ErrorCountInfo SqliteIndexStorage::getErrorCountInfo(const ErrorFilter& filter) const {
   CppSQLite3Query query = executeQuery(
-      "SELECT error.id, error.message, error.fatal, error.indexed, error.translation_unit, "
-      "file.path, source_location.start_line, source_location.start_column "
-      "FROM occurrence "
-      "INNER JOIN error ON (error.id = occurrence.element_id) "
+      "SELECT error.fatal, error.indexed, COUNT(*) "
+      "FROM error "
+      "CROSS JOIN occurrence ON (occurrence.element_id = error.id) "
       "INNER JOIN source_location ON (source_location.id = occurrence.source_location_id) "
-      "INNER JOIN file ON (file.id = source_location.file_node_id);");
-
-  std::map<Id, size_t> errorIdCount;
+      "INNER JOIN file ON (file.id = source_location.file_node_id) "
+      "GROUP BY error.fatal, error.indexed;");
 
+  ErrorCountInfo errorCount;
   while(!query.eof()) {
-    const Id elementId = static_cast<Id>(query.getIntField(0, 0));
-    const std::string message = query.getStringField(1, "");
-    const bool fatal = query.getIntField(2, 0) != 0;
-    const bool indexed = query.getIntField(3, 0) != 0;
-    const std::string translationUnit = query.getStringField(4, "");
-    const std::string filePath = query.getStringField(5, "");
-    const int lineNumber = query.getIntField(6, -1);
-    const int columnNumber = query.getIntField(7, -1);
-
-    if(elementId != 0) {
-      // There can be multiple errors with the same id, so a count is added to the id
-      Id errorId = elementId * 10000;
-      if(auto iterator = errorIdCount.find(elementId); iterator != errorIdCount.end()) {
-        errorId += iterator->second;
-        iterator->second = iterator->second + 1;
-      } else {
-        errorIdCount.emplace(elementId, 1);
+    ErrorInfo info;
+    info.fatal = query.getIntField(0, 0) != 0;
+    info.indexed = query.getIntField(1, 0) != 0;
+    const auto count = static_cast<size_t>(query.getIntField(2, 0));
+
+    if(filter.filter(info)) {
+      errorCount.total += count;
+      if(info.fatal) {
+        errorCount.fatal += count;
       }
-
-      errorInfos.emplace_back(errorId,
-                              utility::decodeFromUtf8(message),
-                              utility::decodeFromUtf8(filePath),
-                              lineNumber,
-                              columnNumber,
-                              utility::decodeFromUtf8(translationUnit),
-                              fatal,
-                              indexed);
     }
 
     query.nextRow();
   }
 
-  return errorInfos;
+  return errorCount;
 }
 
 int SqliteIndexStorage::getNodeCount() const {
@@ -934,6 +1084,7 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
   indices.emplace_back(STORAGE_MODE_READ | STORAGE_MODE_CLEAR,
                        SqliteDatabaseIndex("source_location_file_node_id_index", "source_location(file_node_id)"));
   indices.emplace_back(STORAGE_MODE_WRITE, SqliteDatabaseIndex("error_all_data_index", "error(message, fatal)"));
+  indices.emplace_back(STORAGE_MODE_READ, SqliteDatabaseIndex("error_fatal_indexed_index", "error(fatal, indexed)"));
   indices.emplace_back(STORAGE_MODE_WRITE, SqliteDatabaseIndex("file_path_index", "file(path)"));
   indices.emplace_back(
       STORAGE_MODE_READ | STORAGE_MODE_CLEAR, SqliteDatabaseIndex("occurrence_element_id_index", "occurrence(element_id)"));
@@ -952,6 +1103,42 @@ std::vector<std::pair<int, SqliteDatabaseIndex>> SqliteIndexStorage::getIndices(
   return indices;
 }
 
+std::vector<ErrorInfo> SqliteIndexStorage::doGetErrorInfos(const std::string& query) const {
+  std::vector<ErrorInfo> errorInfos;
+  if(query.empty()) {
+    return errorInfos;
+  }
+
+  CppSQLite3Query result = executeQuery(query);
+  while(!result.eof()) {
+    const Id elementId = static_cast<Id>(result.getIntField(0, 0));
+    const std::string message = result.getStringField(1, "");
+    const bool fatal = result.getIntField(2, 0) != 0;
+    const bool indexed = result.getIntField(3, 0) != 0;
+    const std::string translationUnit = result.getStringField(4, "");
+    const std::string filePath = result.getStringField(5, "");
+    const int lineNumber = result.getIntField(6, -1);
+    const int columnNumber = result.getIntField(7, -1);
+    const auto occurrenceIndex = static_cast<Id>(result.getIntField(8, 0));
+
+    if(elementId != 0) {
+      // There can be multiple errors with the same id, so the index of the occurrence is added to the id
+      errorInfos.emplace_back(elementId * 10000 + occurrenceIndex,
+                              utility::decodeFromUtf8(message),
+                              utility::decodeFromUtf8(filePath),
+                              lineNumber,
+                              columnNumber,
+                              utility::decodeFromUtf8(translationUnit),
+                              fatal,
+                              indexed);
+    }
+
+    result.nextRow();
+  }
+
+  return errorInfos;
+}
+
 void SqliteIndexStorage::clearTables() {
   try {
     m_database.execDML("DROP TABLE IF EXISTS main.error;");
@@ -1024,13 +1211,15 @@ void SqliteIndexStorage::setupTables() {
         "indexed INTEGER, "
         "complete INTEGER, "
         "line_count INTEGER, "
+        "size INTEGER, "
+        "content_hash TEXT, "
         "PRIMARY KEY(id), "
         "FOREIGN KEY(id) REFERENCES node(id) ON DELETE CASCADE);");
 
     m_database.execDML(
         "CREATE TABLE IF NOT EXISTS filecontent("
         "id INTEGER, "
-        "content TEXT, "
+        "content BLOB, "
         "PRIMARY KEY(id), "
         "FOREIGN KEY(id) REFERENCES file(id)"
         "ON DELETE CASCADE "
@@ -1158,7 +1347,7 @@ void SqliteIndexStorage::setupPrecompiledStatements() {
         "INSERT INTO element_component(id, element_id, type, data) VALUES(NULL, ?, ?, ?);");
     m_insertFileStmt = m_database.compileStatement(
         "INSERT INTO file(id, path, language, modification_time, indexed, complete, "
-        "line_count) VALUES(?, ?, ?, ?, ?, ?, ?);");
+        "line_count, size, content_hash) VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?);");
     m_insertFileContentStmt = m_database.compileStatement("INSERT INTO filecontent(id, content) VALUES(?, ?);");
     m_checkErrorExistsStmt = m_database.compileStatement(
         "SELECT id FROM error WHERE "
@@ -24,9 +24,13 @@
  */
 
 #include <memory>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
+#include "ErrorCountInfo.h"
+#include "ErrorFilter.h"
 #include "ErrorInfo.h"
 #include "GlobalId.hpp"
 #include "LocationType.h"
@@ -106,8 +110,9 @@ public:
   /**
    * @brief Constructor that initializes a SQLite database at the specified file path
    * @param dbFilePath Path to the SQLite database file
+   * @param openMode ReadOnly for databases that are only queried, setup() must not be called then
    */
-  explicit SqliteIndexStorage(const FilePath& dbFilePath);
+  explicit SqliteIndexStorage(const FilePath& dbFilePath, OpenMode openMode = OpenMode::ReadWrite);
 
   /**
    * @brief Returns the static version of the storage
@@ -425,6 +430,13 @@ public:
    */
   StorageNode getNodeBySerializedName(const std::wstring& serializedName) const;
 
+  /**
+   * @brief Returns all nodes whose serialized name matches a LIKE pattern
+   * @param pattern The pattern, a backslash escapes the wildcards '%' and '_'
+   * @return The nodes
+   */
+  std::vector<StorageNode> getNodesBySerializedNamePattern(const std::wstring& pattern) const;
+
   /**
    * @brief Returns the available node types
    * @return The available node types
@@ -465,6 +477,28 @@ public:
    */
   std::shared_ptr<TextAccess> getFileContentById(Id fileId) const;
 
+  /**
+   * @brief Size and content hash of a file, recorded when its content was stored
+   */
+  struct FileContentFingerprint {
+    size_t size = 0;         ///< size of the file on disk in bytes
+    std::string hash;        ///< hash of the content as returned by TextAccess
+  };
+
+  /**
+   * @brief Returns the fingerprint of a file without loading its content
+   * @param filePath The path of the file
+   * @return The fingerprint or std::nullopt if no content is stored for the file
+   */
+  std::optional<FileContentFingerprint> getFileContentFingerprint(const std::wstring& filePath) const;
+
+  /**
+   * @brief Returns the fingerprints of many files with a few queries instead of one query per file
+   * @param filePaths The paths of the files
+   * @return The fingerprints by path, files without stored content are missing
+   */
+  std::map<std::wstring, FileContentFingerprint> getFileContentFingerprints(const std::vector<std::wstring>& filePaths) const;
+
   /**
    * @brief Sets the indexed status of a file
    * @param fileId The ID of the file to set
@@ -565,10 +599,32 @@ public:
 
   /**
    * @brief Returns all error infos
-   * @return The error infos
+   * @return The error infos ordered by error
    */
   std::vector<ErrorInfo> getAllErrorInfos() const;
 
+  /**
+   * @brief Returns the first error infos passing the filter, up to the limit of the filter
+   * @param filter The error filter
+   * @return The error infos in the order of getAllErrorInfos
+   */
+  std::vector<ErrorInfo> getErrorInfos(const ErrorFilter& filter) const;
+
+  /**
+   * @brief Returns all error infos located in the files that pass the filter, the limit of the filter is ignored
+   * @param filter The error filter
+   * @param fileIds The ids of the file nodes
+   * @return The error infos in the order of getAllErrorInfos
+   */
+  std::vector<ErrorInfo> getErrorInfosInFiles(const ErrorFilter& filter, const std::set<Id>& fileIds) const;
+
+  /**
+   * @brief Counts the error infos passing the filter, the limit of the filter is ignored
+   * @param filter The error filter
+   * @return The total and fatal count
+   */
+  ErrorCountInfo getErrorCountInfo(const ErrorFilter& filter) const;
+
   /**
    * @brief Returns all elements
    * @return The elements
@@ -707,6 +763,8 @@ private:
 
   std::vector<std::pair<int, SqliteDatabaseIndex>> getIndices() const;
 
+  std::vector<ErrorInfo> doGetErrorInfos(const std::string& query) const;
+
   void clearTables() override;
   void setupTables() override;
   void setupPrecompiledStatements() override;
@@ -2,9 +2,27 @@
 
 #include "FileSystem.h"
 #include "logging.h"
+#include "StorageQueryToken.h"
 #include "TimeStamp.h"
 #include "utilityString.h"
 
+namespace {
+// Number of virtual machine instructions between two checks for a superseded query.
+constexpr int ProgressHandlerInstructionCount = 1000;
+
+int interruptSupersededQuery(void* /*data*/) {
+  return StorageQueryToken::isCurrentThreadCancelled() ? 1 : 0;
+}
+
+void logQueryException(const CppSQLite3Exception& exception) {
+  if(exception.errorCode() == SQLITE_INTERRUPT) {
+    LOG_DEBUG("Query interrupted: {}", exception.errorMessage());
+    return;
+  }
+  LOG_ERROR(fmt::format("{}: {}", exception.errorCode(), exception.errorMessage()));
+}
+}    // namespace
+
 SqliteStorage::SqliteStorage() {
   try {
     m_database.open(":memory:");
@@ -16,13 +34,18 @@ SqliteStorage::SqliteStorage() {
   executeStatement("PRAGMA foreign_keys=ON;");
 }
 
-SqliteStorage::SqliteStorage(const FilePath& dbFilePath) : m_dbFilePath(dbFilePath.getCanonical()) {
-  if(!m_dbFilePath.getParentDirectory().empty() && !m_dbFilePath.getParentDirectory().exists()) {
+SqliteStorage::SqliteStorage(const FilePath& dbFilePath, OpenMode openMode) : m_dbFilePath(dbFilePath.getCanonical()) {
+  if(openMode == OpenMode::ReadWrite && !m_dbFilePath.getParentDirectory().empty() &&
+     !m_dbFilePath.getParentDirectory().exists()) {
     FileSystem::createDirectory(m_dbFilePath.getParentDirectory());
   }
 
   try {
-    m_database.open(utility::encodeToUtf8(m_dbFilePath.wstr()).c_str());
+    if(openMode == OpenMode::ReadOnly) {
+      m_database.openReadOnly(utility::encodeToUtf8(m_dbFilePath.wstr()).c_str());
+    } else {
+      m_database.open(utility::encodeToUtf8(m_dbFilePath.wstr()).c_str());
+    }
   } catch(CppSQLite3Exception& e) {
     LOG_ERROR(L"Failed to load database file \"" + m_dbFilePath.wstr() + L"\" with message: " +
               utility::decodeFromUtf8(e.errorMessage()));
@@ -40,6 +63,10 @@ SqliteStorage::~SqliteStorage() {
   }
 }
 
+void SqliteStorage::enableQueryCancellation() {
+  m_database.setProgressHandler(ProgressHandlerInstructionCount, &interruptSupersededQuery, nullptr);
+}
+
 void SqliteStorage::setup() {
   executeStatement("PRAGMA foreign_keys=ON;");
   setupMetaTable();
@@ -184,7 +211,7 @@ CppSQLite3Query SqliteStorage::executeQuery(const std::string& statement) const
   try {
     return m_database.execQuery(statement.c_str());
   } catch(CppSQLite3Exception& exception) {
-    LOG_ERROR(fmt::format("{}: {}", exception.errorCode(), exception.errorMessage()));
+    logQueryException(exception);
   }
   return {};
 }
@@ -194,7 +221,7 @@ CppSQLite3Query SqliteStorage::executeQuery(CppSQLite3Statement& statement) cons
   try {
     return statement.execQuery();
   } catch(CppSQLite3Exception& exception) {
-    LOG_ERROR(fmt::format("{}: {}", exception.errorCode(), exception.errorMessage()));
+    logQueryException(exception);
   }
   return {};
 }
@@ -4,6 +4,8 @@
  * @brief This file contains the SqliteStorage class, which is a base class for SQLite-based storage.
  */
 
+#include <cstdint>
+
 #include "CppSQLite3.h"    // TODO(Hussein): Should be removed
 #include "FilePath.h"
 
@@ -15,6 +17,14 @@ class TimeStamp;
  */
 class SqliteStorage {
 public:
+  /**
+   * @brief How a database on the file system is opened
+   */
+  enum class OpenMode : uint8_t {
+    ReadWrite,    ///< Creates the database and its directory if missing
+    ReadOnly      ///< Fails if the database does not exist, nothing is ever written
+  };
+
   /**
    * @brief Construct a new SqliteStorage object
    *
@@ -29,13 +39,21 @@ public:
    * This constructor is used for SQLite databases that are stored on the file system.
    * @throw CppSQLite3Exception
    */
-  explicit SqliteStorage(const FilePath& dbFilePath);
+  explicit SqliteStorage(const FilePath& dbFilePath, OpenMode openMode = OpenMode::ReadWrite);
 
   /**
    * @brief Destroy the SqliteStorage object
    */
   virtual ~SqliteStorage();
 
+  /**
+   * @brief Interrupt running queries once the StorageQueryToken bound to the calling thread got superseded
+   *
+   * Only enabled for the connections that run the queries of tab activations, the progress handler slows down every
+   * other statement.
+   */
+  void enableQueryCancellation();
+
   /**
    * @brief Setup the storage
    * - Create Meta table
@@ -18,12 +18,15 @@
 #include "../../scheduling/TaskSetValue.h"
 #include "CombinedIndexerCommandProvider.h"
 #include "DialogView.h"
+#include "FileChangeJournal.h"
 #include "FilePath.h"
 #include "FileSystem.h"
 #include "IApplicationSettings.hpp"
+#include "IndexerProcessPool.h"
 #include "PersistentStorage.h"
 #include "ProjectSettings.h"
 #include "RefreshInfoGenerator.h"
+#include "ScopedFunctor.h"
 #include "SourceGroup.h"
 #include "SourceGroupFactory.h"
 #include "SourceGroupStatusType.h"
@@ -52,6 +55,7 @@
 
 namespace {
 constexpr int DefaultIndexerThreadCount = 4;
+constexpr size_t OneMb = 1048576;
 
 int getIndexerThreadCount() {
   int indexerThreadCount = IApplicationSettings::getInstanceRaw()->getIndexerThreadCount();
@@ -158,6 +162,7 @@ void Project::load(const std::shared_ptr<DialogView>& dialogView) {
   }
 
   m_storage = std::make_shared<PersistentStorage>(dbPath, bookmarkDbPath);
+  m_storage->enableQueryCancellation();
 
   bool canLoad = false;
 
@@ -331,11 +336,14 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
   m_sourceGroups = SourceGroupFactory::getInstance()->createSourceGroups(m_settings->getAllSourceGroupSettings());
   for(const std::shared_ptr<SourceGroup>& sourceGroup : m_sourceGroups) {
     if(sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED && !sourceGroup->prepareIndexing()) {
+      finishPreparingIndexing();
       m_refreshStage = RefreshStageType::NONE;
       return;
     }
   }
 
+  updateFileChangeJournal();
+
   if(needsFullRefresh || fullRefresh) {
     refreshMode = RefreshMode::AllFiles;
   } else if(refreshMode == RefreshMode::None) {
@@ -365,7 +373,10 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
         allowsShallowIndexing,
         useShallowIndexing,
         [this, dialogView](const RefreshInfo& info) { buildIndex(info, dialogView); },
-        [this]() { m_refreshStage = RefreshStageType::NONE; });
+        [this]() {
+          finishPreparingIndexing();
+          m_refreshStage = RefreshStageType::NONE;
+        });
   } else {
     RefreshInfo info = getRefreshInfo(refreshMode);
     info.shallow = useShallowIndexing;
@@ -374,24 +385,40 @@ void Project::refresh(std::shared_ptr<DialogView> dialogView, RefreshMode refres
 }
 
 RefreshInfo Project::getRefreshInfo(RefreshMode mode) const {
-  switch(mode) {
-  case RefreshMode::None:
+  if(mode == RefreshMode::None) {
     return {};
+  }
 
+  FileChangeJournal::Changes fileChanges;
+  if(m_fileChangeJournal) {
+    fileChanges = m_fileChangeJournal->getChanges();
+  }
+
+  RefreshInfo info;
+  switch(mode) {
   case RefreshMode::UpdatedFiles:
-    return RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage);
+    info = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(m_sourceGroups, m_storage, fileChanges);
+    break;
 
   case RefreshMode::UpdatedAndIncompleteFiles:
-    return RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage);
+    info = RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(m_sourceGroups, m_storage, fileChanges);
+    break;
 
   case RefreshMode::AllFiles:
   default:
-    return RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
+    info = RefreshInfoGenerator::getRefreshInfoForAllFiles(m_sourceGroups);
   }
+
+  if(m_fileChangeJournal) {
+    info.fileChangeCheckpoint = fileChanges.checkpoint;
+  }
+  return info;
 }
 
 void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogView) {
   assert(dialogView);
+  const ScopedFunctor preparationFinisher([this]() { finishPreparingIndexing(); });
+
   // Check the project status if it's indexing
   if(RefreshStageType::INDEXING == m_refreshStage) {
     MessageStatus(L"Cannot refresh project while indexing.", true, false).dispatch();
@@ -399,6 +426,7 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
   }
 
   if(checkIfNothingToRefresh(info, dialogView)) {
+    synchronizeFileChangeJournal(info.fileChangeCheckpoint);
     return;
   }
 
@@ -456,6 +484,7 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView) {
   }
 
   m_storage = std::make_shared<PersistentStorage>(indexDbFilePath, bookmarkDbFilePath);
+  m_storage->enableQueryCancellation();
   m_storage->setup();
 
   // std::shared_ptr<DialogView> dialogView =
@@ -464,6 +493,8 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView) {
   m_storage->buildCaches();
   // dialogView->hideUnknownProgressDialog();
 
+  // the cached file contents are keyed by the ids and modification times of the replaced storage
+  m_storageCache->clearFileContents();
   m_storageCache->setSubject(m_storage);
   m_state = ProjectStateType::LOADED;
 }
@@ -584,26 +615,36 @@ std::shared_ptr<TaskGroupSequence> Project::createIndexTasks(RefreshInfo info,
 
     // add task for indexing
     const bool multiProcess = IApplicationSettings::getInstanceRaw()->getMultiProcessIndexingEnabled() && hasCxxSourceGroup();
+    const size_t memoryBudget = static_cast<size_t>(IApplicationSettings::getInstanceRaw()->getIndexerMemoryBudget()) * OneMb;
+    std::shared_ptr<IndexerProcessPool> processPool;
+    if(multiProcess && IApplicationSettings::getInstanceRaw()->getPersistentIndexerProcessesEnabled()) {
+      processPool = IndexerProcessPool::getInstance(m_appUUID);
+    }
     taskParallelIndexing->addChildTasks(std::make_shared<TaskGroupSequence>()->addChildTasks(
         // block until there are indexer commands to process
         // TODO(Hussein): Create Tasks using factory pattern
         std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
             ->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
                 "indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
-        std::make_shared<TaskBuildIndex>(adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess)));
-
-    // add task for merging the intermediate storages
-    taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
-        // block until there are indexers running
-        std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
-            ->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
-                "indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
-        // merge until all indexers stopped and nothing left to merge
-        std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
-            ->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-                std::make_shared<TaskMergeStorages>(storageProvider),
-                std::make_shared<TaskReturnSuccessIf<bool>>(
-                    "indexer_threads_stopped", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)))));
+        std::make_shared<TaskBuildIndex>(
+            adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess, memoryBudget, processPool)));
+
+    // add tasks for merging the intermediate storages
+    const int mergeThreadCount = IApplicationSettings::getInstanceRaw()->getStorageMergeThreadCount();
+    const auto mergeCount = static_cast<size_t>(IApplicationSettings::getInstanceRaw()->getStorageMergeCount());
+    for(int i = 0; i < mergeThreadCount; i++) {
+      taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+          // block until there are indexers running
+          std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+              ->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
+                  "indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
+          // merge until all indexers stopped and nothing left to merge
+          std::make_shared<TaskDecoratorRepeat>(TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
+              ->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+                  std::make_shared<TaskMergeStorages>(storageProvider, mergeCount),
+                  std::make_shared<TaskReturnSuccessIf<bool>>(
+                      "indexer_threads_stopped", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)))));
+    }
 
     // add task for injecting the intermediate storages into the persistent storage
     taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -648,8 +689,16 @@ std::shared_ptr<TaskGroupSequence> Project::createIndexTasks(RefreshInfo info,
 
   taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
       std::make_shared<TaskGroupSequence>()->addChildTasks(
-          std::make_shared<TaskFindKeyOnBlackboard>("keep_database"), std::make_shared<TaskLambda>([dialogView, this]() {
-            Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([dialogView, this]() { swapToTempStorage(dialogView); }));
+          std::make_shared<TaskFindKeyOnBlackboard>("keep_database"),
+          std::make_shared<TaskLambda>([dialogView, this, checkpoint = info.fileChangeCheckpoint]() {
+            Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([dialogView, this, checkpoint]() {
+                             swapToTempStorage(dialogView);
+                             // files that were cleared but not indexed again are unknown to the new index and get
+                             // indexed by the next refresh, so an interrupted indexing run synchronizes as well
+                             if(m_state == ProjectStateType::LOADED) {
+                               synchronizeFileChangeJournal(checkpoint);
+                             }
+                           }));
           })),
       std::make_shared<TaskGroupSequence>()->addChildTasks(
           std::make_shared<TaskFindKeyOnBlackboard>("discard_database"), std::make_shared<TaskLambda>([this]() {
@@ -699,6 +748,48 @@ bool Project::checkIfNothingToRefresh(const RefreshInfo& info, std::shared_ptr<D
   return false;
 }
 
+void Project::updateFileChangeJournal() {
+  if(!m_hasGUI || !m_storage || !IApplicationSettings::getInstanceRaw()->getFileChangeJournalEnabled()) {
+    m_fileChangeJournal.reset();
+    return;
+  }
+
+  std::set<std::wstring> directories;
+  for(const FilePath& filePath : m_storage->getIndexedFiles()) {
+    directories.insert(filePath.getParentDirectory().wstr());
+  }
+
+  // watch the outermost directories, files outside of them are still checked on disk by every refresh
+  std::vector<FilePath> rootDirectories;
+  for(const std::wstring& directory : directories) {
+    bool nested = false;
+    for(size_t end = directory.rfind(L'/'); !nested && end != std::wstring::npos && end > 0;
+        end = directory.rfind(L'/', end - 1)) {
+      nested = directories.contains(directory.substr(0, end));
+    }
+    if(!nested) {
+      rootDirectories.emplace_back(directory);
+    }
+  }
+
+  // a journal that stopped watching is replaced, so it becomes complete again with the full scan of this refresh
+  if(!m_fileChangeJournal || !m_fileChangeJournal->isWatching() || m_fileChangeJournal->getRootDirectories() != rootDirectories) {
+    m_fileChangeJournal = std::make_unique<FileChangeJournal>(std::move(rootDirectories));
+  }
+}
+
+void Project::synchronizeFileChangeJournal(std::optional<std::uint64_t> checkpoint) {
+  if(m_fileChangeJournal && checkpoint) {
+    m_fileChangeJournal->markSynchronized(*checkpoint);
+  }
+}
+
+void Project::finishPreparingIndexing() {
+  for(const std::shared_ptr<SourceGroup>& sourceGroup : m_sourceGroups) {
+    sourceGroup->finishPreparingIndexing();
+  }
+}
+
 bool Project::checkIfFilesToClear(RefreshInfo& info, std::shared_ptr<DialogView> dialogView) {
   if(RefreshMode::AllFiles != info.mode && (!info.filesToClear.empty() || !info.nonIndexedFilesToClear.empty())) {
     for(const std::shared_ptr<SourceGroup>& sourceGroup : m_sourceGroups) {
@@ -9,6 +9,7 @@
  */
 #pragma once
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,7 @@
 #include "SourceGroup.h"
 
 class DialogView;
+class FileChangeJournal;
 class FilePath;
 class PersistentStorage;
 class ProjectSettings;
@@ -158,6 +160,23 @@ private:
 
   bool checkIfFilesToClear(RefreshInfo& info, std::shared_ptr<DialogView> dialogView);
 
+  /**
+   * @brief Lets the source groups release what they kept since prepareIndexing, once the refresh is started or canceled.
+   */
+  void finishPreparingIndexing();
+
+  /**
+   * @brief Watches the directories of the indexed files if the file change journal is enabled.
+   *
+   * The journal is only replaced if the directories changed, a new journal is complete after the next refresh.
+   */
+  void updateFileChangeJournal();
+
+  /**
+   * @brief Tells the journal that the index reflects the files as of the checkpoint the refresh was planned with.
+   */
+  void synchronizeFileChangeJournal(std::optional<std::uint64_t> checkpoint);
+
   std::shared_ptr<ProjectSettings> m_settings;
   StorageCache* m_storageCache;
 
@@ -166,6 +185,7 @@ private:
 
   std::shared_ptr<PersistentStorage> m_storage;
   std::vector<std::shared_ptr<SourceGroup>> m_sourceGroups;
+  std::unique_ptr<FileChangeJournal> m_fileChangeJournal;
 
   std::string m_appUUID;
   bool m_hasGUI;
@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 #include <cstdint>
+#include <optional>
 #include <ostream>
 #include <set>
 
@@ -57,4 +58,8 @@ struct RefreshInfo final {
 
   RefreshMode mode = RefreshMode::None;
   bool shallow = false;
+
+  /// Checkpoint of the file change journal the info was planned with, the journal is synchronized to it once the new
+  /// index is kept
+  std::optional<std::uint64_t> fileChangeCheckpoint;
 };
@@ -1,22 +1,36 @@
 #include "RefreshInfoGenerator.h"
 
+#include <filesystem>
+
+#include "FileContent.h"
 #include "FileInfo.h"
 #include "FileSystem.h"
 #include "PersistentStorage.h"
+#include "Profiler.h"
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
 #include "TextAccess.h"
 #include "utility.h"
+#include "utilityApp.h"
+
+namespace {
+constexpr size_t MinFilesPerThread = 64;
+}    // namespace
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
-                                                                std::shared_ptr<const PersistentStorage> storage) {
+                                                                std::shared_ptr<const PersistentStorage> storage,
+                                                                const FileChangeJournal::Changes& fileChanges) {
+  Profiler::Span span("project", "plan refresh");
+
   // 1) Divide filepaths that are already known by the storage to "unchanged and indexed",
   // "unchanged and non-indexed" and "changed"
   std::set<FilePath> unchangedIndexedFilePaths;
   std::set<FilePath> unchangedNonindexedFilePaths;
   std::set<FilePath> changedFilePaths;
+  std::set<FilePath> existingFilePaths;
 
+  const std::set<FilePath> indexedFilePaths = storage->getIndexedFiles();
   {
     const std::vector<FileInfo> fileInfosFromStorage = storage->getFileInfoForAllFiles();
 
@@ -32,28 +46,56 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
       }
     }
 
+    // read the state of all files on disk up front, the file system calls run in parallel. Files the journal vouches
+    // for are still in the state they were indexed in.
+    std::vector<FileInfo> diskFileInfos(fileInfosFromStorage.size());
+    utility::forEachIndexParallel(
+        fileInfosFromStorage.size(), MinFilesPerThread, [&fileInfosFromStorage, &diskFileInfos, &fileChanges](size_t index) {
+          const FileInfo& storedFileInfo = fileInfosFromStorage[index];
+          diskFileInfos[index] = fileChanges.isUnchanged(storedFileInfo.path) ?
+              storedFileInfo :
+              FileSystem::getFileInfoForPath(storedFileInfo.path);
+        });
+
+    // only these files need the change check, the others are sorted by their known and indexed state alone
+    std::vector<size_t> changeCheckIndices;
+    for(size_t i = 0; i < fileInfosFromStorage.size(); i++) {
+      const FilePath& path = fileInfosFromStorage[i].path;
+      const bool knownAndExisting = alreadyKnownPaths.contains(path) && !diskFileInfos[i].path.empty();
+      const bool indexed = indexedFilePaths.contains(path);
+      if(knownAndExisting == indexed) {
+        changeCheckIndices.push_back(i);
+      }
+      if(!diskFileInfos[i].path.empty()) {
+        existingFilePaths.insert(path);
+      }
+    }
+
+    const std::vector<bool> fileChanged = didFilesChange(fileInfosFromStorage, diskFileInfos, changeCheckIndices, storage);
+
     // checking source and header files
-    for(const FileInfo& info : fileInfosFromStorage) {
-      if(alreadyKnownPaths.find(info.path) != alreadyKnownPaths.end() && info.path.exists()) {
-        if(storage->getFilePathIndexed(info.path)) {
-          if(didFileChange(info, storage)) {
-            changedFilePaths.insert(info.path);
+    for(size_t i = 0; i < fileInfosFromStorage.size(); i++) {
+      const FilePath& path = fileInfosFromStorage[i].path;
+      if(alreadyKnownPaths.contains(path) && !diskFileInfos[i].path.empty()) {
+        if(indexedFilePaths.contains(path)) {
+          if(fileChanged[i]) {
+            changedFilePaths.insert(path);
           } else {
-            unchangedIndexedFilePaths.insert(info.path);
+            unchangedIndexedFilePaths.insert(path);
           }
         } else {
-          changedFilePaths.insert(info.path);
+          changedFilePaths.insert(path);
         }
-      } else if(!storage->getFilePathIndexed(info.path) && !didFileChange(info, storage)) {
-        unchangedNonindexedFilePaths.insert(info.path);
+      } else if(!indexedFilePaths.contains(path) && !fileChanged[i]) {
+        unchangedNonindexedFilePaths.insert(path);
       } else    // file has been removed
       {
-        changedFilePaths.insert(info.path);
+        changedFilePaths.insert(path);
       }
     }
   }
 
-  const std::set<FilePath> allSourceFilePathsFromSourcegroups = getAllSourceFilePaths(sourceGroups);
+  const std::set<FilePath> allSourceFilePathsFromSourcegroups = getAllSourceFilePaths(sourceGroups, existingFilePaths);
 
   // 2) Figure out which files need to be cleared
   // 2.1) Add all changed files
@@ -109,7 +151,7 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
   info.mode = RefreshMode::UpdatedFiles;
   info.filesToIndex = filesToIndex;
   for(const FilePath& fileToClear : filesToClear) {
-    if(storage->getFilePathIndexed(fileToClear)) {
+    if(indexedFilePaths.contains(fileToClear)) {
       info.filesToClear.insert(fileToClear);
     } else {
       info.nonIndexedFilesToClear.insert(fileToClear);
@@ -120,8 +162,9 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(const std::vecto
 }
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
-                                                                   std::shared_ptr<const PersistentStorage> storage) {
-  RefreshInfo info = getRefreshInfoForUpdatedFiles(sourceGroups, storage);
+                                                                   std::shared_ptr<const PersistentStorage> storage,
+                                                                   const FileChangeJournal::Changes& fileChanges) {
+  RefreshInfo info = getRefreshInfoForUpdatedFiles(sourceGroups, storage, fileChanges);
   info.mode = RefreshMode::UpdatedAndIncompleteFiles;
 
   std::set<FilePath> incompleteFiles;
@@ -138,10 +181,11 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForIncompleteFiles(const std::ve
     utility::append(incompleteFiles, storage->getReferencing(incompleteFiles));
 
     std::set<FilePath> staticSourceFilePaths = getAllSourceFilePaths(sourceGroups);
+    const std::set<FilePath> indexedFilePaths = storage->getIndexedFiles();
     for(const FilePath& path : incompleteFiles) {
       staticSourceFilePaths.erase(path);
 
-      if(storage->getFilePathIndexed(path)) {
+      if(indexedFilePaths.contains(path)) {
         info.filesToClear.insert(path);
       } else {
         info.nonIndexedFilesToClear.insert(path);
@@ -165,45 +209,85 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForAllFiles(const std::vector<st
   return info;
 }
 
-std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups) {
+std::set<FilePath> RefreshInfoGenerator::getAllSourceFilePaths(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+                                                               const std::set<FilePath>& existingFilePaths) {
   std::set<FilePath> allSourceFilePaths;
+  std::vector<FilePath> uncheckedFilePaths;
 
   for(const auto& sourceGroup : sourceGroups) {
     if(sourceGroup->getStatus() == SOURCE_GROUP_STATUS_ENABLED) {
       for(const FilePath& sourceFilePath : sourceGroup->getAllSourceFilePaths()) {
-        if(sourceFilePath.exists()) {
+        if(existingFilePaths.contains(sourceFilePath)) {
           allSourceFilePaths.insert(sourceFilePath);
+        } else {
+          uncheckedFilePaths.push_back(sourceFilePath);
         }
       }
     }
   }
 
+  // FilePath keeps the result of exists(), so the second call below does not touch the file system again
+  utility::forEachIndexParallel(uncheckedFilePaths.size(), MinFilesPerThread, [&uncheckedFilePaths](size_t index) {
+    std::ignore = uncheckedFilePaths[index].exists();
+  });
+
+  for(const FilePath& sourceFilePath : uncheckedFilePaths) {
+    if(sourceFilePath.exists()) {
+      allSourceFilePaths.insert(sourceFilePath);
+    }
+  }
+
   return allSourceFilePaths;
 }
 
-bool RefreshInfoGenerator::didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage) {
-  FileInfo diskFileInfo = FileSystem::getFileInfoForPath(info.path);
-  if(diskFileInfo.lastWriteTime > info.lastWriteTime) {
-    if(!storage->hasContentForFile(info.path)) {
-      return true;
-    }
+std::vector<bool> RefreshInfoGenerator::didFilesChange(const std::vector<FileInfo>& fileInfos,
+                                                       const std::vector<FileInfo>& diskFileInfos,
+                                                       const std::vector<size_t>& indices,
+                                                       const std::shared_ptr<const PersistentStorage>& storage) {
+  struct ModifiedFile {
+    size_t index;
+    std::optional<SqliteIndexStorage::FileContentFingerprint> fingerprint;
+    bool changed = true;
+  };
 
-    std::shared_ptr<TextAccess> storedFileContent = storage->getFileContent(info.path, false);
-    std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFileInfo.path);
+  // compare modification time, then size, then content hash, the stored content is never loaded
+  std::vector<ModifiedFile> modifiedFiles;
+  std::vector<FilePath> modifiedFilePaths;
+  for(const size_t index : indices) {
+    if(diskFileInfos[index].lastWriteTime > fileInfos[index].lastWriteTime) {
+      modifiedFiles.push_back({index, std::nullopt});
+      modifiedFilePaths.push_back(fileInfos[index].path);
+    }
+  }
 
-    const std::vector<std::string>& diskFileLines = diskFileContent->getAllLines();
-    const std::vector<std::string>& storedFileLines = storedFileContent->getAllLines();
+  const auto fingerprints = storage->getFileContentFingerprints(modifiedFilePaths);
+  for(ModifiedFile& modifiedFile : modifiedFiles) {
+    if(const auto it = fingerprints.find(fileInfos[modifiedFile.index].path); it != fingerprints.end()) {
+      modifiedFile.fingerprint = it->second;
+    }
+  }
 
-    if(diskFileLines.size() != storedFileLines.size()) {
-      return true;
+  utility::forEachIndexParallel(modifiedFiles.size(), MinFilesPerThread, [&modifiedFiles, &diskFileInfos](size_t index) {
+    ModifiedFile& modifiedFile = modifiedFiles[index];
+    if(!modifiedFile.fingerprint || modifiedFile.fingerprint->hash.empty()) {
+      return;
     }
 
-    for(size_t i = 0; i < diskFileLines.size(); i++) {
-      if(diskFileLines[i] != storedFileLines[i]) {
-        return true;
-      }
+    const FilePath& diskFilePath = diskFileInfos[modifiedFile.index].path;
+    std::error_code errorCode;
+    const auto diskFileSize = std::filesystem::file_size(diskFilePath.str(), errorCode);
+    if(errorCode || diskFileSize != modifiedFile.fingerprint->size) {
+      return;
     }
-    return false;
+
+    const std::shared_ptr<TextAccess> diskFileContent = TextAccess::createFromFile(diskFilePath);
+    modifiedFile.changed = utility::fileContentHashToString(utility::hashFileContent(diskFileContent->getText())) !=
+        modifiedFile.fingerprint->hash;
+  });
+
+  std::vector<bool> changed(fileInfos.size(), false);
+  for(const ModifiedFile& modifiedFile : modifiedFiles) {
+    changed[modifiedFile.index] = modifiedFile.changed;
   }
-  return false;
-}
\ No newline at end of file
+  return changed;
+}
@@ -3,6 +3,8 @@
 #include <set>
 #include <vector>
 
+#include "FileChangeJournal.h"
+
 struct FileInfo;
 class FilePath;
 class PersistentStorage;
@@ -11,16 +13,34 @@ class SourceGroup;
 
 class RefreshInfoGenerator {
 public:
+  /**
+   * @brief Files that changed since they were indexed and the files depending on them.
+   *
+   * Stored files the file changes vouch for are not checked on disk, a default constructed (incomplete) set of changes
+   * checks every file.
+   */
   static RefreshInfo getRefreshInfoForUpdatedFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
-                                                   std::shared_ptr<const PersistentStorage> storage);
+                                                   std::shared_ptr<const PersistentStorage> storage,
+                                                   const FileChangeJournal::Changes& fileChanges = {});
 
   static RefreshInfo getRefreshInfoForIncompleteFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
-                                                      std::shared_ptr<const PersistentStorage> storage);
+                                                      std::shared_ptr<const PersistentStorage> storage,
+                                                      const FileChangeJournal::Changes& fileChanges = {});
 
   static RefreshInfo getRefreshInfoForAllFiles(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
 
 private:
-  static std::set<FilePath> getAllSourceFilePaths(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups);
+  /**
+   * @brief Source files of all enabled source groups that exist, files in existingFilePaths are not checked again.
+   */
+  static std::set<FilePath> getAllSourceFilePaths(const std::vector<std::shared_ptr<SourceGroup>>& sourceGroups,
+                                                  const std::set<FilePath>& existingFilePaths = {});
 
-  static bool didFileChange(const FileInfo& info, std::shared_ptr<const PersistentStorage> storage);
+  /**
+   * @brief Checks the files at the indices for changes, all other entries of the result are false.
+   */
+  static std::vector<bool> didFilesChange(const std::vector<FileInfo>& fileInfos,
+                                          const std::vector<FileInfo>& diskFileInfos,
+                                          const std::vector<size_t>& indices,
+                                          const std::shared_ptr<const PersistentStorage>& storage);
 };
\ No newline at end of file
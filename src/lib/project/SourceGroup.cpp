@@ -34,6 +34,8 @@ bool SourceGroup::prepareIndexing() {
   return true;
 }
 
+void SourceGroup::finishPreparingIndexing() {}
+
 bool SourceGroup::allowsPartialClearing() const {
   return true;
 }
@@ -24,6 +24,7 @@ public:
   virtual ~SourceGroup();
 
   virtual bool prepareIndexing();
+  virtual void finishPreparingIndexing();
   virtual bool allowsPartialClearing() const;
   virtual bool allowsShallowIndexing() const;
 
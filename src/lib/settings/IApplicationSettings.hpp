@@ -125,6 +125,36 @@ struct IApplicationSettings : Settings {
   [[nodiscard]] virtual bool getMultiProcessIndexingEnabled() const noexcept = 0;
   virtual void setMultiProcessIndexingEnabled(bool enabled) noexcept = 0;
 
+  /**
+   * @brief Upper bound for the summed resident memory of all indexer workers in MB, 0 disables the limit.
+   */
+  [[nodiscard]] virtual int getIndexerMemoryBudget() const noexcept = 0;
+  virtual void setIndexerMemoryBudget(int megabytes) noexcept = 0;
+
+  /**
+   * @brief Keep multi process indexers running between indexing runs instead of starting them for every run.
+   */
+  [[nodiscard]] virtual bool getPersistentIndexerProcessesEnabled() const noexcept = 0;
+  virtual void setPersistentIndexerProcessesEnabled(bool enabled) noexcept = 0;
+
+  /**
+   * @brief Watch the files of an open project so refreshes only check the files that changed.
+   */
+  [[nodiscard]] virtual bool getFileChangeJournalEnabled() const noexcept = 0;
+  virtual void setFileChangeJournalEnabled(bool enabled) noexcept = 0;
+
+  /**
+   * @brief Number of threads that merge intermediate storages while indexing.
+   */
+  [[nodiscard]] virtual int getStorageMergeThreadCount() const noexcept = 0;
+  virtual void setStorageMergeThreadCount(int count) noexcept = 0;
+
+  /**
+   * @brief Maximum number of intermediate storages a merge thread merges in one pass.
+   */
+  [[nodiscard]] virtual int getStorageMergeCount() const noexcept = 0;
+  virtual void setStorageMergeCount(int count) noexcept = 0;
+
   [[nodiscard]] virtual std::vector<std::filesystem::path> getHeaderSearchPaths() const noexcept = 0;
   [[nodiscard]] virtual std::vector<std::filesystem::path> getHeaderSearchPathsExpanded() const noexcept = 0;
   virtual bool setHeaderSearchPaths(const std::vector<std::filesystem::path>& headerSearchPaths) noexcept = 0;
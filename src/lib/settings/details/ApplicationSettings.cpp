@@ -1,5 +1,6 @@
 #include "details/ApplicationSettings.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <memory>
 
@@ -305,6 +306,46 @@ void ApplicationSettings::setMultiProcessIndexingEnabled(bool enabled) noexcept
   setValue<bool>("indexing/multi_process_indexing", enabled);
 }
 
+int ApplicationSettings::getIndexerMemoryBudget() const noexcept {
+  return getValue<int>("indexing/memory_budget", 0);
+}
+
+void ApplicationSettings::setIndexerMemoryBudget(int megabytes) noexcept {
+  setValue<int>("indexing/memory_budget", std::max(0, megabytes));
+}
+
+bool ApplicationSettings::getPersistentIndexerProcessesEnabled() const noexcept {
+  return getValue<bool>("indexing/persistent_indexer_processes", false);
+}
+
+void ApplicationSettings::setPersistentIndexerProcessesEnabled(bool enabled) noexcept {
+  setValue<bool>("indexing/persistent_indexer_processes", enabled);
+}
+
+bool ApplicationSettings::getFileChangeJournalEnabled() const noexcept {
+  return getValue<bool>("indexing/file_change_journal", false);
+}
+
+void ApplicationSettings::setFileChangeJournalEnabled(bool enabled) noexcept {
+  setValue<bool>("indexing/file_change_journal", enabled);
+}
+
+int ApplicationSettings::getStorageMergeThreadCount() const noexcept {
+  return std::max(1, getValue<int>("indexing/storage_merge_thread_count", 1));
+}
+
+void ApplicationSettings::setStorageMergeThreadCount(int count) noexcept {
+  setValue<int>("indexing/storage_merge_thread_count", std::max(1, count));
+}
+
+int ApplicationSettings::getStorageMergeCount() const noexcept {
+  return std::max(2, getValue<int>("indexing/storage_merge_count", 8));
+}
+
+void ApplicationSettings::setStorageMergeCount(int count) noexcept {
+  setValue<int>("indexing/storage_merge_count", std::max(2, count));
+}
+
 std::vector<fs::path> ApplicationSettings::getHeaderSearchPaths() const noexcept {
   return getPathValuesStl("indexing/cxx/header_search_paths/header_search_path");
 }
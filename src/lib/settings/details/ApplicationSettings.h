@@ -102,6 +102,21 @@ public:
   bool getMultiProcessIndexingEnabled() const noexcept override;
   void setMultiProcessIndexingEnabled(bool enabled) noexcept override;
 
+  int getIndexerMemoryBudget() const noexcept override;
+  void setIndexerMemoryBudget(int megabytes) noexcept override;
+
+  bool getPersistentIndexerProcessesEnabled() const noexcept override;
+  void setPersistentIndexerProcessesEnabled(bool enabled) noexcept override;
+
+  bool getFileChangeJournalEnabled() const noexcept override;
+  void setFileChangeJournalEnabled(bool enabled) noexcept override;
+
+  int getStorageMergeThreadCount() const noexcept override;
+  void setStorageMergeThreadCount(int count) noexcept override;
+
+  int getStorageMergeCount() const noexcept override;
+  void setStorageMergeCount(int count) noexcept override;
+
   std::vector<std::filesystem::path> getHeaderSearchPaths() const noexcept override;
   std::vector<std::filesystem::path> getHeaderSearchPathsExpanded() const noexcept override;
   bool setHeaderSearchPaths(const std::vector<std::filesystem::path>& headerSearchPaths) noexcept override;
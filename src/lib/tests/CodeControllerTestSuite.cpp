@@ -0,0 +1,137 @@
+#include <memory>
+#include <string>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "CodeSnippetParams.h"
+#include "Component.h"
+#include "MockedMessageQueue.hpp"
+#include "SourceLocationCollection.h"
+#include "SourceLocationFile.h"
+#include "TextAccess.h"
+#include "mocks/MockedCodeView.hpp"
+#include "mocks/MockedStorageAccess.hpp"
+#include "mocks/MockedViewLayout.hpp"
+#ifndef _WIN32
+#  define private public    // NOLINT
+#endif
+#include "CodeController.h"
+#ifndef _WIN32
+#  undef private
+#endif
+
+using namespace testing;
+
+namespace {
+std::string makeCode(size_t lineCount) {
+  std::string code;
+  for(size_t i = 0; i < lineCount; i++) {
+    code += "int a" + std::to_string(i) + ";\n";
+  }
+  return code;
+}
+
+std::shared_ptr<SourceLocationFile> makeLocationFile(const FilePath& filePath, bool isWhole, size_t firstLine, size_t lineCount) {
+  auto locationFile = std::make_shared<SourceLocationFile>(filePath, L"cpp", isWhole, true, true);
+  for(size_t line = firstLine; line < firstLine + lineCount; line++) {
+    locationFile->addSourceLocation(LOCATION_TOKEN, line, {line}, line, 5, line, 6);
+  }
+  return locationFile;
+}
+}    // namespace
+
+struct CodeControllerFix : Test {
+  void SetUp() override {
+    mMessageQueue = std::make_shared<NiceMock<MockedMessageQueue>>();
+    IMessageQueue::setInstance(mMessageQueue);
+
+    mViewLayout = std::make_unique<NiceMock<MockedViewLayout>>();
+    mView = std::make_shared<MockedCodeView>(mViewLayout.get());
+    EXPECT_CALL(*mView, isInListMode).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mView, hasSingleFileCached).WillRepeatedly(Return(false));
+
+    mStorageAccess = std::make_unique<NiceMock<MockedStorageAccess>>();
+    mComponent = std::make_shared<Component>(mView, std::make_shared<CodeController>(mStorageAccess.get()));
+    mController = mComponent->getController<CodeController>();
+    ASSERT_NE(nullptr, mController);
+    mController->m_collection = std::make_shared<SourceLocationCollection>();
+  }
+
+  void TearDown() override {
+    mComponent.reset();
+    IMessageQueue::setInstance(nullptr);
+    mMessageQueue.reset();
+  }
+
+  // Shows the file with the given line count in the single file view.
+  CodeFileParams& showFile(const FilePath& filePath, size_t lineCount) {
+    EXPECT_CALL(*mStorageAccess, getFileContent(filePath, false))
+        .WillOnce(Return(TextAccess::createFromString(makeCode(lineCount), filePath)));
+
+    CodeFileParams file;
+    file.locationFile = makeLocationFile(filePath, true, 1, 1);
+    mController->m_files = {file};
+    mController->setFileState(mController->m_files.front(), MessageChangeFileView::FILE_MAXIMIZED, false);
+
+    EXPECT_CALL(*mView, showSingleFile);
+    mController->showFiles(CodeView::CodeParams(), CodeScrollParams(), true);
+    return mController->m_files.front();
+  }
+
+  std::shared_ptr<MockedMessageQueue> mMessageQueue;
+  std::unique_ptr<MockedViewLayout> mViewLayout;
+  std::shared_ptr<MockedCodeView> mView;
+  std::unique_ptr<MockedStorageAccess> mStorageAccess;
+  std::shared_ptr<Component> mComponent;
+  CodeController* mController = nullptr;
+};
+
+TEST_F(CodeControllerFix, showFilesLoadsAllLocationsOfSmallFile) {
+  const FilePath filePath(L"small.cpp");
+  EXPECT_CALL(*mStorageAccess, getSourceLocationsForFile(filePath))
+      .WillOnce(Return(makeLocationFile(filePath, true, 1, CodeSnippetParams::VirtualizedLineCount)));
+  EXPECT_CALL(*mView, updateSourceLocations);
+
+  const CodeFileParams& file = showFile(filePath, CodeSnippetParams::VirtualizedLineCount);
+
+  ASSERT_TRUE(file.fileParams);
+  EXPECT_FALSE(file.fileParams->isVirtualized);
+  EXPECT_TRUE(file.fileParams->hasAllSourceLocations);
+  EXPECT_EQ(CodeSnippetParams::VirtualizedLineCount, file.fileParams->locationFile->getSourceLocationCount());
+}
+
+TEST_F(CodeControllerFix, showFilesSkipsLocationsOfVirtualizedFile) {
+  const FilePath filePath(L"huge.cpp");
+  EXPECT_CALL(*mStorageAccess, getSourceLocationsForFile).Times(0);
+  EXPECT_CALL(*mView, updateSourceLocations).Times(0);
+
+  const CodeFileParams& file = showFile(filePath, CodeSnippetParams::VirtualizedLineCount + 1);
+
+  ASSERT_TRUE(file.fileParams);
+  EXPECT_TRUE(file.fileParams->isVirtualized);
+  EXPECT_FALSE(file.fileParams->hasAllSourceLocations);
+}
+
+TEST_F(CodeControllerFix, visibleLinesOfVirtualizedFileAreMergedIntoFileLocations) {
+  const FilePath filePath(L"huge.cpp");
+  const CodeFileParams& file = showFile(filePath, CodeSnippetParams::VirtualizedLineCount + 1);
+
+  EXPECT_CALL(*mStorageAccess, getSourceLocationsForLinesInFile(filePath, 100, 199))
+      .WillOnce(Return(makeLocationFile(filePath, false, 100, 100)));
+  EXPECT_CALL(*mStorageAccess, getSourceLocationsForLinesInFile(filePath, 150, 299))
+      .WillOnce(Return(makeLocationFile(filePath, false, 150, 150)));
+  EXPECT_CALL(*mView, updateSourceLocations).Times(2);
+
+  MessageCodeVisibleLinesChanged first(filePath, 100, 199);
+  mController->handleMessage(&first);
+  MessageCodeVisibleLinesChanged second(filePath, 150, 299);
+  mController->handleMessage(&second);
+
+  // the location of line 1 shown first and the lines 100 to 299 of both windows
+  const std::shared_ptr<SourceLocationFile>& locationFile = file.fileParams->locationFile;
+  EXPECT_EQ(201, locationFile->getSourceLocationCount());
+  EXPECT_TRUE(locationFile->isWhole());
+  EXPECT_NE(nullptr, locationFile->getSourceLocationById(1));
+  EXPECT_NE(nullptr, locationFile->getSourceLocationById(299));
+}
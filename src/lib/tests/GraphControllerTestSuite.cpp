@@ -0,0 +1,132 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "Component.h"
+#include "Graph.h"
+#include "GraphViewStyle.h"
+#include "GraphViewStyleImpl.h"
+#include "MockedMessageQueue.hpp"
+#include "mocks/MockedGraphView.hpp"
+#include "mocks/MockedStorageAccess.hpp"
+#include "mocks/MockedViewLayout.hpp"
+#include "utilityApp.h"
+#ifndef _WIN32
+#  define private public    // NOLINT
+#endif
+#include "GraphController.h"
+#ifndef _WIN32
+#  undef private
+#endif
+
+using namespace testing;
+
+namespace {
+struct MockedGraphViewStyleImpl : GraphViewStyleImpl {
+  MOCK_METHOD(float, getCharWidth, (const std::string&, size_t), (override));
+  MOCK_METHOD(float, getCharHeight, (const std::string&, size_t), (override));
+  MOCK_METHOD(float, getGraphViewZoomDifferenceForPlatform, (), (override));
+};
+}    // namespace
+
+struct GraphControllerFix : Test {
+  void SetUp() override {
+    mMessageQueue = std::make_shared<NiceMock<MockedMessageQueue>>();
+    IMessageQueue::setInstance(mMessageQueue);
+
+    mGraphViewStyle = std::make_shared<NiceMock<MockedGraphViewStyleImpl>>();
+    ON_CALL(*mGraphViewStyle, getCharWidth).WillByDefault(Return(7.0F));
+    ON_CALL(*mGraphViewStyle, getCharHeight).WillByDefault(Return(12.0F));
+    GraphViewStyle::setImpl(mGraphViewStyle);
+
+    mViewLayout = std::make_unique<NiceMock<MockedViewLayout>>();
+    mView = std::make_shared<MockedGraphView>(mViewLayout.get());
+    EXPECT_CALL(*mView, getViewSize).WillRepeatedly(Return(QVector2D(800, 600)));
+
+    mStorageAccess = std::make_unique<NiceMock<MockedStorageAccess>>();
+    mComponent = std::make_shared<Component>(mView, std::make_shared<GraphController>(mStorageAccess.get()));
+    mController = mComponent->getController<GraphController>();
+    ASSERT_NE(nullptr, mController);
+  }
+
+  void TearDown() override {
+    mComponent.reset();
+    GraphViewStyle::setImpl(nullptr);
+    IMessageQueue::setInstance(nullptr);
+    mMessageQueue.reset();
+  }
+
+  // Group of data nodes with names of different lengths, so the nodes get different sizes.
+  std::shared_ptr<DummyNode> createGroup(size_t nodeCount) {
+    auto group = std::make_shared<DummyNode>(DummyNode::DUMMY_GROUP);
+    group->name = L"group";
+    group->visible = true;
+
+    for(size_t i = 0; i < nodeCount; i++) {
+      const Id id = mNextNodeId++;
+      const std::wstring name = L"function" + std::wstring(i % 13, L'x') + std::to_wstring(i);
+      Node* node = mGraph.createNode(id, NodeType(NODE_FUNCTION), NameHierarchy(name, NAME_DELIMITER_CXX), DEFINITION_EXPLICIT);
+
+      auto dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+      dummyNode->data = node;
+      dummyNode->tokenId = id;
+      dummyNode->name = name;
+      dummyNode->visible = true;
+      group->subNodes.push_back(dummyNode);
+    }
+    return group;
+  }
+
+  std::shared_ptr<MockedMessageQueue> mMessageQueue;
+  std::shared_ptr<NiceMock<MockedGraphViewStyleImpl>> mGraphViewStyle;
+  std::unique_ptr<MockedViewLayout> mViewLayout;
+  std::shared_ptr<MockedGraphView> mView;
+  std::unique_ptr<MockedStorageAccess> mStorageAccess;
+  std::shared_ptr<Component> mComponent;
+  GraphController* mController = nullptr;
+  Graph mGraph;
+  Id mNextNodeId = 1;
+};
+
+TEST_F(GraphControllerFix, parallelGroupLayoutMatchesSequentialLayout) {
+  constexpr size_t NodeCount = 200;
+  const std::shared_ptr<DummyNode> parallelGroup = createGroup(NodeCount);
+  const std::shared_ptr<DummyNode> sequentialGroup = createGroup(NodeCount);
+
+  mController->layoutNestingRecursive(parallelGroup.get());
+
+  // nested calls on a worker thread of utility::forEachIndexParallel run on that worker, so the group is laid out sequentially
+  utility::forEachIndexParallel(2, 1, [this, &sequentialGroup](size_t index) {
+    if(index == 0) {
+      mController->layoutNestingRecursive(sequentialGroup.get());
+    }
+  });
+
+  EXPECT_EQ(sequentialGroup->size, parallelGroup->size);
+  ASSERT_EQ(sequentialGroup->subNodes.size(), parallelGroup->subNodes.size());
+  for(size_t i = 0; i < NodeCount; i++) {
+    EXPECT_EQ(sequentialGroup->subNodes[i]->name, parallelGroup->subNodes[i]->name);
+    EXPECT_EQ(sequentialGroup->subNodes[i]->position, parallelGroup->subNodes[i]->position);
+    EXPECT_EQ(sequentialGroup->subNodes[i]->size, parallelGroup->subNodes[i]->size);
+  }
+}
+
+TEST_F(GraphControllerFix, overviewShowsSymbolsBundleOnlyWithoutOtherSymbolBundles) {
+  const auto getBundleNames = [this]() {
+    std::vector<std::wstring> names;
+    for(const std::shared_ptr<DummyNode>& node : mController->m_dummyNodes) {
+      names.push_back(node->name);
+    }
+    mController->m_dummyNodes.clear();
+    return names;
+  };
+
+  mController->createOverviewBundles({{NODE_FILE, 2}, {NODE_SYMBOL, 3}});
+  EXPECT_THAT(getBundleNames(), ElementsAre(L"Files", L"Symbols"));
+
+  mController->createOverviewBundles({{NODE_FILE, 2}, {NODE_FUNCTION, 1}, {NODE_SYMBOL, 3}});
+  EXPECT_THAT(getBundleNames(), ElementsAre(L"Files", L"Functions"));
+}
@@ -0,0 +1,72 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "InterprocessIndexerControlManager.h"
+#include "ISharedMemoryGarbageCollector.hpp"
+#include "MockedSharedMemoryGarbageCollector.hpp"
+
+using namespace testing;
+
+struct InterprocessIndexerControlManagerFix : Test {
+  void SetUp() override {
+    mSharedMemoryGarbageCollector = std::make_shared<NiceMock<lib::MockedSharedMemoryGarbageCollector>>();
+    lib::ISharedMemoryGarbageCollector::setInstance(mSharedMemoryGarbageCollector);
+
+    mOwner = std::make_unique<InterprocessIndexerControlManager>("ctltest", 0, true);
+    mWorker = std::make_unique<InterprocessIndexerControlManager>("ctltest", 1, false);
+  }
+
+  void TearDown() override {
+    mWorker.reset();
+    mOwner.reset();
+
+    lib::ISharedMemoryGarbageCollector::setInstance(nullptr);
+    mSharedMemoryGarbageCollector.reset();
+  }
+
+  std::shared_ptr<NiceMock<lib::MockedSharedMemoryGarbageCollector>> mSharedMemoryGarbageCollector;
+  std::unique_ptr<InterprocessIndexerControlManager> mOwner;
+  std::unique_ptr<InterprocessIndexerControlManager> mWorker;
+};
+
+TEST_F(InterprocessIndexerControlManagerFix, noBatchIsOpenInitially) {
+  EXPECT_EQ(0, mWorker->getBatchId());
+  EXPECT_FALSE(mWorker->isBatchOpen(0));
+  EXPECT_FALSE(mWorker->isShutdownRequested());
+}
+
+TEST_F(InterprocessIndexerControlManagerFix, openedBatchIsVisibleToWorkersUntilClosed) {
+  const Id batchId = mOwner->openBatch(4);
+
+  EXPECT_EQ(batchId, mWorker->getBatchId());
+  EXPECT_EQ(4, mWorker->getBatchWorkerCount());
+  EXPECT_TRUE(mWorker->isBatchOpen(batchId));
+
+  mOwner->closeBatch();
+
+  EXPECT_FALSE(mWorker->isBatchOpen(batchId));
+}
+
+TEST_F(InterprocessIndexerControlManagerFix, openingNextBatchSupersedesPreviousOne) {
+  const Id firstBatchId = mOwner->openBatch(1);
+  const Id secondBatchId = mOwner->openBatch(1);
+
+  EXPECT_NE(firstBatchId, secondBatchId);
+  EXPECT_FALSE(mWorker->isBatchOpen(firstBatchId));
+  EXPECT_TRUE(mWorker->isBatchOpen(secondBatchId));
+}
+
+TEST_F(InterprocessIndexerControlManagerFix, finishedBatchIsReportedPerProcess) {
+  const Id batchId = mOwner->openBatch(1);
+  mWorker->setFinishedBatchId(batchId);
+
+  EXPECT_EQ(batchId, mOwner->getFinishedBatchId(1));
+  EXPECT_EQ(0, mOwner->getFinishedBatchId(2));
+}
+
+TEST_F(InterprocessIndexerControlManagerFix, shutdownRequestReachesWorkers) {
+  mOwner->requestShutdown();
+
+  EXPECT_TRUE(mWorker->isShutdownRequested());
+}
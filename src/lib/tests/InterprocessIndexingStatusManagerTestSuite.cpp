@@ -0,0 +1,117 @@
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "FilePath.h"
+#include "InterprocessIndexingStatusManager.h"
+#include "ISharedMemoryGarbageCollector.hpp"
+#include "MockedSharedMemoryGarbageCollector.hpp"
+
+using namespace testing;
+
+namespace {
+constexpr size_t OneMb = 1048576;
+}    // namespace
+
+struct InterprocessIndexingStatusManagerFix : Test {
+  void SetUp() override {
+    mSharedMemoryGarbageCollector = std::make_shared<NiceMock<lib::MockedSharedMemoryGarbageCollector>>();
+    lib::ISharedMemoryGarbageCollector::setInstance(mSharedMemoryGarbageCollector);
+
+    mOwner = std::make_unique<InterprocessIndexingStatusManager>("memtest", 0, true);
+    mFirstWorker = std::make_unique<InterprocessIndexingStatusManager>("memtest", 1, false);
+    mSecondWorker = std::make_unique<InterprocessIndexingStatusManager>("memtest", 2, false);
+  }
+
+  void TearDown() override {
+    mSecondWorker.reset();
+    mFirstWorker.reset();
+    mOwner.reset();
+
+    lib::ISharedMemoryGarbageCollector::setInstance(nullptr);
+    mSharedMemoryGarbageCollector.reset();
+  }
+
+  std::shared_ptr<NiceMock<lib::MockedSharedMemoryGarbageCollector>> mSharedMemoryGarbageCollector;
+  std::unique_ptr<InterprocessIndexingStatusManager> mOwner;
+  std::unique_ptr<InterprocessIndexingStatusManager> mFirstWorker;
+  std::unique_ptr<InterprocessIndexingStatusManager> mSecondWorker;
+};
+
+TEST_F(InterprocessIndexingStatusManagerFix, memoryUsageIsSummedOverProcesses) {
+  mOwner->setProcessMemoryUsage(100 * OneMb);
+  mFirstWorker->setProcessMemoryUsage(200 * OneMb);
+  mSecondWorker->setProcessMemoryUsage(300 * OneMb);
+
+  EXPECT_EQ(600 * OneMb, mOwner->getTotalMemoryUsage());
+
+  mFirstWorker->setProcessMemoryUsage(50 * OneMb);
+  mSecondWorker->clearProcessMemoryUsage();
+
+  EXPECT_EQ(150 * OneMb, mOwner->getTotalMemoryUsage());
+}
+
+TEST_F(InterprocessIndexingStatusManagerFix, noBudgetAlwaysAdmits) {
+  mOwner->setMemoryBudget(0);
+  mFirstWorker->setProcessMemoryUsage(1000 * OneMb);
+  mFirstWorker->startIndexingSourceFile(FilePath(L"a.cpp"));
+
+  EXPECT_TRUE(mSecondWorker->canStartIndexingSourceFile());
+}
+
+TEST_F(InterprocessIndexingStatusManagerFix, exhaustedBudgetHoldsBackWhileOthersAreIndexing) {
+  mOwner->setMemoryBudget(1000 * OneMb);
+  EXPECT_EQ(1000 * OneMb, mSecondWorker->getMemoryBudget());
+
+  mFirstWorker->setProcessMemoryUsage(950 * OneMb);
+  mFirstWorker->startIndexingSourceFile(FilePath(L"a.cpp"));
+
+  EXPECT_FALSE(mSecondWorker->canStartIndexingSourceFile());
+
+  mFirstWorker->finishIndexingSourceFile();
+
+  EXPECT_TRUE(mSecondWorker->canStartIndexingSourceFile());
+}
+
+TEST_F(InterprocessIndexingStatusManagerFix, finishingOneFileKeepsOtherFilesIndexing) {
+  mOwner->setMemoryBudget(1000 * OneMb);
+  mOwner->setProcessMemoryUsage(950 * OneMb);
+
+  mFirstWorker->startIndexingSourceFile(FilePath(L"a.cpp"));
+  mSecondWorker->startIndexingSourceFile(FilePath(L"b.cpp"));
+  mFirstWorker->finishIndexingSourceFile();
+
+  EXPECT_FALSE(mFirstWorker->canStartIndexingSourceFile());
+  EXPECT_THAT(mOwner->getIndexingSourceFilePaths(), ElementsAre(FilePath(L"b.cpp")));
+}
+
+TEST_F(InterprocessIndexingStatusManagerFix, onlyPublishedStoragesAreAnnounced) {
+  mFirstWorker->startIndexingSourceFile(FilePath(L"a.cpp"));
+  mFirstWorker->finishIndexingSourceFile();
+
+  EXPECT_EQ(0, mOwner->getNextFinishedProcessId());
+
+  mFirstWorker->pushFinishedProcessId();
+  mSecondWorker->pushFinishedProcessId();
+
+  EXPECT_EQ(1, mOwner->getNextFinishedProcessId());
+  EXPECT_EQ(2, mOwner->getNextFinishedProcessId());
+  EXPECT_EQ(0, mOwner->getNextFinishedProcessId());
+}
+
+TEST_F(InterprocessIndexingStatusManagerFix, pendingFilesAreCrashedUntilPublished) {
+  mFirstWorker->startIndexingSourceFile(FilePath(L"a.cpp"));
+  mFirstWorker->finishIndexingSourceFile(true);
+  mFirstWorker->startIndexingSourceFile(FilePath(L"b.cpp"));
+  mFirstWorker->finishIndexingSourceFile(true);
+  mSecondWorker->startIndexingSourceFile(FilePath(L"c.cpp"));
+  mSecondWorker->finishIndexingSourceFile();
+
+  EXPECT_THAT(mOwner->getIndexingSourceFilePaths(), IsEmpty());
+  EXPECT_THAT(mOwner->getCrashedSourceFilePaths(), ElementsAre(FilePath(L"a.cpp"), FilePath(L"b.cpp")));
+
+  mFirstWorker->clearPendingSourceFiles({FilePath(L"a.cpp")});
+
+  EXPECT_THAT(mOwner->getCrashedSourceFilePaths(), ElementsAre(FilePath(L"b.cpp")));
+}
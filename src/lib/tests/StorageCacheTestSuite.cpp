@@ -1,7 +1,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "FileInfo.h"
 #include "Graph.h"
+#include "MockedStorageAccess.hpp"
 #include "TextAccess.h"
 #define private public    // NOLINT(clang-diagnostic-keyword-macro)
 #include "StorageCache.h"
@@ -37,6 +39,13 @@ TEST(StorageCache, getErrorCount_empty) {
   EXPECT_EQ(0, errorsCount.total);
 }
 
+TEST(StorageCache, getFilteredErrorCount_empty) {
+  StorageCache cache;
+  cache.mUseErrorCache = true;
+  const auto errorsCount = cache.getFilteredErrorCount({});
+  EXPECT_EQ(0, errorsCount.total);
+}
+
 TEST(StorageCache, getErrorsLimited_empty) {
   StorageCache cache;
   cache.mUseErrorCache = true;
@@ -78,6 +87,105 @@ TEST(StorageCache, setUseErrorCache_false) {
   EXPECT_THAT(cache.mCachedErrors, testing::IsEmpty());
 }
 
+TEST(StorageCache, getFileContent_isCachedAfterFirstRequest) {
+  auto storage = std::make_shared<testing::StrictMock<MockedStorageAccess>>();
+  EXPECT_CALL(*storage, getNodeIdForFileNode(FilePath{L"a.cpp"})).WillOnce(testing::Return(1));
+  EXPECT_CALL(*storage, getFileInfoForFileId(1)).WillOnce(testing::Return(FileInfo(FilePath{L"a.cpp"})));
+  EXPECT_CALL(*storage, getFileContent(testing::_, false))
+      .WillOnce(testing::Return(TextAccess::createFromString("int a;\n", FilePath{L"a.cpp"})));
+
+  StorageCache cache;
+  cache.setSubject(storage);
+
+  const auto first = cache.getFileContent(FilePath{L"a.cpp"}, false);
+  const auto second = cache.getFileContent(FilePath{L"a.cpp"}, false);
+
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(1, cache.getFileContentCacheHitCount());
+  EXPECT_EQ(1, cache.getFileContentCacheMissCount());
+}
+
+TEST(StorageCache, clear_dropsCachedFileContents) {
+  auto storage = std::make_shared<testing::StrictMock<MockedStorageAccess>>();
+  EXPECT_CALL(*storage, getNodeIdForFileNode(FilePath{L"a.cpp"})).Times(2).WillRepeatedly(testing::Return(0));
+  EXPECT_CALL(*storage, getFileContent(testing::_, false))
+      .Times(2)
+      .WillRepeatedly(testing::Return(TextAccess::createFromString("int a;\n", FilePath{L"a.cpp"})));
+
+  StorageCache cache;
+  cache.setSubject(storage);
+
+  std::ignore = cache.getFileContent(FilePath{L"a.cpp"}, false);
+  cache.clear();
+  std::ignore = cache.getFileContent(FilePath{L"a.cpp"}, false);
+
+  EXPECT_EQ(0, cache.getFileContentCacheHitCount());
+  EXPECT_EQ(2, cache.getFileContentCacheMissCount());
+}
+
+TEST(StorageCache, clearFileContents_usesKeyOfRefreshedStorage) {
+  auto storage = std::make_shared<testing::StrictMock<MockedStorageAccess>>();
+  EXPECT_CALL(*storage, getNodeIdForFileNode(FilePath{L"a.cpp"})).Times(2).WillRepeatedly(testing::Return(1));
+  EXPECT_CALL(*storage, getFileInfoForFileId(1))
+      .WillOnce(testing::Return(FileInfo(FilePath{L"a.cpp"}, TimeStamp(std::string("2024-01-01 10:00:00")))))
+      .WillOnce(testing::Return(FileInfo(FilePath{L"a.cpp"}, TimeStamp(std::string("2024-01-02 10:00:00")))));
+  EXPECT_CALL(*storage, getFileContent(testing::_, false))
+      .WillOnce(testing::Return(TextAccess::createFromString("int a;\n", FilePath{L"a.cpp"})))
+      .WillOnce(testing::Return(TextAccess::createFromString("int b;\n", FilePath{L"a.cpp"})));
+
+  StorageCache cache;
+  cache.setSubject(storage);
+
+  const std::wstring indexedKey = cache.getFileContentCacheKey(FilePath{L"a.cpp"});
+  std::ignore = cache.getFileContent(FilePath{L"a.cpp"}, false);
+  // the key of a path is not looked up again until the file contents are cleared
+  EXPECT_EQ(indexedKey, cache.getFileContentCacheKey(FilePath{L"a.cpp"}));
+
+  cache.clearFileContents();
+  const auto refreshed = cache.getFileContent(FilePath{L"a.cpp"}, false);
+
+  EXPECT_NE(indexedKey, cache.getFileContentCacheKey(FilePath{L"a.cpp"}));
+  EXPECT_EQ("int b;\n", refreshed->getText());
+  EXPECT_EQ(0, cache.getFileContentCacheHitCount());
+  EXPECT_EQ(2, cache.getFileContentCacheMissCount());
+}
+
+TEST(StorageCache, getTooltipInfoForTokenIds_isCachedAfterFirstRequest) {
+  TooltipInfo info;
+  info.title = L"int a";
+
+  auto storage = std::make_shared<testing::StrictMock<MockedStorageAccess>>();
+  EXPECT_CALL(*storage, getTooltipInfoForTokenIds(std::vector<Id>{1}, TOOLTIP_ORIGIN_CODE)).WillOnce(testing::Return(info));
+
+  StorageCache cache;
+  cache.setSubject(storage);
+
+  std::ignore = cache.getTooltipInfoForTokenIds({1}, TOOLTIP_ORIGIN_CODE);
+  const auto second = cache.getTooltipInfoForTokenIds({1}, TOOLTIP_ORIGIN_CODE);
+
+  EXPECT_EQ(L"int a", second.title);
+  EXPECT_EQ(1, cache.getTooltipCacheHitCount());
+}
+
+TEST(StorageCache, clear_dropsCachedTooltipInfos) {
+  TooltipInfo info;
+  info.title = L"int a";
+
+  auto storage = std::make_shared<testing::StrictMock<MockedStorageAccess>>();
+  EXPECT_CALL(*storage, getTooltipInfoForTokenIds(std::vector<Id>{1}, TOOLTIP_ORIGIN_CODE))
+      .Times(2)
+      .WillRepeatedly(testing::Return(info));
+
+  StorageCache cache;
+  cache.setSubject(storage);
+
+  std::ignore = cache.getTooltipInfoForTokenIds({1}, TOOLTIP_ORIGIN_CODE);
+  cache.clear();
+  std::ignore = cache.getTooltipInfoForTokenIds({1}, TOOLTIP_ORIGIN_CODE);
+
+  EXPECT_EQ(0, cache.getTooltipCacheHitCount());
+}
+
 TEST(StorageCache, addErrorsToCache) {
   StorageCache cache;
   cache.addErrorsToCache({}, {1, 2});
@@ -1,8 +1,73 @@
+#include <map>
+#include <set>
+#include <string>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "LocationType.h"
 #include "StorageProvider.h"
 
+namespace {
+std::shared_ptr<IntermediateStorage> makeStorage(size_t sourceLocationCount) {
+  auto storage = std::make_shared<IntermediateStorage>();
+  std::set<StorageSourceLocation> locations;
+  for(size_t i = 0; i < sourceLocationCount; ++i) {
+    locations.emplace(i + 1, 1, i + 1, 1, i + 1, 2, locationTypeToInt(LOCATION_TOKEN));
+  }
+  storage->setStorageSourceLocations(std::move(locations));
+  return storage;
+}
+
+// Storage with a file, a shared node and an own node, the ids of all these storages overlap.
+std::shared_ptr<IntermediateStorage> makeFileStorage(const std::wstring& name) {
+  auto storage = std::make_shared<IntermediateStorage>();
+  const Id fileId = storage->addNode(StorageNodeData{0, name + L".cpp"}).first;
+  storage->addFile(StorageFile(fileId, name + L".cpp", L"cpp", "", true, true));
+  const Id sharedId = storage->addNode(StorageNodeData{0, L"shared"}).first;
+  const Id ownId = storage->addNode(StorageNodeData{0, name}).first;
+  storage->addSymbol(StorageSymbol(ownId, 1));
+  const Id edgeId = storage->addEdge(StorageEdgeData(1, ownId, sharedId));
+  const Id locationId = storage->addSourceLocation(
+      StorageSourceLocationData(fileId, 1, 1, 1, 5, locationTypeToInt(LOCATION_TOKEN)));
+  storage->addOccurrence(StorageOccurrence(ownId, locationId));
+  storage->addOccurrence(StorageOccurrence(edgeId, locationId));
+  return storage;
+}
+
+// Content of a storage described by names instead of ids.
+std::set<std::wstring> describe(const Storage& storage) {
+  std::map<Id, std::wstring> names;
+  for(const StorageNode& node : storage.getStorageNodes()) {
+    names[node.id] = node.serializedName;
+  }
+  for(const StorageEdge& edge : storage.getStorageEdges()) {
+    names[edge.id] = names[edge.sourceNodeId] + L"->" + names[edge.targetNodeId];
+  }
+
+  std::set<std::wstring> result;
+  for(const auto& [id, name] : names) {
+    result.insert(L"element " + name);
+  }
+  for(const StorageFile& file : storage.getStorageFiles()) {
+    result.insert(L"file " + names[file.id] + L" " + file.filePath);
+  }
+  for(const StorageSymbol& symbol : storage.getStorageSymbols()) {
+    result.insert(L"symbol " + names[symbol.id]);
+  }
+
+  std::map<Id, std::wstring> locations;
+  for(const StorageSourceLocation& location : storage.getStorageSourceLocations()) {
+    locations[location.id] = names[location.fileNodeId] + L":" + std::to_wstring(location.startLine) + L":" +
+        std::to_wstring(location.startCol);
+  }
+  for(const StorageOccurrence& occurrence : storage.getStorageOccurrences()) {
+    result.insert(L"occurrence " + names[occurrence.elementId] + L" at " + locations[occurrence.sourceLocationId]);
+  }
+  return result;
+}
+}    // namespace
+
 TEST(StorageProvider, getStorageCount_empty) {
   // Given:
   const StorageProvider provider;
@@ -101,3 +166,77 @@ TEST(StorageProvider, consumeLargestStorage_oneStorageExists) {
   // Then:
   EXPECT_TRUE(result.has_value());
 }
+
+TEST(StorageProvider, consumeStoragesToMerge_oneStorageExists) {
+  // Given:
+  StorageProvider provider;
+  // And:
+  provider.insert(makeStorage(1));
+  // When:
+  const auto result = provider.consumeStoragesToMerge(4);
+  // Then:
+  EXPECT_TRUE(result.empty());
+  EXPECT_EQ(1, provider.getStorageCount());
+}
+
+TEST(StorageProvider, consumeStoragesToMerge_keepsLargestStorage) {
+  // Given:
+  StorageProvider provider;
+  // And:
+  provider.insert(makeStorage(2));
+  provider.insert(makeStorage(5));
+  provider.insert(makeStorage(1));
+  provider.insert(makeStorage(3));
+  // When:
+  const auto result = provider.consumeStoragesToMerge(2);
+  // Then:
+  ASSERT_EQ(2, result.size());
+  EXPECT_EQ(3, result[0]->getSourceLocationCount());
+  EXPECT_EQ(2, result[1]->getSourceLocationCount());
+  // And:
+  ASSERT_EQ(2, provider.getStorageCount());
+  EXPECT_EQ(5, provider.consumeLargestStorage().value()->getSourceLocationCount());
+}
+
+TEST(StorageProvider, merge_empty) {
+  // When:
+  const auto result = StorageProvider::merge({});
+  // Then:
+  EXPECT_EQ(nullptr, result);
+}
+
+TEST(StorageProvider, merge_multipleStorages) {
+  // Given:
+  auto storage0 = std::make_shared<IntermediateStorage>();
+  storage0->addNode(StorageNodeData{0, L"a"});
+  auto storage1 = std::make_shared<IntermediateStorage>();
+  storage1->addNode(StorageNodeData{0, L"a"});
+  storage1->addNode(StorageNodeData{0, L"b"});
+  auto storage2 = std::make_shared<IntermediateStorage>();
+  storage2->addNode(StorageNodeData{0, L"c"});
+  // When:
+  const auto result = StorageProvider::merge({storage0, storage1, storage2});
+  // Then:
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(3, result->getStorageNodes().size());
+}
+
+TEST(StorageProvider, merge_matchesSequentialInjection) {
+  // Given:
+  const std::vector<std::wstring> names = {L"a", L"b", L"c", L"d"};
+  auto expected = std::make_shared<IntermediateStorage>();
+  std::vector<std::shared_ptr<IntermediateStorage>> storages;
+  for(const std::wstring& name : names) {
+    expected->inject(makeFileStorage(name).get());
+    storages.push_back(makeFileStorage(name));
+  }
+  // When:
+  const auto result = StorageProvider::merge(storages);
+  // Then:
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(describe(*expected), describe(*result));
+  EXPECT_EQ(1 + 2 * names.size(), result->getStorageNodes().size());
+  EXPECT_EQ(names.size(), result->getStorageEdges().size());
+  EXPECT_EQ(names.size(), result->getStorageFiles().size());
+  EXPECT_EQ(2 * names.size(), result->getStorageOccurrences().size());
+}
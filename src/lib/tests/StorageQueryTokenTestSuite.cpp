@@ -0,0 +1,76 @@
+#include <stdexcept>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "StorageQueryToken.h"
+
+namespace {
+
+struct StorageQueryTokenFix : testing::Test {
+  void TearDown() override {
+    StorageQueryToken::clear();
+  }
+};
+
+TEST_F(StorageQueryTokenFix, tokenOfLatestActivationIsNotCancelled) {
+  StorageQueryToken::supersede(1, 10);
+
+  EXPECT_FALSE(StorageQueryToken(1, 10).isCancelled());
+  EXPECT_FALSE(StorageQueryToken().isCancelled());
+}
+
+TEST_F(StorageQueryTokenFix, newerActivationCancelsOnlyItsOwnTab) {
+  StorageQueryToken::supersede(1, 10);
+  StorageQueryToken::supersede(2, 11);
+  StorageQueryToken::supersede(1, 12);
+
+  EXPECT_TRUE(StorageQueryToken(1, 10).isCancelled());
+  EXPECT_FALSE(StorageQueryToken(1, 12).isCancelled());
+  EXPECT_FALSE(StorageQueryToken(2, 11).isCancelled());
+}
+
+TEST_F(StorageQueryTokenFix, runBindsTokenToCallingThread) {
+  StorageQueryToken::supersede(1, 10);
+  const StorageQueryToken token(1, 10);
+
+  bool cancelledInside = true;
+  EXPECT_TRUE(token.run([&]() {
+    cancelledInside = StorageQueryToken::isCurrentThreadCancelled();
+  }));
+
+  EXPECT_FALSE(cancelledInside);
+  EXPECT_FALSE(StorageQueryToken::isCurrentThreadCancelled());
+}
+
+TEST_F(StorageQueryTokenFix, runReportsSupersededActivation) {
+  StorageQueryToken::supersede(1, 10);
+  const StorageQueryToken token(1, 10);
+
+  bool cancelledInside = false;
+  EXPECT_FALSE(token.run([&]() {
+    StorageQueryToken::supersede(1, 11);
+    cancelledInside = StorageQueryToken::isCurrentThreadCancelled();
+  }));
+
+  EXPECT_TRUE(cancelledInside);
+}
+
+TEST_F(StorageQueryTokenFix, runDropsErrorsOfInterruptedQueries) {
+  StorageQueryToken::supersede(1, 10);
+  const StorageQueryToken token(1, 10);
+
+  EXPECT_FALSE(token.run([]() {
+    StorageQueryToken::supersede(1, 11);
+    throw std::runtime_error("interrupted");
+  }));
+}
+
+TEST_F(StorageQueryTokenFix, runRethrowsErrorsOfCurrentQueries) {
+  StorageQueryToken::supersede(1, 10);
+  const StorageQueryToken token(1, 10);
+
+  EXPECT_THROW(std::ignore = token.run([]() { throw std::runtime_error("failed"); }), std::runtime_error);
+}
+
+}    // namespace
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "Graph.h"
+#include "TrailLayouter.h"
+
+namespace {
+// Trail graph of dummy nodes and edges, set up the way GraphController passes a trail to the layouter.
+class TrailLayouterFix : public testing::Test {
+public:
+  void addNodes(size_t count) {
+    for(size_t i = 0; i < count; i++) {
+      const Id id = static_cast<Id>(i + 1);
+      const std::wstring name = L"func" + std::to_wstring(id);
+      m_graph.createNode(id, NodeType(NODE_FUNCTION), NameHierarchy(name, NAME_DELIMITER_CXX), DEFINITION_EXPLICIT);
+
+      auto dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+      dummyNode->tokenId = id;
+      dummyNode->name = name;
+      dummyNode->visible = true;
+      dummyNode->active = (i == 0);
+      dummyNode->size = QVector2D(100, 30);
+
+      m_dummyNodes.push_back(dummyNode);
+      m_topLevelAncestorIds.emplace(id, id);
+    }
+  }
+
+  void addCall(size_t callerIndex, size_t calleeIndex) {
+    const Id callerId = m_dummyNodes[callerIndex]->tokenId;
+    const Id calleeId = m_dummyNodes[calleeIndex]->tokenId;
+
+    Node* caller = m_graph.getNodeById(callerId);
+    Node* callee = m_graph.getNodeById(calleeId);
+    Edge* edge = m_graph.createEdge(m_nextEdgeId++, Edge::EDGE_CALL, caller, callee);
+
+    auto dummyEdge = std::make_shared<DummyEdge>(callerId, calleeId, edge);
+    dummyEdge->visible = true;
+    m_dummyEdges.push_back(dummyEdge);
+  }
+
+  // call tree with a few callees per function, further calls mostly go to functions one level deeper in the tree and
+  // sometimes back to a function higher up, which creates cycles
+  void addGeneratedCallGraph(size_t nodeCount, size_t calleesPerNode, size_t extraCallsPerNode) {
+    addNodes(nodeCount);
+
+    std::vector<size_t> depthStarts = {0, 1};
+    while(depthStarts.back() < nodeCount) {
+      depthStarts.push_back(depthStarts.back() + (depthStarts.back() - depthStarts[depthStarts.size() - 2]) * calleesPerNode);
+    }
+    depthStarts.back() = nodeCount;
+
+    uint32_t random = 42;
+    const auto nextRandom = [&random](size_t max) {
+      random = random * 1664525 + 1013904223;
+      return static_cast<size_t>(random >> 8) % max;
+    };
+
+    for(size_t depth = 0; depth + 1 < depthStarts.size(); depth++) {
+      for(size_t i = depthStarts[depth]; i < depthStarts[depth + 1]; i++) {
+        if(i > 0) {
+          addCall((i - 1) / calleesPerNode, i);
+        }
+
+        for(size_t j = 0; j < extraCallsPerNode; j++) {
+          if(nextRandom(10) == 0) {
+            addCall(i, nextRandom(depthStarts[depth] + 1));
+          } else if(depth + 2 < depthStarts.size()) {
+            addCall(i, depthStarts[depth + 1] + nextRandom(depthStarts[depth + 2] - depthStarts[depth + 1]));
+          }
+        }
+      }
+    }
+  }
+
+  void layout() {
+    TrailLayouter layouter(TrailLayouter::LAYOUT_LEFT_RIGHT);
+    layouter.layoutGraph(m_dummyNodes, m_dummyEdges, m_topLevelAncestorIds);
+  }
+
+  float x(size_t index) const {
+    return m_dummyNodes[index]->position.x();
+  }
+
+  bool hasOverlappingNodes() const {
+    std::map<float, std::vector<const DummyNode*>> nodesPerCol;
+    for(const auto& node : m_dummyNodes) {
+      nodesPerCol[node->position.x()].push_back(node.get());
+    }
+
+    for(auto& [col, nodes] : nodesPerCol) {
+      std::sort(nodes.begin(), nodes.end(), [](const DummyNode* a, const DummyNode* b) {
+        return a->position.y() < b->position.y();
+      });
+
+      for(size_t i = 1; i < nodes.size(); i++) {
+        if(nodes[i - 1]->position.y() + nodes[i - 1]->size.y() > nodes[i]->position.y()) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  Graph m_graph;
+  Id m_nextEdgeId = 1000000;
+
+  std::vector<std::shared_ptr<DummyNode>> m_dummyNodes;
+  std::vector<std::shared_ptr<DummyEdge>> m_dummyEdges;
+  std::map<Id, Id> m_topLevelAncestorIds;
+};
+}    // namespace
+
+TEST_F(TrailLayouterFix, callChainIsLaidOutInCallOrder) {
+  addNodes(3);
+  addCall(0, 1);
+  addCall(1, 2);
+
+  layout();
+
+  EXPECT_LT(x(0), x(1));
+  EXPECT_LT(x(1), x(2));
+}
+
+TEST_F(TrailLayouterFix, cycleIsBrokenWithoutHidingNodes) {
+  addNodes(3);
+  addCall(0, 1);
+  addCall(1, 2);
+  addCall(2, 0);
+
+  layout();
+
+  for(const auto& node : m_dummyNodes) {
+    EXPECT_TRUE(node->visible);
+  }
+  EXPECT_LT(x(0), x(1));
+  EXPECT_LT(x(1), x(2));
+}
+
+TEST_F(TrailLayouterFix, longCallChainDoesNotRecurse) {
+  addNodes(20000);
+  for(size_t i = 1; i < m_dummyNodes.size(); i++) {
+    addCall(i - 1, i);
+  }
+
+  layout();
+
+  EXPECT_TRUE(m_dummyNodes.back()->visible);
+  EXPECT_LT(x(m_dummyNodes.size() - 2), x(m_dummyNodes.size() - 1));
+}
+
+TEST_F(TrailLayouterFix, generatedCallGraphIsLaidOutWithoutOverlaps) {
+  addGeneratedCallGraph(3000, 4, 2);
+
+  layout();
+
+  for(const auto& node : m_dummyNodes) {
+    EXPECT_TRUE(node->visible);
+  }
+  EXPECT_FALSE(hasOverlappingNodes());
+}
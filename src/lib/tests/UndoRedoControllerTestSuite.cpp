@@ -0,0 +1,139 @@
+#include <memory>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "HistorySnapshotInterfaces.h"
+#include "MockedMessageQueue.hpp"
+#include "mocks/MockedStorageAccess.hpp"
+#include "type/activation/MessageActivateOverview.h"
+#include "type/graph/MessageScrollGraph.h"
+#ifndef _WIN32
+#  define private public    // NOLINT
+#endif
+#include "UndoRedoController.h"
+#ifndef _WIN32
+#  undef private
+#endif
+
+using namespace testing;
+
+namespace {
+struct TestSnapshot final : HistorySnapshot {
+  explicit TestSnapshot(size_t byteSize_) : byteSize(byteSize_) {}
+
+  size_t getByteSize() const override {
+    return byteSize;
+  }
+
+  size_t byteSize;
+};
+
+struct MockedHistorySnapshotSource : HistorySnapshotSource {
+  MOCK_METHOD(bool, hasSnapshot, (), (const, override));
+  MOCK_METHOD(std::shared_ptr<HistorySnapshot>, takeSnapshot, (), (override));
+  MOCK_METHOD(void, restoreSnapshot, (std::shared_ptr<HistorySnapshot>), (override));
+
+  using HistorySnapshotSource::isRestoredMessage;
+};
+}    // namespace
+
+struct UndoRedoControllerFix : Test {
+  using Command = UndoRedoController::Command;
+
+  void SetUp() override {
+    mMessageQueue = std::make_shared<NiceMock<MockedMessageQueue>>();
+    IMessageQueue::setInstance(mMessageQueue);
+
+    mController = std::make_unique<UndoRedoController>(&mStorageAccess);
+    mController->addSnapshotSource(&mGraphSource);
+    mController->addSnapshotSource(&mCodeSource);
+
+    mController->m_list.emplace_back(mFirstActivation, Command::ORDER_ACTIVATE);
+    mController->m_list.emplace_back(mScroll, Command::ORDER_VIEW, true);
+    mController->m_list.emplace_back(std::make_shared<MessageActivateOverview>(), Command::ORDER_ACTIVATE);
+  }
+
+  void TearDown() override {
+    mController.reset();
+    IMessageQueue::setInstance(nullptr);
+    mMessageQueue.reset();
+  }
+
+  // Moves the history to the position after the given number of commands.
+  void moveTo(size_t commandCount) {
+    mController->m_iterator = std::next(mController->m_list.begin(), static_cast<std::ptrdiff_t>(commandCount));
+  }
+
+  // Lets both sources hand over snapshots of the given size whenever the history stores a position.
+  void expectSnapshots(size_t byteSize) {
+    EXPECT_CALL(mGraphSource, hasSnapshot).WillRepeatedly(Return(true));
+    EXPECT_CALL(mCodeSource, hasSnapshot).WillRepeatedly(Return(true));
+    EXPECT_CALL(mGraphSource, takeSnapshot).WillRepeatedly([byteSize]() { return std::make_shared<TestSnapshot>(byteSize); });
+    EXPECT_CALL(mCodeSource, takeSnapshot).WillRepeatedly([byteSize]() { return std::make_shared<TestSnapshot>(byteSize); });
+  }
+
+  std::shared_ptr<MockedMessageQueue> mMessageQueue;
+  NiceMock<MockedStorageAccess> mStorageAccess;
+  StrictMock<MockedHistorySnapshotSource> mGraphSource;
+  StrictMock<MockedHistorySnapshotSource> mCodeSource;
+  std::shared_ptr<MessageActivateOverview> mFirstActivation = std::make_shared<MessageActivateOverview>();
+  std::shared_ptr<MessageScrollGraph> mScroll = std::make_shared<MessageScrollGraph>(0, 10);
+  std::unique_ptr<UndoRedoController> mController;
+};
+
+TEST_F(UndoRedoControllerFix, storeSnapshotsKeepsStateOfAllSourcesIfOneHasNoSnapshot) {
+  EXPECT_CALL(mGraphSource, hasSnapshot).WillRepeatedly(Return(true));
+  EXPECT_CALL(mCodeSource, hasSnapshot).WillRepeatedly(Return(false));
+  EXPECT_CALL(mGraphSource, takeSnapshot).Times(0);
+  EXPECT_CALL(mCodeSource, takeSnapshot).Times(0);
+  moveTo(3);
+
+  mController->storeSnapshots();
+
+  EXPECT_FALSE(mController->hasSnapshots(mController->m_iterator));
+}
+
+TEST_F(UndoRedoControllerFix, restoreSnapshotsHandsSnapshotsBackToTheirSources) {
+  auto graphSnapshot = std::make_shared<TestSnapshot>(10);
+  auto codeSnapshot = std::make_shared<TestSnapshot>(20);
+  EXPECT_CALL(mGraphSource, hasSnapshot).WillOnce(Return(true));
+  EXPECT_CALL(mCodeSource, hasSnapshot).WillOnce(Return(true));
+  EXPECT_CALL(mGraphSource, takeSnapshot).WillOnce(Return(graphSnapshot));
+  EXPECT_CALL(mCodeSource, takeSnapshot).WillOnce(Return(codeSnapshot));
+  moveTo(2);
+  mController->storeSnapshots();
+  ASSERT_TRUE(mController->hasSnapshots(mController->m_iterator));
+
+  EXPECT_CALL(mGraphSource, restoreSnapshot(std::shared_ptr<HistorySnapshot>(graphSnapshot)));
+  EXPECT_CALL(mCodeSource, restoreSnapshot(std::shared_ptr<HistorySnapshot>(codeSnapshot)));
+  EXPECT_TRUE(mController->restoreSnapshots(mController->m_list.begin()));
+
+  // the snapshots change owner, so the position is replayed the next time unless it is stored again
+  EXPECT_FALSE(mController->hasSnapshots(mController->m_iterator));
+
+  // the scroll only applies its last value and is replayed on top of the restored state
+  mFirstActivation->setIsReplayed(true);
+  mScroll->setIsReplayed(true);
+  EXPECT_TRUE(mGraphSource.isRestoredMessage(*mFirstActivation));
+  EXPECT_FALSE(mGraphSource.isRestoredMessage(*mScroll));
+  EXPECT_TRUE(mCodeSource.isRestoredMessage(*mFirstActivation));
+}
+
+TEST_F(UndoRedoControllerFix, restoreSnapshotsFallsBackToReplayOnceSnapshotsAreEvicted) {
+  // the snapshots of one position take more than half of the budget
+  expectSnapshots(UndoRedoController::SnapshotByteBudget / 4 + 1);
+  moveTo(1);
+  mController->storeSnapshots();
+  moveTo(3);
+  mController->storeSnapshots();
+
+  moveTo(1);
+  EXPECT_FALSE(mController->hasSnapshots(mController->m_iterator));
+  EXPECT_FALSE(mController->restoreSnapshots(mController->m_list.begin()));
+
+  EXPECT_CALL(mGraphSource, restoreSnapshot);
+  EXPECT_CALL(mCodeSource, restoreSnapshot);
+  moveTo(3);
+  EXPECT_TRUE(mController->restoreSnapshots(std::next(mController->m_list.begin(), 2)));
+}
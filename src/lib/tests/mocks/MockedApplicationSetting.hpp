@@ -85,6 +85,20 @@ struct MockedApplicationSettings : IApplicationSettings {
   MOCK_METHOD(bool, getMultiProcessIndexingEnabled, (), (const, noexcept, override));
   MOCK_METHOD(void, setMultiProcessIndexingEnabled, (bool), (noexcept, override));
 
+  MOCK_METHOD(int, getIndexerMemoryBudget, (), (const, noexcept, override));
+  MOCK_METHOD(void, setIndexerMemoryBudget, (int), (noexcept, override));
+
+  MOCK_METHOD(bool, getPersistentIndexerProcessesEnabled, (), (const, noexcept, override));
+  MOCK_METHOD(void, setPersistentIndexerProcessesEnabled, (bool), (noexcept, override));
+
+  MOCK_METHOD(bool, getFileChangeJournalEnabled, (), (const, noexcept, override));
+  MOCK_METHOD(void, setFileChangeJournalEnabled, (bool), (noexcept, override));
+
+  MOCK_METHOD(int, getStorageMergeThreadCount, (), (const, noexcept, override));
+  MOCK_METHOD(void, setStorageMergeThreadCount, (int), (noexcept, override));
+  MOCK_METHOD(int, getStorageMergeCount, (), (const, noexcept, override));
+  MOCK_METHOD(void, setStorageMergeCount, (int), (noexcept, override));
+
   MOCK_METHOD(std::vector<std::filesystem::path>, getHeaderSearchPaths, (), (const, noexcept, override));
   MOCK_METHOD(std::vector<std::filesystem::path>, getHeaderSearchPathsExpanded, (), (const, noexcept, override));
   MOCK_METHOD(bool, setHeaderSearchPaths, (const std::vector<std::filesystem::path>&), (noexcept, override));
@@ -29,6 +29,8 @@ struct MockedDialogView : DialogView {
 
   MOCK_METHOD(void, updateIndexingDialog, (size_t, size_t, size_t, const std::vector<FilePath>&), (override));
 
+  MOCK_METHOD(void, updateIndexingMemoryUsage, (size_t, size_t), (override));
+
   MOCK_METHOD(void, updateCustomIndexingDialog, (size_t, size_t, size_t, const std::vector<FilePath>&), (override));
 
 
@@ -50,6 +50,8 @@ public:
   MOCK_METHOD(GraphPtr, getGraphForAll, (), (const, override));
 
   MOCK_METHOD(GraphPtr, getGraphForNodeTypes, (NodeTypeSet), (const, override));
+  MOCK_METHOD((std::map<NodeKind, size_t>), getOverviewBundleCounts, (), (const, override));
+  MOCK_METHOD(GraphPtr, getGraphForOverviewBundle, (NodeKind, size_t, size_t), (const, override));
 
   MOCK_METHOD(GraphPtr, getGraphForActiveTokenIds, (const Ids&, const Ids&, bool*), (const, override));
 
@@ -87,6 +89,8 @@ public:
 
   MOCK_METHOD(ErrorCountInfo, getErrorCount, (), (const, override));
 
+  MOCK_METHOD(ErrorCountInfo, getFilteredErrorCount, (const ErrorFilter&), (const, override));
+
   MOCK_METHOD(VecErrorInfo, getErrorsLimited, (const ErrorFilter&), (const, override));
 
   MOCK_METHOD(VecErrorInfo, getErrorsForFileLimited, (const ErrorFilter&, const FilePath&), (const, override));
@@ -14,6 +14,7 @@ struct MockedStorageCache : StorageCache {
   MOCK_METHOD(TextAccessPtr, getFileContent, (const FilePath&, bool), (const, override));
 
   MOCK_METHOD(ErrorCountInfo, getErrorCount, (), (const, override));
+  MOCK_METHOD(ErrorCountInfo, getFilteredErrorCount, (const ErrorFilter&), (const, override));
 
   using ErrorInfoVec = std::vector<ErrorInfo>;
   MOCK_METHOD(ErrorInfoVec, getErrorsLimited, (const ErrorFilter&), (const, override));
@@ -0,0 +1,325 @@
+#include "CxxCompilationDatabase.h"
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string_view>
+
+#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/Path.h>
+
+#include "logging.h"
+#include "OrderedCache.h"
+#include "utilityString.h"
+
+namespace {
+// bump the version whenever the layout of the cache file changes
+constexpr std::string_view CacheFileMagic = "SRCTRLCDB";
+constexpr uint64_t CacheFileVersion = 1;
+
+// the cache does not keep databases alive, a database is freed once its last user releases it
+struct CacheEntry {
+  uint64_t cdbSize = 0;
+  int64_t cdbWriteTime = 0;
+  std::weak_ptr<const CxxCompilationDatabase> database;
+};
+
+std::mutex s_cacheMutex;
+std::map<std::wstring, CacheEntry> s_cache;
+
+bool getFileState(const FilePath& filePath, uint64_t& size, int64_t& writeTime) {
+  const std::filesystem::path path(filePath.wstr());
+  std::error_code errorCode;
+  size = std::filesystem::file_size(path, errorCode);
+  if(errorCode) {
+    return false;
+  }
+  writeTime = std::filesystem::last_write_time(path, errorCode).time_since_epoch().count();
+  return !errorCode;
+}
+
+// the file name of the command as absolute native path, like the JSON compilation database indexes its commands
+std::string getNativeFileName(const clang::tooling::CompileCommand& command) {
+  llvm::SmallString<128> fileName;
+  if(llvm::sys::path::is_relative(command.Filename)) {
+    fileName = command.Directory;
+    llvm::sys::path::append(fileName, command.Filename);
+    llvm::sys::path::remove_dots(fileName, true);
+  } else {
+    fileName = command.Filename;
+  }
+  llvm::sys::path::native(fileName);
+  return fileName.str().str();
+}
+
+class CacheFileWriter final {
+public:
+  explicit CacheFileWriter(const std::filesystem::path& path) : m_file(path, std::ios::binary | std::ios::trunc) {}
+
+  void write(uint64_t value) {
+    m_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void write(std::string_view text) {
+    write(static_cast<uint64_t>(text.size()));
+    m_file.write(text.data(), static_cast<std::streamsize>(text.size()));
+  }
+
+  bool finish() {
+    m_file.close();
+    return !m_file.fail();
+  }
+
+private:
+  std::ofstream m_file;
+};
+
+// checks every length against the remaining file size, so a corrupted file cannot cause huge allocations
+class CacheFileReader final {
+public:
+  CacheFileReader(const std::filesystem::path& path, uint64_t size) : m_file(path, std::ios::binary), m_remaining(size) {}
+
+  bool read(uint64_t& value) {
+    if(m_remaining < sizeof(value) || !m_file.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+      return false;
+    }
+    m_remaining -= sizeof(value);
+    return true;
+  }
+
+  bool read(std::string& text) {
+    uint64_t size = 0;
+    if(!read(size) || size > m_remaining) {
+      return false;
+    }
+    text.resize(size);
+    if(!m_file.read(text.data(), static_cast<std::streamsize>(size))) {
+      return false;
+    }
+    m_remaining -= size;
+    return true;
+  }
+
+  [[nodiscard]] bool isAtEnd() const {
+    return m_remaining == 0;
+  }
+
+private:
+  std::ifstream m_file;
+  uint64_t m_remaining;
+};
+}    // namespace
+
+std::shared_ptr<const CxxCompilationDatabase> CxxCompilationDatabase::load(const FilePath& cdbPath,
+                                                                           const FilePath& cacheFilePath,
+                                                                           std::string* error) {
+  uint64_t cdbSize = 0;
+  int64_t cdbWriteTime = 0;
+  if(cdbPath.empty() || !getFileState(cdbPath, cdbSize, cdbWriteTime)) {
+    return {};
+  }
+
+  const std::lock_guard<std::mutex> lock(s_cacheMutex);
+
+  std::erase_if(s_cache, [&cdbPath](const auto& pathAndEntry) {
+    return pathAndEntry.second.database.expired() && pathAndEntry.first != cdbPath.wstr();
+  });
+
+  CacheEntry& entry = s_cache[cdbPath.wstr()];
+  if(std::shared_ptr<const CxxCompilationDatabase> database = entry.database.lock();
+     database && entry.cdbSize == cdbSize && entry.cdbWriteTime == cdbWriteTime) {
+    return database;
+  }
+  entry = CacheEntry();
+
+  std::vector<clang::tooling::CompileCommand> commands;
+  if(!cacheFilePath.empty()) {
+    commands = readCacheFile(cacheFilePath, cdbPath, cdbSize, cdbWriteTime);
+  }
+
+  if(commands.empty()) {
+    std::string errorString;
+    const std::unique_ptr<clang::tooling::JSONCompilationDatabase> cdb = clang::tooling::JSONCompilationDatabase::loadFromFile(
+        utility::encodeToUtf8(cdbPath.wstr()), errorString, clang::tooling::JSONCommandLineSyntax::AutoDetect);
+
+    if((error != nullptr) && !errorString.empty()) {
+      *error = errorString;
+    }
+    if(!cdb) {
+      return {};
+    }
+
+    commands = cdb->getAllCompileCommands();
+    LOG_INFO(L"Parsed {} compile commands from \"{}\"", commands.size(), cdbPath.wstr());
+
+    if(!cacheFilePath.empty() && !commands.empty()) {
+      writeCacheFile(cacheFilePath, cdbPath, cdbSize, cdbWriteTime, commands);
+    }
+  }
+
+  auto database = std::make_shared<const CxxCompilationDatabase>(cdbPath, std::move(commands));
+  entry.cdbSize = cdbSize;
+  entry.cdbWriteTime = cdbWriteTime;
+  entry.database = database;
+  return database;
+}
+
+void CxxCompilationDatabase::clearCache() {
+  const std::lock_guard<std::mutex> lock(s_cacheMutex);
+  s_cache.clear();
+}
+
+CxxCompilationDatabase::CxxCompilationDatabase(const FilePath& cdbPath, std::vector<clang::tooling::CompileCommand> commands)
+    : m_commands(std::move(commands)) {
+  OrderedCache<FilePath, FilePath> canonicalDirectoryPathCache([](const FilePath& path) { return path.getCanonical(); });
+  std::set<FilePath> sourceFilePaths;
+
+  m_commandFilePaths.reserve(m_commands.size());
+  for(size_t i = 0; i < m_commands.size(); i++) {
+    const std::string fileName = getNativeFileName(m_commands[i]);
+    m_commandIndicesByFile[fileName].push_back(i);
+
+    FilePath path(utility::decodeFromUtf8(fileName));
+    if(!path.isAbsolute()) {
+      path = cdbPath.getParentDirectory().getConcatenated(path);
+    }
+    path = canonicalDirectoryPathCache.getValue(path.getParentDirectory()).concatenate(path.fileName());
+
+    if(sourceFilePaths.insert(path).second) {
+      m_sourceFilePaths.push_back(path);
+    }
+    m_commandFilePaths.push_back(std::move(path));
+  }
+}
+
+std::vector<clang::tooling::CompileCommand> CxxCompilationDatabase::getCompileCommands(llvm::StringRef FilePath) const {
+  llvm::SmallString<128> fileName;
+  llvm::sys::path::native(FilePath, fileName);
+
+  std::vector<clang::tooling::CompileCommand> commands;
+  if(const auto it = m_commandIndicesByFile.find(fileName.str().str()); it != m_commandIndicesByFile.end()) {
+    for(const size_t index : it->second) {
+      commands.push_back(m_commands[index]);
+    }
+  }
+  return commands;
+}
+
+std::vector<std::string> CxxCompilationDatabase::getAllFiles() const {
+  std::vector<std::string> files;
+  files.reserve(m_commandIndicesByFile.size());
+  for(const auto& [fileName, indices] : m_commandIndicesByFile) {
+    files.push_back(fileName);
+  }
+  return files;
+}
+
+std::vector<clang::tooling::CompileCommand> CxxCompilationDatabase::getAllCompileCommands() const {
+  return m_commands;
+}
+
+const std::vector<clang::tooling::CompileCommand>& CxxCompilationDatabase::getCommands() const {
+  return m_commands;
+}
+
+const std::vector<FilePath>& CxxCompilationDatabase::getCommandFilePaths() const {
+  return m_commandFilePaths;
+}
+
+const std::vector<FilePath>& CxxCompilationDatabase::getSourceFilePaths() const {
+  return m_sourceFilePaths;
+}
+
+std::vector<clang::tooling::CompileCommand> CxxCompilationDatabase::readCacheFile(const FilePath& cacheFilePath,
+                                                                                  const FilePath& cdbPath,
+                                                                                  uint64_t cdbSize,
+                                                                                  int64_t cdbWriteTime) {
+  uint64_t cacheFileSize = 0;
+  int64_t cacheFileWriteTime = 0;
+  if(!getFileState(cacheFilePath, cacheFileSize, cacheFileWriteTime)) {
+    return {};
+  }
+
+  CacheFileReader reader(std::filesystem::path(cacheFilePath.wstr()), cacheFileSize);
+
+  std::string magic;
+  uint64_t version = 0;
+  std::string path;
+  uint64_t size = 0;
+  uint64_t writeTime = 0;
+  uint64_t commandCount = 0;
+  if(!reader.read(magic) || magic != CacheFileMagic || !reader.read(version) || version != CacheFileVersion ||
+     !reader.read(path) || path != utility::encodeToUtf8(cdbPath.wstr()) || !reader.read(size) || size != cdbSize ||
+     !reader.read(writeTime) || static_cast<int64_t>(writeTime) != cdbWriteTime || !reader.read(commandCount)) {
+    return {};
+  }
+
+  std::vector<clang::tooling::CompileCommand> commands;
+  for(uint64_t i = 0; i < commandCount; i++) {
+    clang::tooling::CompileCommand command;
+    uint64_t argumentCount = 0;
+    if(!reader.read(command.Directory) || !reader.read(command.Filename) || !reader.read(command.Output) ||
+       !reader.read(argumentCount) || argumentCount > cacheFileSize) {
+      return {};
+    }
+
+    command.CommandLine.resize(argumentCount);
+    for(std::string& argument : command.CommandLine) {
+      if(!reader.read(argument)) {
+        return {};
+      }
+    }
+    commands.push_back(std::move(command));
+  }
+
+  if(!reader.isAtEnd()) {
+    return {};
+  }
+
+  LOG_INFO(L"Loaded {} compile commands of \"{}\" from \"{}\"", commands.size(), cdbPath.wstr(), cacheFilePath.wstr());
+  return commands;
+}
+
+void CxxCompilationDatabase::writeCacheFile(const FilePath& cacheFilePath,
+                                            const FilePath& cdbPath,
+                                            uint64_t cdbSize,
+                                            int64_t cdbWriteTime,
+                                            const std::vector<clang::tooling::CompileCommand>& commands) {
+  const std::filesystem::path path(cacheFilePath.wstr());
+  std::filesystem::path temporaryPath = path;
+  temporaryPath += ".tmp";
+
+  std::error_code errorCode;
+  std::filesystem::create_directories(path.parent_path(), errorCode);
+
+  // write to a temporary file first, so a concurrent or interrupted run never sees a partial cache file
+  CacheFileWriter writer(temporaryPath);
+  writer.write(CacheFileMagic);
+  writer.write(CacheFileVersion);
+  writer.write(utility::encodeToUtf8(cdbPath.wstr()));
+  writer.write(cdbSize);
+  writer.write(static_cast<uint64_t>(cdbWriteTime));
+  writer.write(static_cast<uint64_t>(commands.size()));
+  for(const clang::tooling::CompileCommand& command : commands) {
+    writer.write(command.Directory);
+    writer.write(command.Filename);
+    writer.write(command.Output);
+    writer.write(static_cast<uint64_t>(command.CommandLine.size()));
+    for(const std::string& argument : command.CommandLine) {
+      writer.write(argument);
+    }
+  }
+
+  bool written = writer.finish();
+  if(written) {
+    std::filesystem::rename(temporaryPath, path, errorCode);
+    written = !errorCode;
+  }
+  if(!written) {
+    LOG_WARNING(L"Cannot write the compilation database cache file \"{}\"", cacheFilePath.wstr());
+    std::filesystem::remove(temporaryPath, errorCode);
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <clang/Tooling/CompilationDatabase.h>
+
+#include "FilePath.h"
+
+/**
+ * @brief The compile commands of a JSON compilation database, parsed once and shared until the file changes.
+ *
+ * Loaded databases are cached per file and validated by the file size and last write time, so all users during a
+ * refresh share one parsed copy. The cache only refers to databases that are still in use, it does not keep them alive
+ * after the last user released them. The commands can also be persisted in a binary cache file, which lets the next
+ * load skip the JSON parsing while the database is unchanged.
+ *
+ * The canonical source file path of each command is computed once on load, canonicalizing each directory only once.
+ */
+class CxxCompilationDatabase final : public clang::tooling::CompilationDatabase {
+public:
+  /**
+   * @brief Returns the cached database or loads it from the cache file or the JSON file.
+   *
+   * @param cacheFilePath binary cache file to read and update, no cache file is used if empty
+   * @param error receives the error message if the JSON file cannot be parsed
+   */
+  static std::shared_ptr<const CxxCompilationDatabase> load(const FilePath& cdbPath,
+                                                            const FilePath& cacheFilePath = {},
+                                                            std::string* error = nullptr);
+
+  /**
+   * @brief Forgets all databases loaded in this process, cache files are kept.
+   */
+  static void clearCache();
+
+  CxxCompilationDatabase(const FilePath& cdbPath, std::vector<clang::tooling::CompileCommand> commands);
+
+  std::vector<clang::tooling::CompileCommand> getCompileCommands(llvm::StringRef FilePath) const override;
+  std::vector<std::string> getAllFiles() const override;
+  std::vector<clang::tooling::CompileCommand> getAllCompileCommands() const override;
+
+  /**
+   * @brief All compile commands without copying them.
+   */
+  [[nodiscard]] const std::vector<clang::tooling::CompileCommand>& getCommands() const;
+
+  /**
+   * @brief The canonical source file path of each command, in the order of getCommands.
+   */
+  [[nodiscard]] const std::vector<FilePath>& getCommandFilePaths() const;
+
+  /**
+   * @brief The canonical source file paths of all commands without duplicates.
+   */
+  [[nodiscard]] const std::vector<FilePath>& getSourceFilePaths() const;
+
+private:
+  static std::vector<clang::tooling::CompileCommand> readCacheFile(const FilePath& cacheFilePath,
+                                                                   const FilePath& cdbPath,
+                                                                   uint64_t cdbSize,
+                                                                   int64_t cdbWriteTime);
+  static void writeCacheFile(const FilePath& cacheFilePath,
+                             const FilePath& cdbPath,
+                             uint64_t cdbSize,
+                             int64_t cdbWriteTime,
+                             const std::vector<clang::tooling::CompileCommand>& commands);
+
+  std::vector<clang::tooling::CompileCommand> m_commands;
+  std::vector<FilePath> m_commandFilePaths;
+  std::vector<FilePath> m_sourceFilePaths;
+  std::unordered_map<std::string, std::vector<size_t>> m_commandIndicesByFile;    ///< native absolute file name to commands
+};
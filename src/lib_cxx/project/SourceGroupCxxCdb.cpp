@@ -3,12 +3,12 @@
 #include <range/v3/range/conversion.hpp>
 #include <range/v3/view/transform.hpp>
 
-#include <clang/Tooling/JSONCompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
 #include "../../scheduling/TaskLambda.h"
 #include "Application.h"
 #include "ClangInvocationInfo.h"
+#include "CxxCompilationDatabase.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxIndexerCommandProvider.h"
 #include "IApplicationSettings.hpp"
@@ -32,9 +32,15 @@ bool SourceGroupCxxCdb::prepareIndexing() {
     Application::getInstance()->handleDialog(error, {L"Ok"});
     return false;
   }
+
+  m_preparedCdb = loadCDB();
   return true;
 }
 
+void SourceGroupCxxCdb::finishPreparingIndexing() {
+  m_preparedCdb.reset();
+}
+
 std::set<FilePath> SourceGroupCxxCdb::filterToContainedFilePaths(const std::set<FilePath>& filePaths) const {
   return SourceGroup::filterToContainedFilePaths(filePaths,
                                                  getAllSourceFilePaths(),
@@ -43,16 +49,15 @@ std::set<FilePath> SourceGroupCxxCdb::filterToContainedFilePaths(const std::set<
 }
 
 std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths() const {
-  return getAllSourceFilePaths(utility::loadCDB(m_settings->getCompilationDatabasePathExpandedAndAbsolute()));
+  return getAllSourceFilePaths(loadCDB());
 }
 
-std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const {
+std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(const std::shared_ptr<const CxxCompilationDatabase>& cdb) const {
   std::set<FilePath> sourceFilePaths;
 
   if(cdb) {
     const std::vector<FilePathFilter> excludeFilters = m_settings->getExcludeFiltersExpandedAndAbsolute();
-    for(const FilePath& path :
-        IndexerCommandCxx::getSourceFilesFromCDB(cdb, m_settings->getCompilationDatabasePathExpandedAndAbsolute())) {
+    for(const FilePath& path : cdb->getSourceFilePaths()) {
       bool excluded = FilePathFilter::areMatching(excludeFilters, path);
       if(!excluded && path.exists()) {
         sourceFilePaths.insert(path);
@@ -66,8 +71,7 @@ std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(std::shared_ptr<clan
 std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProvider(const RefreshInfo& info) const {
   std::shared_ptr<CxxIndexerCommandProvider> provider = std::make_shared<CxxIndexerCommandProvider>();
 
-  const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-  std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = loadCDB();
   if(!cdb) {
     return provider;
   }
@@ -81,14 +85,9 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
   const std::set<FilePathFilter> excludeFilters = utility::toSet(m_settings->getExcludeFiltersExpandedAndAbsolute());
   const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
 
-  for(const clang::tooling::CompileCommand& command : cdb->getAllCompileCommands()) {
-    FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-    if(!sourcePath.isAbsolute()) {
-      sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename)).makeCanonical();
-      if(!sourcePath.isAbsolute()) {
-        sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-      }
-    }
+  for(size_t i = 0; i < cdb->getCommands().size(); i++) {
+    const clang::tooling::CompileCommand& command = cdb->getCommands()[i];
+    const FilePath& sourcePath = cdb->getCommandFilePaths()[i];
 
     if(info.filesToIndex.find(sourcePath) != info.filesToIndex.end() && sourceFilePaths.find(sourcePath) != sourceFilePaths.end()) {
       std::vector<std::wstring> cdbFlags = utility::convert<std::string, std::wstring>(
@@ -127,18 +126,12 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(std::shared_ptr<Storage
   std::vector<std::wstring> compilerFlags;
 
   if(m_settings->getUseCompilerFlags()) {
-    const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-    std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+    const std::shared_ptr<const CxxCompilationDatabase> cdb = loadCDB();
     if(cdb) {
       const std::set<FilePath> sourceFilePaths = getAllSourceFilePaths(cdb);
-      for(const clang::tooling::CompileCommand& command : cdb->getAllCompileCommands()) {
-        FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-        if(!sourcePath.isAbsolute()) {
-          sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename)).makeCanonical();
-          if(!sourcePath.isAbsolute()) {
-            sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-          }
-        }
+      for(size_t i = 0; i < cdb->getCommands().size(); i++) {
+        const clang::tooling::CompileCommand& command = cdb->getCommands()[i];
+        const FilePath& sourcePath = cdb->getCommandFilePaths()[i];
 
         if(sourceFilePaths.find(sourcePath) != sourceFilePaths.end() && utility::containsIncludePchFlag(command.CommandLine)) {
           for(const std::string& arg : command.CommandLine) {
@@ -197,3 +190,9 @@ std::vector<std::wstring> SourceGroupCxxCdb::getBaseCompilerFlags() const {
 
   return compilerFlags;
 }
+
+std::shared_ptr<const CxxCompilationDatabase> SourceGroupCxxCdb::loadCDB() const {
+  // the parsed commands are kept next to the project, so the next run can skip parsing an unchanged database
+  const FilePath cacheFilePath = m_settings->getSourceGroupDependenciesDirectoryPath().concatenate(L"compile_commands.cache");
+  return CxxCompilationDatabase::load(m_settings->getCompilationDatabasePathExpandedAndAbsolute(), cacheFilePath);
+}
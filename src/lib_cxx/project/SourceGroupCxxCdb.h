@@ -7,11 +7,8 @@
 
 #include "SourceGroup.h"
 
+class CxxCompilationDatabase;
 class FilePath;
-namespace clang { namespace tooling {
-class JSONCompilationDatabase;
-}}    // namespace clang::tooling
-
 class SourceGroupSettingsCxxCdb;
 
 class SourceGroupCxxCdb : public SourceGroup {
@@ -19,9 +16,10 @@ public:
   SourceGroupCxxCdb(std::shared_ptr<SourceGroupSettingsCxxCdb> settings);
 
   bool prepareIndexing() override;
+  void finishPreparingIndexing() override;
   std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override;
   std::set<FilePath> getAllSourceFilePaths() const override;
-  std::set<FilePath> getAllSourceFilePaths(std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const;
+  std::set<FilePath> getAllSourceFilePaths(const std::shared_ptr<const CxxCompilationDatabase>& cdb) const;
   std::shared_ptr<IndexerCommandProvider> getIndexerCommandProvider(const RefreshInfo& info) const override;
   std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override;
   std::shared_ptr<Task> getPreIndexTask(std::shared_ptr<StorageProvider> storageProvider,
@@ -31,8 +29,11 @@ private:
   std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override;
   std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override;
   std::vector<std::wstring> getBaseCompilerFlags() const;
+  std::shared_ptr<const CxxCompilationDatabase> loadCDB() const;
 
   std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
+  // keeps the database cached from prepareIndexing until the index tasks are created, so it is only loaded once per refresh
+  std::shared_ptr<const CxxCompilationDatabase> m_preparedCdb;
 };
 
 #endif    // SOURCE_GROUP_CXX_CDB_H
@@ -2,9 +2,10 @@
 
 #include <ranges>
 
-#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <clang/Tooling/Tooling.h>
 
 #include "CanonicalFilePathCache.h"
+#include "CxxCompilationDatabase.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxDiagnosticConsumer.h"
 #include "CxxParser.h"
@@ -90,25 +91,12 @@ std::shared_ptr<Task> createBuildPchTask(const SourceGroupSettingsWithCxxPchOpti
   });
 }
 
-std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(const FilePath& cdbPath, std::string* error) {
-  if(cdbPath.empty() || !cdbPath.exists()) {
-    return {};
-  }
-
-  std::string errorString;
-  std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = std::shared_ptr<clang::tooling::JSONCompilationDatabase>(
-      clang::tooling::JSONCompilationDatabase::loadFromFile(
-          utility::encodeToUtf8(cdbPath.wstr()), errorString, clang::tooling::JSONCommandLineSyntax::AutoDetect));
-
-  if((error != nullptr) && !errorString.empty()) {
-    *error = errorString;
-  }
-
-  return cdb;
+std::shared_ptr<const CxxCompilationDatabase> loadCDB(const FilePath& cdbPath, std::string* error) {
+  return CxxCompilationDatabase::load(cdbPath, {}, error);
 }
 
-bool containsIncludePchFlags(const std::shared_ptr<clang::tooling::JSONCompilationDatabase>& cdb) {
-  for(const clang::tooling::CompileCommand& command : cdb->getAllCompileCommands()) {
+bool containsIncludePchFlags(const std::shared_ptr<const CxxCompilationDatabase>& cdb) {
+  for(const clang::tooling::CompileCommand& command : cdb->getCommands()) {
     if(containsIncludePchFlag(command.CommandLine)) {
       return true;
     }
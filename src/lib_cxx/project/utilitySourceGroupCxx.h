@@ -3,10 +3,7 @@
 #include <string>
 #include <vector>
 
-namespace clang::tooling {
-class JSONCompilationDatabase;
-}    // namespace clang::tooling
-
+class CxxCompilationDatabase;
 class DialogView;
 class FilePath;
 class SourceGroupSettingsWithCxxPchOptions;
@@ -19,8 +16,8 @@ std::shared_ptr<Task> createBuildPchTask(const SourceGroupSettingsWithCxxPchOpti
                                          const std::shared_ptr<StorageProvider>& storageProvider,
                                          const std::shared_ptr<DialogView>& dialogView);
 
-std::shared_ptr<clang::tooling::JSONCompilationDatabase> loadCDB(const FilePath& cdbPath, std::string* error = nullptr);
-bool containsIncludePchFlags(const std::shared_ptr<clang::tooling::JSONCompilationDatabase>& cdb);
+std::shared_ptr<const CxxCompilationDatabase> loadCDB(const FilePath& cdbPath, std::string* error = nullptr);
+bool containsIncludePchFlags(const std::shared_ptr<const CxxCompilationDatabase>& cdb);
 bool containsIncludePchFlag(const std::vector<std::string>& args);
 std::vector<std::wstring> getWithRemoveIncludePchFlag(const std::vector<std::wstring>& args);
 void removeIncludePchFlag(std::vector<std::wstring>& args);
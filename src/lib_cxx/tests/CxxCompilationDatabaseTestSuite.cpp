@@ -0,0 +1,161 @@
+#include <filesystem>
+#include <fstream>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "CxxCompilationDatabase.h"
+
+using namespace testing;
+
+namespace {
+namespace fs = std::filesystem;
+
+struct CxxCompilationDatabaseFix : Test {
+  void SetUp() override {
+    CxxCompilationDatabase::clearCache();
+
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+    fs::create_directories(mRoot / "src", errorCode);
+    std::ofstream(mRoot / "src" / "main.cpp") << "int main() {}\n";
+    std::ofstream(mRoot / "src" / "util.cpp") << "int util() {}\n";
+    writeDatabase(getCommands(L"-DVERSION=1"));
+  }
+
+  void TearDown() override {
+    CxxCompilationDatabase::clearCache();
+
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+  }
+
+  // one command with a file name relative to its directory and one with an absolute file name
+  std::string getCommands(const std::wstring& define) const {
+    const std::string root = mRoot.generic_string();
+    const std::string flag(define.begin(), define.end());
+    return "[{\"directory\": \"" + root + "/src\", \"file\": \"main.cpp\", \"arguments\": [\"clang\", \"" + flag +
+        "\", \"-c\", \"main.cpp\"]},\n {\"directory\": \"" + root + "\", \"file\": \"" + root +
+        "/src/util.cpp\", \"command\": \"clang -Iinclude -c src/util.cpp\"}]\n";
+  }
+
+  void writeDatabase(const std::string& text) const {
+    std::ofstream(mDatabasePath, std::ios::trunc) << text;
+  }
+
+  [[nodiscard]] FilePath getDatabasePath() const {
+    return FilePath(mDatabasePath.wstring());
+  }
+
+  [[nodiscard]] FilePath getCacheFilePath() const {
+    return FilePath((mRoot / "cache" / "compile_commands.cache").wstring());
+  }
+
+  [[nodiscard]] FilePath getSourceFilePath(const std::wstring& fileName) const {
+    return FilePath((mRoot / "src").wstring()).concatenate(fileName);
+  }
+
+  const fs::path mRoot = fs::weakly_canonical(fs::temp_directory_path()) / "CxxCompilationDatabaseTestSuite";
+  const fs::path mDatabasePath = mRoot / "compile_commands.json";
+};
+}    // namespace
+
+TEST_F(CxxCompilationDatabaseFix, missingDatabaseIsNotLoaded) {
+  EXPECT_THAT(CxxCompilationDatabase::load(FilePath{}), IsNull());
+  EXPECT_THAT(CxxCompilationDatabase::load(FilePath(L"path/not/exists/compile_commands.json")), IsNull());
+}
+
+TEST_F(CxxCompilationDatabaseFix, invalidDatabaseReportsError) {
+  writeDatabase("[{}]");
+
+  std::string error;
+  EXPECT_THAT(CxxCompilationDatabase::load(getDatabasePath(), {}, &error), IsNull());
+  EXPECT_THAT(error, Not(IsEmpty()));
+}
+
+TEST_F(CxxCompilationDatabaseFix, commandsHaveCanonicalSourceFilePaths) {
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath());
+  ASSERT_THAT(cdb, NotNull());
+
+  ASSERT_THAT(cdb->getCommands(), SizeIs(2));
+  EXPECT_THAT(cdb->getCommandFilePaths(), ElementsAre(getSourceFilePath(L"main.cpp"), getSourceFilePath(L"util.cpp")));
+  EXPECT_THAT(cdb->getSourceFilePaths(), ElementsAre(getSourceFilePath(L"main.cpp"), getSourceFilePath(L"util.cpp")));
+  EXPECT_THAT(cdb->getAllFiles(), SizeIs(2));
+
+  const std::vector<clang::tooling::CompileCommand> commands = cdb->getCompileCommands(
+      getSourceFilePath(L"main.cpp").str());
+  ASSERT_THAT(commands, SizeIs(1));
+  EXPECT_THAT(commands.front().CommandLine, Contains("-DVERSION=1"));
+}
+
+TEST_F(CxxCompilationDatabaseFix, unchangedDatabaseIsShared) {
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath());
+
+  EXPECT_THAT(cdb, NotNull());
+  EXPECT_EQ(cdb, CxxCompilationDatabase::load(getDatabasePath()));
+}
+
+TEST_F(CxxCompilationDatabaseFix, releasedDatabaseIsNotKeptAlive) {
+  std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath());
+  const std::weak_ptr<const CxxCompilationDatabase> weakCdb = cdb;
+  cdb.reset();
+
+  EXPECT_TRUE(weakCdb.expired());
+  EXPECT_THAT(CxxCompilationDatabase::load(getDatabasePath()), NotNull());
+}
+
+TEST_F(CxxCompilationDatabaseFix, changedDatabaseIsReloaded) {
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath());
+
+  writeDatabase(getCommands(L"-DVERSION=12"));
+  const std::shared_ptr<const CxxCompilationDatabase> changedCdb = CxxCompilationDatabase::load(getDatabasePath());
+
+  ASSERT_THAT(changedCdb, NotNull());
+  EXPECT_NE(cdb, changedCdb);
+  EXPECT_THAT(changedCdb->getCommands().front().CommandLine, Contains("-DVERSION=12"));
+}
+
+TEST_F(CxxCompilationDatabaseFix, cacheFileReplacesParsingOfUnchangedDatabase) {
+  std::ignore = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+  CxxCompilationDatabase::clearCache();
+  ASSERT_TRUE(getCacheFilePath().exists());
+
+  // a database that cannot be parsed but has the same size and write time is only read from the cache file
+  const fs::file_time_type writeTime = fs::last_write_time(mDatabasePath);
+  writeDatabase(std::string(fs::file_size(mDatabasePath), ' '));
+  fs::last_write_time(mDatabasePath, writeTime);
+
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+
+  ASSERT_THAT(cdb, NotNull());
+  EXPECT_THAT(cdb->getCommandFilePaths(), ElementsAre(getSourceFilePath(L"main.cpp"), getSourceFilePath(L"util.cpp")));
+  EXPECT_THAT(cdb->getCommands().front().CommandLine, ElementsAre("clang", "-DVERSION=1", "-c", "main.cpp"));
+  EXPECT_EQ(cdb->getCommands().back().Directory, mRoot.generic_string());
+}
+
+TEST_F(CxxCompilationDatabaseFix, cacheFileOfChangedDatabaseIsReplaced) {
+  std::ignore = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+  CxxCompilationDatabase::clearCache();
+
+  writeDatabase(getCommands(L"-DVERSION=12"));
+  std::ignore = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+  CxxCompilationDatabase::clearCache();
+
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+
+  ASSERT_THAT(cdb, NotNull());
+  EXPECT_THAT(cdb->getCommands().front().CommandLine, Contains("-DVERSION=12"));
+}
+
+TEST_F(CxxCompilationDatabaseFix, corruptCacheFileIsIgnored) {
+  std::ignore = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+  CxxCompilationDatabase::clearCache();
+
+  const fs::path cacheFilePath(getCacheFilePath().wstr());
+  fs::resize_file(cacheFilePath, fs::file_size(cacheFilePath) - 3);
+
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(getDatabasePath(), getCacheFilePath());
+
+  ASSERT_THAT(cdb, NotNull());
+  EXPECT_THAT(cdb->getCommands(), SizeIs(2));
+}
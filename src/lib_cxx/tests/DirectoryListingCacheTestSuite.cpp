@@ -0,0 +1,71 @@
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "DirectoryListingCache.h"
+
+using namespace testing;
+
+namespace {
+namespace fs = std::filesystem;
+
+struct DirectoryListingCacheFix : Test {
+  void SetUp() override {
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+    fs::create_directories(mRoot / "include", errorCode);
+    std::ofstream(mRoot / "include" / "a.h") << "// a\n";
+  }
+
+  void TearDown() override {
+    std::error_code errorCode;
+    fs::remove_all(mRoot, errorCode);
+  }
+
+  [[nodiscard]] FilePath getPath(const fs::path& relativePath) const {
+    return FilePath((mRoot / relativePath).wstring());
+  }
+
+  const fs::path mRoot = fs::weakly_canonical(fs::temp_directory_path()) / "DirectoryListingCacheTestSuite";
+  DirectoryListingCache mCache;
+};
+}    // namespace
+
+TEST_F(DirectoryListingCacheFix, listedFilesAndDirectoriesExist) {
+  EXPECT_TRUE(mCache.exists(getPath("include/a.h")));
+  EXPECT_TRUE(mCache.exists(getPath("include")));
+}
+
+TEST_F(DirectoryListingCacheFix, unlistedFilesDoNotExist) {
+  EXPECT_FALSE(mCache.exists(getPath("include/b.h")));
+  EXPECT_FALSE(mCache.exists(getPath("missing/a.h")));
+  EXPECT_FALSE(mCache.exists(getPath("include/a.h/b.h")));
+}
+
+TEST_F(DirectoryListingCacheFix, listingIsNotUpdated) {
+  ASSERT_FALSE(mCache.exists(getPath("include/b.h")));
+
+  std::ofstream(mRoot / "include" / "b.h") << "// b\n";
+
+  EXPECT_FALSE(mCache.exists(getPath("include/b.h")));
+  EXPECT_TRUE(DirectoryListingCache().exists(getPath("include/b.h")));
+}
+
+TEST_F(DirectoryListingCacheFix, relativePathComponentsAreResolved) {
+  EXPECT_TRUE(mCache.exists(getPath("include/../include/a.h")));
+  EXPECT_TRUE(mCache.exists(getPath("include/.")));
+  EXPECT_FALSE(mCache.exists(getPath("missing/../include/a.h")));
+}
+
+TEST_F(DirectoryListingCacheFix, symlinksAreFollowed) {
+  std::error_code errorCode;
+  fs::create_symlink(mRoot / "include" / "a.h", mRoot / "include" / "link.h", errorCode);
+  fs::create_symlink(mRoot / "include" / "missing.h", mRoot / "include" / "dangling.h", errorCode);
+  if(errorCode) {
+    GTEST_SKIP() << "Cannot create symlinks: " << errorCode.message();
+  }
+
+  EXPECT_TRUE(mCache.exists(getPath("include/link.h")));
+  EXPECT_FALSE(mCache.exists(getPath("include/dangling.h")));
+}
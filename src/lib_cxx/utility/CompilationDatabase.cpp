@@ -6,9 +6,7 @@
 
 #include <fmt/format.h>
 
-#include <clang/Tooling/CompilationDatabase.h>
-#include <clang/Tooling/JSONCompilationDatabase.h>
-
+#include "CxxCompilationDatabase.h"
 #include "FilePath.h"
 #include "logging.h"
 #include "utility.h"
@@ -48,8 +46,7 @@ void utility::CompilationDatabase::init() {
   }
 
   std::string error;
-  const std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb(clang::tooling::JSONCompilationDatabase::loadFromFile(
-      utility::encodeToUtf8(mFilePath.wstr()), error, clang::tooling::JSONCommandLineSyntax::AutoDetect));
+  const std::shared_ptr<const CxxCompilationDatabase> cdb = CxxCompilationDatabase::load(mFilePath, {}, &error);
 
   if(!cdb) {
     LOG_ERROR(L"Loading compilation database from file \"" + mFilePath.wstr() + L"\" failed with error: " +
@@ -57,7 +54,6 @@ void utility::CompilationDatabase::init() {
     return;
   }
 
-  std::vector<clang::tooling::CompileCommand> commands = cdb->getAllCompileCommands();
   std::set<FilePath> frameworkHeaders;
   std::set<FilePath> systemHeaders;
   std::set<FilePath> headers;
@@ -67,7 +63,7 @@ void utility::CompilationDatabase::init() {
     const std::wstring systemIncludeFlag = L"-isystem";
     const std::wstring quoteFlag = L"-iquote";
     const std::wstring includeFlag = L"-I";
-    for(auto& command : commands) {
+    for(const clang::tooling::CompileCommand& command : cdb->getCommands()) {
       const std::wstring commandDirectory = utility::decodeFromUtf8(command.Directory);
       for(size_t i = 0; i < command.CommandLine.size(); i++) {
         std::wstring argument = utility::decodeFromUtf8(command.CommandLine[i]);
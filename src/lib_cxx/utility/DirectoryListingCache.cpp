@@ -0,0 +1,94 @@
+#include "DirectoryListingCache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+#if defined(_WIN32) || defined(__APPLE__)
+std::wstring toLowerCaseAscii(std::wstring name) {
+  std::ranges::transform(name, name.begin(), [](wchar_t c) { return (c >= L'A' && c <= L'Z') ? c - L'A' + L'a' : c; });
+  return name;
+}
+
+// the file system may match these names to entries spelled differently, e.g. by 8.3 short names, trailing dots or
+// unicode normalization
+bool hasAmbiguousSpelling(const std::wstring& name) {
+  return name.back() == L'.' || name.back() == L' ' ||
+      std::ranges::any_of(name, [](wchar_t c) { return c > 127 || c == L'~' || c == L':'; });
+}
+#endif
+}    // namespace
+
+bool DirectoryListingCache::exists(const FilePath& filePath) {
+  const std::wstring fileName = filePath.fileName();
+  if(fileName.empty() || fileName == L"." || fileName == L".." || fileName.find_first_of(L"/\\") != std::wstring::npos) {
+    return filePath.exists();
+  }
+
+  std::wstring directoryPath = filePath.getParentDirectory().wstr();
+  if(directoryPath.empty()) {
+    directoryPath = L".";
+  }
+
+  const std::shared_ptr<const Listing> listing = getListing(directoryPath);
+  if(!listing->complete || listing->uncertainNames.contains(fileName)) {
+    return filePath.exists();
+  }
+  if(listing->names.contains(fileName)) {
+    return true;
+  }
+#if defined(_WIN32) || defined(__APPLE__)
+  if(hasAmbiguousSpelling(fileName) || listing->lowerCaseNames.contains(toLowerCaseAscii(fileName))) {
+    return filePath.exists();
+  }
+#endif
+  return false;
+}
+
+std::shared_ptr<const DirectoryListingCache::Listing> DirectoryListingCache::createListing(const std::wstring& directoryPath) {
+  auto listing = std::make_shared<Listing>();
+
+  std::error_code errorCode;
+  std::filesystem::directory_iterator iterator(std::filesystem::path(directoryPath), errorCode);
+  if(errorCode) {
+    // nothing exists below a missing directory, other errors like missing read permissions still allow a stat call
+    listing->complete = errorCode == std::errc::no_such_file_or_directory || errorCode == std::errc::not_a_directory;
+    return listing;
+  }
+
+  for(; !errorCode && iterator != std::filesystem::directory_iterator(); iterator.increment(errorCode)) {
+    std::wstring name = iterator->path().filename().wstring();
+
+    std::error_code statusErrorCode;
+    const std::filesystem::file_status status = iterator->symlink_status(statusErrorCode);
+#if defined(_WIN32) || defined(__APPLE__)
+    listing->lowerCaseNames.insert(toLowerCaseAscii(name));
+#endif
+    if(statusErrorCode || std::filesystem::is_symlink(status) || status.type() == std::filesystem::file_type::unknown) {
+      listing->uncertainNames.insert(std::move(name));
+    } else {
+      listing->names.insert(std::move(name));
+    }
+  }
+
+  if(errorCode) {
+    listing->complete = false;
+  }
+  return listing;
+}
+
+std::shared_ptr<const DirectoryListingCache::Listing> DirectoryListingCache::getListing(const std::wstring& directoryPath) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if(const auto it = m_listings.find(directoryPath); it != m_listings.end()) {
+      return it->second;
+    }
+  }
+
+  // list outside of the lock, another thread listing the same directory meanwhile gets the same result
+  std::shared_ptr<const Listing> listing = createListing(directoryPath);
+
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_listings.emplace(directoryPath, std::move(listing)).first->second;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "FilePath.h"
+
+/**
+ * @brief Answers whether paths exist from cached directory listings instead of one stat call per path.
+ *
+ * Each directory is listed once. Names a listing cannot answer exactly, like symlinks that may be dangling, fall back to
+ * FilePath::exists. All functions can be called from multiple threads.
+ */
+class DirectoryListingCache final {
+public:
+  [[nodiscard]] bool exists(const FilePath& filePath);
+
+private:
+  struct Listing final {
+    bool complete = true;                              ///< false if the directory could not be listed
+    std::unordered_set<std::wstring> names;            ///< files and directories
+    std::unordered_set<std::wstring> uncertainNames;    ///< symlinks and entries of unknown type
+#if defined(_WIN32) || defined(__APPLE__)
+    std::unordered_set<std::wstring> lowerCaseNames;    ///< case insensitive file systems match these
+#endif
+  };
+
+  static std::shared_ptr<const Listing> createListing(const std::wstring& directoryPath);
+
+  std::shared_ptr<const Listing> getListing(const std::wstring& directoryPath);
+
+  std::mutex m_mutex;
+  std::unordered_map<std::wstring, std::shared_ptr<const Listing>> m_listings;
+};
@@ -1,10 +1,15 @@
 #include "IncludeProcessing.h"
 
+#include <cctype>
 #include <iterator>
+#include <mutex>
 #include <set>
+#include <string_view>
 
+#include <unordered_map>
 #include <unordered_set>
 
+#include "DirectoryListingCache.h"
 #include "FilePath.h"
 #include "FileTree.h"
 #include "IApplicationSettings.hpp"
@@ -12,21 +17,83 @@
 #include "TextAccess.h"
 #include "TextCodec.h"
 #include "utility.h"
+#include "utilityApp.h"
 #include "utilityString.h"
 
 namespace {
+constexpr size_t MinFilesPerThread = 8;
+
 struct IncludeDirectiveComparator {
   bool operator()(const IncludeDirective& a, const IncludeDirective& b) const {
     return a.getIncludedFile() < b.getIncludedFile();
   }
 };
+
+// In these encodings every line decodes on its own, ASCII bytes decode to themselves and no other byte decodes to ASCII.
+bool decodesAsciiBytesUnchanged(const std::string& textEncoding) {
+  const std::string name = utility::toLowerCase(textEncoding);
+  return name == "utf-8" || name.starts_with("iso-8859-") || name.starts_with("windows-125");
+}
+
+bool isAsciiSpace(char c) {
+  return static_cast<unsigned char>(c) < 0x80 && std::isspace(static_cast<unsigned char>(c));
+}
+
+// Byte level check whether a line can hold an include directive, so most lines do not need to be decoded. It only
+// rejects lines that start with other ASCII characters and accepts everything else, like leading non-ASCII bytes.
+bool mayContainIncludeDirective(std::string_view line) {
+  size_t pos = 0;
+  const auto skipSpaces = [&line, &pos]() {
+    while(pos < line.size() && isAsciiSpace(line[pos])) {
+      pos++;
+    }
+  };
+
+  skipSpaces();
+  if(pos < line.size() && static_cast<unsigned char>(line[pos]) >= 0x80) {
+    return true;
+  }
+  if(pos == line.size() || line[pos] != '#') {
+    return false;
+  }
+
+  pos++;
+  skipSpaces();
+  if(pos < line.size() && static_cast<unsigned char>(line[pos]) >= 0x80) {
+    return true;
+  }
+  return line.substr(pos).starts_with("include");
+}
 }    // namespace
 
+struct IncludeProcessing::FileSystemCache {
+  FilePath getCanonical(const FilePath& filePath) {
+    {
+      const std::lock_guard<std::mutex> lock(mutex);
+      if(const auto it = canonicalPaths.find(filePath.wstr()); it != canonicalPaths.end()) {
+        return it->second;
+      }
+    }
+
+    FilePath canonicalPath = filePath.getCanonical();
+
+    const std::lock_guard<std::mutex> lock(mutex);
+    return canonicalPaths.emplace(filePath.wstr(), std::move(canonicalPath)).first->second;
+  }
+
+  DirectoryListingCache directoryListings;
+  std::mutex mutex;
+  std::unordered_map<std::wstring, FilePath> canonicalPaths;
+};
+
 std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(const std::set<FilePath>& sourceFilePaths,
                                                                                 const std::set<FilePath>& indexedPaths,
                                                                                 const std::set<FilePath>& headerSearchDirectories,
                                                                                 const size_t desiredQuantileCount,
                                                                                 std::function<void(float)> progress) {
+  const std::string textEncoding = IApplicationSettings::getInstanceRaw()->getTextEncoding();
+  FileSystemCache fileSystemCache;
+
   std::unordered_set<std::wstring> processedFilePaths;
   std::set<IncludeDirective, IncludeDirectiveComparator> unresolvedIncludeDirectives;
 
@@ -37,7 +104,7 @@ std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
     progress(float(i) / static_cast<float>(parts.size()));
 
     const std::vector<IncludeDirective> directives = doGetUnresolvedIncludeDirectives(
-        utility::toSet(parts[i]), processedFilePaths, indexedPaths, headerSearchDirectories);
+        utility::toSet(parts[i]), processedFilePaths, indexedPaths, headerSearchDirectories, textEncoding, fileSystemCache);
     std::copy(directives.begin(), directives.end(), std::inserter(unresolvedIncludeDirectives, unresolvedIncludeDirectives.end()));
   }
 
@@ -59,6 +126,9 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(const std::set<
                                                                  std::function<void(float)> progress) {
   progress(0.0f);
 
+  const std::string textEncoding = IApplicationSettings::getInstanceRaw()->getTextEncoding();
+  FileSystemCache fileSystemCache;
+
   std::vector<std::shared_ptr<FileTree>> existingFileTrees;
   for(const FilePath& searchedPath : searchedPaths) {
     existingFileTrees.push_back(std::make_shared<FileTree>(searchedPath));
@@ -80,31 +150,53 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(const std::set<
                      std::inserter(processedFilePaths, processedFilePaths.begin()),
                      [](const FilePath& p) { return p.getAbsolute().wstr(); });
 
-      std::set<FilePath> unprocessedFilePathsForNextIteration;
+      // the files of one iteration are processed in parallel, each of them only depends on the state before the iteration
+      struct IncludedFile {
+        FilePath canonicalPath;           // empty if the included file was not found
+        FilePath headerSearchDirectory;    // empty if the file was found without a new header search directory
+      };
+      const std::vector<FilePath> filePaths(unprocessedFilePaths.begin(), unprocessedFilePaths.end());
+      std::vector<std::vector<IncludedFile>> includedFiles(filePaths.size());
 
-      for(const FilePath& unprocessedFilePath : unprocessedFilePaths) {
-        for(const IncludeDirective& includeDirective : getIncludeDirectives(unprocessedFilePath)) {
+      utility::forEachIndexParallel(filePaths.size(), MinFilesPerThread, [&](size_t index) {
+        for(const IncludeDirective& includeDirective : getIncludeDirectives(filePaths[index], textEncoding)) {
           const FilePath includedFilePath = includeDirective.getIncludedFile();
 
-          FilePath foundIncludedPath = resolveIncludeDirective(includeDirective, currentHeaderSearchDirectories);
-          if(foundIncludedPath.empty()) {
-            for(std::shared_ptr<FileTree> existingFileTree : existingFileTrees) {
+          IncludedFile includedFile;
+          FilePath foundIncludedPath = resolveIncludeDirective(
+              includeDirective, currentHeaderSearchDirectories, fileSystemCache.directoryListings);
+          bool found = !foundIncludedPath.empty();
+          if(!found) {
+            for(const std::shared_ptr<FileTree>& existingFileTree : existingFileTrees) {
               // TODO: handle the case where a file can be found by two different paths
               const FilePath rootPath = existingFileTree->getAbsoluteRootPathForRelativeFilePath(includedFilePath);
               if(!rootPath.empty()) {
                 foundIncludedPath = rootPath.getConcatenated(includedFilePath);
-                if(foundIncludedPath.exists()) {
-                  headerSearchDirectories.insert(rootPath);
+                if(fileSystemCache.directoryListings.exists(foundIncludedPath)) {
+                  includedFile.headerSearchDirectory = rootPath;
+                  found = true;
                   break;
                 }
               }
             }
           }
-          if(foundIncludedPath.exists()) {
-            foundIncludedPath.makeCanonical();
-            if(processedFilePaths.find(foundIncludedPath.wstr()) == processedFilePaths.end()) {
-              unprocessedFilePathsForNextIteration.insert(foundIncludedPath);
-            }
+          if(found) {
+            includedFile.canonicalPath = fileSystemCache.getCanonical(foundIncludedPath);
+          }
+          includedFiles[index].push_back(std::move(includedFile));
+        }
+      });
+
+      std::set<FilePath> unprocessedFilePathsForNextIteration;
+
+      for(const std::vector<IncludedFile>& includedFilesOfFile : includedFiles) {
+        for(const IncludedFile& includedFile : includedFilesOfFile) {
+          if(!includedFile.headerSearchDirectory.empty()) {
+            headerSearchDirectories.insert(includedFile.headerSearchDirectory);
+          }
+          if(!includedFile.canonicalPath.empty() &&
+             processedFilePaths.find(includedFile.canonicalPath.wstr()) == processedFilePaths.end()) {
+            unprocessedFilePathsForNextIteration.insert(includedFile.canonicalPath);
           }
         }
       }
@@ -119,18 +211,34 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(const std::set<
 }
 
 std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(const FilePath& filePath) {
+  return getIncludeDirectives(filePath, IApplicationSettings::getInstanceRaw()->getTextEncoding());
+}
+
+std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(std::shared_ptr<TextAccess> textAccess) {
+  return getIncludeDirectives(*textAccess, IApplicationSettings::getInstanceRaw()->getTextEncoding());
+}
+
+std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(const FilePath& filePath, const std::string& textEncoding) {
   if(filePath.exists()) {
-    return getIncludeDirectives(TextAccess::createFromFile(filePath));
+    return getIncludeDirectives(*TextAccess::createFromFile(filePath), textEncoding);
   }
   return std::vector<IncludeDirective>();
 }
 
-std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(std::shared_ptr<TextAccess> textAccess) {
+std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(const TextAccess& textAccess,
+                                                                    const std::string& textEncoding) {
   std::vector<IncludeDirective> includeDirectives;
 
-  TextCodec codec(IApplicationSettings::getInstanceRaw()->getTextEncoding());
-  const std::vector<std::string> lines = textAccess->getAllLines();
+  // the first line is always decoded, the decoder drops a byte order mark only at the start of the text
+  const bool scanBytes = decodesAsciiBytesUnchanged(textEncoding);
+
+  TextCodec codec(textEncoding);
+  const std::vector<std::string>& lines = textAccess.getAllLines();
   for(unsigned i = 0; i < lines.size(); i++) {
+    if(scanBytes && i > 0 && !mayContainIncludeDirective(lines[i])) {
+      continue;
+    }
+
     const std::wstring line = codec.decode(lines[i]);
     const std::wstring lineTrimmedToHash = utility::trim(line);
     if(utility::isPrefix<std::wstring>(L"#", lineTrimmedToHash)) {
@@ -145,7 +253,7 @@ std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(std::share
 
         if(!includeString.empty()) {
           // lines are 1 based
-          includeDirectives.push_back(IncludeDirective(FilePath(includeString), textAccess->getFilePath(), i + 1, usesBrackets));
+          includeDirectives.push_back(IncludeDirective(FilePath(includeString), textAccess.getFilePath(), i + 1, usesBrackets));
         }
       }
     }
@@ -158,7 +266,9 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
     std::set<FilePath> filePathsToProcess,
     std::unordered_set<std::wstring>& processedFilePaths,
     const std::set<FilePath>& indexedPaths,
-    const std::set<FilePath>& headerSearchDirectories) {
+    const std::set<FilePath>& headerSearchDirectories,
+    const std::string& textEncoding,
+    FileSystemCache& fileSystemCache) {
   std::vector<IncludeDirective> unresolvedIncludeDirectives;
 
   while(!filePathsToProcess.empty()) {
@@ -167,11 +277,26 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
                    std::inserter(processedFilePaths, processedFilePaths.begin()),
                    [](const FilePath& p) { return p.getAbsolute().makeCanonical().wstr(); });
 
+    // the files are read and resolved in parallel, the results are merged in order to keep the first unresolved
+    // directive of each included file
+    const std::vector<FilePath> filePaths(filePathsToProcess.begin(), filePathsToProcess.end());
+    std::vector<std::vector<std::pair<IncludeDirective, FilePath>>> resolvedIncludeDirectives(filePaths.size());
+
+    utility::forEachIndexParallel(filePaths.size(), MinFilesPerThread, [&](size_t index) {
+      for(const IncludeDirective& includeDirective : getIncludeDirectives(filePaths[index], textEncoding)) {
+        FilePath resolvedIncludePath = resolveIncludeDirective(
+            includeDirective, headerSearchDirectories, fileSystemCache.directoryListings);
+        if(!resolvedIncludePath.empty()) {
+          resolvedIncludePath = fileSystemCache.getCanonical(resolvedIncludePath);
+        }
+        resolvedIncludeDirectives[index].emplace_back(includeDirective, std::move(resolvedIncludePath));
+      }
+    });
+
     std::set<FilePath> filePathsToProcessForNextIteration;
 
-    for(const FilePath& filePath : filePathsToProcess) {
-      for(const IncludeDirective& includeDirective : getIncludeDirectives(filePath)) {
-        const FilePath resolvedIncludePath = resolveIncludeDirective(includeDirective, headerSearchDirectories).makeCanonical();
+    for(const auto& resolvedIncludeDirectivesOfFile : resolvedIncludeDirectives) {
+      for(const auto& [includeDirective, resolvedIncludePath] : resolvedIncludeDirectivesOfFile) {
         if(resolvedIncludePath.empty()) {
           unresolvedIncludeDirectives.push_back(includeDirective);
         } else if(processedFilePaths.find(resolvedIncludePath.wstr()) == processedFilePaths.end()) {
@@ -192,14 +317,15 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 }
 
 FilePath IncludeProcessing::resolveIncludeDirective(const IncludeDirective& includeDirective,
-                                                    const std::set<FilePath>& headerSearchDirectories) {
+                                                    const std::set<FilePath>& headerSearchDirectories,
+                                                    DirectoryListingCache& directoryListingCache) {
   const FilePath includedFilePath = includeDirective.getIncludedFile();
 
   {
     // check for an absolute include path
     if(includedFilePath.isAbsolute()) {
       const FilePath resolvedIncludePath = includedFilePath;
-      if(resolvedIncludePath.exists()) {
+      if(directoryListingCache.exists(resolvedIncludePath)) {
         return includedFilePath;
       }
     }
@@ -208,7 +334,7 @@ FilePath IncludeProcessing::resolveIncludeDirective(const IncludeDirective& incl
   {
     // check for an include path relative to the including path
     const FilePath resolvedIncludePath = includeDirective.getIncludingFile().getParentDirectory().concatenate(includedFilePath);
-    if(resolvedIncludePath.exists()) {
+    if(directoryListingCache.exists(resolvedIncludePath)) {
       return resolvedIncludePath;
     }
   }
@@ -217,7 +343,7 @@ FilePath IncludeProcessing::resolveIncludeDirective(const IncludeDirective& incl
     // check for an include path relative to the header search directories
     for(const FilePath& headerSearchDirectory : headerSearchDirectories) {
       const FilePath resolvedIncludePath = headerSearchDirectory.getConcatenated(includedFilePath);
-      if(resolvedIncludePath.exists()) {
+      if(directoryListingCache.exists(resolvedIncludePath)) {
         return resolvedIncludePath;
       }
     }
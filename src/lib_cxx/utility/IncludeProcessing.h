@@ -10,6 +10,7 @@
 
 #include "OrderedCache.h"
 
+class DirectoryListingCache;
 class FilePath;
 class IncludeDirective;
 class TextAccess;
@@ -33,13 +34,22 @@ public:
   static std::vector<IncludeDirective> getIncludeDirectives(std::shared_ptr<TextAccess> textAccess);
 
 private:
+  struct FileSystemCache;
+
+  static std::vector<IncludeDirective> getIncludeDirectives(const FilePath& filePath, const std::string& textEncoding);
+
+  static std::vector<IncludeDirective> getIncludeDirectives(const TextAccess& textAccess, const std::string& textEncoding);
+
   static std::vector<IncludeDirective> doGetUnresolvedIncludeDirectives(std::set<FilePath> filePathsToProcess,
                                                                         std::unordered_set<std::wstring>& processedFilePaths,
                                                                         const std::set<FilePath>& indexedPaths,
-                                                                        const std::set<FilePath>& headerSearchDirectories);
+                                                                        const std::set<FilePath>& headerSearchDirectories,
+                                                                        const std::string& textEncoding,
+                                                                        FileSystemCache& fileSystemCache);
 
   static FilePath resolveIncludeDirective(const IncludeDirective& includeDirective,
-                                          const std::set<FilePath>& headerSearchDirectories);
+                                          const std::set<FilePath>& headerSearchDirectories,
+                                          DirectoryListingCache& directoryListingCache);
 
   IncludeProcessing() = delete;
 };
@@ -26,6 +26,7 @@
 #include "TextCodec.h"
 #include "type/code/MessageActivateLocalSymbols.h"
 #include "type/code/MessageActivateTokenIds.h"
+#include "type/code/MessageCodeVisibleLinesChanged.h"
 #include "type/error/MessageShowError.h"
 #include "type/focus/MessageFocusIn.h"
 #include "type/focus/MessageFocusOut.h"
@@ -35,6 +36,11 @@
 #include "utilityQt.h"
 #include "utilityString.h"
 
+namespace {
+// Number of lines above and below the viewport whose source locations are requested for virtualized areas.
+constexpr size_t VirtualizedLineMargin = 200;
+}    // namespace
+
 MouseWheelOverScrollbarFilter::MouseWheelOverScrollbarFilter() = default;
 
 bool MouseWheelOverScrollbarFilter::eventFilter(QObject* obj, QEvent* event) {
@@ -93,6 +99,7 @@ QtCodeArea::QtCodeArea(size_t startLineNumber,
   connect(this, &QtCodeArea::blockCountChanged, this, &QtCodeArea::updateLineNumberAreaWidth);
   connect(this, &QtCodeArea::updateRequest, this, &QtCodeArea::updateLineNumberArea);
   connect(this, &QtCodeArea::copyAvailable, this, &QtCodeArea::setCopyAvailable);
+  connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &QtCodeArea::requestSourceLocationsForVisibleLines);
 
   // MouseWheelOverScrollbarFilter is deleted by parent.
   horizontalScrollBar()->installEventFilter(new MouseWheelOverScrollbarFilter());
@@ -112,10 +119,24 @@ QSize QtCodeArea::sizeHint() const {
   double height = 0;
   double width = 0;
 
-  for(QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
-    QRectF rect = blockBoundingGeometry(block);
-    height += rect.height();
-    width = std::max(rect.width(), width);
+  if(m_isVirtualized) {
+    // Avoid laying out every block: lines do not wrap, so all blocks have the same height and the longest one
+    // determines the width.
+    QTextBlock longestBlock = document()->firstBlock();
+    for(QTextBlock block = longestBlock; block.isValid(); block = block.next()) {
+      if(block.length() > longestBlock.length()) {
+        longestBlock = block;
+      }
+    }
+
+    height = blockBoundingGeometry(document()->firstBlock()).height() * blockCount();
+    width = blockBoundingGeometry(longestBlock).width();
+  } else {
+    for(QTextBlock block = document()->firstBlock(); block.isValid(); block = block.next()) {
+      QRectF rect = blockBoundingGeometry(block);
+      height += rect.height();
+      width = std::max(rect.width(), width);
+    }
   }
 
   if(horizontalScrollBar()->minimum() != horizontalScrollBar()->maximum() && utility::getOsType() != OsType::Mac) {
@@ -266,6 +287,7 @@ void QtCodeArea::updateLineNumberAreaWidthForDigits(int digits) {
 }
 
 void QtCodeArea::updateSourceLocations(const std::shared_ptr<SourceLocationFile>& locationFile) {
+  // the locations of virtualized areas are merged by the controller, which also keeps the windows requested earlier
   if(locationFile->getSourceLocationCount() > getSourceLocationFile()->getSourceLocationCount()) {
     if(!m_hoveredAnnotations.empty()) {
       setHoveredAnnotations({});
@@ -277,6 +299,14 @@ void QtCodeArea::updateSourceLocations(const std::shared_ptr<SourceLocationFile>
   }
 }
 
+void QtCodeArea::setIsVirtualized(bool isVirtualized) {
+  m_isVirtualized = isVirtualized;
+  m_requestedStartLineNumber = 0;
+  m_requestedEndLineNumber = 0;
+
+  requestSourceLocationsForVisibleLines();
+}
+
 void QtCodeArea::updateContent() {
   annotateText();
 }
@@ -612,6 +642,8 @@ void QtCodeArea::resizeEvent(QResizeEvent* e) {
 
   QRect cr = contentsRect();
   m_lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), lineNumberAreaWidth(), cr.height()));
+
+  requestSourceLocationsForVisibleLines();
 }
 
 void QtCodeArea::mousePressEvent(QMouseEvent* event) {
@@ -805,6 +837,26 @@ void QtCodeArea::setCopyAvailable(bool yes) {
   m_copyAction->setEnabled(yes);
 }
 
+void QtCodeArea::requestSourceLocationsForVisibleLines() {
+  if(!m_isVirtualized || lineHeight() <= 0) {
+    return;
+  }
+
+  const size_t startLineNumber = getStartLineNumber() + static_cast<size_t>(firstVisibleBlock().blockNumber());
+  const size_t endLineNumber = std::min(startLineNumber + static_cast<size_t>(viewport()->height() / lineHeight()),
+                                        getEndLineNumber());
+
+  if(m_requestedStartLineNumber != 0U && startLineNumber >= m_requestedStartLineNumber &&
+     endLineNumber <= m_requestedEndLineNumber) {
+    return;
+  }
+
+  m_requestedStartLineNumber = std::max(startLineNumber, VirtualizedLineMargin + 1) - VirtualizedLineMargin;
+  m_requestedEndLineNumber = std::min(endLineNumber + VirtualizedLineMargin, getEndLineNumber());
+
+  MessageCodeVisibleLinesChanged(getFilePath(), m_requestedStartLineNumber, m_requestedEndLineNumber).dispatch();
+}
+
 void QtCodeArea::clearSelection() {
   QTextCursor cursor = textCursor();
   cursor.clearSelection();
@@ -62,6 +62,11 @@ public:
   void updateLineNumberAreaWidthForDigits(int digits);
 
   void updateSourceLocations(const std::shared_ptr<SourceLocationFile>& locationFile);
+
+  /**
+   * @brief Virtualized areas request source locations only for the visible lines plus a margin while scrolling.
+   */
+  void setIsVirtualized(bool isVirtualized);
   void updateContent();
 
   void setIsActiveFile(bool isActiveFile);
@@ -108,6 +113,7 @@ private slots:
   void updateLineNumberArea(QRect, int);
   void setIDECursorPosition();
   void setCopyAvailable(bool yes);
+  void requestSourceLocationsForVisibleLines();
 
 private:
   void clearSelection();
@@ -141,5 +147,9 @@ private:
   bool m_isActiveFile;
   bool m_showLineNumbers;
 
+  bool m_isVirtualized = false;
+  size_t m_requestedStartLineNumber = 0;
+  size_t m_requestedEndLineNumber = 0;
+
   QtScrollSpeedChangeListener m_scrollSpeedChangeListener;
 };
\ No newline at end of file
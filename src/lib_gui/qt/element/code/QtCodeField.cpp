@@ -1,5 +1,7 @@
 #include "QtCodeField.h"
 
+#include <algorithm>
+
 #include <QAction>
 #include <QPainter>
 #include <QTextBlock>
@@ -75,7 +77,7 @@ QtCodeField::QtCodeField(size_t startLineNumber,
   createAnnotations(locationFile);
 
   m_highlighter = std::make_shared<QtHighlighter>(document(), locationFile->getLanguage());
-  m_highlighter->highlightDocument();
+  m_highlighter->highlightDocument([this]() { viewport()->update(); });
 
   IApplicationSettings* appSettings = IApplicationSettings::getInstanceRaw();
   QFont font(appSettings->getFontName().c_str());
@@ -468,29 +470,17 @@ void QtCodeField::activateAnnotations(const std::vector<const Annotation*>& anno
 }
 
 int QtCodeField::toTextEditPosition(int lineNumber, int columnNumber) const {
-  lineNumber -= static_cast<int>(m_startLineNumber - 1);
-  int position = 0;
-
-  for(int i = 0; i < lineNumber - 1; i++) {
-    position += m_lineLengths[static_cast<std::size_t>(i)];
-  }
-
-  position += columnNumber;
-  return position;
+  const auto lineIndex = std::clamp<std::ptrdiff_t>(
+      lineNumber - static_cast<int>(m_startLineNumber), 0, static_cast<std::ptrdiff_t>(m_lineStartPositions.size()) - 1);
+  return m_lineStartPositions[static_cast<std::size_t>(lineIndex)] + columnNumber;
 }
 
 std::pair<int, int> QtCodeField::toLineColumn(int textEditPosition) const {
-  int lineNumber = static_cast<int>(m_startLineNumber);
-  for(int i = 0; i < document()->lineCount(); i++) {
-    int nextTextEditPosition = textEditPosition - m_lineLengths[static_cast<std::size_t>(i)];
-    if(nextTextEditPosition >= 0) {
-      textEditPosition = nextTextEditPosition;
-      lineNumber++;
-    } else {
-      break;
-    }
-  }
-  return std::make_pair(lineNumber, textEditPosition);
+  // index of the last line start at or before the position
+  const auto iterator = std::upper_bound(m_lineStartPositions.begin(), m_lineStartPositions.end(), textEditPosition);
+  const auto lineIndex = std::max<std::ptrdiff_t>(std::distance(m_lineStartPositions.begin(), iterator) - 1, 0);
+  return std::make_pair(static_cast<int>(m_startLineNumber) + static_cast<int>(lineIndex),
+                        textEditPosition - m_lineStartPositions[static_cast<std::size_t>(lineIndex)]);
 }
 
 int QtCodeField::startTextEditPosition() const {
@@ -685,9 +675,11 @@ void QtCodeField::createLineLengthCache() {
   m_endTextEditPosition = -1;
 
   m_lineLengths.clear();
+  m_lineStartPositions.assign(1, 0);
 
   for(QTextBlock it = document()->begin(); it != document()->end(); it = it.next()) {
     m_lineLengths.push_back(it.length());
+    m_lineStartPositions.push_back(m_lineStartPositions.back() + it.length());
     m_endTextEditPosition += it.length();
   }
 }
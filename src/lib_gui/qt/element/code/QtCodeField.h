@@ -141,6 +141,7 @@ private:
   std::shared_ptr<QtHighlighter> m_highlighter;
 
   std::vector<int> m_lineLengths;
+  std::vector<int> m_lineStartPositions;    // text edit position of each line start, plus the end of the last line
   std::vector<std::vector<std::pair<int, int>>> m_multibyteCharacterLocations;
 
   int m_endTextEditPosition;
@@ -95,6 +95,7 @@ bool QtCodeFileSingle::addFile(const CodeFileParams& params, bool useSingleFileC
 
   // NOLINTNEXTLINE(cppcoreguidelines-owning-memory)
   file.area = new QtCodeArea(1, params.fileParams->code, locationFile, m_navigator, !params.fileParams->isOverview, this);
+  file.area->setIsVirtualized(params.fileParams->isVirtualized);
   connect(file.area->verticalScrollBar(), &QScrollBar::valueChanged, m_navigator, &QtCodeNavigator::scrolled);
 
   setFileData(file);
@@ -49,6 +49,7 @@ QtGraphicsView::QtGraphicsView(GraphFocusHandler* focusHandler, QWidget* parent)
   connect(m_timerStopper.get(), &QTimer::timeout, this, &QtGraphicsView::stopTimer);
 
   m_zoomLabelTimer = std::make_shared<QTimer>(this);
+  m_zoomLabelTimer->setSingleShot(true);
   connect(m_zoomLabelTimer.get(), &QTimer::timeout, this, &QtGraphicsView::hideZoomLabel);
 
   m_openInTabAction = new QAction(QStringLiteral("Open in New Tab (Ctrl + Shift + Left Click)"), this);
@@ -693,6 +694,9 @@ void QtGraphicsView::zoomOutPressed() {
 
 void QtGraphicsView::hideZoomLabel() {
   m_zoomState->hide();
+
+  // The zoom level is stored once zooming settled, writing the settings file on every wheel step stalls the frames.
+  IApplicationSettings::getInstanceRaw()->save();
 }
 
 void QtGraphicsView::legendClicked() const {
@@ -706,9 +710,7 @@ bool QtGraphicsView::moves() const {
 void QtGraphicsView::setZoomFactor(float zoomFactor) {
   m_zoomFactor = zoomFactor;
 
-  IApplicationSettings* settings = IApplicationSettings::getInstanceRaw();
-  settings->setGraphZoomLevel(zoomFactor);
-  settings->save();
+  IApplicationSettings::getInstanceRaw()->setGraphZoomLevel(zoomFactor);
 
   m_zoomState->setText(QString::number(int(m_zoomFactor * 100)) + "%");
   updateTransform();
@@ -5,6 +5,7 @@
 #include <QPen>
 
 #include "GraphViewStyle.h"
+#include "QtSimpleTextItem.h"
 
 QtCountCircleItem::QtCountCircleItem(QGraphicsItem* parent) : QtRoundedRectItem(parent) {
   this->setRadius(10);
@@ -15,7 +16,7 @@ QtCountCircleItem::QtCountCircleItem(QGraphicsItem* parent) : QtRoundedRectItem(
   font.setPixelSize(static_cast<int>(GraphViewStyle::getFontSizeOfCountCircle()));
   font.setWeight(QFont::Normal);
 
-  m_number = new QGraphicsSimpleTextItem(this);
+  m_number = new QtSimpleTextItem(this);
   m_number->setFont(font);
 }
 
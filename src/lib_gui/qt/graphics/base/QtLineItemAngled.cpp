@@ -5,6 +5,8 @@
 #include <QPainter>
 #include <QStyleOptionGraphicsItem>
 
+#include "utilityQt.h"
+
 QtLineItemAngled::QtLineItemAngled(QGraphicsItem* parent) : QtLineItemBase(parent) {
   this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
 }
@@ -30,9 +32,16 @@ void QtLineItemAngled::paint(QPainter* painter, const QStyleOptionGraphicsItem*
   QPen p = pen();
   painter->setPen(p);
 
+  QPolygon poly = getPath();
+
+  // rounded corners and arrow heads are not visible when zoomed out far
+  if(!utility::isGraphDetailVisible(painter)) {
+    painter->drawPolyline(poly);
+    return;
+  }
+
   QPainterPath path;
 
-  QPolygon poly = getPath();
   int i = static_cast<int>(poly.length()) - 1;
 
   path.moveTo(poly.at(i));
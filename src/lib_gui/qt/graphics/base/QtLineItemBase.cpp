@@ -14,6 +14,13 @@ QtLineItemBase::QtLineItemBase(QGraphicsItem* parent)
 
 QtLineItemBase::~QtLineItemBase() {}
 
+QRectF QtLineItemBase::boundingRect() const {
+  if(m_boundingRect.isNull()) {
+    m_boundingRect = shape().controlPointRect();
+  }
+  return m_boundingRect;
+}
+
 void QtLineItemBase::updateLine(const QVector4D& ownerRect,
                                 const QVector4D& targetRect,
                                 const QVector4D& ownerParentRect,
@@ -23,6 +30,7 @@ void QtLineItemBase::updateLine(const QVector4D& ownerRect,
                                 bool showArrow) {
   prepareGeometryChange();
   m_polygon.clear();
+  m_boundingRect = QRectF();
 
   m_ownerRect = ownerRect;
   m_targetRect = targetRect;
@@ -44,19 +52,27 @@ void QtLineItemBase::updateLine(const QVector4D& ownerRect,
 }
 
 void QtLineItemBase::setRoute(Route route) {
+  prepareGeometryChange();
   m_route = route;
+  m_boundingRect = QRectF();
 }
 
 void QtLineItemBase::setOnFront(bool front) {
+  prepareGeometryChange();
   m_onFront = front;
+  m_boundingRect = QRectF();
 }
 
 void QtLineItemBase::setOnBack(bool back) {
+  prepareGeometryChange();
   m_onBack = back;
+  m_boundingRect = QRectF();
 }
 
 void QtLineItemBase::setEarlyBend(bool earlyBend) {
+  prepareGeometryChange();
   m_earlyBend = earlyBend;
+  m_boundingRect = QRectF();
 }
 
 QPolygon QtLineItemBase::getPath() const {
@@ -14,6 +14,10 @@ public:
   QtLineItemBase(QGraphicsItem* parent);
   virtual ~QtLineItemBase();
 
+  // The bounding rect of a line item is derived from its shape, which strokes the whole path. It is cached, because the
+  // scene asks for it on every repaint and index update.
+  QRectF boundingRect() const override;
+
   void updateLine(const QVector4D& ownerRect,
                   const QVector4D& targetRect,
                   const QVector4D& ownerParentRect,
@@ -54,6 +58,7 @@ private:
   QVector4D m_targetParentRect;
 
   mutable QPolygon m_polygon;
+  mutable QRectF m_boundingRect;
 };
 
 #endif    // QT_LINE_ITEM_BASE_H
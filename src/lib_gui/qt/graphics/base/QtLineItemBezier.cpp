@@ -2,6 +2,8 @@
 
 #include <QPainter>
 
+#include "utilityQt.h"
+
 QtLineItemBezier::QtLineItemBezier(QGraphicsItem* parent) : QtLineItemBase(parent) {}
 
 QtLineItemBezier::~QtLineItemBezier() {}
@@ -19,6 +21,14 @@ QPainterPath QtLineItemBezier::shape() const {
 }
 
 void QtLineItemBezier::paint(QPainter* painter, const QStyleOptionGraphicsItem* /*options*/, QWidget* /*widget*/) {
+  // curves and arrow heads are not visible when zoomed out far
+  if(!utility::isGraphDetailVisible(painter)) {
+    const QPolygon poly = QtLineItemBase::getPath();
+    painter->setPen(pen());
+    painter->drawLine(poly.first(), poly.last());
+    return;
+  }
+
   QPainterPath path = getCurve();
 
   if(m_showArrow) {
@@ -3,6 +3,8 @@
 #include <QGraphicsDropShadowEffect>
 #include <QPainter>
 
+#include "utilityQt.h"
+
 QtRoundedRectItem::QtRoundedRectItem(QGraphicsItem* parent) : QGraphicsRectItem(parent), m_radius(0.0) {
   this->setZValue(-1.0);
 }
@@ -13,6 +15,11 @@ void QtRoundedRectItem::paint(QPainter* painter, const QStyleOptionGraphicsItem*
   painter->setPen(pen());
   painter->setBrush(brush());
 
+  if(!utility::isGraphDetailVisible(painter)) {
+    painter->drawRect(this->rect());
+    return;
+  }
+
   painter->setRenderHint(QPainter::Antialiasing);
 
   painter->drawRoundedRect(this->rect(), m_radius, m_radius);
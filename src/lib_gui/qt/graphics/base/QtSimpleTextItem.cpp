@@ -0,0 +1,17 @@
+#include "QtSimpleTextItem.h"
+
+#include <QPainter>
+
+#include "utilityQt.h"
+
+QtSimpleTextItem::QtSimpleTextItem(QGraphicsItem* parent) : QGraphicsSimpleTextItem(parent) {}
+
+QtSimpleTextItem::~QtSimpleTextItem() = default;
+
+void QtSimpleTextItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget) {
+  if(!utility::isGraphDetailVisible(painter)) {
+    return;
+  }
+
+  QGraphicsSimpleTextItem::paint(painter, options, widget);
+}
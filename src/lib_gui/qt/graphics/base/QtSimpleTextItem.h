@@ -0,0 +1,15 @@
+#ifndef QT_GRAPHICS_SIMPLE_TEXT_ITEM_H
+#define QT_GRAPHICS_SIMPLE_TEXT_ITEM_H
+
+#include <QGraphicsSimpleTextItem>
+
+// Text item that is skipped when the graph is zoomed out too far for the text to be readable.
+class QtSimpleTextItem : public QGraphicsSimpleTextItem {
+public:
+  QtSimpleTextItem(QGraphicsItem* parent);
+  virtual ~QtSimpleTextItem();
+
+  void paint(QPainter* painter, const QStyleOptionGraphicsItem* options, QWidget* widget) override;
+};
+
+#endif    // QT_GRAPHICS_SIMPLE_TEXT_ITEM_H
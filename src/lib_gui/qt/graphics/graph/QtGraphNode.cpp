@@ -16,6 +16,7 @@
 #include "QtGraphNodeComponent.h"
 #include "QtGraphNodeExpandToggle.h"
 #include "QtRoundedRectItem.h"
+#include "QtSimpleTextItem.h"
 #include "ResourcePaths.h"
 #include "type/code/MessageCodeShowDefinition.h"
 #include "type/graph/MessageGraphNodeHide.h"
@@ -58,7 +59,7 @@ QtGraphNode::QtGraphNode(GraphFocusHandler* focusHandler) : m_focusHandler(focus
   this->setPen(QPen(Qt::transparent));
   this->setCursor(Qt::PointingHandCursor);
 
-  m_text = new QGraphicsSimpleTextItem(this);
+  m_text = new QtSimpleTextItem(this);
   m_rect = new QtRoundedRectItem(this);
   m_undefinedRect = new QtRoundedRectItem(this);
   m_undefinedRect->hide();
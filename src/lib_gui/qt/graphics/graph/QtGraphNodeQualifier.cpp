@@ -8,6 +8,7 @@
 #include <QVector2D>
 
 #include "NameHierarchy.h"
+#include "QtSimpleTextItem.h"
 #include "type/graph/MessageActivateNodes.h"
 
 QtGraphNodeQualifier::QtGraphNodeQualifier(const NameHierarchy& name) : m_qualifierName(name) {
@@ -23,7 +24,7 @@ QtGraphNodeQualifier::QtGraphNodeQualifier(const NameHierarchy& name) : m_qualif
   font.setPixelSize(static_cast<int>(GraphViewStyle::getFontSizeOfQualifier()));
   font.setWeight(QFont::Normal);
 
-  m_name = new QGraphicsSimpleTextItem(this);
+  m_name = new QtSimpleTextItem(this);
   m_name->setFont(font);
   m_name->setText(QString::fromStdWString(name.getQualifiedName()));
 }
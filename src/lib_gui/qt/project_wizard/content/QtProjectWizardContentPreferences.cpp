@@ -283,6 +283,36 @@ void QtProjectWizardContentPreferences::populate(QGridLayout* layout, int& row)
       layout,
       row);
 
+  // persistent indexer processes
+  m_persistentIndexerProcesses = addCheckBox(
+      QStringLiteral("Persistent<br />Indexer Processes"),
+      QStringLiteral("Keep C/C++ indexer processes running between refreshes"),
+      QStringLiteral("<p>Keep the indexer processes alive after indexing finished, so the next refresh does not have to "
+                     "start them again.</p>"
+                     "<p>Only applies to multi process indexing.</p>"),
+      layout,
+      row);
+
+  // file change journal
+  m_fileChangeJournal = addCheckBox(
+      QStringLiteral("Watch Project<br />Files"),
+      QStringLiteral("Only check changed files when refreshing"),
+      QStringLiteral("<p>Watch the source directories of the open project for file changes, so refreshing after a "
+                     "small edit only checks the edited files instead of all files of the project.</p>"
+                     "<p>Only available on Linux. The first refresh after opening a project and refreshes after too "
+                     "many changes still check all files.</p>"),
+      layout,
+      row);
+
+  // indexer memory budget
+  m_indexerMemoryBudget = addLineEdit(
+      QStringLiteral("Indexer Memory<br />Budget (MB)"),
+      QStringLiteral("<p>Limit the memory used by all indexer threads together. New files are only started while the "
+                     "indexers stay below this budget.</p>"
+                     "<p>Set to 0 to disable the limit.</p>"),
+      layout,
+      row);
+
   addGap(layout, row);
 
   addTitle(QStringLiteral("C/C++"), layout, row);
@@ -342,6 +372,9 @@ void QtProjectWizardContentPreferences::load() {
   m_threads->setCurrentIndex(appSettings->getIndexerThreadCount());    // index and value are the same
   indexerThreadsChanges(m_threads->currentIndex());
   m_multiProcessIndexing->setChecked(appSettings->getMultiProcessIndexingEnabled());
+  m_persistentIndexerProcesses->setChecked(appSettings->getPersistentIndexerProcessesEnabled());
+  m_fileChangeJournal->setChecked(appSettings->getFileChangeJournalEnabled());
+  m_indexerMemoryBudget->setText(QString::number(appSettings->getIndexerMemoryBudget()));
 }
 
 void QtProjectWizardContentPreferences::save() {
@@ -393,6 +426,9 @@ void QtProjectWizardContentPreferences::save() {
 
   appSettings->setIndexerThreadCount(m_threads->currentIndex());    // index and value are the same
   appSettings->setMultiProcessIndexingEnabled(m_multiProcessIndexing->isChecked());
+  appSettings->setPersistentIndexerProcessesEnabled(m_persistentIndexerProcesses->isChecked());
+  appSettings->setFileChangeJournalEnabled(m_fileChangeJournal->isChecked());
+  appSettings->setIndexerMemoryBudget(m_indexerMemoryBudget->text().toInt());
 
   appSettings->save();
 }
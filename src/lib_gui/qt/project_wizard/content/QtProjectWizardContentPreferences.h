@@ -100,5 +100,8 @@ private:
   QLabel* m_threadsInfoLabel;
 
   QCheckBox* m_multiProcessIndexing;
+  QCheckBox* m_persistentIndexerProcesses;
+  QCheckBox* m_fileChangeJournal;
+  QLineEdit* m_indexerMemoryBudget;
   QComboBox* mLoggingLevelComboBox;
 };
\ No newline at end of file
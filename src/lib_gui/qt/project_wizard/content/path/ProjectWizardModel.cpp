@@ -36,7 +36,7 @@ void ProjectWizardModel::onPickerTextChanged(QtProjectWizardWindow* window, cons
       FilePath(text.toStdWString()), m_settings->getProjectDirectoryPath());
   if(!cdbPath.empty() && cdbPath.exists() && cdbPath != m_settings->getCompilationDatabasePathExpandedAndAbsolute()) {
     std::string error;
-    std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath, &error);
+    const std::shared_ptr<const CxxCompilationDatabase> cdb = utility::loadCDB(cdbPath, &error);
     if(cdb && error.empty()) {
       pickedPath(window);
     }
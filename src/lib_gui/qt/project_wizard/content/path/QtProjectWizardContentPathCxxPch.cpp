@@ -45,7 +45,7 @@ void QtProjectWizardContentPathCxxPch::save() {
 bool QtProjectWizardContentPathCxxPch::check() {
   if(std::shared_ptr<SourceGroupSettingsCxxCdb> cdbSettings = std::dynamic_pointer_cast<SourceGroupSettingsCxxCdb>(m_settings)) {
     const FilePath cdbPath = cdbSettings->getCompilationDatabasePathExpandedAndAbsolute();
-    std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+    const std::shared_ptr<const CxxCompilationDatabase> cdb = utility::loadCDB(cdbPath);
     if(!cdb) {
       QMessageBox msgBox(m_window);
       msgBox.setText(QStringLiteral("Unable to open and read the provided compilation database file."));
@@ -1,21 +1,28 @@
 #include "QtHighlighter.h"
 
+#include <algorithm>
+#include <string_view>
+
+#include <QCoreApplication>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
-#include <QTextBlock>
 #include <QTextCursor>
 #include <QTextDocument>
 
+#include "../../../scheduling/TaskLambda.h"
 #include "ColorScheme.h"
 #include "FileSystem.h"
 #include "logging.h"
 #include "ResourcePaths.h"
+#include "TabId.h"
 #include "TextAccess.h"
 #include "utility.h"
 
 std::map<std::wstring, std::vector<QtHighlighter::HighlightingRule>> QtHighlighter::s_highlightingRules;
 std::map<QtHighlighter::HighlightType, QTextCharFormat> QtHighlighter::s_charFormats;
+LruCache<std::wstring, std::shared_ptr<const QtHighlighter::BlockRanges>> QtHighlighter::s_blockRangesCache(
+    QtHighlighter::BlockRangesCacheByteBudget);
 
 std::string QtHighlighter::highlightTypeToString(QtHighlighter::HighlightType type) {
   switch(type) {
@@ -126,9 +133,11 @@ void QtHighlighter::loadHighlightingRules() {
 
 void QtHighlighter::clearHighlightingRules() {
   s_highlightingRules.clear();
+  s_blockRangesCache.clear();
 }
 
-QtHighlighter::QtHighlighter(QTextDocument* document, const std::wstring& language) : m_document(document) {
+QtHighlighter::QtHighlighter(QTextDocument* document, const std::wstring& language)
+    : m_document(document), m_language(language), m_self(std::make_shared<QtHighlighter*>(this)) {
   if(!s_highlightingRules.size()) {
     loadHighlightingRules();
   }
@@ -139,94 +148,78 @@ QtHighlighter::QtHighlighter(QTextDocument* document, const std::wstring& langua
   }
 }
 
-void QtHighlighter::highlightDocument() {
+void QtHighlighter::highlightDocument(std::function<void()> onFinished) {
   QTextDocument* doc = document();
 
-  int docStart = 0;
-  int docEnd = 0;
-  for(int i = 0; i < doc->blockCount(); i++) {
-    docEnd += doc->findBlockByLineNumber(i).length();
-  }
-
-  if(docEnd > 0) {
-    docEnd -= 1;
-  }
-
-  applyFormat(docStart, docEnd, s_charFormats[HighlightType::TEXT]);
+  applyFormat(0, std::max(doc->characterCount() - 1, 0), s_charFormats[HighlightType::TEXT]);
 
+  m_blockRanges.reset();
   m_highlightedLines.clear();
-  m_highlightedLines.resize(static_cast<std::size_t>(document()->blockCount()), false);
+  m_highlightedLines.resize(static_cast<std::size_t>(doc->blockCount()), false);
+
+  // raw text keeps the block separators, so its positions match the document positions
+  const QString text = doc->toRawText();
+  const std::wstring key = m_language + L':' +
+      std::to_wstring(std::hash<std::u16string_view>()(
+          std::u16string_view(reinterpret_cast<const char16_t*>(text.utf16()), static_cast<size_t>(text.size())))) +
+      L':' + std::to_wstring(text.size());
 
-  if(m_highlightingRules.empty()) {
+  if(std::optional<std::shared_ptr<const BlockRanges>> cached = s_blockRangesCache.getValue(key)) {
+    setBlockRanges(*cached);
     return;
   }
 
-  std::vector<HighlightingRule> singleLineRules;
-  for(const HighlightingRule& rule : m_highlightingRules) {
-    if(rule.priority && !rule.multiLine) {
-      singleLineRules.emplace_back(rule);
-    }
-  }
-  createRanges(doc, singleLineRules);
+  Task::dispatch(
+      TabId::background(),
+      std::make_shared<TaskLambda>([self = std::weak_ptr<QtHighlighter*>(m_self),
+                                    rules = m_highlightingRules,
+                                    text,
+                                    key,
+                                    onFinished = std::move(onFinished)]() {
+        if(self.expired()) {
+          return;
+        }
+
+        std::shared_ptr<const BlockRanges> blockRanges = tokenize(text, rules);
+
+        size_t byteSize = 0;
+        for(const std::vector<Range>& ranges : *blockRanges) {
+          byteSize += sizeof(ranges) + ranges.size() * sizeof(Range);
+        }
+        s_blockRangesCache.setValue(key, blockRanges, byteSize);
+
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [self, blockRanges, onFinished]() {
+              if(std::shared_ptr<QtHighlighter*> highlighter = self.lock()) {
+                (*highlighter)->setBlockRanges(blockRanges);
+                if(onFinished) {
+                  onFinished();
+                }
+              }
+            },
+            Qt::QueuedConnection);
+      }));
 }
 
 void QtHighlighter::highlightRange(int startLine, int endLine) {
-  if(startLine < 0 || endLine < 0 || startLine > endLine || endLine > int(m_highlightedLines.size())) {
+  // lines past the end of the document are skipped, the line flags have no entry for them
+  endLine = std::min(endLine, int(m_highlightedLines.size()) - 1);
+  if(!m_blockRanges || startLine < 0 || endLine < 0 || startLine > endLine) {
     return;
   }
 
-  bool hasUnhighlightedLines = false;
   for(int i = startLine; i <= endLine; i++) {
-    if(!m_highlightedLines[static_cast<std::size_t>(i)]) {
-      hasUnhighlightedLines = true;
-      break;
-    }
-  }
-
-  if(!hasUnhighlightedLines) {
-    return;
-  }
-
-  QTextDocument* doc = document();
-  QTextBlock start = doc->findBlockByLineNumber(startLine);
-  QTextBlock end = doc->findBlockByLineNumber(endLine + 1);
-
-  [[maybe_unused]] const HighlightingRule* singleLineCommentRule = nullptr;
-  [[maybe_unused]] const HighlightingRule* quotationRule = nullptr;
-
-  for(const HighlightingRule& rule : m_highlightingRules) {
-    if(rule.type == HighlightType::COMMENT && !rule.multiLine) {
-      singleLineCommentRule = &rule;
-    } else if(rule.type == HighlightType::QUOTATION) {
-      quotationRule = &rule;
+    if(m_highlightedLines[static_cast<std::size_t>(i)]) {
+      continue;
     }
-  }
-
-  int index = startLine;
-  for(QTextBlock it = start; it != end; it = it.next()) {
-    if(!m_highlightedLines[static_cast<std::size_t>(index)]) {
-      applyFormat(it.position(), it.position() + it.length() - 1, s_charFormats[HighlightType::TEXT]);
-
-      for(const HighlightingRule& rule : m_highlightingRules) {
-        if(rule.multiLine) {
-          continue;
-        }
 
-        if(rule.priority) {
-          formatBlockIfInRange(it, rule.type, &m_singleLineRanges);
-        } else {
-          formatBlockForRule(it, rule, &m_singleLineRanges);
-        }
-      }
-
-      if(m_multiLineRanges.size()) {
-        formatBlockIfInRange(it, &m_multiLineRanges);
+    for(const auto& [type, start, end] : (*m_blockRanges)[static_cast<std::size_t>(i)]) {
+      if(auto format = s_charFormats.find(type); format != s_charFormats.end()) {
+        applyFormat(start, end, format->second);
       }
     }
-    index++;
-  }
 
-  for(int i = startLine; i <= endLine; i++) {
     m_highlightedLines[static_cast<std::size_t>(i)] = true;
   }
 }
@@ -252,54 +245,145 @@ QTextCharFormat QtHighlighter::getFormat(int /*startPosition*/, int endPosition)
   return cursor.charFormat();
 }
 
-void QtHighlighter::createRanges(QTextDocument* doc, const std::vector<HighlightingRule>& singleLineRules) {
-  m_singleLineRanges.clear();
-  m_multiLineRanges.clear();
+std::shared_ptr<const QtHighlighter::BlockRanges> QtHighlighter::tokenize(const QString& text,
+                                                                        const std::vector<HighlightingRule>& rules) {
+  const QStringList blocks = text.split(QChar::ParagraphSeparator);
+
+  std::vector<int> blockPositions;
+  blockPositions.reserve(static_cast<size_t>(blocks.size()));
+  int position = 0;
+  for(const QString& block : blocks) {
+    blockPositions.push_back(position);
+    position += static_cast<int>(block.size()) + 1;
+  }
 
-  for(QTextBlock it = doc->begin(); it != doc->end(); it = it.next()) {
-    for(const HighlightingRule& rule : singleLineRules) {
-      utility::append(m_singleLineRanges, getRangesForRule(it, rule));
+  const auto blockIndexForPosition = [&blockPositions](int pos) {
+    const auto iterator = std::upper_bound(blockPositions.begin(), blockPositions.end(), pos);
+    return static_cast<size_t>(std::max<std::ptrdiff_t>(std::distance(blockPositions.begin(), iterator) - 1, 0));
+  };
+
+  const std::vector<Range> singleLineRanges = createSingleLineRanges(blocks, blockPositions, rules);
+  const std::vector<Range> multiLineRanges = createMultiLineRanges(text, singleLineRanges, rules);
+
+  BlockRanges singleLineRangesPerBlock(blockPositions.size());
+  for(const Range& range : singleLineRanges) {
+    singleLineRangesPerBlock[blockIndexForPosition(std::get<1>(range))].push_back(range);
+  }
+
+  BlockRanges multiLineRangesPerBlock(blockPositions.size());
+  for(const Range& range : multiLineRanges) {
+    const size_t lastBlockIndex = blockIndexForPosition(std::get<2>(range));
+    for(size_t i = blockIndexForPosition(std::get<1>(range)); i <= lastBlockIndex; i++) {
+      multiLineRangesPerBlock[i].push_back(range);
     }
   }
 
-  // remove ranges starting inside others
-  {
-    std::map<std::pair<int, int>, size_t> sortedRangesToIndex;
-    for(size_t i = 0; i < m_singleLineRanges.size(); i++) {
-      const std::tuple<HighlightType, int, int>& range = m_singleLineRanges[i];
-      sortedRangesToIndex.emplace(std::make_pair(std::get<1>(range), std::get<2>(range)), i);
+  auto blockRanges = std::make_shared<BlockRanges>(blockPositions.size());
+  for(size_t i = 0; i < blockPositions.size(); i++) {
+    const QString& block = blocks[static_cast<int>(i)];
+    const int startPos = blockPositions[i];
+    const int endPos = startPos + static_cast<int>(block.size());
+
+    std::vector<Range>& ranges = (*blockRanges)[i];
+    const auto addClipped = [&ranges, startPos, endPos](HighlightType type, int start, int end) {
+      start = std::max(start, startPos);
+      end = std::min(end, endPos);
+      if(start <= end) {
+        ranges.emplace_back(type, start, end);
+      }
+    };
+
+    ranges.emplace_back(HighlightType::TEXT, startPos, endPos);
+
+    for(const HighlightingRule& rule : rules) {
+      if(rule.multiLine) {
+        continue;
+      }
+
+      if(rule.priority) {
+        for(const auto& [type, start, end] : singleLineRangesPerBlock[i]) {
+          if(type == rule.type) {
+            addClipped(type, start, end);
+          }
+        }
+        continue;
+      }
+
+      QRegExp expression(rule.pattern);
+      int index = expression.indexIn(block);
+      while(index >= 0) {
+        const int length = expression.matchedLength();
+
+        if(!isInRange(startPos + index, singleLineRangesPerBlock[i])) {
+          ranges.emplace_back(rule.type, startPos + index, startPos + index + length);
+        }
+
+        index = expression.indexIn(block, index + std::max(length, 1));
+      }
+    }
+
+    for(const auto& [type, start, end] : multiLineRangesPerBlock[i]) {
+      addClipped(type, start, end);
     }
+  }
+
+  return blockRanges;
+}
 
-    std::set<size_t> indicesToErase;
-    const std::pair<int, int>* topRange = nullptr;
-    for(const auto& p : sortedRangesToIndex) {
-      if(topRange && p.first.first <= topRange->second) {
-        indicesToErase.insert(p.second);
-      } else {
-        topRange = &p.first;
+std::vector<QtHighlighter::Range> QtHighlighter::createSingleLineRanges(const QStringList& blocks,
+                                                                      const std::vector<int>& blockPositions,
+                                                                      const std::vector<HighlightingRule>& rules) {
+  std::vector<Range> ranges;
+
+  for(size_t i = 0; i < blockPositions.size(); i++) {
+    for(const HighlightingRule& rule : rules) {
+      if(rule.priority && !rule.multiLine) {
+        utility::append(ranges, getRangesForRule(blocks[static_cast<int>(i)], blockPositions[i], rule));
       }
     }
+  }
 
-    for(std::set<size_t>::const_reverse_iterator it = indicesToErase.rbegin(); it != indicesToErase.rend(); it++) {
-      m_singleLineRanges.erase(m_singleLineRanges.begin() + static_cast<std::ptrdiff_t>(*it));
+  // remove ranges starting inside others
+  std::map<std::pair<int, int>, size_t> sortedRangesToIndex;
+  for(size_t i = 0; i < ranges.size(); i++) {
+    sortedRangesToIndex.emplace(std::make_pair(std::get<1>(ranges[i]), std::get<2>(ranges[i])), i);
+  }
+
+  std::set<size_t> indicesToErase;
+  const std::pair<int, int>* topRange = nullptr;
+  for(const auto& p : sortedRangesToIndex) {
+    if(topRange && p.first.first <= topRange->second) {
+      indicesToErase.insert(p.second);
+    } else {
+      topRange = &p.first;
     }
   }
 
-  m_multiLineRanges = createMultiLineRanges(doc, &m_singleLineRanges);
+  for(auto it = indicesToErase.rbegin(); it != indicesToErase.rend(); it++) {
+    ranges.erase(ranges.begin() + static_cast<std::ptrdiff_t>(*it));
+  }
+
+  // the remaining ranges do not overlap, sorting them allows binary search in isInRange
+  std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+    return std::make_pair(std::get<1>(a), std::get<2>(a)) < std::make_pair(std::get<1>(b), std::get<2>(b));
+  });
+
+  return ranges;
 }
 
-std::vector<std::tuple<QtHighlighter::HighlightType, int, int>> QtHighlighter::createMultiLineRanges(
-    QTextDocument* doc, std::vector<std::tuple<HighlightType, int, int>>* ranges) {
-  std::vector<std::tuple<HighlightType, int, int>> multiLineRanges;
+std::vector<QtHighlighter::Range> QtHighlighter::createMultiLineRanges(const QString& text,
+                                                                     const std::vector<Range>& singleLineRanges,
+                                                                     const std::vector<HighlightingRule>& rules) {
+  std::vector<Range> multiLineRanges;
 
   const HighlightingRule* startRule = nullptr;
 
-  for(const HighlightingRule& rule : m_highlightingRules) {
+  for(const HighlightingRule& rule : rules) {
     if(rule.priority && rule.multiLine) {
       if(!startRule) {
         startRule = &rule;
       } else if(rule.type == startRule->type) {
-        utility::append(multiLineRanges, createMultiLineRangesForRules(doc, ranges, startRule, &rule));
+        utility::append(multiLineRanges, createMultiLineRangesForRules(text, singleLineRanges, *startRule, rule));
         startRule = nullptr;
       }
     }
@@ -308,42 +392,46 @@ std::vector<std::tuple<QtHighlighter::HighlightType, int, int>> QtHighlighter::c
   return multiLineRanges;
 }
 
-std::vector<std::tuple<QtHighlighter::HighlightType, int, int>> QtHighlighter::createMultiLineRangesForRules(
-    QTextDocument* doc,
-    std::vector<std::tuple<HighlightType, int, int>>* ranges,
-    const HighlightingRule* startRule,
-    const HighlightingRule* endRule) {
-  std::vector<std::tuple<HighlightType, int, int>> multiLineRanges;
-
-  QTextCursor cursorStart(doc);
-  QTextCursor cursorEnd(doc);
+std::vector<QtHighlighter::Range> QtHighlighter::createMultiLineRangesForRules(const QString& text,
+                                                                             const std::vector<Range>& singleLineRanges,
+                                                                             const HighlightingRule& startRule,
+                                                                             const HighlightingRule& endRule) {
+  std::vector<Range> multiLineRanges;
+
+  // range patterns are searched as plain text
+  const QString startPattern = startRule.pattern.pattern();
+  const QString endPattern = endRule.pattern.pattern();
+  if(startPattern.isEmpty() || endPattern.isEmpty()) {
+    return multiLineRanges;
+  }
 
+  int position = 0;
   while(true) {
+    int start = -1;
     while(true) {
-      cursorStart = document()->find(startRule->pattern.pattern(), cursorStart);
-      if(cursorStart.isNull()) {
+      start = static_cast<int>(text.indexOf(startPattern, position, Qt::CaseInsensitive));
+      if(start < 0) {
         break;
       }
 
-      if(!isInRange(cursorStart.selectionEnd() - 1, *ranges)) {
+      position = start + static_cast<int>(startPattern.size());
+      if(!isInRange(position - 1, singleLineRanges)) {
         break;
-      } else {
-        cursorStart.setPosition(cursorStart.selectionEnd() + 1);
       }
+      position++;
     }
 
-    if(cursorStart.isNull()) {
+    if(start < 0) {
       break;
     }
 
-    cursorEnd = document()->find(endRule->pattern.pattern(), cursorStart);
-    if(cursorEnd.isNull()) {
+    const int end = static_cast<int>(text.indexOf(endPattern, position, Qt::CaseInsensitive));
+    if(end < 0) {
       break;
     }
 
-    multiLineRanges.emplace_back(std::make_tuple(startRule->type, cursorStart.selectionStart(), cursorEnd.position()));
-
-    cursorStart = cursorEnd;
+    position = end + static_cast<int>(endPattern.size());
+    multiLineRanges.emplace_back(startRule.type, start, position);
   }
 
   return multiLineRanges;
@@ -354,107 +442,41 @@ QtHighlighter::HighlightingRule::HighlightingRule() {}
 QtHighlighter::HighlightingRule::HighlightingRule(HighlightType type_, const QRegExp& regExp, bool priority_, bool multiLine_)
     : type(type_), pattern(regExp), priority(priority_), multiLine(multiLine_) {}
 
-bool QtHighlighter::isInRange(int pos, const std::vector<std::tuple<HighlightType, int, int>>& ranges) const {
-  for(const std::tuple<HighlightType, int, int>& range : ranges) {
-    if(pos >= std::get<1>(range) && pos <= std::get<2>(range)) {
-      return true;
-    }
-  }
-
-  return false;
+bool QtHighlighter::isInRange(int pos, const std::vector<Range>& sortedRanges) {
+  const auto iterator = std::upper_bound(
+      sortedRanges.begin(), sortedRanges.end(), pos, [](int p, const Range& range) { return p < std::get<1>(range); });
+  return iterator != sortedRanges.begin() && pos <= std::get<2>(*std::prev(iterator));
 }
 
-std::vector<std::tuple<QtHighlighter::HighlightType, int, int>> QtHighlighter::getRangesForRule(const QTextBlock& block,
-                                                                                                const HighlightingRule& rule) const {
-  const int pos = block.position();
-  const QString text = block.text();
+std::vector<QtHighlighter::Range> QtHighlighter::getRangesForRule(const QString& block, int position, const HighlightingRule& rule) {
   QRegExp expression(rule.pattern);
-  int index = expression.indexIn(text);
+  int index = expression.indexIn(block);
 
-  std::vector<std::tuple<HighlightType, int, int>> ranges;
+  std::vector<Range> ranges;
 
   while(index >= 0) {
     const int length = expression.matchedLength();
     if(expression.capturedTexts().size() > 1) {
       const QString cap = expression.capturedTexts()[1];
-      const int start = static_cast<int>(text.indexOf(cap, index));
-      ranges.push_back(std::make_tuple(rule.type, pos + start, pos + start + cap.length()));
+      const int start = static_cast<int>(block.indexOf(cap, index));
+      ranges.emplace_back(rule.type, position + start, position + start + static_cast<int>(cap.length()));
     } else {
-      ranges.push_back(std::make_tuple(rule.type, pos + index, pos + index + length));
+      ranges.emplace_back(rule.type, position + index, position + index + length);
     }
-    index = expression.indexIn(block.text(), index + length);
+    index = expression.indexIn(block, index + std::max(length, 1));
   }
 
   return ranges;
 }
 
-void QtHighlighter::formatBlockForRule(const QTextBlock& block,
-                                       const HighlightingRule& rule,
-                                       std::vector<std::tuple<HighlightType, int, int>>* ranges) {
-  if(s_charFormats.find(rule.type) == s_charFormats.end()) {
+void QtHighlighter::setBlockRanges(std::shared_ptr<const BlockRanges> blockRanges) {
+  // the document may have changed in the meantime
+  if(blockRanges->size() < m_highlightedLines.size()) {
     return;
   }
 
-  const QTextCharFormat& format = s_charFormats.find(rule.type)->second;
-
-  QRegExp expression(rule.pattern);
-  int pos = block.position();
-  int index = expression.indexIn(block.text());
-
-  while(index >= 0) {
-    int length = expression.matchedLength();
-
-    if(!isInRange(pos + index, *ranges)) {
-      applyFormat(pos + index, pos + index + length, format);
-    }
-
-    index = expression.indexIn(block.text(), index + length);
-  }
-}
-
-void QtHighlighter::formatBlockIfInRange(const QTextBlock& block,
-                                         HighlightType type,
-                                         std::vector<std::tuple<HighlightType, int, int>>* ranges) {
-  int startPos = block.position();
-  int endPos = startPos + block.length() - 1;
-
-  if(s_charFormats.find(type) == s_charFormats.end()) {
-    return;
-  }
-
-  const QTextCharFormat& format = s_charFormats.find(type)->second;
-
-  for(auto range : *ranges) {
-    if(type == std::get<0>(range)) {
-      int start = std::max(std::get<1>(range), startPos);
-      int end = std::min(std::get<2>(range), endPos);
-
-      if(start <= end) {
-        applyFormat(start, end, format);
-      }
-    }
-  }
-}
-
-void QtHighlighter::formatBlockIfInRange(const QTextBlock& block, std::vector<std::tuple<HighlightType, int, int>>* ranges) {
-  int startPos = block.position();
-  int endPos = startPos + block.length() - 1;
-
-  for(auto range : *ranges) {
-    HighlightType type = std::get<0>(range);
-    if(s_charFormats.find(type) == s_charFormats.end()) {
-      continue;
-    }
-
-    const QTextCharFormat& format = s_charFormats.find(type)->second;
-
-    int start = std::max(std::get<1>(range), startPos);
-    int end = std::min(std::get<2>(range), endPos);
-
-    if(start <= end) {
-      applyFormat(start, end, format);
-    }
-  }
+  m_blockRanges = std::move(blockRanges);
+  std::fill(m_highlightedLines.begin(), m_highlightedLines.end(), false);
 }
 
 QTextDocument* QtHighlighter::document() const {
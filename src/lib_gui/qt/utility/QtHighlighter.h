@@ -1,10 +1,14 @@
 #ifndef QT_HIGHLIGHTER_H
 #define QT_HIGHLIGHTER_H
 
+#include <functional>
+#include <memory>
+
 #include <QRegExp>
 #include <QTextCharFormat>
 
-class QTextBlock;
+#include "LruCache.h"
+
 class QTextDocument;
 
 class QtHighlighter {
@@ -20,7 +24,13 @@ public:
   QtHighlighter(QTextDocument* parent, const std::wstring& language);
   ~QtHighlighter() = default;
 
-  void highlightDocument();
+  /**
+   * @brief Tokenizes the document on the background scheduler.
+   *
+   * Until the tokens arrive highlightRange() leaves lines plain, so painting never waits. onFinished is called on
+   * the Qt thread once lines can be highlighted. Tokens are cached by language and document content.
+   */
+  void highlightDocument(std::function<void()> onFinished = {});
   void highlightRange(int startLine, int endLine);
 
   void rehighlightLines(const std::vector<int>& lines);
@@ -40,35 +50,45 @@ private:
     bool multiLine = false;
   };
 
-  void createRanges(QTextDocument* doc, const std::vector<HighlightingRule>& quotationRules);
-  std::vector<std::tuple<HighlightType, int, int>> createMultiLineRanges(QTextDocument* doc,
-                                                                         std::vector<std::tuple<HighlightType, int, int>>* ranges);
-  std::vector<std::tuple<QtHighlighter::HighlightType, int, int>> createMultiLineRangesForRules(
-      QTextDocument* doc,
-      std::vector<std::tuple<HighlightType, int, int>>* ranges,
-      const HighlightingRule* startRule,
-      const HighlightingRule* endRule);
+  using Range = std::tuple<HighlightType, int, int>;
+  // Format ranges of each block in the order they are applied.
+  using BlockRanges = std::vector<std::vector<Range>>;
+
+  static std::shared_ptr<const BlockRanges> tokenize(const QString& text, const std::vector<HighlightingRule>& rules);
 
-  bool isInRange(int index, const std::vector<std::tuple<HighlightType, int, int>>& ranges) const;
-  std::vector<std::tuple<HighlightType, int, int>> getRangesForRule(const QTextBlock& block, const HighlightingRule& rule) const;
+  static std::vector<Range> createSingleLineRanges(const QStringList& blocks,
+                                                   const std::vector<int>& blockPositions,
+                                                   const std::vector<HighlightingRule>& rules);
+  static std::vector<Range> createMultiLineRanges(const QString& text,
+                                                  const std::vector<Range>& singleLineRanges,
+                                                  const std::vector<HighlightingRule>& rules);
+  static std::vector<Range> createMultiLineRangesForRules(const QString& text,
+                                                          const std::vector<Range>& singleLineRanges,
+                                                          const HighlightingRule& startRule,
+                                                          const HighlightingRule& endRule);
 
-  void formatBlockForRule(const QTextBlock& block,
-                          const HighlightingRule& rule,
-                          std::vector<std::tuple<HighlightType, int, int>>* ranges);
-  void formatBlockIfInRange(const QTextBlock& block, HighlightType type, std::vector<std::tuple<HighlightType, int, int>>* ranges);
-  void formatBlockIfInRange(const QTextBlock& block, std::vector<std::tuple<HighlightType, int, int>>* ranges);
+  static bool isInRange(int index, const std::vector<Range>& sortedRanges);
+  static std::vector<Range> getRangesForRule(const QString& block, int position, const HighlightingRule& rule);
+
+  void setBlockRanges(std::shared_ptr<const BlockRanges> blockRanges);
 
   QTextDocument* document() const;
 
   static std::map<std::wstring, std::vector<HighlightingRule>> s_highlightingRules;
   static std::map<HighlightType, QTextCharFormat> s_charFormats;
 
+  static constexpr size_t BlockRangesCacheByteBudget = 16 * 1024 * 1024;
+  static LruCache<std::wstring, std::shared_ptr<const BlockRanges>> s_blockRangesCache;
+
   QTextDocument* m_document;
+  std::wstring m_language;
 
   std::vector<HighlightingRule> m_highlightingRules;
-  std::vector<std::tuple<HighlightType, int, int>> m_singleLineRanges;
-  std::vector<std::tuple<HighlightType, int, int>> m_multiLineRanges;
+  std::shared_ptr<const BlockRanges> m_blockRanges;
   std::vector<bool> m_highlightedLines;
+
+  // Only handed out as weak reference, so tokens arriving after destruction are dropped.
+  std::shared_ptr<QtHighlighter*> m_self;
 };
 
 #endif    // QT_HIGHLIGHTER_H
@@ -7,6 +7,7 @@
 #include <QFontDatabase>
 #include <QIcon>
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QWidget>
 
 #include "ColorScheme.h"
@@ -20,6 +21,11 @@
 #include "utilityApp.h"
 #include "utilityString.h"
 
+namespace {
+// Scale of the graph below which node names shrink to a few pixels.
+constexpr qreal GraphDetailLevelOfDetail = 0.4;
+}    // namespace
+
 namespace utility {
 
 QIcon toIcon(const std::wstring& path) {
@@ -318,6 +324,10 @@ QIcon createButtonIcon(const FilePath& iconPath, const std::string& colorId) {
   return icon;
 }
 
+bool isGraphDetailVisible(const QPainter* painter) {
+  return QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()) >= GraphDetailLevelOfDetail;
+}
+
 QtMainWindow* getMainWindowforMainView(ViewLayout* viewLayout) {
   if(const auto* mainView = dynamic_cast<QtMainView*>(viewLayout); nullptr != mainView) {
     return mainView->getMainWindow();
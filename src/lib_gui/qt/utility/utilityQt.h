@@ -4,6 +4,7 @@
 class FilePath;
 class QColor;
 class QIcon;
+class QPainter;
 class QPixmap;
 class QString;
 class QWidget;
@@ -28,6 +29,13 @@ QPixmap colorizePixmap(const QPixmap& pixmap, const QColor& color);
 
 QIcon createButtonIcon(const FilePath& iconPath, const std::string& colorId);
 
+/**
+ * @brief Whether graph items painted with this painter are large enough on screen to show their details.
+ *
+ * Far zoomed out, names and icons are unreadable, so nodes draw as plain rects and edges as straight polylines.
+ */
+bool isGraphDetailVisible(const QPainter* painter);
+
 QtMainWindow* getMainWindowforMainView(ViewLayout* viewLayout);
 
 void copyNewFilesFromDirectory(const QString& src, const QString& dst);
@@ -127,7 +127,7 @@ void QtCodeView::updateSourceLocations(const std::vector<CodeFileParams>& files)
         }
       }
 
-      if(file.fileParams && file.fileParams->hasAllSourceLocations) {
+      if(file.fileParams && (file.fileParams->hasAllSourceLocations || file.fileParams->isVirtualized)) {
         m_widget->updateSourceLocations(*file.fileParams.get());
       }
     }
@@ -199,6 +199,15 @@ void QtDialogView::updateIndexingDialog(size_t startedFileCount,
   });
 }
 
+void QtDialogView::updateIndexingMemoryUsage(size_t usedMemory, size_t memoryBudget) {
+  m_onQtThread([this, usedMemory, memoryBudget]() {
+    auto* window = dynamic_cast<QtIndexingProgressDialog*>(m_windowStack.getTopWindow());
+    if(window) {
+      window->updateMemoryUsage(usedMemory, memoryBudget);
+    }
+  });
+}
+
 void QtDialogView::updateCustomIndexingDialog(size_t startedFileCount,
                                               size_t finishedFileCount,
                                               size_t totalFileCount,
@@ -44,6 +44,7 @@ public:
                             size_t finishedFileCount,
                             size_t totalFileCount,
                             const std::vector<FilePath>& sourcePaths) override;
+  void updateIndexingMemoryUsage(size_t usedMemory, size_t memoryBudget) override;
   void updateCustomIndexingDialog(size_t startedFileCount,
                                   size_t finishedFileCount,
                                   size_t totalFileCount,
@@ -40,6 +40,19 @@
 #include "type/MessageStatus.h"
 #include "utilityQt.h"
 
+namespace {
+// Above this number of nodes and edges the per item animations of a transition make it stutter instead of guiding the eye.
+constexpr size_t MaxAnimatedTransitionItemCount = 1000;
+
+size_t getNodeCountRecursive(const std::list<QtGraphNode*>& nodes) {
+  size_t count = nodes.size();
+  for(const QtGraphNode* node : nodes) {
+    count += getNodeCountRecursive(node->getSubNodes());
+  }
+  return count;
+}
+}    // namespace
+
 QtGraphView::QtGraphView(ViewLayout* viewLayout) : GraphView(viewLayout), m_focusHandler(this) {
   setWidgetWrapper(std::make_shared<QtViewWidgetWrapper>(new QFrame));
 
@@ -363,7 +376,8 @@ void QtGraphView::rebuildGraph(std::shared_ptr<Graph> graph,
     m_scrollToTop = params.scrollToTop;
     m_isIndexedList = params.isIndexedList;
 
-    if(params.animatedTransition && IApplicationSettings::getInstanceRaw()->getUseAnimations() && view->isVisible()) {
+    if(params.animatedTransition && IApplicationSettings::getInstanceRaw()->getUseAnimations() && view->isVisible() &&
+       getNodeCountRecursive(m_nodes) + m_edges.size() <= MaxAnimatedTransitionItemCount) {
       createTransition();
     } else {
       switchToNewGraphData();
@@ -10,6 +10,7 @@
 QtIndexingProgressDialog::QtIndexingProgressDialog(bool /*hideable*/, QWidget* parent)
     : QtProgressBarDialog(0.38F, parent)
     , m_filePathLabel(new QLabel())
+    , m_memoryLabel(new QLabel())
     , m_errorWidget(QtIndexingDialog::createErrorWidget(m_layout)) {
   setSizeGripStyle(false);
 
@@ -20,6 +21,11 @@ QtIndexingProgressDialog::QtIndexingProgressDialog(bool /*hideable*/, QWidget* p
   m_filePathLabel->setAlignment(Qt::AlignRight);
   m_layout->addWidget(m_filePathLabel);
 
+  m_memoryLabel->setObjectName(QStringLiteral("memory"));
+  m_memoryLabel->setAlignment(Qt::AlignRight);
+  m_memoryLabel->hide();
+  m_layout->addWidget(m_memoryLabel);
+
   m_layout->addSpacing(12);
 
 
@@ -85,6 +91,19 @@ void QtIndexingProgressDialog::updateErrorCount(size_t errorCount, size_t fatalC
   }
 }
 
+void QtIndexingProgressDialog::updateMemoryUsage(size_t usedMemory, size_t memoryBudget) {
+  constexpr double OneGb = 1073741824.0;
+
+  QString str = "Memory: " + QString::number(static_cast<double>(usedMemory) / OneGb, 'f', 1) + " GB";
+  if(memoryBudget != 0U) {
+    str += " / " + QString::number(static_cast<double>(memoryBudget) / OneGb, 'f', 1) + " GB (" +
+        QString::number(usedMemory * 100 / memoryBudget) + "%)";
+  }
+
+  m_memoryLabel->setText(str);
+  m_memoryLabel->show();
+}
+
 void QtIndexingProgressDialog::onHidePressed() {
   emit visibleChanged(false);
 }
@@ -14,6 +14,7 @@ public:
 
   void updateIndexingProgress(size_t fileCount, size_t totalFileCount, const FilePath& sourcePath);
   void updateErrorCount(size_t errorCount, size_t fatalCount);
+  void updateMemoryUsage(size_t usedMemory, size_t memoryBudget);
 
 protected:
   void closeEvent(QCloseEvent* event) override;
@@ -24,6 +25,7 @@ private:
   void onStopPressed();
 
   QLabel* m_filePathLabel;
+  QLabel* m_memoryLabel;
   QWidget* m_errorWidget;
   QString m_sourcePath;
 };
\ No newline at end of file
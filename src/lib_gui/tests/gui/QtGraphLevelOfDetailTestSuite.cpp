@@ -0,0 +1,61 @@
+#include "QtGraphLevelOfDetailTestSuite.hpp"
+
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QTest>
+
+#include "QtSimpleTextItem.h"
+#include "utilityQt.h"
+
+namespace {
+// Renders a scene with one text item and returns whether any pixel of the frame was painted.
+bool isTextPainted(qreal zoomFactor) {
+  QGraphicsScene scene;
+  auto* text = new QtSimpleTextItem(nullptr);
+  text->setText(QStringLiteral("XXXXXXXXXX"));
+  scene.addItem(text);
+
+  QImage frame(200, 50, QImage::Format_ARGB32_Premultiplied);
+  frame.fill(Qt::white);
+  {
+    QPainter painter(&frame);
+    const QRectF source(0, 0, frame.width() / zoomFactor, frame.height() / zoomFactor);
+    scene.render(&painter, QRectF(frame.rect()), source, Qt::IgnoreAspectRatio);
+  }
+
+  for(int y = 0; y < frame.height(); y++) {
+    for(int x = 0; x < frame.width(); x++) {
+      if(frame.pixel(x, y) != QColor(Qt::white).rgba()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+}    // namespace
+
+void QtGraphLevelOfDetailTestSuite::detailsAreVisibleAtDefaultZoom() {
+  QImage image(10, 10, QImage::Format_ARGB32_Premultiplied);
+  QPainter painter(&image);
+
+  QVERIFY(utility::isGraphDetailVisible(&painter));
+
+  painter.scale(2.0, 2.0);
+  QVERIFY(utility::isGraphDetailVisible(&painter));
+}
+
+void QtGraphLevelOfDetailTestSuite::detailsAreSkippedWhenZoomedOut() {
+  QImage image(10, 10, QImage::Format_ARGB32_Premultiplied);
+  QPainter painter(&image);
+
+  painter.scale(0.2, 0.2);
+  QVERIFY(!utility::isGraphDetailVisible(&painter));
+}
+
+void QtGraphLevelOfDetailTestSuite::textIsSkippedWhenZoomedOut() {
+  QVERIFY(isTextPainted(1.0));
+  QVERIFY(!isTextPainted(0.2));
+}
+
+QTEST_MAIN(QtGraphLevelOfDetailTestSuite)
@@ -0,0 +1,13 @@
+#pragma once
+#include <QObject>
+
+class QtGraphLevelOfDetailTestSuite : public QObject {
+  Q_OBJECT
+public:
+private slots:
+  void detailsAreVisibleAtDefaultZoom();
+
+  void detailsAreSkippedWhenZoomedOut();
+
+  void textIsSkippedWhenZoomedOut();
+};
@@ -0,0 +1,306 @@
+#include "QtHighlighterTestSuite.hpp"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include <QRegExp>
+#include <QTest>
+#include <QTextBlock>
+#include <QTextCharFormat>
+#include <QTextCursor>
+#include <QTextDocument>
+
+#include "LruCache.h"
+#include "utility.h"
+#define private public
+#include "QtHighlighter.h"
+#undef private
+
+namespace {
+using HighlightType = QtHighlighter::HighlightType;
+using Range = QtHighlighter::Range;
+using Rule = QtHighlighter::HighlightingRule;
+
+const std::wstring Language = L"test";
+
+// Rules like the ones of the C++ syntax highlighting, multi-line ranges are searched as plain text.
+std::vector<Rule> createRules() {
+  return {
+      Rule(HighlightType::KEYWORD, QRegExp(QStringLiteral("\\b(auto|char|const|int|return)\\b")), false),
+      Rule(HighlightType::NUMBER, QRegExp(QStringLiteral("\\b[0-9]+\\b")), false),
+      Rule(HighlightType::FUNCTION, QRegExp(QStringLiteral("\\b[A-Za-z_][A-Za-z0-9_]*(?=\\()")), false),
+      Rule(HighlightType::DIRECTIVE, QRegExp(QStringLiteral("^\\s*#\\s*[a-z]+")), false),
+      Rule(HighlightType::QUOTATION, QRegExp(QStringLiteral("\"(?:[^\"\\\\]|\\\\.)*\"")), true),
+      Rule(HighlightType::COMMENT, QRegExp(QStringLiteral("//.*")), true),
+      Rule(HighlightType::COMMENT, QRegExp(QStringLiteral("/*")), true, true),
+      Rule(HighlightType::COMMENT, QRegExp(QStringLiteral("*/")), true, true),
+      Rule(HighlightType::QUOTATION, QRegExp(QStringLiteral("R\"(")), true, true),
+      Rule(HighlightType::QUOTATION, QRegExp(QStringLiteral(")\"")), true, true),
+  };
+}
+
+QString getColorName(HighlightType type) {
+  return QtHighlighter::s_charFormats[type].foreground().color().name();
+}
+
+// Color of every character of the document, blocks are separated by "|".
+QStringList getCharColorNames(QTextDocument* document) {
+  QStringList colorNames;
+  for(QTextBlock block = document->begin(); block != document->end(); block = block.next()) {
+    for(QTextBlock::iterator it = block.begin(); !it.atEnd(); ++it) {
+      const QTextFragment fragment = it.fragment();
+      for(int i = 0; i < fragment.length(); i++) {
+        colorNames.append(fragment.charFormat().foreground().color().name());
+      }
+    }
+    colorNames.append(QStringLiteral("|"));
+  }
+  return colorNames;
+}
+
+// The highlighting before the tokenizer moved to the background scheduler, it ran the rules on the blocks of the document.
+class DocumentHighlighter {
+public:
+  DocumentHighlighter(QTextDocument* document, std::vector<Rule> rules) : m_document(document), m_rules(std::move(rules)) {}
+
+  void highlight() {
+    applyFormat(0, std::max(m_document->characterCount() - 1, 0), HighlightType::TEXT);
+
+    for(QTextBlock block = m_document->begin(); block != m_document->end(); block = block.next()) {
+      for(const Rule& rule : m_rules) {
+        if(rule.priority && !rule.multiLine) {
+          utility::append(m_singleLineRanges, getRangesForRule(block, rule));
+        }
+      }
+    }
+
+    // remove ranges starting inside others
+    std::map<std::pair<int, int>, size_t> sortedRangesToIndex;
+    for(size_t i = 0; i < m_singleLineRanges.size(); i++) {
+      sortedRangesToIndex.emplace(std::make_pair(std::get<1>(m_singleLineRanges[i]), std::get<2>(m_singleLineRanges[i])), i);
+    }
+    std::set<size_t> indicesToErase;
+    const std::pair<int, int>* topRange = nullptr;
+    for(const auto& p : sortedRangesToIndex) {
+      if(topRange && p.first.first <= topRange->second) {
+        indicesToErase.insert(p.second);
+      } else {
+        topRange = &p.first;
+      }
+    }
+    for(auto it = indicesToErase.rbegin(); it != indicesToErase.rend(); it++) {
+      m_singleLineRanges.erase(m_singleLineRanges.begin() + static_cast<std::ptrdiff_t>(*it));
+    }
+
+    const Rule* startRule = nullptr;
+    for(const Rule& rule : m_rules) {
+      if(rule.priority && rule.multiLine) {
+        if(!startRule) {
+          startRule = &rule;
+        } else if(rule.type == startRule->type) {
+          utility::append(m_multiLineRanges, createMultiLineRanges(*startRule, rule));
+          startRule = nullptr;
+        }
+      }
+    }
+
+    for(QTextBlock block = m_document->begin(); block != m_document->end(); block = block.next()) {
+      applyFormat(block.position(), block.position() + block.length() - 1, HighlightType::TEXT);
+
+      for(const Rule& rule : m_rules) {
+        if(rule.multiLine) {
+          continue;
+        }
+
+        if(rule.priority) {
+          formatBlockIfInRange(block, m_singleLineRanges, &rule.type);
+        } else {
+          formatBlockForRule(block, rule);
+        }
+      }
+
+      formatBlockIfInRange(block, m_multiLineRanges, nullptr);
+    }
+  }
+
+private:
+  static bool isInRange(int pos, const std::vector<Range>& ranges) {
+    return std::any_of(ranges.begin(), ranges.end(), [pos](const Range& range) {
+      return pos >= std::get<1>(range) && pos <= std::get<2>(range);
+    });
+  }
+
+  static std::vector<Range> getRangesForRule(const QTextBlock& block, const Rule& rule) {
+    std::vector<Range> ranges;
+    QRegExp expression(rule.pattern);
+    int index = expression.indexIn(block.text());
+    while(index >= 0) {
+      const int length = expression.matchedLength();
+      if(expression.capturedTexts().size() > 1) {
+        const QString cap = expression.capturedTexts()[1];
+        const int start = static_cast<int>(block.text().indexOf(cap, index));
+        ranges.emplace_back(rule.type, block.position() + start, block.position() + start + static_cast<int>(cap.length()));
+      } else {
+        ranges.emplace_back(rule.type, block.position() + index, block.position() + index + length);
+      }
+      index = expression.indexIn(block.text(), index + length);
+    }
+    return ranges;
+  }
+
+  std::vector<Range> createMultiLineRanges(const Rule& startRule, const Rule& endRule) const {
+    std::vector<Range> ranges;
+    QTextCursor cursorStart(m_document);
+    while(true) {
+      while(true) {
+        cursorStart = m_document->find(startRule.pattern.pattern(), cursorStart);
+        if(cursorStart.isNull() || !isInRange(cursorStart.selectionEnd() - 1, m_singleLineRanges)) {
+          break;
+        }
+        cursorStart.setPosition(cursorStart.selectionEnd() + 1);
+      }
+      if(cursorStart.isNull()) {
+        break;
+      }
+
+      const QTextCursor cursorEnd = m_document->find(endRule.pattern.pattern(), cursorStart);
+      if(cursorEnd.isNull()) {
+        break;
+      }
+
+      ranges.emplace_back(startRule.type, cursorStart.selectionStart(), cursorEnd.position());
+      cursorStart = cursorEnd;
+    }
+    return ranges;
+  }
+
+  void formatBlockForRule(const QTextBlock& block, const Rule& rule) {
+    QRegExp expression(rule.pattern);
+    int index = expression.indexIn(block.text());
+    while(index >= 0) {
+      const int length = expression.matchedLength();
+      if(!isInRange(block.position() + index, m_singleLineRanges)) {
+        applyFormat(block.position() + index, block.position() + index + length, rule.type);
+      }
+      index = expression.indexIn(block.text(), index + length);
+    }
+  }
+
+  // formats the ranges of the given type, or all ranges without a type
+  void formatBlockIfInRange(const QTextBlock& block, const std::vector<Range>& ranges, const HighlightType* type) {
+    const int startPos = block.position();
+    const int endPos = startPos + block.length() - 1;
+    for(const auto& [rangeType, rangeStart, rangeEnd] : ranges) {
+      if(type && *type != rangeType) {
+        continue;
+      }
+      const int start = std::max(rangeStart, startPos);
+      const int end = std::min(rangeEnd, endPos);
+      if(start <= end) {
+        applyFormat(start, end, rangeType);
+      }
+    }
+  }
+
+  void applyFormat(int startPosition, int endPosition, HighlightType type) {
+    QTextCursor cursor(m_document);
+    cursor.setPosition(startPosition);
+    cursor.setPosition(endPosition, QTextCursor::KeepAnchor);
+    cursor.setCharFormat(QtHighlighter::s_charFormats[type]);
+  }
+
+  QTextDocument* m_document;
+  std::vector<Rule> m_rules;
+  std::vector<Range> m_singleLineRanges;
+  std::vector<Range> m_multiLineRanges;
+};
+
+QStringList highlightWithDocumentHighlighter(const QString& text) {
+  QTextDocument document;
+  document.setPlainText(text);
+  DocumentHighlighter(&document, createRules()).highlight();
+  return getCharColorNames(&document);
+}
+
+// Runs the tokenizer on the calling thread and applies its ranges like a painted code field.
+QStringList highlightWithTokens(const QString& text, int endLine = -1) {
+  QTextDocument document;
+  document.setPlainText(text);
+
+  QtHighlighter highlighter(&document, Language);
+  highlighter.applyFormat(0, std::max(document.characterCount() - 1, 0), QtHighlighter::s_charFormats[HighlightType::TEXT]);
+  highlighter.m_highlightedLines.assign(static_cast<size_t>(document.blockCount()), false);
+  highlighter.setBlockRanges(QtHighlighter::tokenize(document.toRawText(), highlighter.m_highlightingRules));
+  highlighter.highlightRange(0, endLine < 0 ? document.blockCount() - 1 : endLine);
+
+  return getCharColorNames(&document);
+}
+}    // namespace
+
+void QtHighlighterTestSuite::initTestCase() {
+  const std::map<HighlightType, const char*> colors = {{HighlightType::COMMENT, "#008000"},
+                                                       {HighlightType::DIRECTIVE, "#800080"},
+                                                       {HighlightType::FUNCTION, "#0000ff"},
+                                                       {HighlightType::KEYWORD, "#000080"},
+                                                       {HighlightType::NUMBER, "#ff0000"},
+                                                       {HighlightType::QUOTATION, "#808000"},
+                                                       {HighlightType::TEXT, "#000000"},
+                                                       {HighlightType::TYPE, "#008080"}};
+  for(const auto& [type, color] : colors) {
+    QTextCharFormat format;
+    format.setForeground(QColor(color));
+    QtHighlighter::s_charFormats[type] = format;
+  }
+
+  // the highlighter only loads the rules files if no rules are set
+  QtHighlighter::s_highlightingRules.emplace(Language, createRules());
+}
+
+void QtHighlighterTestSuite::cleanupTestCase() {
+  QtHighlighter::clearHighlightingRules();
+  QtHighlighter::s_charFormats.clear();
+}
+
+void QtHighlighterTestSuite::tokensMatchDocumentHighlighting_data() {
+  QTest::addColumn<QString>("text");
+
+  QTest::newRow("code") << QStringLiteral("#include <vector>\nint main() {\n  return 42; // answer\n}\n");
+  QTest::newRow("multi-line comment") << QStringLiteral(
+      "int a = 1; /* first\n  \"no string\" 2\n  last */ int b = foo(2);\n");
+  QTest::newRow("comment markers in string") << QStringLiteral(
+      "const char* s = \"/* no comment */\";\nint c = 3; // \"no string\"\n");
+  QTest::newRow("multi-line string") << QStringLiteral(
+      "auto s = R\"(first\nsecond \"quoted\" // no comment\n)\"; int d = 4;\n");
+  QTest::newRow("unterminated comment") << QStringLiteral("int e = 5; /* open\nint f = 6;\n");
+  QTest::newRow("adjacent comments") << QStringLiteral("/* a */ int g; /* b\n*/ int h;\n/**/\n");
+}
+
+void QtHighlighterTestSuite::tokensMatchDocumentHighlighting() {
+  QFETCH(QString, text);
+
+  QCOMPARE(highlightWithTokens(text), highlightWithDocumentHighlighter(text));
+}
+
+void QtHighlighterTestSuite::multiLineCommentIsHighlightedAcrossBlocks() {
+  // "int a; /* x" and "y */ int b;", the block separator is the 12th entry
+  const QStringList colorNames = highlightWithTokens(QStringLiteral("int a; /* x\ny */ int b;"));
+
+  QCOMPARE(colorNames[0], getColorName(HighlightType::KEYWORD));
+  QCOMPARE(colorNames[4], getColorName(HighlightType::TEXT));
+  QCOMPARE(colorNames[7], getColorName(HighlightType::COMMENT));
+  QCOMPARE(colorNames[10], getColorName(HighlightType::COMMENT));
+  QCOMPARE(colorNames[12], getColorName(HighlightType::COMMENT));
+  QCOMPARE(colorNames[15], getColorName(HighlightType::COMMENT));
+  QCOMPARE(colorNames[17], getColorName(HighlightType::KEYWORD));
+}
+
+void QtHighlighterTestSuite::linesPastTheEndAreSkipped() {
+  // "int a;" and "int b;", the block separator is the 7th entry
+  const QStringList colorNames = highlightWithTokens(QStringLiteral("int a;\nint b;"), 5);
+
+  QCOMPARE(colorNames[0], getColorName(HighlightType::KEYWORD));
+  QCOMPARE(colorNames[7], getColorName(HighlightType::KEYWORD));
+}
+
+QTEST_MAIN(QtHighlighterTestSuite)
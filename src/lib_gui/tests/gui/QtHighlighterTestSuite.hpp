@@ -0,0 +1,19 @@
+#pragma once
+#include <QObject>
+
+class QtHighlighterTestSuite : public QObject {
+  Q_OBJECT
+public:
+private slots:
+  void initTestCase();
+
+  void cleanupTestCase();
+
+  void tokensMatchDocumentHighlighting_data();
+
+  void tokensMatchDocumentHighlighting();
+
+  void multiLineCommentIsHighlightedAcrossBlocks();
+
+  void linesPastTheEndAreSkipped();
+};
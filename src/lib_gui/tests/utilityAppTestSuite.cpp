@@ -1,3 +1,7 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "utilityApp.h"
@@ -30,4 +34,35 @@ TEST(utilityAppTestSuite, getOsType) {
 #elif defined(D_LINUX)
   EXPECT_EQ(utility::getOsType(), OsType::Linux);
 #endif
-}
\ No newline at end of file
+}
+
+TEST(utilityAppTestSuite, forEachIndexParallelCallsEveryIndexOnce) {
+  for(const size_t count : {0, 1, 7, 1000}) {
+    std::vector<std::atomic<int>> calls(count);
+    utility::forEachIndexParallel(count, 8, [&calls](size_t index) { calls[index]++; });
+
+    for(const std::atomic<int>& callCount : calls) {
+      EXPECT_EQ(1, callCount);
+    }
+  }
+}
+
+TEST(utilityAppTestSuite, forEachIndexParallelRunsSmallCountsOnCallingThread) {
+  const std::thread::id callingThread = std::this_thread::get_id();
+  utility::forEachIndexParallel(
+      15, 8, [&callingThread](size_t /*index*/) { EXPECT_EQ(callingThread, std::this_thread::get_id()); });
+}
+
+TEST(utilityAppTestSuite, forEachIndexParallelRunsNestedCallsOnWorkerThread) {
+  std::atomic<int> nestedCallsOnOtherThreads = 0;
+  utility::forEachIndexParallel(64, 1, [&nestedCallsOnOtherThreads](size_t /*index*/) {
+    const std::thread::id workerThread = std::this_thread::get_id();
+    utility::forEachIndexParallel(64, 1, [&](size_t /*nestedIndex*/) {
+      if(std::this_thread::get_id() != workerThread) {
+        nestedCallsOnOtherThreads++;
+      }
+    });
+  });
+
+  EXPECT_EQ(0, nestedCallsOnOtherThreads);
+}
@@ -1,8 +1,11 @@
 #include "utilityApp.h"
 
+#include <atomic>
 #include <chrono>
+#include <fstream>
+#include <map>
 #include <mutex>
-#include <set>
+#include <thread>
 
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/io_service.hpp>
@@ -14,6 +17,16 @@
 
 #include <QThread>
 
+#if defined(_WIN32)
+#  include <Windows.h>
+// Windows.h has to be included first
+#  include <psapi.h>
+#elif defined(__APPLE__)
+#  include <mach/mach.h>
+#else
+#  include <unistd.h>
+#endif
+
 #include "logging.h"
 #include "ScopedFunctor.h"
 #include "utilityString.h"
@@ -22,7 +35,8 @@ namespace utility {
 
 std::mutex sRunningProcessesMutex;    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
-std::set<std::shared_ptr<boost::process::child>> sRunningProcesses;    // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+std::map<std::shared_ptr<boost::process::child>, std::vector<std::wstring>> sRunningProcesses;    // process to its arguments
 
 std::filesystem::path searchPath(const std::filesystem::path& bin, bool& isOk) {
   isOk = false;
@@ -97,7 +111,7 @@ ProcessOutput executeProcess(const std::wstring& command,
 
     {
       const std::lock_guard<std::mutex> lock(sRunningProcessesMutex);
-      sRunningProcesses.insert(process);
+      sRunningProcesses.emplace(process, arguments);
     }
 
     [[maybe_unused]] ScopedFunctor const remover([process]() {
@@ -190,11 +204,20 @@ ProcessOutput executeProcess(const std::wstring& command,
 
 void killRunningProcesses() {
   const std::lock_guard<std::mutex> lock(sRunningProcessesMutex);
-  for(const auto& process : sRunningProcesses) {
+  for(const auto& [process, processArguments] : sRunningProcesses) {
     process->terminate();
   }
 }
 
+void killRunningProcesses(const std::vector<std::wstring>& arguments) {
+  const std::lock_guard<std::mutex> lock(sRunningProcessesMutex);
+  for(const auto& [process, processArguments] : sRunningProcesses) {
+    if(processArguments == arguments) {
+      process->terminate();
+    }
+  }
+}
+
 int getIdealThreadCount() {
   int threadCount = QThread::idealThreadCount();
   if constexpr(getOsType() == OsType::Windows) {
@@ -203,6 +226,59 @@ int getIdealThreadCount() {
   return std::max(1, threadCount);
 }
 
+void forEachIndexParallel(size_t count, size_t minCountPerThread, const std::function<void(size_t)>& func) {
+  thread_local bool isWorkerThread = false;
+
+  const size_t threadCount = isWorkerThread ?
+      1 :
+      std::min(static_cast<size_t>(getIdealThreadCount()), count / std::max<size_t>(minCountPerThread, 1));
+  if(threadCount < 2) {
+    for(size_t i = 0; i < count; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> nextIndex = 0;
+  std::vector<std::thread> threads;
+  for(size_t i = 0; i < threadCount; i++) {
+    threads.emplace_back([&nextIndex, &func, count]() {
+      isWorkerThread = true;
+      for(size_t index = nextIndex++; index < count; index = nextIndex++) {
+        func(index);
+      }
+    });
+  }
+
+  for(std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+size_t getResidentMemorySize() {
+#if defined(_WIN32)
+  PROCESS_MEMORY_COUNTERS counters;
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) != 0) {
+    return counters.WorkingSetSize;
+  }
+#elif defined(__APPLE__)
+  mach_task_basic_info info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+    return info.resident_size;
+  }
+#else
+  // second field of statm is the resident page count
+  std::ifstream statm("/proc/self/statm");
+  size_t totalPages = 0;
+  size_t residentPages = 0;
+  if(statm >> totalPages >> residentPages) {
+    return residentPages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+#endif
+  return 0;
+}
+
 std::string getAppArchTypeString() {
   return "64";
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include <filesystem>
+#include <functional>
 #include <string>
 
 #include "ApplicationArchitectureType.h"
@@ -27,8 +28,27 @@ ProcessOutput executeProcess(const std::wstring& command,
 
 void killRunningProcesses();
 
+/**
+ * @brief Terminates the running processes that were started with exactly these arguments.
+ */
+void killRunningProcesses(const std::vector<std::wstring>& arguments);
+
 int getIdealThreadCount();
 
+/**
+ * @brief Calls the function for every index in [0, count) on worker threads.
+ *
+ * The threads pick the next index when they are done, so indices that take much longer than others do not hold up a
+ * whole share of the work. Runs on the calling thread if fewer than two threads would get minCountPerThread indices,
+ * and when called from a worker thread of an enclosing call.
+ */
+void forEachIndexParallel(size_t count, size_t minCountPerThread, const std::function<void(size_t)>& func);
+
+/**
+ * @brief Resident set size of the calling process in bytes, 0 if it cannot be determined.
+ */
+size_t getResidentMemorySize();
+
 constexpr OsType getOsType() {
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
   return OsType::Windows;
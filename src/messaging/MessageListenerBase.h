@@ -23,7 +23,7 @@ public:
   }
 
   void handleMessageBase(MessageBase* pMessage) {
-    if(m_alive) {
+    if(m_alive && !skipsMessage(*pMessage)) {
       doHandleMessageBase(pMessage);
     }
   }
@@ -36,6 +36,13 @@ public:
     return 0;
   }
 
+  /**
+   * @brief Lets a listener drop messages whose effect it already has, e.g. replays covered by a restored snapshot.
+   */
+  virtual bool skipsMessage(const MessageBase& /*message*/) const {
+    return false;
+  }
+
 private:
   virtual std::string doGetType() const = 0;
   virtual void doHandleMessageBase(MessageBase*) = 0;
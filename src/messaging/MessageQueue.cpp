@@ -1,20 +1,20 @@
 #include "MessageQueue.h"
 
-#include <chrono>
 #include <mutex>
 #include <thread>
 
 #include <range/v3/algorithm/find.hpp>
-#include <range/v3/algorithm/find_if.hpp>
 #include <range/v3/algorithm/for_each.hpp>
 
 #include "../../../scheduling/TaskGroupParallel.h"
 #include "../../../scheduling/TaskGroupSequence.h"
 #include "../../../scheduling/TaskLambda.h"
 #include "logging.h"
+#include "MessageActivateBase.h"
 #include "MessageBase.h"
 #include "MessageFilter.h"
 #include "MessageListenerBase.h"
+#include "StorageQueryToken.h"
 #include "TabId.h"
 
 IMessageQueue::Ptr IMessageQueue::sInstance;
@@ -24,43 +24,66 @@ MessageQueue::MessageQueue() noexcept = default;
 
 MessageQueue::~MessageQueue() noexcept {
   const std::scoped_lock<std::mutex> lock(mListenersMutex);
-  ranges::for_each(mListeners, [](auto& listener) { listener->removedListener(); });
-  mListeners.clear();
+  ranges::for_each(mListenersById, [](auto& listener) { listener.second->removedListener(); });
+  mListenersById.clear();
+  mListenersByType.clear();
+  mListenerTypes.clear();
+  mUnindexedListeners.clear();
 }
 
 void MessageQueue::registerListener(MessageListenerBase* listener) noexcept {
   const std::scoped_lock<std::mutex> lock(mListenersMutex);
-  if(ranges::find(mListeners, listener) != mListeners.end()) {
+  if(!mListenersById.emplace(listener->getId(), listener).second) {
     return;
   }
-  mListeners.push_back(listener);
+  mUnindexedListeners.push_back(listener);
 }
 
 void MessageQueue::unregisterListener(MessageListenerBase* listener) noexcept {
   const std::scoped_lock<std::mutex> lock(mListenersMutex);
-  if(auto found = ranges::find(mListeners, listener); found != mListeners.end()) {
-    mListeners.erase(found);
-
-    // TODO(Hussein): That sound fishy for me. It need `mListenersMutex`
-    const auto index = static_cast<size_t>(std::distance(mListeners.begin(), found));
-    // mCurrentListenerIndex and mListenersLength need to be updated in case this happens
-    // while a message is handled.
-    if(index <= mCurrentListenerIndex) {
-      mCurrentListenerIndex--;
-    }
+  if(mListenersById.erase(listener->getId()) == 0) {
+    LOG_ERROR("Listener was not found");
+    return;
+  }
 
-    if(index < mListenersLength) {
-      mListenersLength--;
-    }
+  if(auto found = ranges::find(mUnindexedListeners, listener); found != mUnindexedListeners.end()) {
+    mUnindexedListeners.erase(found);
+    return;
+  }
+
+  auto type = mListenerTypes.find(listener);
+  if(type == mListenerTypes.end()) {
+    return;
   }
 
-  LOG_ERROR("Listener was not found");
+  std::vector<MessageListenerBase*>& listeners = mListenersByType[type->second];
+  mListenerTypes.erase(type);
+
+  if(auto found = ranges::find(listeners, listener); found != listeners.end()) {
+    const auto index = static_cast<size_t>(std::distance(listeners.begin(), found));
+    listeners.erase(found);
+
+    // Dispatches of a message to these listeners need to be updated in case this happens while the message is handled.
+    for(Dispatch* dispatch : mDispatches) {
+      if(dispatch->listeners != &listeners) {
+        continue;
+      }
+
+      if(index < dispatch->nextIndex) {
+        dispatch->nextIndex--;
+      }
+
+      if(index < dispatch->length) {
+        dispatch->length--;
+      }
+    }
+  }
 }
 
 MessageListenerBase* MessageQueue::getListenerById(Id listenerId) const noexcept {
   const std::scoped_lock<std::mutex> lock(mListenersMutex);
-  auto found = ranges::find_if(mListeners, [listenerId](auto* listener) { return listener->getId() == listenerId; });
-  return found == mListeners.end() ? nullptr : *found;
+  auto found = mListenersById.find(listenerId);
+  return found == mListenersById.end() ? nullptr : found->second;
 }
 
 void MessageQueue::addMessageFilter(std::shared_ptr<MessageFilter> filter) noexcept {
@@ -71,11 +94,14 @@ void MessageQueue::addMessageFilter(std::shared_ptr<MessageFilter> filter) noexc
 }
 
 void MessageQueue::pushMessage(std::shared_ptr<MessageBase> message) noexcept {
-  const std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
-  if(ranges::find(mMessageBuffer, message) != mMessageBuffer.end()) {
-    return;
+  {
+    const std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
+    if(!mQueuedMessages.insert(message.get()).second) {
+      return;
+    }
+    mMessageBuffer.push_back(std::move(message));
   }
-  mMessageBuffer.push_back(std::move(message));
+  mMessageBufferCondition.notify_one();
 }
 
 void MessageQueue::processMessage(const std::shared_ptr<MessageBase>& message, bool asNextTask) noexcept {
@@ -83,6 +109,13 @@ void MessageQueue::processMessage(const std::shared_ptr<MessageBase>& message, b
     LOG_INFO(L"send " + message->str());
   }
 
+  // A new activation of a tab makes the storage queries still running for the previous one obsolete, unless it builds
+  // upon the content the previous one shows.
+  if(message->getSchedulerId() != 0 && !message->keepContent() &&
+     dynamic_cast<const MessageActivateBase*>(message.get()) != nullptr) {
+    StorageQueryToken::supersede(message->getSchedulerId(), message->getId());
+  }
+
   if(mSendMessagesAsTasks && message->sendAsTask()) {
     sendMessageAsTask(message, asNextTask);
     return;
@@ -92,9 +125,9 @@ void MessageQueue::processMessage(const std::shared_ptr<MessageBase>& message, b
 }
 
 void MessageQueue::startMessageLoopThreaded() noexcept {
+  mThreadIsRunning = true;
   // TODO(Hussein): Remove `detach()`
   std::thread(&MessageQueue::startMessageLoop, this).detach();
-  mThreadIsRunning = true;
 }
 
 void MessageQueue::startMessageLoop() noexcept {
@@ -107,17 +140,19 @@ void MessageQueue::startMessageLoop() noexcept {
   while(true) {
     processMessages();
 
+    std::unique_lock<std::mutex> lock(mMessageBufferMutex);
+    mMessageBufferCondition.wait(lock, [this]() { return !mMessageBuffer.empty() || !mLoopIsRunning; });
+
     if(!mLoopIsRunning) {
       break;
     }
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(25ms);
   }
 
-  if(mThreadIsRunning) {
+  {
+    const std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
     mThreadIsRunning = false;
   }
+  mLoopStoppedCondition.notify_all();
 }
 
 void MessageQueue::stopMessageLoop() noexcept {
@@ -125,16 +160,15 @@ void MessageQueue::stopMessageLoop() noexcept {
     LOG_WARNING("Loop is not running");
   }
 
-  mLoopIsRunning = false;
-
-  while(true) {
-    if(!mThreadIsRunning) {
-      break;
-    }
-
-    using namespace std::chrono_literals;
-    std::this_thread::sleep_for(25ms);
+  {
+    // changed while holding the mutex, so the loop can't miss the wake up between checking and waiting
+    const std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
+    mLoopIsRunning = false;
   }
+  mMessageBufferCondition.notify_all();
+
+  std::unique_lock<std::mutex> lock(mMessageBufferMutex);
+  mLoopStoppedCondition.wait(lock, [this]() { return !mThreadIsRunning; });
 }
 
 bool MessageQueue::loopIsRunning() const noexcept {
@@ -156,6 +190,7 @@ void MessageQueue::processMessages() {
     {
       const std::scoped_lock<std::mutex> lock(mMessageBufferMutex);
 
+      const size_t messageCount = mMessageBuffer.size();
       ranges::for_each(mFilters, [this](const auto& filter) {
         if(mMessageBuffer.empty()) {
           return;
@@ -164,12 +199,19 @@ void MessageQueue::processMessages() {
         filter->filter(&mMessageBuffer);
       });
 
+      // filters only drop messages
+      if(mMessageBuffer.size() != messageCount) {
+        mQueuedMessages.clear();
+        ranges::for_each(mMessageBuffer, [this](const auto& queuedMessage) { mQueuedMessages.insert(queuedMessage.get()); });
+      }
+
       if(mMessageBuffer.empty()) {
         break;
       }
 
       message = mMessageBuffer.front();
       mMessageBuffer.pop_front();
+      mQueuedMessages.erase(message.get());
     }
 
     processMessage(message, false);
@@ -178,28 +220,36 @@ void MessageQueue::processMessages() {
 
 void MessageQueue::sendMessage(const std::shared_ptr<MessageBase>& message) {
   const std::scoped_lock<std::mutex> lock(mListenersMutex);
+  indexListeners();
+
+  auto listeners = mListenersByType.find(message->getType());
+  if(listeners == mListenersByType.end()) {
+    return;
+  }
 
-  // mListenersLength is saved, so that new listeners registered within message handling don't
-  // get the current message and the length can be reduced when a listener gets unregistered.
-  mListenersLength = mListeners.size();
+  // The length is saved, so that new listeners registered within message handling don't get the current message.
+  // Only the vector is used from here on, registering a new message type can rehash the map and invalidate the iterator.
+  Dispatch dispatch;
+  dispatch.listeners = &listeners->second;
+  dispatch.length = dispatch.listeners->size();
+  mDispatches.push_back(&dispatch);
 
-  // The currentListenerIndex holds the index of the current listener being handled, so it can be
-  // changed when a listener gets removed while message handling.
-  for(mCurrentListenerIndex = 0; mCurrentListenerIndex < mListenersLength; ++mCurrentListenerIndex) {
-    MessageListenerBase* listener = mListeners[mCurrentListenerIndex];
+  while(dispatch.nextIndex < dispatch.length) {
+    MessageListenerBase* listener = (*dispatch.listeners)[dispatch.nextIndex++];
 
-    if(listener->getType() == message->getType() &&
-       (message->getSchedulerId() == 0 || listener->getSchedulerId() == 0 ||
-        listener->getSchedulerId() == message->getSchedulerId())) {
+    if(message->getSchedulerId() == 0 || listener->getSchedulerId() == 0 ||
+       listener->getSchedulerId() == message->getSchedulerId()) {
       // The listenersMutex gets unlocked so changes to listeners are possible while message handling.
       mListenersMutex.unlock();
       listener->handleMessageBase(message.get());
       mListenersMutex.lock();
     }
   }
+
+  mDispatches.erase(ranges::find(mDispatches, &dispatch));
 }
 
-void MessageQueue::sendMessageAsTask(const std::shared_ptr<MessageBase>& message, bool asNextTask) const {
+void MessageQueue::sendMessageAsTask(const std::shared_ptr<MessageBase>& message, bool asNextTask) {
   std::shared_ptr<TaskGroup> taskGroup;
   if(message->isParallel()) {
     taskGroup = std::make_shared<TaskGroupParallel>();
@@ -209,17 +259,20 @@ void MessageQueue::sendMessageAsTask(const std::shared_ptr<MessageBase>& message
 
   {
     const std::scoped_lock<std::mutex> lock(mListenersMutex);
-    for(auto* pListener : mListeners) {
-      if(pListener->getType() == message->getType() &&
-         (message->getSchedulerId() == 0 || pListener->getSchedulerId() == 0 ||
-          pListener->getSchedulerId() == message->getSchedulerId())) {
-        const Id listenerId = pListener->getId();
-        taskGroup->addTask(std::make_shared<TaskLambda>([listenerId, message]() {
-          auto* pInnerListener = MessageQueue::getInstance()->getListenerById(listenerId);
-          if(pInnerListener != nullptr) {
-            pInnerListener->handleMessageBase(message.get());
-          }
-        }));
+    indexListeners();
+
+    if(auto listeners = mListenersByType.find(message->getType()); listeners != mListenersByType.end()) {
+      for(auto* pListener : listeners->second) {
+        if(message->getSchedulerId() == 0 || pListener->getSchedulerId() == 0 ||
+           pListener->getSchedulerId() == message->getSchedulerId()) {
+          const Id listenerId = pListener->getId();
+          taskGroup->addTask(std::make_shared<TaskLambda>([listenerId, message]() {
+            auto* pInnerListener = MessageQueue::getInstance()->getListenerById(listenerId);
+            if(pInnerListener != nullptr) {
+              pInnerListener->handleMessageBase(message.get());
+            }
+          }));
+        }
       }
     }
   }
@@ -235,4 +288,13 @@ void MessageQueue::sendMessageAsTask(const std::shared_ptr<MessageBase>& message
     Task::dispatch(schedulerId, taskGroup);
   }
 }
+
+void MessageQueue::indexListeners() {
+  for(MessageListenerBase* listener : mUnindexedListeners) {
+    std::string type = listener->getType();
+    mListenersByType[type].push_back(listener);
+    mListenerTypes.emplace(listener, std::move(type));
+  }
+  mUnindexedListeners.clear();
+}
 }    // namespace details
\ No newline at end of file
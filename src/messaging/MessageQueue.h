@@ -1,9 +1,13 @@
 #pragma once
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "GlobalId.hpp"
@@ -94,22 +98,48 @@ public:
   void setSendMessagesAsTasks(bool sendMessagesAsTasks) noexcept override;
 
 private:
+  /**
+   * @brief Progress of one message through the listeners of its type.
+   *
+   * nextIndex and length are adjusted when a listener gets unregistered while the message is handled, so the remaining
+   * listeners still get it. Listeners registered meanwhile are not part of the dispatch.
+   */
+  struct Dispatch {
+    const std::vector<MessageListenerBase*>* listeners = nullptr;
+    size_t nextIndex = 0;
+    size_t length = 0;
+  };
+
   void processMessages();
   void sendMessage(const std::shared_ptr<MessageBase>& message);
-  void sendMessageAsTask(const std::shared_ptr<MessageBase>& message, bool asNextTask) const;
+  void sendMessageAsTask(const std::shared_ptr<MessageBase>& message, bool asNextTask);
+
+  /**
+   * @brief Sorts the newly registered listeners in by their message type, needs mListenersMutex.
+   *
+   * The type is not known yet while registering, because listeners register from the base class constructor.
+   */
+  void indexListeners();
 
   MessageBufferType mMessageBuffer;
-  std::vector<MessageListenerBase*> mListeners;
+  std::unordered_set<const MessageBase*> mQueuedMessages;
   std::vector<std::shared_ptr<MessageFilter>> mFilters;
 
-  size_t mCurrentListenerIndex = 0;
-  size_t mListenersLength = 0;
+  // listeners of each message type in the order of their registration
+  std::unordered_map<std::string, std::vector<MessageListenerBase*>> mListenersByType;
+  std::unordered_map<const MessageListenerBase*, std::string> mListenerTypes;
+  std::unordered_map<Id, MessageListenerBase*> mListenersById;
+  std::vector<MessageListenerBase*> mUnindexedListeners;
+
+  std::vector<Dispatch*> mDispatches;
 
   std::atomic_bool mLoopIsRunning = false;
   std::atomic_bool mThreadIsRunning = false;
 
   mutable std::mutex mMessageBufferMutex;
   mutable std::mutex mListenersMutex;
+  std::condition_variable mMessageBufferCondition;
+  std::condition_variable mLoopStoppedCondition;
 
   bool mSendMessagesAsTasks = false;
 };
@@ -0,0 +1,177 @@
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../Message.h"
+#include "../MessageListener.h"
+#include "../MessageQueue.h"
+
+namespace {
+class TestMessageA : public Message<TestMessageA> {
+public:
+  static const std::string getStaticType() {
+    return "TestMessageA";
+  }
+};
+
+class TestMessageB : public Message<TestMessageB> {
+public:
+  static const std::string getStaticType() {
+    return "TestMessageB";
+  }
+};
+
+template <typename MessageType>
+class TestListener : public MessageListener<MessageType> {
+public:
+  TestListener(std::vector<int>* calls_, int number_) : calls(*calls_), number(number_) {}
+
+  void handleMessage(MessageType* /*pMessage*/) override {
+    calls.push_back(number);
+    if(onMessage) {
+      onMessage();
+    }
+  }
+
+  std::vector<int>& calls;
+  int number;
+  std::function<void()> onMessage;
+};
+
+class MessageQueueFix : public testing::Test {
+public:
+  void SetUp() override {
+    IMessageQueue::setInstance(std::make_shared<details::MessageQueue>());
+  }
+
+  void TearDown() override {
+    IMessageQueue::setInstance(nullptr);
+  }
+
+  static void send(std::shared_ptr<MessageBase> message) {
+    IMessageQueue::getInstance()->processMessage(message, false);
+  }
+
+  std::vector<int> calls;
+};
+}    // namespace
+
+TEST_F(MessageQueueFix, messageIsSentToListenersInRegistrationOrder) {
+  TestListener<TestMessageA> first(&calls, 1);
+  TestListener<TestMessageA> second(&calls, 2);
+  TestListener<TestMessageA> third(&calls, 3);
+
+  send(std::make_shared<TestMessageA>());
+
+  EXPECT_EQ(std::vector<int>({1, 2, 3}), calls);
+}
+
+TEST_F(MessageQueueFix, messageIsOnlySentToListenersOfItsType) {
+  TestListener<TestMessageA> listenerA(&calls, 1);
+  TestListener<TestMessageB> listenerB(&calls, 2);
+
+  send(std::make_shared<TestMessageB>());
+  send(std::make_shared<TestMessageA>());
+
+  EXPECT_EQ(std::vector<int>({2, 1}), calls);
+}
+
+TEST_F(MessageQueueFix, destroyedListenerDoesNotGetMessages) {
+  TestListener<TestMessageA> first(&calls, 1);
+  auto second = std::make_unique<TestListener<TestMessageA>>(&calls, 2);
+  send(std::make_shared<TestMessageA>());
+  second.reset();
+
+  send(std::make_shared<TestMessageA>());
+
+  EXPECT_EQ(std::vector<int>({1, 2, 1}), calls);
+}
+
+TEST_F(MessageQueueFix, listenerRegisteredWhileHandlingDoesNotGetCurrentMessage) {
+  std::unique_ptr<TestListener<TestMessageA>> added;
+  TestListener<TestMessageA> first(&calls, 1);
+  first.onMessage = [this, &added]() {
+    if(!added) {
+      added = std::make_unique<TestListener<TestMessageA>>(&calls, 2);
+    }
+  };
+
+  send(std::make_shared<TestMessageA>());
+  EXPECT_EQ(std::vector<int>({1}), calls);
+
+  send(std::make_shared<TestMessageA>());
+  EXPECT_EQ(std::vector<int>({1, 1, 2}), calls);
+}
+
+TEST_F(MessageQueueFix, listenerRemovedWhileHandlingIsSkipped) {
+  TestListener<TestMessageA> first(&calls, 1);
+  auto second = std::make_unique<TestListener<TestMessageA>>(&calls, 2);
+  TestListener<TestMessageA> third(&calls, 3);
+  first.onMessage = [&second]() { second.reset(); };
+
+  send(std::make_shared<TestMessageA>());
+
+  EXPECT_EQ(std::vector<int>({1, 3}), calls);
+}
+
+TEST_F(MessageQueueFix, listenerRemovingItselfWhileHandlingDoesNotSkipOthers) {
+  auto first = std::make_unique<TestListener<TestMessageA>>(&calls, 1);
+  TestListener<TestMessageA> second(&calls, 2);
+  first->onMessage = [&first]() {
+    IMessageQueue::getInstance()->unregisterListener(first.get());
+    first->removedListener();
+  };
+
+  send(std::make_shared<TestMessageA>());
+  send(std::make_shared<TestMessageA>());
+
+  EXPECT_EQ(std::vector<int>({1, 2, 2}), calls);
+}
+
+TEST_F(MessageQueueFix, messagePushedTwiceIsQueuedOnce) {
+  auto message = std::make_shared<TestMessageA>();
+  IMessageQueue::getInstance()->pushMessage(message);
+  IMessageQueue::getInstance()->pushMessage(message);
+  IMessageQueue::getInstance()->pushMessage(std::make_shared<TestMessageA>());
+
+  TestListener<TestMessageA> listener(&calls, 1);
+  IMessageQueue::getInstance()->startMessageLoopThreaded();
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while(IMessageQueue::getInstance()->hasMessagesQueued() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::yield();
+  }
+  IMessageQueue::getInstance()->stopMessageLoop();
+
+  EXPECT_EQ(std::vector<int>({1, 1}), calls);
+}
+
+TEST_F(MessageQueueFix, runningLoopHandlesPushedMessageAndStops) {
+  std::mutex mutex;
+  std::condition_variable handled;
+  bool wasHandled = false;
+
+  TestListener<TestMessageA> listener(&calls, 1);
+  listener.onMessage = [&]() {
+    const std::scoped_lock<std::mutex> lock(mutex);
+    wasHandled = true;
+    handled.notify_all();
+  };
+
+  IMessageQueue::getInstance()->startMessageLoopThreaded();
+  IMessageQueue::getInstance()->pushMessage(std::make_shared<TestMessageA>());
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    EXPECT_TRUE(handled.wait_for(lock, std::chrono::seconds(5), [&wasHandled]() { return wasHandled; }));
+  }
+
+  IMessageQueue::getInstance()->stopMessageLoop();
+  EXPECT_FALSE(IMessageQueue::getInstance()->loopIsRunning());
+}
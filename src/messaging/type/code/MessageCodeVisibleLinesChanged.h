@@ -0,0 +1,26 @@
+#pragma once
+// internal
+#include "FilePath.h"
+#include "Message.h"
+#include "TabId.h"
+
+class MessageCodeVisibleLinesChanged final : public Message<MessageCodeVisibleLinesChanged> {
+public:
+  MessageCodeVisibleLinesChanged(const FilePath& filePath_, size_t startLineNumber_, size_t endLineNumber_)
+      : filePath(filePath_), startLineNumber(startLineNumber_), endLineNumber(endLineNumber_) {
+    setIsLogged(false);
+    setSchedulerId(TabId::currentTab());
+  }
+
+  static const std::string getStaticType() {
+    return "MessageCodeVisibleLinesChanged";
+  }
+
+  void print(std::wostream& ostream) const override {
+    ostream << filePath.wstr() << L" [" << startLineNumber << L", " << endLineNumber << L"]";
+  }
+
+  const FilePath filePath;
+  const size_t startLineNumber;
+  const size_t endLineNumber;
+};
@@ -0,0 +1,137 @@
+#include "BenchmarkData.h"
+
+#include <algorithm>
+
+#include "DefinitionKind.h"
+#include "Edge.h"
+#include "IntermediateStorage.h"
+#include "LocationType.h"
+#include "NameHierarchy.h"
+#include "NodeKind.h"
+
+namespace benchmark_data {
+namespace {
+constexpr size_t SymbolsPerClass = 20;
+constexpr size_t ClassesPerNamespace = 50;
+constexpr size_t SymbolsPerFile = 100;
+
+const std::vector<std::wstring> ClassWords = {
+    L"Widget", L"Controller", L"Storage", L"Parser", L"Node", L"Graph", L"Buffer", L"Index", L"Token", L"Filter"};
+const std::vector<std::wstring> FunctionWords = {
+    L"update", L"get", L"set", L"create", L"find", L"remove", L"process", L"handle", L"build", L"clear"};
+const std::vector<std::wstring> ParameterTypes = {L"()", L"(int)", L"(const std::string &)", L"(Id, bool)"};
+}    // namespace
+
+std::vector<NameHierarchy> createNameHierarchies(size_t symbolCount) {
+  Random random;
+  std::vector<NameHierarchy> names;
+  names.reserve(symbolCount);
+
+  for(size_t i = 0; i < symbolCount; i++) {
+    const size_t classIndex = i / SymbolsPerClass;
+    const size_t namespaceIndex = classIndex / ClassesPerNamespace;
+
+    NameHierarchy name(NAME_DELIMITER_CXX);
+    name.push(L"ns_" + std::to_wstring(namespaceIndex));
+    name.push(ClassWords[classIndex % ClassWords.size()] + L"_" + std::to_wstring(classIndex));
+    name.push(NameElement(FunctionWords[random.next(FunctionWords.size())] + L"_" + std::to_wstring(i),
+                          L"void",
+                          ParameterTypes[random.next(ParameterTypes.size())]));
+    names.push_back(std::move(name));
+  }
+  return names;
+}
+
+std::vector<std::wstring> createSerializedNames(size_t symbolCount) {
+  std::vector<std::wstring> serializedNames;
+  serializedNames.reserve(symbolCount);
+  for(const NameHierarchy& name : createNameHierarchies(symbolCount)) {
+    serializedNames.push_back(NameHierarchy::serialize(name));
+  }
+  return serializedNames;
+}
+
+std::vector<std::wstring> createQualifiedNames(size_t symbolCount) {
+  std::vector<std::wstring> qualifiedNames;
+  qualifiedNames.reserve(symbolCount);
+  for(const NameHierarchy& name : createNameHierarchies(symbolCount)) {
+    qualifiedNames.push_back(name.getQualifiedName());
+  }
+  return qualifiedNames;
+}
+
+std::wstring createSourceText(size_t symbolCount) {
+  std::wstring text;
+  for(const NameHierarchy& name : createNameHierarchies(symbolCount)) {
+    text += name.getQualifiedNameWithSignature() + L" {}\n";
+  }
+  return text;
+}
+
+std::vector<std::wstring> createFilePaths(size_t fileCount) {
+  Random random;
+  std::vector<std::wstring> filePaths;
+  filePaths.reserve(fileCount);
+
+  for(size_t i = 0; i < fileCount; i++) {
+    std::wstring path = L"/home/user/project/src";
+    if(random.next(5) == 0) {
+      path += L"/external";
+    }
+    path += L"/module_" + std::to_wstring(i / 50) + L"/" + ClassWords[i % ClassWords.size()] + L"_" + std::to_wstring(i);
+    path += (random.next(2) == 0) ? L".h" : L".cpp";
+    filePaths.push_back(std::move(path));
+  }
+  return filePaths;
+}
+
+std::shared_ptr<IntermediateStorage> createIntermediateStorage(size_t symbolCount) {
+  Random random;
+  auto storage = std::make_shared<IntermediateStorage>();
+
+  const std::vector<std::wstring> filePaths = createFilePaths((symbolCount + SymbolsPerFile - 1) / SymbolsPerFile);
+  std::vector<Id> fileIds;
+  fileIds.reserve(filePaths.size());
+  for(const std::wstring& filePath : filePaths) {
+    const Id fileId = storage->addNode(StorageNodeData(
+                                           nodeKindToInt(NODE_FILE),
+                                           NameHierarchy::serialize(NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+                          .first;
+    storage->addFile(StorageFile(fileId, filePath, L"cpp", "2024-01-01 00:00:00", true, true));
+    fileIds.push_back(fileId);
+  }
+
+  const std::vector<std::wstring> serializedNames = createSerializedNames(symbolCount);
+  std::vector<Id> symbolIds;
+  symbolIds.reserve(serializedNames.size());
+  for(size_t i = 0; i < serializedNames.size(); i++) {
+    const Id symbolId = storage->addNode(StorageNodeData(nodeKindToInt(NODE_FUNCTION), serializedNames[i])).first;
+    storage->addSymbol(StorageSymbol(symbolId, definitionKindToInt(DEFINITION_EXPLICIT)));
+    symbolIds.push_back(symbolId);
+
+    const Id fileId = fileIds[i / SymbolsPerFile];
+    const size_t line = i % SymbolsPerFile + 1;
+    const Id locationId = storage->addSourceLocation(
+        StorageSourceLocationData(fileId, line, 6, line, 20, locationTypeToInt(LOCATION_TOKEN)));
+    storage->addOccurrence(StorageOccurrence(symbolId, locationId));
+  }
+
+  // every function calls two others, mostly near by like in real code
+  for(size_t i = 0; i < symbolIds.size(); i++) {
+    for(size_t j = 0; j < 2; j++) {
+      const size_t callee = (random.next(4) == 0) ? random.next(symbolIds.size())
+                                                  : std::min(symbolIds.size() - 1, i + 1 + random.next(SymbolsPerClass));
+      const Id edgeId = storage->addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), symbolIds[i], symbolIds[callee]));
+
+      const Id fileId = fileIds[i / SymbolsPerFile];
+      const size_t line = i % SymbolsPerFile + 1;
+      const Id locationId = storage->addSourceLocation(
+          StorageSourceLocationData(fileId, line, 30 + j * 20, line, 45 + j * 20, locationTypeToInt(LOCATION_TOKEN)));
+      storage->addOccurrence(StorageOccurrence(edgeId, locationId));
+    }
+  }
+
+  return storage;
+}
+
+}    // namespace benchmark_data
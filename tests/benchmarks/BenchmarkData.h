@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class IntermediateStorage;
+class NameHierarchy;
+
+/**
+ * @brief Deterministic synthetic data for the benchmarks, the same count always yields the same data.
+ */
+namespace benchmark_data {
+
+/**
+ * @brief Linear congruential generator, fixed so the data doesn't depend on the standard library implementation.
+ */
+class Random {
+public:
+  explicit Random(uint32_t seed = 42) : mState(seed) {}
+
+  size_t next(size_t max) {
+    mState = mState * 1664525 + 1013904223;
+    return static_cast<size_t>(mState >> 8) % max;
+  }
+
+private:
+  uint32_t mState;
+};
+
+/**
+ * @brief C++ like qualified symbols, e.g. `ns_3::Widget_17::update_42(int)`, spread over namespaces and classes.
+ */
+std::vector<NameHierarchy> createNameHierarchies(size_t symbolCount);
+
+/**
+ * @brief Serialized names of createNameHierarchies().
+ */
+std::vector<std::wstring> createSerializedNames(size_t symbolCount);
+
+/**
+ * @brief Qualified names of createNameHierarchies() as shown in the search.
+ */
+std::vector<std::wstring> createQualifiedNames(size_t symbolCount);
+
+/**
+ * @brief Source text declaring the symbols, roughly a line per symbol.
+ */
+std::wstring createSourceText(size_t symbolCount);
+
+/**
+ * @brief Absolute file paths in a project tree with about a hundred symbols per file.
+ */
+std::vector<std::wstring> createFilePaths(size_t fileCount);
+
+/**
+ * @brief Indexer result for the symbols: files, nodes, symbols, call edges, locations and occurrences.
+ */
+std::shared_ptr<IntermediateStorage> createIntermediateStorage(size_t symbolCount);
+
+}    // namespace benchmark_data
@@ -0,0 +1,13 @@
+#pragma once
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Runs a benchmark for 10k, 100k and 1M symbols, the argument is the symbol count.
+ */
+inline void symbolScales(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgName("symbols")->Arg(10'000)->Arg(100'000)->Arg(1'000'000)->Unit(benchmark::kMillisecond);
+}
+
+inline size_t symbolCount(const benchmark::State& state) {
+  return static_cast<size_t>(state.range(0));
+}
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <QApplication>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPainter>
+#include <QVector4D>
+
+#include "GraphViewStyle.h"
+#include "QtLineItemAngled.h"
+#include "QtRoundedRectItem.h"
+#include "QtSimpleTextItem.h"
+
+namespace {
+// Synthetic graph of NodeCount nodes on a grid, each connected to its right neighbour.
+constexpr int NodeCount = 10000;
+constexpr int ColumnCount = 100;
+constexpr int NodeWidth = 120;
+constexpr int NodeHeight = 30;
+constexpr int NodeSpacing = 40;
+
+// Size of the rendered frame, roughly a maximized graph view.
+constexpr int FrameWidth = 1600;
+constexpr int FrameHeight = 1000;
+
+QVector4D getNodeRect(int index) {
+  const auto x = static_cast<float>((index % ColumnCount) * (NodeWidth + NodeSpacing));
+  const auto y = static_cast<float>((index / ColumnCount) * (NodeHeight + NodeSpacing));
+  return {x, y, x + NodeWidth, y + NodeHeight};
+}
+
+QGraphicsScene& getScene() {
+  static QGraphicsScene* scene = []() {
+    GraphViewStyle::EdgeStyle edgeStyle;
+    edgeStyle.color = "#878787";
+    edgeStyle.width = 1.0F;
+    edgeStyle.arrowLength = 5;
+    edgeStyle.arrowWidth = 8;
+    edgeStyle.arrowClosed = false;
+    edgeStyle.cornerRadius = 10;
+    edgeStyle.dashed = false;
+
+    auto* newScene = new QGraphicsScene();
+    for(int i = 0; i < NodeCount; i++) {
+      const QVector4D rect = getNodeRect(i);
+
+      auto* node = new QtRoundedRectItem(nullptr);
+      node->setRect(0, 0, NodeWidth, NodeHeight);
+      node->setPos(static_cast<qreal>(rect.x()), static_cast<qreal>(rect.y()));
+      node->setRadius(4);
+      node->setBrush(QBrush(QColor(QStringLiteral("#F2F2F2"))));
+      newScene->addItem(node);
+
+      auto* text = new QtSimpleTextItem(node);
+      text->setText(QStringLiteral("node_%1").arg(i));
+      text->setPos(8, 6);
+
+      if(i % ColumnCount != ColumnCount - 1) {
+        auto* edge = new QtLineItemAngled(nullptr);
+        edge->updateLine(rect, getNodeRect(i + 1), rect, getNodeRect(i + 1), edgeStyle, 1, true);
+        newScene->addItem(edge);
+      }
+    }
+    return newScene;
+  }();
+  return *scene;
+}
+
+// The argument is the zoom factor in percent.
+void GraphScene_renderFrame(benchmark::State& state) {
+  QGraphicsScene& scene = getScene();
+  const qreal zoomFactor = static_cast<qreal>(state.range(0)) / 100.0;
+
+  QImage frame(FrameWidth, FrameHeight, QImage::Format_ARGB32_Premultiplied);
+  for(auto _ : state) {
+    frame.fill(Qt::white);
+
+    QPainter painter(&frame);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+
+    // the visible part of the scene, anchored at the top left like a freshly opened graph
+    const QRectF source(0, 0, FrameWidth / zoomFactor, FrameHeight / zoomFactor);
+    scene.render(&painter, QRectF(frame.rect()), source, Qt::IgnoreAspectRatio);
+  }
+}
+BENCHMARK(GraphScene_renderFrame)->ArgName("zoom")->Arg(100)->Arg(10)->Unit(benchmark::kMillisecond);
+}    // namespace
+
+// The graph items need an application, it takes its arguments like "-platform offscreen" before the benchmark does.
+int main(int argc, char** argv) {
+  QApplication application(argc, argv);
+
+  benchmark::Initialize(&argc, argv);
+  if(benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
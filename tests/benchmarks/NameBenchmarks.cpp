@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.h"
+#include "BenchmarkScales.h"
+#include "FilePath.h"
+#include "FilePathFilter.h"
+#include "NameHierarchy.h"
+
+namespace {
+void NameHierarchy_serialize(benchmark::State& state) {
+  const std::vector<NameHierarchy> names = benchmark_data::createNameHierarchies(symbolCount(state));
+
+  for(auto _ : state) {
+    for(const NameHierarchy& name : names) {
+      benchmark::DoNotOptimize(NameHierarchy::serialize(name));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+}
+BENCHMARK(NameHierarchy_serialize)->Apply(symbolScales);
+
+void NameHierarchy_deserialize(benchmark::State& state) {
+  const std::vector<std::wstring> serializedNames = benchmark_data::createSerializedNames(symbolCount(state));
+
+  for(auto _ : state) {
+    for(const std::wstring& serializedName : serializedNames) {
+      benchmark::DoNotOptimize(NameHierarchy::deserialize(serializedName));
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * serializedNames.size()));
+}
+BENCHMARK(NameHierarchy_deserialize)->Apply(symbolScales);
+
+// Typical exclude filters of a project, matched against one file per hundred symbols.
+void FilePathFilter_isMatching(benchmark::State& state) {
+  const std::vector<FilePathFilter> filters = {FilePathFilter(L"/home/user/project/src/external/**"),
+                                               FilePathFilter(L"**/module_1*/*.h"),
+                                               FilePathFilter(L"**/Buffer_*.cpp")};
+
+  std::vector<FilePath> filePaths;
+  for(const std::wstring& filePath : benchmark_data::createFilePaths(symbolCount(state) / 100)) {
+    filePaths.emplace_back(filePath);
+  }
+
+  for(auto _ : state) {
+    size_t matchCount = 0;
+    for(const FilePath& filePath : filePaths) {
+      for(const FilePathFilter& filter : filters) {
+        matchCount += filter.isMatching(filePath) ? 1 : 0;
+      }
+    }
+    benchmark::DoNotOptimize(matchCount);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * filePaths.size() * filters.size()));
+}
+BENCHMARK(FilePathFilter_isMatching)->Apply(symbolScales);
+}    // namespace
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.h"
+#include "BenchmarkScales.h"
+#include "NodeTypeSet.h"
+#include "SearchIndex.h"
+#include "SuffixArray.h"
+
+namespace {
+void SearchIndex_search(benchmark::State& state) {
+  SearchIndex index;
+  Id id = 1;
+  for(const std::wstring& name : benchmark_data::createQualifiedNames(symbolCount(state))) {
+    index.addNode(id++, name, NodeType(NODE_FUNCTION));
+  }
+  index.finishSetup();
+
+  for(auto _ : state) {
+    benchmark::DoNotOptimize(index.search(L"wdgupd", NodeTypeSet::all(), 100));
+  }
+}
+BENCHMARK(SearchIndex_search)->Apply(symbolScales);
+
+void SearchIndex_setup(benchmark::State& state) {
+  const std::vector<std::wstring> names = benchmark_data::createQualifiedNames(symbolCount(state));
+
+  for(auto _ : state) {
+    SearchIndex index;
+    Id id = 1;
+    for(const std::wstring& name : names) {
+      index.addNode(id++, name, NodeType(NODE_FUNCTION));
+    }
+    index.finishSetup();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * names.size()));
+}
+BENCHMARK(SearchIndex_setup)->Apply(symbolScales);
+
+// The full text search builds one suffix array per file, so the text is split into files like the indexed project.
+void SuffixArray_construction(benchmark::State& state) {
+  constexpr size_t SymbolsPerFile = 100;
+  const std::wstring fileText = benchmark_data::createSourceText(SymbolsPerFile);
+  const size_t fileCount = symbolCount(state) / SymbolsPerFile;
+
+  for(auto _ : state) {
+    for(size_t i = 0; i < fileCount; i++) {
+      SuffixArray array(fileText);
+      benchmark::DoNotOptimize(array);
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * fileCount * fileText.size() * sizeof(wchar_t)));
+}
+BENCHMARK(SuffixArray_construction)->Apply(symbolScales);
+}    // namespace
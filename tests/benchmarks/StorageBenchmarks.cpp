@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.h"
+#include "BenchmarkScales.h"
+#include "IntermediateStorage.h"
+#include "SqliteIndexStorage.h"
+
+namespace {
+// Merging the result of one indexer into another, as done before the results are written to the database.
+void Storage_inject(benchmark::State& state) {
+  const std::shared_ptr<IntermediateStorage> injected = benchmark_data::createIntermediateStorage(symbolCount(state));
+
+  for(auto _ : state) {
+    auto storage = std::make_unique<IntermediateStorage>();
+    storage->inject(injected.get());
+
+    state.PauseTiming();
+    storage.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * symbolCount(state)));
+}
+BENCHMARK(Storage_inject)->Apply(symbolScales);
+
+void SqliteIndexStorage_batchInsert(benchmark::State& state) {
+  const std::shared_ptr<IntermediateStorage> source = benchmark_data::createIntermediateStorage(symbolCount(state));
+
+  for(auto _ : state) {
+    state.PauseTiming();
+    auto storage = std::make_unique<SqliteIndexStorage>();
+    storage->setup();
+    state.ResumeTiming();
+
+    storage->beginTransaction();
+    storage->addNodes(source->getStorageNodes());
+    storage->addSymbols(source->getStorageSymbols());
+    storage->addEdges(source->getStorageEdges());
+    storage->commitTransaction();
+
+    state.PauseTiming();
+    storage.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * symbolCount(state)));
+}
+BENCHMARK(SqliteIndexStorage_batchInsert)->Apply(symbolScales);
+}    // namespace
@@ -0,0 +1,99 @@
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkData.h"
+#include "Graph.h"
+#include "TrailLayouter.h"
+
+namespace {
+/**
+ * @brief Call graph set up the way GraphController passes a trail to the layouter.
+ *
+ * A call tree with a few callees per function, further calls mostly go to functions one level deeper in the tree and
+ * sometimes back to a function higher up, which creates cycles.
+ */
+struct TrailGraph {
+  TrailGraph(size_t nodeCount, size_t calleesPerNode, size_t extraCallsPerNode) {
+    for(size_t i = 0; i < nodeCount; i++) {
+      const auto id = static_cast<Id>(i + 1);
+      const std::wstring name = L"func" + std::to_wstring(id);
+      graph.createNode(id, NodeType(NODE_FUNCTION), NameHierarchy(name, NAME_DELIMITER_CXX), DEFINITION_EXPLICIT);
+
+      auto dummyNode = std::make_shared<DummyNode>(DummyNode::DUMMY_DATA);
+      dummyNode->tokenId = id;
+      dummyNode->name = name;
+      dummyNode->visible = true;
+      dummyNode->active = (i == 0);
+      dummyNode->size = QVector2D(100, 30);
+
+      dummyNodes.push_back(dummyNode);
+      topLevelAncestorIds.emplace(id, id);
+    }
+
+    std::vector<size_t> depthStarts = {0, 1};
+    while(depthStarts.back() < nodeCount) {
+      depthStarts.push_back(depthStarts.back() + (depthStarts.back() - depthStarts[depthStarts.size() - 2]) * calleesPerNode);
+    }
+    depthStarts.back() = nodeCount;
+
+    benchmark_data::Random random;
+    for(size_t depth = 0; depth + 1 < depthStarts.size(); depth++) {
+      for(size_t i = depthStarts[depth]; i < depthStarts[depth + 1]; i++) {
+        if(i > 0) {
+          addCall((i - 1) / calleesPerNode, i);
+        }
+
+        for(size_t j = 0; j < extraCallsPerNode; j++) {
+          if(random.next(10) == 0) {
+            addCall(i, random.next(depthStarts[depth] + 1));
+          } else if(depth + 2 < depthStarts.size()) {
+            addCall(i, depthStarts[depth + 1] + random.next(depthStarts[depth + 2] - depthStarts[depth + 1]));
+          }
+        }
+      }
+    }
+  }
+
+  void addCall(size_t callerIndex, size_t calleeIndex) {
+    const Id callerId = dummyNodes[callerIndex]->tokenId;
+    const Id calleeId = dummyNodes[calleeIndex]->tokenId;
+
+    Edge* edge = graph.createEdge(nextEdgeId++, Edge::EDGE_CALL, graph.getNodeById(callerId), graph.getNodeById(calleeId));
+
+    auto dummyEdge = std::make_shared<DummyEdge>(callerId, calleeId, edge);
+    dummyEdge->visible = true;
+    dummyEdges.push_back(dummyEdge);
+  }
+
+  Graph graph;
+  Id nextEdgeId = 1000000;
+
+  std::vector<std::shared_ptr<DummyNode>> dummyNodes;
+  std::vector<std::shared_ptr<DummyEdge>> dummyEdges;
+  std::map<Id, Id> topLevelAncestorIds;
+};
+
+// The argument is the number of functions in the trail.
+void TrailLayouter_layoutGraph(benchmark::State& state) {
+  const auto nodeCount = static_cast<size_t>(state.range(0));
+
+  for(auto _ : state) {
+    // the layout changes the dummy nodes, so every iteration starts from a new trail
+    state.PauseTiming();
+    auto trail = std::make_unique<TrailGraph>(nodeCount, 4, 2);
+    state.ResumeTiming();
+
+    TrailLayouter layouter(TrailLayouter::LAYOUT_LEFT_RIGHT);
+    layouter.layoutGraph(trail->dummyNodes, trail->dummyEdges, trail->topLevelAncestorIds);
+
+    state.PauseTiming();
+    trail.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nodeCount));
+}
+BENCHMARK(TrailLayouter_layoutGraph)->ArgName("nodes")->Arg(1'000)->Arg(3'000)->Unit(benchmark::kMillisecond);
+}    // namespace
@@ -0,0 +1,118 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "DefinitionKind.h"
+#include "Edge.h"
+#include "FileSystem.h"
+#include "IndexQuery.h"
+#include "NameHierarchy.h"
+#include "NodeKind.h"
+
+using namespace testing;
+
+namespace {
+// index of a file "main.cpp" including "util.h", with ns::caller calling ns::callee and util
+class IndexQueryFix : public Test {
+public:
+  void SetUp() override {
+    SqliteIndexStorage storage(mDatabasePath);
+    storage.setup();
+    storage.setVersion(storage.getStaticVersion());
+    storage.beginTransaction();
+
+    const Id mainFileId = addFile(storage, L"/src/main.cpp");
+    const Id headerFileId = addFile(storage, L"/src/util.h");
+    storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_INCLUDE), mainFileId, headerFileId));
+
+    const Id callerId = addFunction(storage, {L"ns", L"caller"});
+    const Id calleeId = addFunction(storage, {L"ns", L"callee"});
+    const Id utilId = addFunction(storage, {L"util"});
+    storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), callerId, calleeId));
+    storage.addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_CALL), callerId, utilId));
+
+    const Id locationId = storage.addSourceLocation(StorageSourceLocationData(mainFileId, 12, 5, 12, 10, 0));
+    storage.addOccurrence(StorageOccurrence(calleeId, locationId));
+
+    storage.commitTransaction();
+  }
+
+  void TearDown() override {
+    std::ignore = FileSystem::remove(mDatabasePath);
+  }
+
+  static Id addFile(SqliteIndexStorage& storage, const std::wstring& path) {
+    const Id fileId = storage.addNode(
+        StorageNodeData(nodeKindToInt(NODE_FILE), NameHierarchy::serialize(NameHierarchy(path, NAME_DELIMITER_FILE))));
+    storage.addFile(StorageFile(fileId, path, L"cpp", "", true, true));
+    return fileId;
+  }
+
+  static Id addFunction(SqliteIndexStorage& storage, const std::vector<std::wstring>& names) {
+    const Id functionId = storage.addNode(
+        StorageNodeData(nodeKindToInt(NODE_FUNCTION), NameHierarchy::serialize(NameHierarchy(names, NAME_DELIMITER_CXX))));
+    storage.addSymbol(StorageSymbol(functionId, definitionKindToInt(DEFINITION_EXPLICIT)));
+    return functionId;
+  }
+
+  const FilePath mDatabasePath{L"data/IndexQueryTestSuite/test.srctrldb"};
+};
+}    // namespace
+
+TEST_F(IndexQueryFix, databaseIsCompatible) {
+  const IndexQuery query(mDatabasePath);
+
+  EXPECT_TRUE(query.isCompatible());
+}
+
+TEST_F(IndexQueryFix, searchFindsSymbolsFuzzily) {
+  const IndexQuery query(mDatabasePath);
+
+  const std::string answer = query.run("search callee");
+
+  EXPECT_THAT(answer, HasSubstr("\"name\":\"ns::callee\""));
+  EXPECT_THAT(answer, Not(HasSubstr("util")));
+}
+
+TEST_F(IndexQueryFix, callersAndCalleesOfQualifiedOrPartialName) {
+  const IndexQuery query(mDatabasePath);
+
+  const std::string callees = query.run("callees ns::caller");
+  EXPECT_THAT(callees, HasSubstr("\"name\":\"ns::callee\""));
+  EXPECT_THAT(callees, HasSubstr("\"name\":\"util\""));
+
+  const std::string callers = query.run("callers callee");
+  EXPECT_THAT(callers, HasSubstr("\"name\":\"ns::caller\""));
+  EXPECT_THAT(callers, Not(HasSubstr("\"name\":\"util\"")));
+}
+
+TEST_F(IndexQueryFix, referencesAreSourceLocations) {
+  const IndexQuery query(mDatabasePath);
+
+  const std::string answer = query.run("references ns::callee");
+
+  EXPECT_THAT(answer, HasSubstr("\"file\":\"/src/main.cpp\""));
+  EXPECT_THAT(answer, HasSubstr("\"line\":12"));
+  EXPECT_THAT(answer, HasSubstr("\"column\":5"));
+}
+
+TEST_F(IndexQueryFix, includesOfFile) {
+  const IndexQuery query(mDatabasePath);
+
+  const std::string answer = query.run("includes /src/main.cpp");
+
+  EXPECT_THAT(answer, HasSubstr("\"file\":\"/src/util.h\""));
+}
+
+TEST_F(IndexQueryFix, unknownSymbolAndQueryAreErrors) {
+  const IndexQuery query(mDatabasePath);
+
+  EXPECT_THAT(query.run("callers nothing"), HasSubstr("\"error\":\"unknown symbol\""));
+  EXPECT_THAT(query.run("who-calls ns::callee"), HasSubstr("\"error\""));
+  EXPECT_THAT(query.run("callers"), HasSubstr("\"error\":\"missing argument\""));
+}
+
+TEST_F(IndexQueryFix, answerIsSingleLine) {
+  const IndexQuery query(mDatabasePath);
+
+  EXPECT_THAT(query.run("callees ns::caller"), Not(HasSubstr("\n")));
+}
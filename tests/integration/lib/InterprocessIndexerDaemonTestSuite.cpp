@@ -0,0 +1,78 @@
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+#  include "IndexerCommandCxx.h"
+#  include "InterprocessIndexerCommandManager.h"
+#  include "InterprocessIndexerControlManager.h"
+#  include "InterprocessIndexerDaemon.h"
+#  include "InterprocessIndexingStatusManager.h"
+#  include "InterprocessIntermediateStorageManager.h"
+#  include "ISharedMemoryGarbageCollector.hpp"
+#  include "MockedSharedMemoryGarbageCollector.hpp"
+
+using namespace testing;
+
+namespace {
+constexpr const char* Uuid = "daemontest";
+
+struct InterprocessIndexerDaemonFix : Test {
+  void SetUp() override {
+    mSharedMemoryGarbageCollector = std::make_shared<NiceMock<lib::MockedSharedMemoryGarbageCollector>>();
+    lib::ISharedMemoryGarbageCollector::setInstance(mSharedMemoryGarbageCollector);
+
+    mControlManager = std::make_unique<InterprocessIndexerControlManager>(Uuid, 0, true);
+    mCommandManager = std::make_unique<InterprocessIndexerCommandManager>(Uuid, 0, true);
+    mStatusManager = std::make_unique<InterprocessIndexingStatusManager>(Uuid, 0, true);
+    mStorageManager = std::make_unique<InterprocessIntermediateStorageManager>(Uuid, 1, true);
+  }
+
+  void TearDown() override {
+    mStorageManager.reset();
+    mStatusManager.reset();
+    mCommandManager.reset();
+    mControlManager.reset();
+
+    lib::ISharedMemoryGarbageCollector::setInstance(nullptr);
+    mSharedMemoryGarbageCollector.reset();
+  }
+
+  void pushIndexerCommands(size_t count) {
+    std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+    for(size_t i = 0; i < count; i++) {
+      indexerCommands.push_back(std::make_shared<IndexerCommandCxx>(FilePath(L"missing" + std::to_wstring(i) + L".cpp"),
+                                                                    std::set<FilePath>{},
+                                                                    std::set<FilePathFilter>{},
+                                                                    std::set<FilePathFilter>{},
+                                                                    FilePath(),
+                                                                    std::vector<std::wstring>{}));
+    }
+    mCommandManager->pushIndexerCommands(indexerCommands);
+  }
+
+  std::shared_ptr<NiceMock<lib::MockedSharedMemoryGarbageCollector>> mSharedMemoryGarbageCollector;
+  std::unique_ptr<InterprocessIndexerControlManager> mControlManager;
+  std::unique_ptr<InterprocessIndexerCommandManager> mCommandManager;
+  std::unique_ptr<InterprocessIndexingStatusManager> mStatusManager;
+  std::unique_ptr<InterprocessIntermediateStorageManager> mStorageManager;
+};
+}    // namespace
+
+TEST_F(InterprocessIndexerDaemonFix, batchClosedBeforeFirstPollIsDrained) {
+  const Id batchId = mControlManager->openBatch(1);
+  pushIndexerCommands(3);
+  mControlManager->closeBatch();
+
+  // returns once the idle timeout passed after the batch
+  InterprocessIndexerDaemon(Uuid, 1, std::chrono::seconds(1)).run();
+
+  EXPECT_EQ(0, mCommandManager->indexerCommandCount());
+  EXPECT_EQ(batchId, mControlManager->getFinishedBatchId(1));
+}
+#endif    // BUILD_CXX_LANGUAGE_PACKAGE
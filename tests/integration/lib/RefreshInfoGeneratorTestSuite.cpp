@@ -845,3 +845,96 @@ TEST(RefreshInfoGenerator, clearsUnchangedFilesReferencedByUnchangedFileThatRefe
   }
   cleanup();
 }
+
+TEST(RefreshInfoGenerator, refreshInfoForUpdatedFilesOfLargeProjectClassifiesEveryFile) {
+  cleanup();
+  {
+    // enough files for the file system checks to run in parallel
+    const size_t fileCount = 400;
+
+    std::set<FilePath> sourceFilePaths;
+    std::set<FilePath> expectedFilesToClear;
+    std::set<FilePath> expectedFilesToIndex;
+
+    std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(m_indexDbPath, m_bookmarkDbPath);
+    storage->setup();
+
+    for(size_t i = 0; i < fileCount; i++) {
+      const FilePath sourceFilePath = m_sourceFolder.getConcatenated(L"file_" + std::to_wstring(i) + L".cpp");
+      sourceFilePaths.insert(sourceFilePath);
+
+      switch(i % 4) {
+      case 0:    // unchanged
+        addVeryNewFileToStorage(sourceFilePath, true, true, storage);
+        addFileToFileSystem(sourceFilePath);
+        break;
+      case 1:    // changed
+        addVeryOldFileToStorage(sourceFilePath, true, true, storage);
+        addFileToFileSystem(sourceFilePath);
+        expectedFilesToClear.insert(sourceFilePath);
+        expectedFilesToIndex.insert(sourceFilePath);
+        break;
+      case 2:    // removed
+        addVeryNewFileToStorage(sourceFilePath, true, true, storage);
+        expectedFilesToClear.insert(sourceFilePath);
+        break;
+      default:    // added
+        addFileToFileSystem(sourceFilePath);
+        expectedFilesToIndex.insert(sourceFilePath);
+      }
+    }
+
+    const FilePath unchangedHeaderFilePath = m_sourceFolder.getConcatenated(L"unchanged_file.h");
+    addVeryNewFileToStorage(unchangedHeaderFilePath, false, true, storage);
+    addFileToFileSystem(unchangedHeaderFilePath);
+
+    storage->buildCaches();
+
+    std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+    sourceGroups.push_back(std::make_shared<SourceGroupTest>(sourceFilePaths));
+
+    const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(sourceGroups, storage);
+
+    EXPECT_TRUE(RefreshMode::UpdatedFiles == refreshInfo.mode);
+    EXPECT_TRUE(refreshInfo.nonIndexedFilesToClear.empty());
+    EXPECT_EQ(expectedFilesToClear, refreshInfo.filesToClear);
+    EXPECT_EQ(expectedFilesToIndex, refreshInfo.filesToIndex);
+  }
+  cleanup();
+}
+
+TEST(RefreshInfoGenerator, refreshInfoForUpdatedFilesOnlyChecksFilesChangedAccordingToJournal) {
+  cleanup();
+  {
+    const FilePath reportedSourceFilePath = m_sourceFolder.getConcatenated(L"reported_file.cpp");
+    const FilePath unreportedSourceFilePath = m_sourceFolder.getConcatenated(L"unreported_file.cpp");
+
+    std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+    sourceGroups.push_back(
+        std::make_shared<SourceGroupTest>(std::set<FilePath>{reportedSourceFilePath, unreportedSourceFilePath}));
+
+    std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(m_indexDbPath, m_bookmarkDbPath);
+    storage->setup();
+
+    addVeryOldFileToStorage(reportedSourceFilePath, true, true, storage);
+    addFileToFileSystem(reportedSourceFilePath);
+    addVeryOldFileToStorage(unreportedSourceFilePath, true, true, storage);
+    addFileToFileSystem(unreportedSourceFilePath);
+
+    storage->buildCaches();
+
+    FileChangeJournal::Changes fileChanges;
+    fileChanges.rootDirectories = {m_sourceFolder};
+    fileChanges.changedPaths = {reportedSourceFilePath.wstr()};
+    fileChanges.complete = true;
+
+    const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(sourceGroups, storage, fileChanges);
+
+    // both files are newer on disk, but the journal vouches for the unreported one
+    EXPECT_TRUE(RefreshMode::UpdatedFiles == refreshInfo.mode);
+    EXPECT_TRUE(refreshInfo.nonIndexedFilesToClear.empty());
+    EXPECT_EQ(std::set<FilePath>{reportedSourceFilePath}, refreshInfo.filesToClear);
+    EXPECT_EQ(std::set<FilePath>{reportedSourceFilePath}, refreshInfo.filesToIndex);
+  }
+  cleanup();
+}
@@ -1,3 +1,4 @@
+#include <filesystem>
 #include <fstream>
 
 #include <gmock/gmock.h>
@@ -265,6 +266,42 @@ TEST_F(SourceGroupFix, sourceGroupCxxCdbGeneratesExpectedOutput) {
 
   generateAndCompareExpectedOutput(projectName, std::make_shared<SourceGroupCxxCdb>(sourceGroupSettings));
 }
+
+TEST_F(SourceGroupFix, sourceGroupCxxCdbLoadsDatabaseOncePerRefresh) {
+  namespace fs = std::filesystem;
+  const fs::path root = fs::weakly_canonical(fs::temp_directory_path()) / "SourceGroupCxxCdbTest";
+  const fs::path cdbPath = root / "compile_commands.json";
+  std::error_code errorCode;
+  fs::remove_all(root, errorCode);
+  fs::create_directories(root / "src", errorCode);
+  std::ofstream(root / "src" / "main.cpp") << "int main() {}\n";
+  std::ofstream(cdbPath) << "[{\"directory\": \"" << (root / "src").generic_string()
+                         << "\", \"file\": \"main.cpp\", \"arguments\": [\"clang\", \"-c\", \"main.cpp\"]}]\n";
+
+  ProjectSettings projectSettings;
+  projectSettings.setProjectFilePath(L"non_existent_project", FilePath(root.wstring()));
+
+  auto sourceGroupSettings = std::make_shared<SourceGroupSettingsCxxCdb>("fake_id", &projectSettings);
+  sourceGroupSettings->setCompilationDatabasePath(FilePath(cdbPath.wstring()));
+  SourceGroupCxxCdb sourceGroup(sourceGroupSettings);
+  ASSERT_TRUE(sourceGroup.prepareIndexing());
+
+  // an unparsable database with the same size and write time and without cache file can only be served by the cache
+  const fs::file_time_type writeTime = fs::last_write_time(cdbPath);
+  const std::string unparsableDatabase(fs::file_size(cdbPath), ' ');
+  std::ofstream(cdbPath, std::ios::trunc) << unparsableDatabase;
+  fs::last_write_time(cdbPath, writeTime);
+  fs::remove_all(root / "sourcetrail_dependencies", errorCode);
+
+  const FilePath sourceFilePath((root / "src" / "main.cpp").wstring());
+  EXPECT_THAT(sourceGroup.getAllSourceFilePaths(), testing::ElementsAre(sourceFilePath));
+  EXPECT_THAT(sourceGroup.filterToContainedFilePaths({sourceFilePath}), testing::ElementsAre(sourceFilePath));
+
+  sourceGroup.finishPreparingIndexing();
+  EXPECT_TRUE(sourceGroup.getAllSourceFilePaths().empty());
+
+  fs::remove_all(root, errorCode);
+}
 #endif    // BUILD_CXX_LANGUAGE_PACKAGE
 
 TEST_F(SourceGroupFix, sourceGroupCustomCommandGeneratesExpectedOutput) {
@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <random>
+
 #include <gtest/gtest.h>
 
 #include "FileSystem.h"
@@ -298,4 +301,212 @@ TEST_F(SqliteIndexStorageTest, SetMode_ClearsAllTemporaryIndices) {
 }
 #endif
 
+// executeStatement and executeQuery are protected in SqliteStorage, a derived class may hand them out as member pointers
+struct SqliteStorageAccess final : SqliteStorage {
+  static bool runStatement(const SqliteStorage& storage, const std::string& statement) {
+    using Statement = bool (SqliteStorage::*)(const std::string&) const;
+    return (storage.*static_cast<Statement>(&SqliteStorageAccess::executeStatement))(statement);
+  }
+
+  static CppSQLite3Query runQuery(const SqliteStorage& storage, const std::string& statement) {
+    using Query = CppSQLite3Query (SqliteStorage::*)(const std::string&) const;
+    return (storage.*static_cast<Query>(&SqliteStorageAccess::executeQuery))(statement);
+  }
+};
+
+// the statements of removeElementsWithLocationInFiles before they were changed to start from the ids to clear
+void removeElementsWithLocationInFilesReference(SqliteIndexStorage& storage, const std::string& fileIds) {
+  const auto execute = [&storage](const std::string& statement) { SqliteStorageAccess::runStatement(storage, statement); };
+
+  execute("CREATE TABLE IF NOT EXISTS element_id_to_clear(id INTEGER NOT NULL, PRIMARY KEY(id));");
+  execute(
+      "INSERT INTO element_id_to_clear SELECT occurrence.element_id FROM occurrence INNER JOIN source_location ON "
+      "(occurrence.source_location_id = source_location.id) WHERE source_location.file_node_id IN (" +
+      fileIds + ") GROUP BY (occurrence.element_id)");
+  execute(
+      "DELETE FROM element WHERE element.id IN (SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN edge ON "
+      "(element_id_to_clear.id = edge.id))");
+  execute(
+      "DELETE FROM element WHERE element.id IN (SELECT id FROM edge WHERE source_node_id IN "
+      "(SELECT id FROM element_id_to_clear))");
+  execute("DELETE FROM element_id_to_clear WHERE id NOT IN (SELECT id FROM element)");
+  execute("DELETE FROM element_id_to_clear WHERE id IN (SELECT id FROM file)");
+  execute("DELETE FROM source_location WHERE file_node_id IN (" + fileIds + ");");
+  execute(
+      "DELETE FROM element_id_to_clear WHERE id IN (SELECT element_id_to_clear.id FROM element_id_to_clear INNER JOIN "
+      "occurrence ON element_id_to_clear.id = occurrence.element_id)");
+  execute("DELETE FROM element_id_to_clear WHERE id IN (SELECT target_node_id FROM edge)");
+  execute(
+      "DELETE FROM element WHERE EXISTS (SELECT * FROM element_id_to_clear WHERE element.id = element_id_to_clear.id)");
+  execute("DROP TABLE IF EXISTS main.element_id_to_clear;");
+}
+
+// adds files with nodes, edges, local symbols and errors that have occurrences in one or more of the files
+std::vector<Id> fillStorageWithRandomElements(SqliteIndexStorage& storage) {
+  std::mt19937 random(42);
+  const auto pick = [&random](const std::vector<Id>& ids) { return ids[random() % ids.size()]; };
+
+  std::vector<Id> fileIds;
+  for(int i = 0; i < 4; i++) {
+    const std::wstring path = L"file" + std::to_wstring(i) + L".cpp";
+    const Id fileId = storage.addNode(StorageNodeData(1, path));
+    storage.addFile(StorageFile(fileId, path, L"cpp", "", false, true));
+    fileIds.push_back(fileId);
+  }
+
+  std::vector<Id> nodeIds;
+  for(int i = 0; i < 40; i++) {
+    const Id nodeId = storage.addNode(StorageNodeData(2, L"node" + std::to_wstring(i)));
+    if(i % 5 == 0) {
+      storage.addComponentAccess(StorageComponentAccess(nodeId, 1));
+    }
+    if(i % 7 == 0) {
+      storage.addElementComponent(StorageElementComponent(nodeId, 1, L"data"));
+    }
+    nodeIds.push_back(nodeId);
+  }
+
+  std::vector<Id> elementIds = nodeIds;
+  for(int i = 0; i < 80; i++) {
+    const Id sourceNodeId = random() % 4 == 0 ? pick(fileIds) : pick(nodeIds);
+    elementIds.push_back(storage.addEdge(StorageEdgeData(static_cast<int>(random() % 3), sourceNodeId, pick(nodeIds))));
+  }
+  for(int i = 0; i < 10; i++) {
+    elementIds.push_back(storage.addLocalSymbol(StorageLocalSymbolData(L"local" + std::to_wstring(i))));
+  }
+  for(int i = 0; i < 5; i++) {
+    elementIds.push_back(storage.addError(StorageErrorData(L"error" + std::to_wstring(i), L"file0.cpp", false, true)).id);
+  }
+
+  for(const Id elementId : elementIds) {
+    const size_t occurrenceCount = random() % 4;
+    for(size_t i = 0; i < occurrenceCount; i++) {
+      const Id sourceLocationId = storage.addSourceLocation(
+          StorageSourceLocationData(pick(fileIds), i + 1, 1, i + 1, 10, static_cast<int>(random() % 2)));
+      storage.addOccurrence(StorageOccurrence(elementId, sourceLocationId));
+    }
+  }
+  return fileIds;
+}
+
+std::vector<std::string> getAllRows(SqliteIndexStorage& storage) {
+  std::vector<std::string> rows;
+  for(const std::string table : {"element",
+                                 "element_component",
+                                 "edge",
+                                 "node",
+                                 "symbol",
+                                 "file",
+                                 "local_symbol",
+                                 "source_location",
+                                 "occurrence",
+                                 "component_access",
+                                 "error"}) {
+    CppSQLite3Query query = SqliteStorageAccess::runQuery(storage, "SELECT * FROM " + table + ";");
+    while(!query.eof()) {
+      std::string row = table;
+      for(int i = 0; i < query.numFields(); i++) {
+        row += std::string("|") + (query.fieldValue(i) != nullptr ? query.fieldValue(i) : "NULL");
+      }
+      rows.push_back(row);
+      query.nextRow();
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+TEST(SqliteIndexStorage, removesElementsWithLocationInFilesLikeReference) {
+  for(const std::vector<size_t>& clearedFileIndices : std::vector<std::vector<size_t>>{{0}, {1, 3}, {0, 1, 2, 3}}) {
+    SqliteIndexStorage storage;
+    storage.setup();
+    SqliteIndexStorage referenceStorage;
+    referenceStorage.setup();
+
+    const std::vector<Id> fileIds = fillStorageWithRandomElements(storage);
+    ASSERT_EQ(fileIds, fillStorageWithRandomElements(referenceStorage));
+    const std::vector<std::string> rowsBefore = getAllRows(storage);
+    ASSERT_EQ(rowsBefore, getAllRows(referenceStorage));
+
+    std::vector<Id> clearedFileIds;
+    std::string clearedFileIdsText;
+    for(const size_t index : clearedFileIndices) {
+      clearedFileIds.push_back(fileIds[index]);
+      clearedFileIdsText += (clearedFileIdsText.empty() ? "" : ",") + std::to_string(fileIds[index]);
+    }
+
+    storage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+    storage.removeElementsWithLocationInFiles(clearedFileIds, nullptr);
+    referenceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_CLEAR);
+    removeElementsWithLocationInFilesReference(referenceStorage, clearedFileIdsText);
+
+    const std::vector<std::string> rows = getAllRows(storage);
+    EXPECT_LT(rows.size(), rowsBefore.size());
+    EXPECT_EQ(rows, getAllRows(referenceStorage));
+  }
+}
+
+std::vector<Id> getErrorIds(const std::vector<ErrorInfo>& errors) {
+  std::vector<Id> ids;
+  ids.reserve(errors.size());
+  for(const ErrorInfo& error : errors) {
+    ids.push_back(error.id);
+  }
+  return ids;
+}
+
+TEST(SqliteIndexStorage, filtersAndCountsErrorsLikeErrorFilter) {
+  SqliteIndexStorage storage;
+  storage.setup();
+
+  std::vector<Id> fileIds;
+  for(int i = 0; i < 3; i++) {
+    const std::wstring path = L"file" + std::to_wstring(i) + L".cpp";
+    const Id fileId = storage.addNode(StorageNodeData(1, path));
+    storage.addFile(StorageFile(fileId, path, L"cpp", "", false, false));
+    fileIds.push_back(fileId);
+  }
+
+  // errors of all types, some of them with multiple occurrences in different files
+  for(int i = 0; i < 24; i++) {
+    const Id errorId =
+        storage.addError(StorageErrorData(L"error" + std::to_wstring(i), L"file0.cpp", i % 2 == 0, i % 3 != 0)).id;
+    for(int j = 0; j <= i % 3; j++) {
+      const Id sourceLocationId = storage.addSourceLocation(
+          StorageSourceLocationData(fileIds[static_cast<size_t>(i + j) % fileIds.size()], j + 1, 1, j + 1, 1, 0));
+      storage.addOccurrence(StorageOccurrence(errorId, sourceLocationId));
+    }
+  }
+
+  storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+  const std::vector<ErrorInfo> allErrors = storage.getAllErrorInfos();
+  ASSERT_EQ(48, allErrors.size());
+
+  for(const size_t limit : {0, 1, 5, 100}) {
+    for(int types = 0; types < 16; types++) {
+      ErrorFilter filter;
+      filter.error = (types & 1) != 0;
+      filter.fatal = (types & 2) != 0;
+      filter.unindexedError = (types & 4) != 0;
+      filter.unindexedFatal = (types & 8) != 0;
+      filter.limit = limit;
+
+      ErrorFilter filterUnlimited = filter;
+      filterUnlimited.limit = 0;
+      const std::vector<ErrorInfo> filteredErrors = filterUnlimited.filterErrors(allErrors);
+
+      EXPECT_EQ(getErrorIds(filter.filterErrors(allErrors)), getErrorIds(storage.getErrorInfos(filter)));
+      EXPECT_EQ(ErrorCountInfo(filteredErrors), storage.getErrorCountInfo(filter));
+
+      std::vector<ErrorInfo> fileErrors;
+      for(const ErrorInfo& error : filteredErrors) {
+        if(error.filePath != L"file1.cpp") {
+          fileErrors.push_back(error);
+        }
+      }
+      EXPECT_EQ(getErrorIds(fileErrors), getErrorIds(storage.getErrorInfosInFiles(filter, {fileIds[0], fileIds[2]})));
+    }
+  }
+}
+
 }    // namespace
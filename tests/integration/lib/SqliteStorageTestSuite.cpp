@@ -15,6 +15,7 @@
 #include <spdlog/spdlog.h>
 
 #include "SqliteStorage.h"
+#include "StorageQueryToken.h"
 #include "TimeStamp.h"
 
 struct MockedSqliteStorage : SqliteStorage {
@@ -213,6 +214,53 @@ TEST_F(SqliteStorageFix, executeStatement) {
   EXPECT_EQ(2, value);
 }
 
+struct SqliteStorageQueryCancellationFix : SqliteStorageFix {
+  void TearDown() override {
+    StorageQueryToken::clear();
+    SqliteStorageFix::TearDown();
+  }
+
+  // Runs long enough for the progress handler to be called many times.
+  int countRows() const {
+    return mSqliteStorage->executeStatementScalar(
+        "WITH RECURSIVE counter(n) AS (SELECT 1 UNION ALL SELECT n + 1 FROM counter WHERE n < 100000) "
+        "SELECT count(*) FROM counter;",
+        0);
+  }
+};
+
+TEST_F(SqliteStorageQueryCancellationFix, executeStatementScalar_IgnoresSupersededActivationByDefault) {
+  // Given:
+  StorageQueryToken::supersede(1, 10);
+  StorageQueryToken::supersede(1, 11);
+
+  // When:
+  int value = 0;
+  std::ignore = StorageQueryToken(1, 10).run([&]() { value = countRows(); });
+
+  // Then:
+  EXPECT_EQ(100000, value);
+}
+
+TEST_F(SqliteStorageQueryCancellationFix, enableQueryCancellation_InterruptsSupersededActivation) {
+  // Given:
+  mSqliteStorage->enableQueryCancellation();
+  StorageQueryToken::supersede(1, 10);
+
+  // When:
+  int currentValue = 0;
+  std::ignore = StorageQueryToken(1, 10).run([&]() { currentValue = countRows(); });
+
+  // And:
+  StorageQueryToken::supersede(1, 11);
+  int supersededValue = 0;
+  std::ignore = StorageQueryToken(1, 10).run([&]() { supersededValue = countRows(); });
+
+  // Then:
+  EXPECT_EQ(100000, currentValue);
+  EXPECT_EQ(0, supersededValue);
+}
+
 }    // namespace
 
 int main(int argc, char** argv) {
@@ -1,8 +1,11 @@
+#include <map>
 #include <memory>
+#include <set>
 #include <utility>
 
 #include <gtest/gtest.h>
 
+#include "Graph.h"
 #include "IntermediateStorage.h"
 #include "ParseLocation.h"
 #include "PersistentStorage.h"
@@ -100,4 +103,75 @@ TEST(Storage, savesFieldAsMember) {
   }
   EXPECT_TRUE(foundEdge);
 }
+
+TEST(Storage, countsTopLevelNodesOfOverviewBundles) {
+  TestStorage storage;
+
+  const std::shared_ptr<IntermediateStorage> intermediateStorage = std::make_shared<IntermediateStorage>();
+  const auto addSymbol = [&](NodeKind kind, const std::wstring& name, DefinitionKind definitionKind) {
+    const StorageNodeData data(nodeKindToInt(kind), NameHierarchy::serialize(createNameHierarchy(name)));
+    const Id id = intermediateStorage->addNode(data).first;
+    intermediateStorage->addSymbol(StorageSymbol(id, definitionKind));
+    return id;
+  };
+
+  addSymbol(NODE_FUNCTION, L"a", DEFINITION_EXPLICIT);
+  addSymbol(NODE_FUNCTION, L"b", DEFINITION_EXPLICIT);
+  addSymbol(NODE_FUNCTION, L"implicit", DEFINITION_IMPLICIT);
+  const Id structId = addSymbol(NODE_STRUCT, L"Struct", DEFINITION_EXPLICIT);
+  const Id fieldId = addSymbol(NODE_FIELD, L"Struct::m_field", DEFINITION_EXPLICIT);
+  intermediateStorage->addEdge(StorageEdgeData(Edge::typeToInt(Edge::EDGE_MEMBER), structId, fieldId));
+
+  const std::wstring filePath = L"path/to/test.h";
+  const Id fileId = intermediateStorage
+                        ->addNode(StorageNodeData(
+                            nodeKindToInt(NODE_FILE), NameHierarchy::serialize(NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+                        .first;
+  intermediateStorage->addFile(StorageFile(fileId, filePath, L"cpp", "someTime", true, true));
+
+  storage.inject(intermediateStorage.get());
+  storage.buildCaches();
+
+  const std::map<NodeKind, size_t> expected = {{NODE_FILE, 1}, {NODE_STRUCT, 1}, {NODE_FUNCTION, 2}};
+  EXPECT_EQ(expected, storage.getOverviewBundleCounts());
+}
+
+TEST(Storage, pagesThroughOverviewBundle) {
+  constexpr size_t PageSize = StorageAccess::OverviewBundlePageSize;
+  constexpr size_t FunctionCount = PageSize + 10;
+
+  TestStorage storage;
+
+  const std::shared_ptr<IntermediateStorage> intermediateStorage = std::make_shared<IntermediateStorage>();
+  for(size_t i = 0; i < FunctionCount; i++) {
+    const NameHierarchy nameHierarchy = createNameHierarchy(L"function" + std::to_wstring(i));
+    const StorageNodeData data(nodeKindToInt(NODE_FUNCTION), NameHierarchy::serialize(nameHierarchy));
+    const Id id = intermediateStorage->addNode(data).first;
+    intermediateStorage->addSymbol(StorageSymbol(id, DEFINITION_EXPLICIT));
+  }
+
+  storage.inject(intermediateStorage.get());
+  storage.buildCaches();
+
+  ASSERT_EQ(FunctionCount, storage.getOverviewBundleCounts()[NODE_FUNCTION]);
+
+  std::set<Id> nodeIds;
+  const auto addPage = [&](size_t offset) {
+    const std::shared_ptr<Graph> graph = storage.getGraphForOverviewBundle(NODE_FUNCTION, offset, PageSize);
+    graph->forEachNode([&](Node* node) {
+      EXPECT_EQ(NODE_FUNCTION, node->getType().getKind());
+      nodeIds.insert(node->getId());
+    });
+    return graph->getNodeCount();
+  };
+
+  EXPECT_EQ(PageSize, addPage(0));
+  // the last page only holds the remaining nodes
+  EXPECT_EQ(FunctionCount - PageSize, addPage(PageSize));
+  EXPECT_EQ(0, addPage(FunctionCount));
+  EXPECT_EQ(0, storage.getGraphForOverviewBundle(NODE_CLASS, 0, PageSize)->getNodeCount());
+
+  // the pages hold every function exactly once
+  EXPECT_EQ(FunctionCount, nodeIds.size());
+}
 }    // namespace
@@ -1,3 +1,6 @@
+#include <filesystem>
+#include <fstream>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -60,6 +63,107 @@ TEST_F(CxxIncludeProcessing, includeDetectionDoesNotFindIncludeInFileWithoutIncl
   EXPECT_TRUE(IncludeProcessing::getIncludeDirectives(TextAccess::createFromString("#ifdef xx\n#endif")).empty());
 }
 
+TEST_F(CxxIncludeProcessing, includeDetectionFindsIncludesAfterOtherLines) {
+  auto includeDirectives = IncludeProcessing::getIncludeDirectives(TextAccess::createFromString(
+      "// #include \"comment.h\"\r\n#pragma once\r\n\t #  include <a.h>\r\nint i;\r\n#include \"b.h\"\r\n",
+      FilePath(L"foo.cpp")));
+
+  ASSERT_THAT(includeDirectives, testing::SizeIs(2));
+  EXPECT_THAT(includeDirectives[0].getIncludedFile().wstr(), testing::StrEq(L"a.h"));
+  EXPECT_EQ(3U, includeDirectives[0].getLineNumber());
+  EXPECT_THAT(includeDirectives[1].getIncludedFile().wstr(), testing::StrEq(L"b.h"));
+  EXPECT_EQ(5U, includeDirectives[1].getLineNumber());
+}
+
+TEST_F(CxxIncludeProcessing, includeDetectionFindsIncludeAfterByteOrderMark) {
+  auto includeDirectives = IncludeProcessing::getIncludeDirectives(
+      TextAccess::createFromString("\xEF\xBB\xBF#include \"foo.h\"\n#include \"bar.h\"", FilePath(L"foo.cpp")));
+
+  ASSERT_THAT(includeDirectives, testing::SizeIs(2));
+  EXPECT_THAT(includeDirectives[0].getIncludedFile().wstr(), testing::StrEq(L"foo.h"));
+  EXPECT_THAT(includeDirectives[1].getIncludedFile().wstr(), testing::StrEq(L"bar.h"));
+}
+
+TEST_F(CxxIncludeProcessing, includeDetectionFindsIncludeAfterNonAsciiText) {
+  auto includeDirectives = IncludeProcessing::getIncludeDirectives(
+      TextAccess::createFromString("// \xC3\xA4\n\xC3\xA4 #include \"a.h\"\n#include \"b.h\" // \xC3\xA4", FilePath(L"foo.cpp")));
+
+  ASSERT_THAT(includeDirectives, testing::SizeIs(1));
+  EXPECT_THAT(includeDirectives[0].getIncludedFile().wstr(), testing::StrEq(L"b.h"));
+}
+
+TEST_F(CxxIncludeProcessing, unresolvedIncludeDetectionFollowsIndexedIncludes) {
+  namespace fs = std::filesystem;
+  const fs::path root = fs::weakly_canonical(fs::temp_directory_path()) / "CxxIncludeProcessingTestSuite";
+  std::error_code errorCode;
+  fs::remove_all(root, errorCode);
+  fs::create_directories(root / "include", errorCode);
+
+  // enough source files to process them on multiple threads
+  std::set<FilePath> sourceFilePaths;
+  for(int i = 0; i < 64; i++) {
+    const fs::path sourceFilePath = root / ("source" + std::to_string(i) + ".cpp");
+    std::ofstream(sourceFilePath) << "#include \"include/a.h\"\n#include <missing" << i % 2 << ".h>\n";
+    sourceFilePaths.insert(FilePath(sourceFilePath.wstring()));
+  }
+  std::ofstream(root / "include" / "a.h") << "#include \"b.h\"\n#include \"missing.h\"\n";
+  std::ofstream(root / "include" / "b.h") << "#include \"a.h\"\n";
+
+  const std::vector<IncludeDirective> unresolvedIncludeDirectives = IncludeProcessing::getUnresolvedIncludeDirectives(
+      sourceFilePaths, {FilePath(root.wstring())}, {}, 1, [](float) {});
+  fs::remove_all(root, errorCode);
+
+  ASSERT_THAT(unresolvedIncludeDirectives, testing::SizeIs(3));
+  EXPECT_THAT(unresolvedIncludeDirectives[0].getIncludedFile().wstr(), testing::StrEq(L"missing.h"));
+  EXPECT_THAT(unresolvedIncludeDirectives[0].getIncludingFile().fileName(), testing::StrEq(L"a.h"));
+  EXPECT_THAT(unresolvedIncludeDirectives[1].getIncludedFile().wstr(), testing::StrEq(L"missing0.h"));
+  EXPECT_THAT(unresolvedIncludeDirectives[1].getIncludingFile().fileName(), testing::StrEq(L"source0.cpp"));
+  EXPECT_THAT(unresolvedIncludeDirectives[2].getIncludedFile().wstr(), testing::StrEq(L"missing1.h"));
+  EXPECT_THAT(unresolvedIncludeDirectives[2].getIncludingFile().fileName(), testing::StrEq(L"source1.cpp"));
+}
+
+TEST_F(CxxIncludeProcessing, headerSearchPathDetectionOfManyFilesMatchesDetectionOfSingleFiles) {
+  namespace fs = std::filesystem;
+  const fs::path root = fs::weakly_canonical(fs::temp_directory_path()) / "CxxIncludeProcessingTestSuite";
+  std::error_code errorCode;
+  fs::remove_all(root, errorCode);
+  fs::create_directories(root / "common" / "shared", errorCode);
+
+  // enough source files to process them on multiple threads
+  std::set<FilePath> sourceFilePaths;
+  for(int i = 0; i < 64; i++) {
+    const std::string libName = "lib" + std::to_string(i % 4);
+    fs::create_directories(root / ("sub" + std::to_string(i % 4)) / libName, errorCode);
+    const fs::path sourceFilePath = root / ("source" + std::to_string(i) + ".cpp");
+    std::ofstream(sourceFilePath) << "#include \"" << libName << "/" << libName << ".h\"\n#include <missing.h>\n";
+    sourceFilePaths.insert(FilePath(sourceFilePath.wstring()));
+  }
+  for(int i = 0; i < 4; i++) {
+    const std::string libName = "lib" + std::to_string(i);
+    std::ofstream(root / ("sub" + std::to_string(i)) / libName / (libName + ".h")) << "#include \"shared/b.h\"\n";
+  }
+  std::ofstream(root / "common" / "shared" / "b.h") << "#include \"missing.h\"\n";
+
+  const std::set<FilePath> searchedPaths = {FilePath(root.wstring())};
+  const std::set<FilePath> headerSearchDirectories = IncludeProcessing::getHeaderSearchDirectories(
+      sourceFilePaths, searchedPaths, {}, 1, [](float) {});
+  std::set<FilePath> headerSearchDirectoriesOfSingleFiles;
+  for(const FilePath& sourceFilePath : sourceFilePaths) {
+    const std::set<FilePath> directories = IncludeProcessing::getHeaderSearchDirectories(
+        {sourceFilePath}, searchedPaths, {}, 1, [](float) {});
+    headerSearchDirectoriesOfSingleFiles.insert(directories.begin(), directories.end());
+  }
+  fs::remove_all(root, errorCode);
+
+  EXPECT_EQ(headerSearchDirectoriesOfSingleFiles, headerSearchDirectories);
+  EXPECT_THAT(headerSearchDirectories,
+              testing::ElementsAre(FilePath((root / "common").wstring()),
+                                   FilePath((root / "sub0").wstring()),
+                                   FilePath((root / "sub1").wstring()),
+                                   FilePath((root / "sub2").wstring()),
+                                   FilePath((root / "sub3").wstring())));
+}
+
 TEST_F(CxxIncludeProcessing, headerSearchPathDetectionDoesNotFindPathRelativeToIncludingFile) {
   auto headerSearchDirectories = utility::toVector(IncludeProcessing::getHeaderSearchDirectories(
       {FilePath(L"data/CxxIncludeProcessingTestSuite/"